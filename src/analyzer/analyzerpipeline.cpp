@@ -0,0 +1,122 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include "moc_analyzerpipeline.cpp"
+#include "util/assert.h"
+#include "util/timer.h"
+
+AnalyzerPipeline::AnalyzerPipeline(
+        int numLanes,
+        int numChunks,
+        SINT maxSamplesPerChunk)
+        : m_semaFreeChunks(numChunks),
+          m_writeChunkIndex(0),
+          m_chunkAcquired(false),
+          m_bQuit(false) {
+    DEBUG_ASSERT(numLanes > 0);
+    DEBUG_ASSERT(numChunks > 0);
+    m_chunks.reserve(numChunks);
+    for (int i = 0; i < numChunks; ++i) {
+        m_chunks.push_back(std::make_unique<Chunk>(maxSamplesPerChunk));
+    }
+    m_lanes.reserve(numLanes);
+    for (int i = 0; i < numLanes; ++i) {
+        m_lanes.push_back(std::make_unique<AnalyzerPipelineLane>(this));
+    }
+    // The lanes inherit the priority of the analyzer thread
+    for (const auto& pLane : m_lanes) {
+        pLane->start();
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    drain();
+    m_bQuit.store(true);
+    for (const auto& pLane : m_lanes) {
+        pLane->m_semaPublishedChunks.release();
+    }
+    for (const auto& pLane : m_lanes) {
+        pLane->wait();
+    }
+}
+
+void AnalyzerPipeline::assignAnalyzers(std::vector<AnalyzerWithState>* pAnalyzers) {
+    DEBUG_ASSERT(!m_chunkAcquired);
+    for (const auto& pLane : m_lanes) {
+        pLane->m_analyzers.clear();
+    }
+    // Distribute the active analyzers round-robin. The expensive beat
+    // and key detection are registered next to each other and thus end
+    // up in different lanes.
+    int laneIndex = 0;
+    for (auto& analyzer : *pAnalyzers) {
+        if (!analyzer.isActive()) {
+            continue;
+        }
+        m_lanes[laneIndex]->m_analyzers.push_back(&analyzer);
+        laneIndex = (laneIndex + 1) % numLanes();
+    }
+    // The lanes access their analyzers only after acquiring a published
+    // chunk, which synchronizes with the release when publishing it.
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::acquireChunk() {
+    DEBUG_ASSERT(!m_chunkAcquired);
+    m_semaFreeChunks.acquire();
+    m_chunkAcquired = true;
+    return mixxx::SampleBuffer::WritableSlice(chunk(m_writeChunkIndex).buffer);
+}
+
+void AnalyzerPipeline::publishChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+    VERIFY_OR_DEBUG_ASSERT(m_chunkAcquired) {
+        return;
+    }
+    m_chunkAcquired = false;
+    Chunk& writeChunk = chunk(m_writeChunkIndex);
+    DEBUG_ASSERT(sampleCount == 0 ||
+            (pSamples >= writeChunk.buffer.data() &&
+                    pSamples + sampleCount <=
+                            writeChunk.buffer.data() + writeChunk.buffer.size()));
+    writeChunk.pSamples = pSamples;
+    writeChunk.sampleCount = sampleCount;
+    writeChunk.pendingLanes.store(numLanes());
+    m_writeChunkIndex = nextChunkIndex(m_writeChunkIndex);
+    for (const auto& pLane : m_lanes) {
+        pLane->m_semaPublishedChunks.release();
+    }
+}
+
+void AnalyzerPipeline::drain() {
+    DEBUG_ASSERT(!m_chunkAcquired);
+    // All chunks are free when all lanes are idle
+    const int numChunks = static_cast<int>(m_chunks.size());
+    m_semaFreeChunks.acquire(numChunks);
+    m_semaFreeChunks.release(numChunks);
+}
+
+AnalyzerPipelineLane::AnalyzerPipelineLane(AnalyzerPipeline* pPipeline)
+        : m_pPipeline(pPipeline),
+          m_readChunkIndex(0) {
+}
+
+void AnalyzerPipelineLane::run() {
+    while (true) {
+        m_semaPublishedChunks.acquire();
+        if (m_pPipeline->m_bQuit.load()) {
+            return;
+        }
+        auto& readChunk = m_pPipeline->chunk(m_readChunkIndex);
+        m_readChunkIndex = m_pPipeline->nextChunkIndex(m_readChunkIndex);
+        if (readChunk.sampleCount > 0) {
+            ScopedTimer t("AnalyzerPipelineLane::processChunk");
+            for (auto* pAnalyzer : m_analyzers) {
+                pAnalyzer->processSamples(
+                        readChunk.pSamples,
+                        static_cast<int>(readChunk.sampleCount));
+            }
+        }
+        if (readChunk.pendingLanes.fetch_sub(1) == 1) {
+            // The last lane recycles the chunk
+            m_pPipeline->m_semaFreeChunks.release();
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+
+class AnalyzerPipelineLane;
+
+// Decouples the analysis of a track from decoding and runs independent
+// analyzers concurrently.
+//
+// The decoding thread writes each chunk of decoded samples into a bounded
+// ring of sample buffers and publishes it. The analyzers are distributed
+// among a fixed number of lanes that run on separate threads. Each lane
+// processes all published chunks in order and a chunk is recycled after
+// all lanes have processed it. The fastest lane is therefore never ahead
+// of the slowest one by more than the capacity of the ring, and the time
+// for analyzing a track is bounded by the slowest lane instead of the sum
+// of all analyzers.
+//
+// Every analyzer still receives exactly the same samples in the same
+// order, i.e. the results are identical to sequential processing.
+class AnalyzerPipeline {
+  public:
+    AnalyzerPipeline(
+            int numLanes,
+            int numChunks,
+            SINT maxSamplesPerChunk);
+    ~AnalyzerPipeline();
+
+    int numLanes() const {
+        return static_cast<int>(m_lanes.size());
+    }
+
+    // Distributes the active analyzers among the lanes. Must only be
+    // called when the pipeline is drained.
+    void assignAnalyzers(std::vector<AnalyzerWithState>* pAnalyzers);
+
+    // Returns the buffer of the next chunk, blocking until all lanes
+    // have finished processing its previous contents. Every acquired
+    // chunk must be published before acquiring the next one.
+    mixxx::SampleBuffer::WritableSlice acquireChunk();
+
+    // Passes sampleCount samples starting at pSamples within the acquired
+    // chunk on to all lanes. A sampleCount of 0 just returns the chunk to
+    // the ring.
+    void publishChunk(const CSAMPLE* pSamples, SINT sampleCount);
+
+    // Blocks until all lanes have processed all published chunks.
+    void drain();
+
+  private:
+    friend class AnalyzerPipelineLane;
+
+    struct Chunk {
+        explicit Chunk(SINT maxSamples)
+                : buffer(maxSamples),
+                  pSamples(nullptr),
+                  sampleCount(0),
+                  pendingLanes(0) {
+        }
+        mixxx::SampleBuffer buffer;
+        const CSAMPLE* pSamples;
+        SINT sampleCount;
+        // The number of lanes that have not yet processed the chunk
+        std::atomic<int> pendingLanes;
+    };
+
+    Chunk& chunk(int chunkIndex) {
+        return *m_chunks[chunkIndex];
+    }
+    int nextChunkIndex(int chunkIndex) const {
+        return (chunkIndex + 1) % static_cast<int>(m_chunks.size());
+    }
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<std::unique_ptr<AnalyzerPipelineLane>> m_lanes;
+
+    // One permit per chunk that is not in use by any lane
+    QSemaphore m_semaFreeChunks;
+    int m_writeChunkIndex;
+    bool m_chunkAcquired;
+
+    std::atomic<bool> m_bQuit;
+};
+
+class AnalyzerPipelineLane : public QThread {
+    Q_OBJECT
+  public:
+    explicit AnalyzerPipelineLane(AnalyzerPipeline* pPipeline);
+
+  protected:
+    void run() override;
+
+  private:
+    friend class AnalyzerPipeline;
+
+    AnalyzerPipeline* const m_pPipeline;
+
+    // Only modified while the pipeline is drained
+    std::vector<AnalyzerWithState*> m_analyzers;
+
+    // One permit per published chunk that has not been processed yet
+    QSemaphore m_semaPublishedChunks;
+    int m_readChunkIndex;
+};
@@ -3,8 +3,10 @@
 #include "analyzer/analyzertrack.h"
 #include "track/trackid.h"
 
-AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId, AnalyzerTrack::Options options)
-        : m_trackId(trackId), m_options(options) {
+AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId,
+        AnalyzerTrack::Options options,
+        Priority priority)
+        : m_trackId(trackId), m_options(options), m_priority(priority) {
 }
 
 const TrackId& AnalyzerScheduledTrack::getTrackId() const {
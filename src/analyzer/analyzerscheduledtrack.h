@@ -9,8 +9,20 @@
 /// A track to be scheduled for analysis with additional options.
 class AnalyzerScheduledTrack {
   public:
+    /// Tracks with a higher priority are analyzed first.
+    enum class Priority {
+        /// Batch analysis of the library
+        Low,
+        /// Tracks that have been selected for analysis
+        Normal,
+        /// Tracks that are about to be played soon, e.g. in Auto DJ
+        High,
+    };
+    static constexpr int kPriorityCount = static_cast<int>(Priority::High) + 1;
+
     AnalyzerScheduledTrack(TrackId trackId,
-            AnalyzerTrack::Options options = AnalyzerTrack::Options());
+            AnalyzerTrack::Options options = AnalyzerTrack::Options(),
+            Priority priority = Priority::Normal);
 
     /// Fetches the id of the track to be analyzed.
     const TrackId& getTrackId() const;
@@ -18,9 +30,14 @@ class AnalyzerScheduledTrack {
     /// Fetches the additional options.
     const AnalyzerTrack::Options& getOptions() const;
 
+    Priority getPriority() const {
+        return m_priority;
+    }
+
   private:
     /// The id of the track to be analyzed.
     TrackId m_trackId;
     /// The additional options.
     AnalyzerTrack::Options m_options;
+    Priority m_priority;
 };
@@ -13,6 +13,7 @@
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/decodedaudiocache.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/db/dbconnectionpooled.h"
@@ -36,6 +37,22 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of threads for running the analyzers of a single track
+// concurrently. A value of 1 disables the pipeline and all analyzers
+// run on the analyzer thread that also decodes the audio data. The
+// number is further limited by the share of each analyzer thread in
+// the available cores, see TrackAnalysisScheduler.
+const ConfigKey kPipelineLanesConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("AnalyzerPipelineLanes"));
+constexpr int kPipelineLanesDefault = 4;
+
+// The number of decoded chunks that may be buffered for the slowest
+// lane while the others continue.
+constexpr int kPipelineChunks = 8;
+
+const QString kDecodeDurationStatTag = QStringLiteral("AnalyzerThread decode");
+const QString kTrackDurationStatTag = QStringLiteral("AnalyzerThread track");
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -62,12 +79,14 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        int maxPipelineLanes) {
     return Pointer(new AnalyzerThread(
                            id,
                            dbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           maxPipelineLanes),
             deleteAnalyzerThread);
 }
 
@@ -75,7 +94,8 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        int maxPipelineLanes)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
@@ -83,6 +103,7 @@ AnalyzerThread::AnalyzerThread(
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
+          m_maxPipelineLanes(maxPipelineLanes),
           m_nextTrack(2), // minimum capacity
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
@@ -120,6 +141,18 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    const int numPipelineLanes = math_min(
+            m_pConfig->getValue(kPipelineLanesConfigKey, kPipelineLanesDefault),
+            math_min(static_cast<int>(m_analyzers.size()),
+                    m_maxPipelineLanes));
+    if (numPipelineLanes > 1) {
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                numPipelineLanes,
+                kPipelineChunks,
+                mixxx::kAnalysisSamplesPerChunk);
+        kLogger.debug() << "Running analyzers in" << numPipelineLanes << "lanes";
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -128,6 +161,9 @@ void AnalyzerThread::doRun() {
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
+        PerformanceTimer trackTimer;
+        trackTimer.start();
+        m_decodeDuration = mixxx::Duration();
 
         // Get the audio
         const mixxx::AudioSourcePointer audioSource =
@@ -166,6 +202,21 @@ void AnalyzerThread::doRun() {
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.finish(*m_currentTrack);
                 }
+                const mixxx::Duration trackDuration = trackTimer.elapsed();
+                Stat::track(kDecodeDurationStatTag,
+                        Stat::DURATION_NANOSEC,
+                        kDefaultComputeFlags,
+                        static_cast<double>(m_decodeDuration.toIntegerNanos()));
+                Stat::track(kTrackDurationStatTag,
+                        Stat::DURATION_NANOSEC,
+                        kDefaultComputeFlags,
+                        static_cast<double>(trackDuration.toIntegerNanos()));
+                kLogger.debug()
+                        << "Analyzed track in"
+                        << trackDuration.debugMillisWithUnit()
+                        << "including"
+                        << m_decodeDuration.debugMillisWithUnit()
+                        << "for decoding";
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
                 for (auto&& analyzer : m_analyzers) {
@@ -181,6 +232,8 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    // The lanes must not outlive the analyzers
+    m_pPipeline.reset();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -220,6 +273,7 @@ WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
 
 AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         const mixxx::AudioSourcePointer& audioSource) {
+    ScopedTimer t("AnalyzerThread::analyzeAudioSource");
     DEBUG_ASSERT(m_currentTrack.has_value());
 
     mixxx::AudioSourceStereoProxy audioSourceProxy(
@@ -229,6 +283,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             audioSourceProxy.getSignalInfo().getChannelCount() ==
             mixxx::kAnalysisChannels);
 
+    // All frames are decoded sequentially and could be cached for
+    // subsequent reads at no extra decoding costs.
+    std::unique_ptr<mixxx::DecodedAudioCache::Writer> pDecodedAudioCacheWriter;
+    auto* const pDecodedAudioCache = mixxx::DecodedAudioCache::instance();
+    if (pDecodedAudioCache) {
+        const auto fileInfo = m_currentTrack->getTrack()->getFileInfo();
+        if (!pDecodedAudioCache->contains(fileInfo)) {
+            pDecodedAudioCacheWriter = pDecodedAudioCache->createWriter(
+                    fileInfo, *audioSource);
+        }
+    }
+
+    if (m_pPipeline) {
+        m_pPipeline->assignAnalyzers(&m_analyzers);
+    }
+
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
@@ -236,6 +306,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
         if (isStopping()) {
+            drainPipeline();
             return AnalysisResult::Cancelled;
         }
 
@@ -247,12 +318,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data, either into the next free
+        // chunk of the pipeline or into the local buffer
+        const auto writableSlice = m_pPipeline
+                ? m_pPipeline->acquireChunk()
+                : mixxx::SampleBuffer::WritableSlice(m_sampleBuffer);
+        PerformanceTimer decodeTimer;
+        decodeTimer.start();
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                writableSlice));
+        m_decodeDuration += decodeTimer.elapsed();
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -277,6 +355,9 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                 // If we have read an incomplete chunk while the range has grown
                 // we need to discard the read results and re-read the current
                 // chunk!
+                if (m_pPipeline) {
+                    m_pPipeline->publishChunk(nullptr, 0);
+                }
 
                 remainingFrameRange.growFront(chunkFrameRange.length());
                 continue;
@@ -290,17 +371,31 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                     audioSourceProxy.frameIndexRange().end() - remainingFrameRange.end());
         }
 
+        // 2nd: step: Analyze chunk of decoded audio data
+        if (m_pPipeline) {
+            // The analyzers continue with this chunk in the background
+            // while the next one is decoded
+            m_pPipeline->publishChunk(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength());
+        }
+
         sleepWhileSuspended();
         if (isStopping()) {
+            drainPipeline();
             return AnalysisResult::Cancelled;
         }
 
-        // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+            if (!m_pPipeline) {
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
+            }
+            if (pDecodedAudioCacheWriter) {
+                pDecodedAudioCacheWriter->write(readableSampleFrames);
             }
         }
 
@@ -326,9 +421,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
     }
 
+    if (pDecodedAudioCacheWriter) {
+        pDecodedAudioCacheWriter->commit(audioSourceProxy.frameIndexRange());
+    }
+
+    // All chunks must have been analyzed before finishing
+    drainPipeline();
+
     return AnalysisResult::Finished;
 }
 
+void AnalyzerThread::drainPipeline() {
+    if (m_pPipeline) {
+        m_pPipeline->drain();
+    }
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
@@ -55,17 +56,22 @@ class AnalyzerThread : public WorkerThread {
         NullPointer();
     };
 
+    // The analyzers of a track run concurrently in at most maxPipelineLanes
+    // threads, which should be the share of this thread in the available
+    // cores.
     static Pointer createInstance(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            int maxPipelineLanes);
 
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            int maxPipelineLanes);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -100,6 +106,7 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    const int m_maxPipelineLanes;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -120,12 +127,18 @@ class AnalyzerThread : public WorkerThread {
 
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Runs the analyzers concurrently if enabled
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
 
     PerformanceTimer m_lastBusyProgressEmittedTimer;
 
+    // The time spent for decoding the current track
+    mixxx::Duration m_decodeDuration;
+
     enum class AnalysisResult {
         Pending,
         Finished,
@@ -134,6 +147,8 @@ class AnalyzerThread : public WorkerThread {
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    void drainPipeline();
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
@@ -116,8 +116,9 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
                 if (missingWaveform && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveform = ConstWaveformPointer(
-                            WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    Waveform* pWaveform = WaveformFactory::loadWaveformFromAnalysis(analysis);
+                    pWaveform->buildLevels();
+                    pLoadedTrackWaveform = ConstWaveformPointer(pWaveform);
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -275,6 +276,7 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
         m_waveform->setCompletion(m_waveform->getDataSize());
+        m_waveform->buildLevels();
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
@@ -1,11 +1,17 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
 #include "track/track.h"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/math.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -16,6 +22,36 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+// The interval for adjusting the number of active workers
+constexpr int kUpdateActiveWorkersIntervalMillis = 2000;
+
+// The engine load in percent above which a low priority analysis is
+// suspended while any deck is playing. 0 disables the suspension.
+const ConfigKey kSuspendEngineLoadConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("AnalysisSuspendEngineLoad"));
+constexpr int kSuspendEngineLoadDefault = 50;
+
+// The analysis is resumed after the engine load has dropped below this
+// fraction of the threshold to avoid toggling back and forth.
+constexpr double kResumeEngineLoadHysteresis = 0.75;
+
+const QString kTracksPerMinuteStatTag = QStringLiteral("TrackAnalysisScheduler tracks/min");
+
+// Reduces the number of workers if other processes keep the CPU cores
+// busy. All workers stay active if the load average is not available.
+int activeWorkerCountForSystemLoad(int maxWorkerCount,
+        int busyWorkerCount,
+        std::optional<double> loadAverage) {
+    if (!loadAverage) {
+        return maxWorkerCount;
+    }
+    // Our own busy workers contribute to the load average
+    const int otherLoad = math_max(0,
+            static_cast<int>(std::lround(*loadAverage)) - busyWorkerCount);
+    return math_max(1,
+            math_min(maxWorkerCount, QThread::idealThreadCount() - otherLoad));
+}
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -27,6 +63,16 @@ void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
 
 } // anonymous namespace
 
+std::optional<double> TrackAnalysisSchedulerEnvironment::systemLoadAverage() const {
+#ifdef Q_OS_UNIX
+    double loadAverage;
+    if (getloadavg(&loadAverage, 1) == 1) {
+        return loadAverage;
+    }
+#endif
+    return std::nullopt;
+}
+
 TrackAnalysisScheduler::NullPointer::NullPointer()
     : Pointer(nullptr, [](TrackAnalysisScheduler*){}) {
 }
@@ -54,11 +100,20 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_activeWorkerCount(numWorkerThreads),
+          m_suspendEngineLoadThreshold((modeFlags & AnalyzerModeFlags::LowPriority)
+                          ? pConfig->getValue(kSuspendEngineLoadConfigKey,
+                                    kSuspendEngineLoadDefault) /
+                                  100.0
+                          : 0.0),
+          m_suspendedByCaller(true),
+          m_suspendedForEngineLoad(false),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
           // The first signal should always be emitted
-          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
+          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration),
+          m_analyzedTracksCount(0) {
     DEBUG_ASSERT(m_pEnvironment);
     VERIFY_OR_DEBUG_ASSERT(numWorkerThreads > 0) {
             kLogger.warning()
@@ -71,6 +126,10 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 << "worker threads. Priority: "
                 << (modeFlags & AnalyzerModeFlags::LowPriority ? "low" : "normal");
     }
+    // The pipeline lanes of all workers together should not exceed the
+    // number of cores
+    const int maxPipelineLanes = math_max(1,
+            QThread::idealThreadCount() / math_max(1, numWorkerThreads));
     // 1st pass: Create worker threads
     m_workers.reserve(numWorkerThreads);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
@@ -78,7 +137,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 threadId,
                 pDbConnectionPool,
                 pConfig,
-                modeFlags));
+                modeFlags,
+                maxPipelineLanes));
         connect(m_workers.back().thread(),
                 &AnalyzerThread::progress,
                 this,
@@ -89,6 +149,12 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         worker.thread()->suspend();
         worker.thread()->start(kWorkerThreadPriority);
     }
+
+    connect(&m_activeWorkersTimer,
+            &QTimer::timeout,
+            this,
+            &TrackAnalysisScheduler::slotUpdateActiveWorkers);
+    m_activeWorkersTimer.start(kUpdateActiveWorkersIntervalMillis);
 }
 
 TrackAnalysisScheduler::~TrackAnalysisScheduler() {
@@ -99,9 +165,24 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
     // The finished() signal is emitted regardless of when the last
     // signal has been emitted
     if (allTracksFinished()) {
+        if (m_analyzedTracksCount > 0) {
+            const double tracksPerMinute = this->tracksPerMinute();
+            kLogger.info()
+                    << "Analyzed"
+                    << m_analyzedTracksCount
+                    << "tracks at"
+                    << tracksPerMinute
+                    << "tracks/min";
+            Stat::track(kTracksPerMinuteStatTag,
+                    Stat::UNSPECIFIED,
+                    Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX,
+                    tracksPerMinute);
+        }
         m_currentTrackProgress = kAnalyzerProgressUnknown;
         m_currentTrackNumber = 0;
         m_dequeuedTracksCount = 0;
+        m_firstResumedAt.reset();
+        m_analyzedTracksCount = 0;
         emit finished();
         return;
     }
@@ -171,7 +252,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         }
     }
     const int totalTracksCount =
-            m_dequeuedTracksCount + static_cast<int>(m_queuedTracks.size());
+            m_dequeuedTracksCount + queuedTracksCount();
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -201,7 +282,7 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     case AnalyzerThreadState::Idle:
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
-        worker.onAnalyzerProgress(analyzerProgress);
+        worker.onIdle();
         submitNextTrack(&worker);
         break;
     case AnalyzerThreadState::Busy:
@@ -221,6 +302,9 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
             m_pendingTrackIds.erase(trackId);
+            if (analyzerProgress == kAnalyzerProgressDone) {
+                ++m_analyzedTracksCount;
+            }
             worker.onAnalyzerProgress(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
@@ -244,7 +328,15 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    const auto priorityIndex = static_cast<int>(track.getPriority());
+    for (int i = 0; i < priorityIndex; ++i) {
+        // Move the track up if it has been queued with a lower priority
+        std::erase_if(m_queuedTracks[i],
+                [&track](const AnalyzerScheduledTrack& queuedTrack) {
+                    return queuedTrack.getTrackId() == track.getTrackId();
+                });
+    }
+    m_queuedTracks[priorityIndex].push_back(track);
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -252,6 +344,27 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
     return true;
 }
 
+bool TrackAnalysisScheduler::raisePriority(
+        TrackId trackId,
+        AnalyzerScheduledTrack::Priority priority) {
+    const auto priorityIndex = static_cast<int>(priority);
+    for (int i = 0; i < priorityIndex; ++i) {
+        auto& queuedTracks = m_queuedTracks[i];
+        const auto queuedTrack = std::find_if(queuedTracks.begin(),
+                queuedTracks.end(),
+                [trackId](const AnalyzerScheduledTrack& queuedTrack) {
+                    return queuedTrack.getTrackId() == trackId;
+                });
+        if (queuedTrack != queuedTracks.end()) {
+            m_queuedTracks[priorityIndex].push_back(AnalyzerScheduledTrack(
+                    trackId, queuedTrack->getOptions(), priority));
+            queuedTracks.erase(queuedTrack);
+            return true;
+        }
+    }
+    return false;
+}
+
 int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks) {
     int scheduledCount = 0;
     for (auto track : tracks) {
@@ -262,24 +375,117 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
     return scheduledCount;
 }
 
+int TrackAnalysisScheduler::queuedTracksCount() const {
+    int count = 0;
+    for (const auto& queuedTracks : m_queuedTracks) {
+        count += static_cast<int>(queuedTracks.size());
+    }
+    return count;
+}
+
+double TrackAnalysisScheduler::tracksPerMinute() const {
+    if (!m_firstResumedAt) {
+        return 0.0;
+    }
+    const auto elapsed = std::chrono::duration<double, std::ratio<60>>(
+            Clock::now() - *m_firstResumedAt);
+    if (elapsed.count() <= 0.0) {
+        return 0.0;
+    }
+    return m_analyzedTracksCount / elapsed.count();
+}
+
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
-    for (auto& worker: m_workers) {
-        worker.suspendThread();
-    }
+    m_suspendedByCaller = true;
+    updateSuspended();
 }
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    m_suspendedByCaller = false;
+    if (!m_firstResumedAt) {
+        m_firstResumedAt = Clock::now();
+    }
+    updateSuspended();
+}
+
+void TrackAnalysisScheduler::updateSuspended() {
+    const bool suspended = m_suspendedByCaller || m_suspendedForEngineLoad;
     for (auto& worker: m_workers) {
-        worker.resumeThread();
+        if (suspended) {
+            worker.suspendThread();
+        } else {
+            worker.resumeThread();
+        }
+    }
+}
+
+void TrackAnalysisScheduler::slotUpdateActiveWorkers() {
+    if (m_suspendEngineLoadThreshold > 0.0) {
+        const double engineLoad = m_pEnvironment->isAnyDeckPlaying()
+                ? m_pEnvironment->engineLoad()
+                : 0.0;
+        const bool suspendedForEngineLoad = m_suspendedForEngineLoad
+                ? engineLoad >= m_suspendEngineLoadThreshold * kResumeEngineLoadHysteresis
+                : engineLoad > m_suspendEngineLoadThreshold;
+        if (m_suspendedForEngineLoad != suspendedForEngineLoad) {
+            kLogger.info()
+                    << (suspendedForEngineLoad ? "Suspending" : "Resuming")
+                    << "analysis at an engine load of"
+                    << engineLoad;
+            m_suspendedForEngineLoad = suspendedForEngineLoad;
+            updateSuspended();
+        }
+    }
+
+    int busyWorkerCount = 0;
+    for (const auto& worker : m_workers) {
+        if (worker && !worker.isIdle()) {
+            ++busyWorkerCount;
+        }
+    }
+    const int activeWorkerCount = activeWorkerCountForSystemLoad(
+            static_cast<int>(m_workers.size()),
+            busyWorkerCount,
+            m_pEnvironment->systemLoadAverage());
+    if (m_activeWorkerCount != activeWorkerCount) {
+        kLogger.debug()
+                << "Adjusting the number of active workers from"
+                << m_activeWorkerCount
+                << "to"
+                << activeWorkerCount;
+        m_activeWorkerCount = activeWorkerCount;
+        // Workers above the limit finish their current track and
+        // are not given a new one
+        submitNextTracksToIdleWorkers();
+    }
+}
+
+void TrackAnalysisScheduler::submitNextTracksToIdleWorkers() {
+    for (auto& worker : m_workers) {
+        if (worker.isIdle()) {
+            submitNextTrack(&worker);
+        }
     }
 }
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
+    if (worker->thread()->id() >= m_activeWorkerCount) {
+        return false;
+    }
+    while (true) {
+        // Dequeue from the queue with the highest priority
+        auto queuedTracks = std::find_if(m_queuedTracks.rbegin(),
+                m_queuedTracks.rend(),
+                [](const auto& queuedTracks) {
+                    return !queuedTracks.empty();
+                });
+        if (queuedTracks == m_queuedTracks.rend()) {
+            break;
+        }
+        AnalyzerScheduledTrack nextScheduledTrack = queuedTracks->front();
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
@@ -289,7 +495,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
+                        queuedTracks->pop_front();
                         ++m_dequeuedTracksCount;
                         return true;
                     } else {
@@ -320,7 +526,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
+        queuedTracks->pop_front();
         ++m_dequeuedTracksCount;
     }
     return false;
@@ -333,7 +539,9 @@ void TrackAnalysisScheduler::stop() {
     }
     // The worker threads are still running at this point
     // and m_workers must not be modified!
-    m_queuedTracks.clear();
+    for (auto& queuedTracks : m_queuedTracks) {
+        queuedTracks.clear();
+    }
     m_pendingTrackIds.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <QList>
+#include <QTimer>
+#include <array>
 #include <deque>
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -21,6 +24,17 @@ class TrackAnalysisSchedulerEnvironment {
     virtual ~TrackAnalysisSchedulerEnvironment() = default;
 
     virtual TrackPointer loadTrackById(TrackId trackId) const = 0;
+
+    /// Returns true if any deck is currently playing.
+    virtual bool isAnyDeckPlaying() const = 0;
+
+    /// The fraction of the available time that the audio engine
+    /// currently needs for processing each buffer.
+    virtual double engineLoad() const = 0;
+
+    /// The 1-minute load average of the system, if available. Only
+    /// Unix systems provide it.
+    virtual std::optional<double> systemLoadAverage() const;
 };
 
 class TrackAnalysisScheduler : public QObject {
@@ -51,9 +65,21 @@ class TrackAnalysisScheduler : public QObject {
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
+    //
+    // Tracks with a higher priority are analyzed first. Scheduling a track
+    // that is already queued with a lower priority moves it up.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
+    // Moves a track that is queued with a lower priority up to the given
+    // priority. Unlike scheduleTrack() this never adds a track. Returns
+    // false if the track is not queued with a lower priority.
+    bool raisePriority(TrackId trackId, AnalyzerScheduledTrack::Priority priority);
+
+    // The number of tracks that have been analyzed per minute since
+    // the analysis has been resumed.
+    double tracksPerMinute() const;
+
   public slots:
     void suspend();
 
@@ -74,7 +100,13 @@ class TrackAnalysisScheduler : public QObject {
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
 
+    // Adjusts the number of active workers to the current system
+    // and engine load.
+    void slotUpdateActiveWorkers();
+
   private:
+    friend class TrackAnalysisSchedulerTest;
+
     // Owns an analyzer thread and buffers the most recent progress update
     // received from this thread during analysis. It does not need to be
     // thread-safe, because all functions are invoked from the host thread
@@ -83,7 +115,8 @@ class TrackAnalysisScheduler : public QObject {
       public:
         explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
             : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+              m_analyzerProgress(kAnalyzerProgressUnknown),
+              m_idle(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -101,9 +134,18 @@ class TrackAnalysisScheduler : public QObject {
             return m_analyzerProgress;
         }
 
+        // Waiting for the next track
+        bool isIdle() const {
+            return m_thread && m_idle;
+        }
+
         bool submitNextTrack(const AnalyzerTrack& track) {
             DEBUG_ASSERT(m_thread);
-            return m_thread->submitNextTrack(std::move(track));
+            if (!m_thread->submitNextTrack(std::move(track))) {
+                return false;
+            }
+            m_idle = false;
+            return true;
         }
 
         void suspendThread() {
@@ -129,6 +171,12 @@ class TrackAnalysisScheduler : public QObject {
             m_analyzerProgress = analyzerProgress;
         }
 
+        void onIdle() {
+            DEBUG_ASSERT(m_thread);
+            m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_idle = true;
+        }
+
         void onThreadExit() {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
@@ -138,13 +186,21 @@ class TrackAnalysisScheduler : public QObject {
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        bool m_idle;
     };
 
     bool submitNextTrack(Worker* worker);
+    void submitNextTracksToIdleWorkers();
     void emitProgressOrFinished();
 
+    // Suspends or resumes the workers according to the requests of the
+    // caller and the current engine load.
+    void updateSuspended();
+
+    int queuedTracksCount() const;
+
     bool allTracksFinished() const {
-        return m_queuedTracks.empty() &&
+        return queuedTracksCount() == 0 &&
                 m_pendingTrackIds.empty();
     }
 
@@ -152,7 +208,22 @@ class TrackAnalysisScheduler : public QObject {
 
     std::vector<Worker> m_workers;
 
-    std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    // Only workers with a lower index than this number get new tracks
+    int m_activeWorkerCount;
+
+    // The analysis is suspended while the engine load exceeds this
+    // threshold and any deck is playing. Disabled if 0.
+    const double m_suspendEngineLoadThreshold;
+
+    bool m_suspendedByCaller;
+    bool m_suspendedForEngineLoad;
+
+    QTimer m_activeWorkersTimer;
+
+    // One queue for each priority
+    std::array<std::deque<AnalyzerScheduledTrack>,
+            AnalyzerScheduledTrack::kPriorityCount>
+            m_queuedTracks;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
@@ -166,4 +237,8 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    // Throughput statistics
+    std::optional<Clock::time_point> m_firstResumedAt;
+    int m_analyzedTracksCount;
 };
@@ -17,7 +17,8 @@ BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
                                    SoundManager* pSoundManager)
         : m_pConfig(pSettingsManager->settings()),
           m_pBroadcastSettings(pSettingsManager->broadcastSettings()),
-          m_pNetworkStream(pSoundManager->getNetworkStream()) {
+          m_pNetworkStream(pSoundManager->getNetworkStream()),
+          m_pSharedEncoders(SharedEncoderPoolPointer::create(m_pNetworkStream)) {
     const bool persist = true;
     m_pBroadcastEnabled = new ControlPushButton(
             ConfigKey(BROADCAST_PREF_KEY,"enabled"), persist);
@@ -132,7 +133,7 @@ void BroadcastManager::slotProfileRemoved(BroadcastProfilePtr profile) {
 void BroadcastManager::slotProfilesChanged() {
     QVector<NetworkOutputStreamWorkerPtr> workers = m_pNetworkStream->outputWorkers();
     for (const NetworkOutputStreamWorkerPtr& pWorker : workers) {
-        ShoutConnectionPtr connection = qSharedPointerCast<ShoutConnection>(pWorker);
+        ShoutConnectionPtr connection = qSharedPointerDynamicCast<ShoutConnection>(pWorker);
         if (connection) {
             BroadcastProfilePtr profile = connection->profile();
             if (profile->connectionStatus() == BroadcastProfile::STATUS_FAILURE
@@ -153,7 +154,7 @@ bool BroadcastManager::addConnection(BroadcastProfilePtr profile) {
         return false;
     }
 
-    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig));
+    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig, m_pSharedEncoders));
     m_pNetworkStream->addOutputWorker(connection);
 
     connect(profile.data(),
@@ -193,7 +194,7 @@ bool BroadcastManager::removeConnection(BroadcastProfilePtr profile) {
 ShoutConnectionPtr BroadcastManager::findConnectionForProfile(BroadcastProfilePtr profile) {
     QVector<NetworkOutputStreamWorkerPtr> workers = m_pNetworkStream->outputWorkers();
     for (const NetworkOutputStreamWorkerPtr& pWorker : workers) {
-        ShoutConnectionPtr connection = qSharedPointerCast<ShoutConnection>(pWorker);
+        ShoutConnectionPtr connection = qSharedPointerDynamicCast<ShoutConnection>(pWorker);
         if (connection.isNull()) {
             continue;
         }
@@ -5,6 +5,7 @@
 #include "preferences/settingsmanager.h"
 #include "preferences/usersettings.h"
 #include "engine/sidechain/enginenetworkstream.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "engine/sidechain/shoutconnection.h"
 
 class SoundManager;
@@ -51,6 +52,7 @@ class BroadcastManager : public QObject {
     UserSettingsPointer m_pConfig;
     BroadcastSettingsPointer m_pBroadcastSettings;
     QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+    SharedEncoderPoolPointer m_pSharedEncoders;
 
     ControlPushButton* m_pBroadcastEnabled;
     ControlObject* m_pStatusCO;
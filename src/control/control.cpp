@@ -1,7 +1,11 @@
 #include "control/control.h"
 
+#include <array>
+#include <atomic>
+
 #include "control/controlobject.h"
 #include "moc_control.cpp"
+#include "util/compatibility/qatomic.h"
 #include "util/stat.h"
 
 namespace {
@@ -27,6 +31,26 @@ QHash<ConfigKey, ConfigKey> s_qCOAliasHash
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
+
+/// Upper bound for the number of controls with ControlPublishMode::Deferred.
+/// The dirty bitmap has a fixed size to avoid allocations in the engine.
+constexpr int kDeferredPublishingSlotCount = 1024;
+constexpr int kDirtyBitsPerWord = 64;
+
+std::atomic<bool> s_deferredPublishingEnabled(false);
+
+/// One bit per slot, set by the writer and cleared by the GUI thread
+/// when publishing. Zero-initialized as static storage.
+std::array<std::atomic<quint64>, kDeferredPublishingSlotCount / kDirtyBitsPerWord>
+        s_deferredDirtyBits;
+
+/// Mutex guarding access to s_deferredPublishingSlots. Never locked
+/// while setting a value.
+MMutex s_deferredPublishingSlotsMutex;
+
+/// The controls with ControlPublishMode::Deferred, indexed by slot.
+std::array<QWeakPointer<ControlDoublePrivate>, kDeferredPublishingSlotCount>
+        s_deferredPublishingSlots GUARDED_BY(s_deferredPublishingSlotsMutex);
 } // namespace
 
 ControlDoublePrivate::ControlDoublePrivate()
@@ -38,6 +62,7 @@ ControlDoublePrivate::ControlDoublePrivate()
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
           m_confirmRequired(true),
+          m_deferredPublishingSlot(-1),
           m_kbdRepeatable(false) {
     m_value.setValue(0.0);
 }
@@ -58,6 +83,7 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           m_confirmRequired(false),
+          m_deferredPublishingSlot(-1),
           m_kbdRepeatable(false) {
     initialize(defaultValue);
 }
@@ -92,6 +118,8 @@ ControlDoublePrivate::~ControlDoublePrivate() {
     s_qCOHash.remove(m_key);
     s_qCOHashMutex.unlock();
 
+    unregisterDeferredPublishing();
+
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
         VERIFY_OR_DEBUG_ASSERT(pConfig) {
@@ -247,6 +275,105 @@ QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
     return s_qCOAliasHash;
 }
 
+// static
+void ControlDoublePrivate::setDeferredPublishingEnabled(bool enabled) {
+    s_deferredPublishingEnabled.store(enabled, std::memory_order_release);
+}
+
+// static
+bool ControlDoublePrivate::isDeferredPublishingEnabled() {
+    return s_deferredPublishingEnabled.load(std::memory_order_acquire);
+}
+
+// static
+void ControlDoublePrivate::publishDeferredValueChanges() {
+    QList<QSharedPointer<ControlDoublePrivate>> dirtyControls;
+    for (int word = 0; word < static_cast<int>(s_deferredDirtyBits.size()); ++word) {
+        // Changes that are flagged after this point are published
+        // during the next invocation
+        quint64 dirtyBits = s_deferredDirtyBits[word].exchange(0, std::memory_order_acq_rel);
+        if (dirtyBits == 0) {
+            continue;
+        }
+        const MMutexLocker locker(&s_deferredPublishingSlotsMutex);
+        for (int bit = 0; dirtyBits != 0; ++bit, dirtyBits >>= 1) {
+            if ((dirtyBits & 1) == 0) {
+                continue;
+            }
+            auto pControl = s_deferredPublishingSlots[word * kDirtyBitsPerWord + bit].lock();
+            if (pControl) {
+                dirtyControls.append(std::move(pControl));
+            }
+        }
+    }
+    // Signal without holding the lock, the receivers might create
+    // new controls
+    for (const auto& pControl : qAsConst(dirtyControls)) {
+        // The creator CO is passed as the sender to prevent that the
+        // change is echoed back to its owner
+        emit pControl->valueChanged(pControl->get(), pControl->getCreatorCO());
+    }
+}
+
+void ControlDoublePrivate::setPublishMode(ControlPublishMode mode) {
+    if (mode == ControlPublishMode::Immediate) {
+        unregisterDeferredPublishing();
+        return;
+    }
+    if (atomicLoadAcquire(m_deferredPublishingSlot) >= 0) {
+        // Already deferred
+        return;
+    }
+    QSharedPointer<ControlDoublePrivate> pControl;
+    {
+        const MMutexLocker locker(&s_qCOHashMutex);
+        pControl = s_qCOHash.value(m_key).lock();
+    }
+    VERIFY_OR_DEBUG_ASSERT(pControl.data() == this) {
+        qWarning() << "Cannot defer publishing the changes of unregistered control" << m_key;
+        return;
+    }
+    const MMutexLocker locker(&s_deferredPublishingSlotsMutex);
+    for (int slot = 0; slot < kDeferredPublishingSlotCount; ++slot) {
+        if (s_deferredPublishingSlots[slot].isNull()) {
+            s_deferredPublishingSlots[slot] = pControl;
+            m_deferredPublishingSlot.storeRelease(slot);
+            return;
+        }
+    }
+    qWarning() << "Too many controls with deferred publishing, publishing"
+               << m_key << "immediately";
+}
+
+void ControlDoublePrivate::unregisterDeferredPublishing() {
+    const int slot = m_deferredPublishingSlot.fetchAndStoreOrdered(-1);
+    if (slot < 0) {
+        return;
+    }
+    const MMutexLocker locker(&s_deferredPublishingSlotsMutex);
+    s_deferredPublishingSlots[slot].clear();
+    // A pending change must not be published for the next control
+    // that occupies this slot
+    s_deferredDirtyBits[slot / kDirtyBitsPerWord].fetch_and(
+            ~(quint64{1} << (slot % kDirtyBitsPerWord)),
+            std::memory_order_relaxed);
+}
+
+bool ControlDoublePrivate::tryDeferValueChanged(QObject* pSender) {
+    const int slot = atomicLoadAcquire(m_deferredPublishingSlot);
+    if (slot < 0 ||
+            pSender == nullptr ||
+            pSender != getCreatorCO() ||
+            !s_deferredPublishingEnabled.load(std::memory_order_acquire)) {
+        return false;
+    }
+    // Lock-free, the value has already been stored
+    s_deferredDirtyBits[slot / kDirtyBitsPerWord].fetch_or(
+            quint64{1} << (slot % kDirtyBitsPerWord),
+            std::memory_order_release);
+    return true;
+}
+
 void ControlDoublePrivate::deleteCreatorCO() {
     delete m_pCreatorCO.fetchAndStoreOrdered(nullptr);
 }
@@ -281,7 +408,9 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
-    emit valueChanged(value, pSender);
+    if (!tryDeferValueChanged(pSender)) {
+        emit valueChanged(value, pSender);
+    }
 
     if (m_bTrack) {
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
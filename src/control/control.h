@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QAtomicInteger>
 #include <QAtomicPointer>
 #include <QHash>
 #include <QObject>
@@ -29,6 +30,20 @@ enum class ControlFlag {
 Q_DECLARE_FLAGS(ControlFlags, ControlFlag)
 Q_DECLARE_OPERATORS_FOR_FLAGS(ControlFlags)
 
+/// Defines when the changes of a control that are written by its creator
+/// are signaled to the other listeners.
+enum class ControlPublishMode {
+    /// valueChanged() is emitted for every change
+    Immediate,
+    /// Changes are only flagged as dirty and a single valueChanged() with
+    /// the latest value is emitted by publishDeferredValueChanges().
+    /// Intended for controls that are written by the engine on every
+    /// callback and are only displayed, e.g. VU meters. Not suitable for
+    /// pulses like beat_active, because changes that are reverted within
+    /// a single GUI tick are never signaled.
+    Deferred,
+};
+
 class ControlDoublePrivate : public QObject {
     Q_OBJECT
   public:
@@ -64,6 +79,16 @@ class ControlDoublePrivate : public QObject {
 
     static QHash<ConfigKey, ConfigKey> getControlAliases();
 
+    // Controls with ControlPublishMode::Deferred keep signaling every change
+    // immediately until deferred publishing has been enabled, i.e. as long
+    // as no one invokes publishDeferredValueChanges() periodically.
+    static void setDeferredPublishingEnabled(bool enabled);
+    static bool isDeferredPublishingEnabled();
+
+    // Emits valueChanged() once for each control with deferred changes.
+    // Must be invoked from the GUI thread.
+    static void publishDeferredValueChanges();
+
     const QString& name() const {
         return m_name;
     }
@@ -88,6 +113,11 @@ class ControlDoublePrivate : public QObject {
         return m_kbdRepeatable;
     }
 
+    // Only changes of the creator CO are deferred. Changes of all other
+    // setters have side effects, e.g. seeking, and are signaled immediately.
+    // Not real-time safe, the mode should be set after creating the control.
+    void setPublishMode(ControlPublishMode mode);
+
     // Sets the control value.
     void set(double value, QObject* pSender);
     // directly sets the control value. Must be used from and only from the
@@ -180,6 +210,10 @@ class ControlDoublePrivate : public QObject {
 
     void initialize(double defaultValue);
     virtual void setInner(double value, QObject* pSender);
+    // Flags the change as dirty instead of emitting valueChanged(). Returns
+    // false if the change must be signaled immediately.
+    bool tryDeferValueChanged(QObject* pSender);
+    void unregisterDeferredPublishing();
 
     const ConfigKey m_key;
 
@@ -200,6 +234,10 @@ class ControlDoublePrivate : public QObject {
     int m_trackFlags;
     bool m_confirmRequired;
 
+    // The slot in the bitmap of dirty controls or -1 if changes are
+    // published immediately.
+    QAtomicInt m_deferredPublishingSlot;
+
     // User-visible, i18n name for what the control is.
     QString m_name;
 
@@ -66,6 +66,14 @@ class ControlObject : public QObject {
         return m_pControl ? m_pControl->getKbdRepeatable() : false;
     }
 
+    // Defers signaling the changes of this ControlObject to the other
+    // listeners until the next GUI tick. See ControlPublishMode.
+    void setPublishMode(ControlPublishMode mode) {
+        if (m_pControl) {
+            m_pControl->setPublishMode(mode);
+        }
+    }
+
     // Return the key of the object
     inline ConfigKey getKey() const {
         return m_key;
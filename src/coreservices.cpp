@@ -15,6 +15,7 @@
 #include "effects/effectsmanager.h"
 #include "engine/enginemaster.h"
 #include "library/coverartcache.h"
+#include "library/coverartdiskcache.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
 #include "library/trackcollection.h"
@@ -27,7 +28,10 @@
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "soundio/soundmanager.h"
+#include "sources/decodedaudiocache.h"
+#include "sources/mp3seekframeindexcache.h"
 #include "sources/soundsourceproxy.h"
+#include "util/audiothreadguard.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
 #include "util/logger.h"
@@ -116,10 +120,14 @@ CoreServices::CoreServices(const CmdlineArgs& args, QApplication* pApp)
     // called after the GUI is initialized
     initializeSettings();
     initializeLogging();
-    // Only record stats in developer mode.
-    if (m_cmdlineArgs.getDeveloper()) {
+    // Only record stats in developer mode or for writing the timeline.
+    if (m_cmdlineArgs.getDeveloper() || m_cmdlineArgs.getTimelineEnabled()) {
         StatsManager::createInstance();
     }
+#ifdef __AUDIO_THREAD_GUARD__
+    // Report all allocations and lock waits on the audio thread
+    mixxx::AudioThreadGuard::setEnabled(true);
+#endif
     mixxx::Translations::initializeTranslations(
             m_pSettingsManager->settings(), pApp, m_cmdlineArgs.getLocale());
     initializeKeyboard();
@@ -135,7 +143,7 @@ CoreServices::~CoreServices() {
     CLEAR_AND_CHECK_DELETED(m_pKbdConfig);
     CLEAR_AND_CHECK_DELETED(m_pKbdConfigEmpty);
 
-    if (m_cmdlineArgs.getDeveloper()) {
+    if (m_cmdlineArgs.getDeveloper() || m_cmdlineArgs.getTimelineEnabled()) {
         StatsManager::destroy();
     }
 
@@ -234,6 +242,10 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    // Must be available before any audio source is opened
+    mixxx::DecodedAudioCache::createInstance(pConfig);
+    mixxx::Mp3SeekFrameIndexCache::createInstance(pConfig);
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -245,8 +257,11 @@ void CoreServices::initialize(QApplication* pApp) {
     if (!m_pDbConnectionPool) {
         exit(-1);
     }
-    // Create a connection for the main thread
+    // Create the connections for the main thread. The library models
+    // query through the read-only connection.
     m_pDbConnectionPool->createThreadLocalConnection();
+    m_pDbConnectionPool->createThreadLocalConnection(
+            mixxx::DbConnection::AccessMode::ReadOnly);
     if (!initializeDatabase()) {
         exit(-1);
     }
@@ -331,6 +346,7 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
+    CoverArtDiskCache::createInstance(pConfig);
     CoverArtCache::createInstance();
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
@@ -587,6 +603,7 @@ void CoreServices::finalize() {
 
     // CoverArtCache is fairly independent of everything else.
     CoverArtCache::destroy();
+    CoverArtDiskCache::destroyInstance();
 
     // PlayerManager depends on Engine, SoundManager, VinylControlManager, and Config
     // The player manager has to be deleted before the library to ensure
@@ -628,7 +645,14 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "detaching all track collections";
     CLEAR_AND_CHECK_DELETED(m_pTrackCollectionManager);
 
+    // All audio sources have been closed when deleting the players
+    // and the library.
+    mixxx::Mp3SeekFrameIndexCache::destroyInstance();
+    mixxx::DecodedAudioCache::destroyInstance();
+
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "closing database connection(s)";
+    m_pDbConnectionPool->destroyThreadLocalConnection(
+            mixxx::DbConnection::AccessMode::ReadOnly);
     m_pDbConnectionPool->destroyThreadLocalConnection();
     m_pDbConnectionPool.reset(); // should drop the last reference
 
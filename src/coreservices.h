@@ -55,6 +55,10 @@ class CoreServices : public QObject {
         return m_pControlIndicatorTimer;
     }
 
+    std::shared_ptr<EngineMaster> getEngineMaster() const {
+        return m_pEngine;
+    }
+
     std::shared_ptr<SoundManager> getSoundManager() const {
         return m_pSoundManager;
     }
@@ -30,6 +30,40 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+const QString kConfigGroup = QStringLiteral("[Database]");
+const ConfigKey kJournalModeConfigKey(kConfigGroup, QStringLiteral("JournalMode"));
+const ConfigKey kSynchronousConfigKey(kConfigGroup, QStringLiteral("Synchronous"));
+const ConfigKey kCacheSizeKiBConfigKey(kConfigGroup, QStringLiteral("CacheSizeKiB"));
+const ConfigKey kMmapSizeMiBConfigKey(kConfigGroup, QStringLiteral("MmapSizeMiB"));
+const ConfigKey kBusyTimeoutMillisConfigKey(kConfigGroup, QStringLiteral("BusyTimeoutMillis"));
+
+// The GUI keeps reading from the library while the scanner, the
+// analyzer, and the track cache are writing to it
+const QString kJournalModeDefault = QStringLiteral("WAL");
+// Durable in WAL mode, the last transactions might only be lost
+// on power failure
+const QString kSynchronousDefault = QStringLiteral("NORMAL");
+constexpr int kCacheSizeKiBDefault = 16 * 1024;
+constexpr int kMmapSizeMiBDefault = 256;
+constexpr int kBusyTimeoutMillisDefault = 5000;
+
+mixxx::DbConnection::Tuning dbConnectionTuning(
+        const UserSettingsPointer& pConfig,
+        bool inMemoryConnection) {
+    mixxx::DbConnection::Tuning tuning;
+    if (!inMemoryConnection) {
+        tuning.journalMode = pConfig->getValue(kJournalModeConfigKey, kJournalModeDefault);
+        const int mmapSizeMiB = pConfig->getValue(
+                kMmapSizeMiBConfigKey, kMmapSizeMiBDefault);
+        tuning.mmapSizeBytes = static_cast<qint64>(mmapSizeMiB) * 1024 * 1024;
+    }
+    tuning.synchronous = pConfig->getValue(kSynchronousConfigKey, kSynchronousDefault);
+    tuning.cacheSizeKiB = pConfig->getValue(kCacheSizeKiBConfigKey, kCacheSizeKiBDefault);
+    tuning.busyTimeoutMillis = pConfig->getValue(
+            kBusyTimeoutMillisConfigKey, kBusyTimeoutMillisDefault);
+    return tuning;
+}
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -58,6 +92,7 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    params.tuning = dbConnectionTuning(pConfig, inMemoryConnection);
     return params;
 }
 
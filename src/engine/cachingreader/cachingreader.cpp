@@ -4,13 +4,14 @@
 #include <QtDebug>
 
 #include "control/controlobject.h"
+#include "mixer/playermanager.h"
 #include "moc_cachingreader.cpp"
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
-#include "util/counter.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/physicalmemory.h"
 #include "util/sample.h"
 
 namespace {
@@ -23,9 +24,9 @@ mixxx::Logger kLogger("CachingReader");
 constexpr SINT kDefaultHintFrames = 1024;
 
 // With CachingReaderChunk::kFrames = 8192 each chunk consumes
-// 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB.
+// 8192 frames * 2 channels/frame * 4-bytes per sample = 64 KiB.
 //
-//     80 chunks ->  5120 KB =  5 MB
+//     80 chunks ->  5120 KiB =  5 MiB
 //
 // Each deck (including sample decks) will use their own CachingReader.
 // Consequently the total memory required for all allocated chunks depends
@@ -33,17 +34,117 @@ constexpr SINT kDefaultHintFrames = 1024;
 // CachingReader must be multiplied by the number of decks to calculate
 // the total amount!
 //
+// This is the default for all sampler and preview decks. Decks scale the
+// number of chunks with the size of the physical memory (see below) and
+// the user may override it for all or individual decks.
+//
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
 // (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
 constexpr SINT kNumberOfCachedChunksInMemory = 80;
 
+// Decks reserve 1/512 of the physical memory, i.e. 16 MiB or about 47 s
+// of 44.1 kHz audio per deck with 8 GiB. Capped at 1024 chunks = 64 MiB
+// or about 3 min 10 s.
+constexpr quint64 kPhysicalMemoryPerDeckDivisor = 512;
+constexpr SINT kMaxNumberOfCachedChunksPerDeck = 1024;
+
+// Whatever the user configures, a single CachingReader never uses more
+// than 1/32 of the physical memory.
+constexpr quint64 kPhysicalMemoryPerReaderCeilingDivisor = 32;
+
+// The chunk pool size in MiB for all CachingReaders (0 = automatic)
+const ConfigKey kConfigKeyMemoryMiB = ConfigKey(
+        QStringLiteral("[CachingReader]"),
+        QStringLiteral("MemoryMiB"));
+// Overrides kConfigKeyMemoryMiB for a single deck, i.e. in the group of
+// the deck, e.g. [Channel1],cachingreader_memory_mib
+const QString kConfigItemDeckMemoryMiB = QStringLiteral("cachingreader_memory_mib");
+
+// Decode whole tracks of decks and samplers and optionally keep them in
+// memory mapped temporary files instead of the heap
+const ConfigKey kConfigKeyResidentTracks = ConfigKey(
+        QStringLiteral("[CachingReader]"),
+        QStringLiteral("ResidentTracks"));
+const ConfigKey kConfigKeyResidentTracksMemoryMapped = ConfigKey(
+        QStringLiteral("[CachingReader]"),
+        QStringLiteral("ResidentTracksMemoryMapped"));
+
+std::unique_ptr<CachingReaderResidentTrackSlot> createResidentTrackSlot(
+        const QString& group,
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig || !pConfig->getValue(kConfigKeyResidentTracks, false)) {
+        return nullptr;
+    }
+    if (!PlayerManager::isDeckGroup(group) && !PlayerManager::isSamplerGroup(group)) {
+        return nullptr;
+    }
+    return std::make_unique<CachingReaderResidentTrackSlot>();
+}
+
+SINT chunksForBytes(quint64 bytes) {
+    return static_cast<SINT>(bytes / (CachingReaderChunk::kSamples * sizeof(CSAMPLE)));
+}
+
 } // anonymous namespace
 
+// static
+SINT CachingReader::numberOfCachedChunks(
+        const QString& group,
+        const UserSettingsPointer& pConfig) {
+    const quint64 physicalMemoryBytes = mixxx::PhysicalMemory::totalBytes();
+    SINT numberOfChunks = 0;
+    if (pConfig) {
+        int memoryMiB = pConfig->getValue(
+                ConfigKey(group, kConfigItemDeckMemoryMiB), 0);
+        if (memoryMiB <= 0) {
+            memoryMiB = pConfig->getValue(kConfigKeyMemoryMiB, 0);
+        }
+        if (memoryMiB > 0) {
+            numberOfChunks = math_max(chunksForBytes(static_cast<quint64>(memoryMiB) << 20), SINT(1));
+        }
+    }
+    if (numberOfChunks <= 0) {
+        numberOfChunks = kNumberOfCachedChunksInMemory;
+        if (PlayerManager::isDeckGroup(group)) {
+            numberOfChunks = math_clamp(
+                    chunksForBytes(physicalMemoryBytes / kPhysicalMemoryPerDeckDivisor),
+                    kNumberOfCachedChunksInMemory,
+                    kMaxNumberOfCachedChunksPerDeck);
+        }
+    }
+    if (physicalMemoryBytes > 0) {
+        const auto maxNumberOfChunks = math_max(
+                chunksForBytes(physicalMemoryBytes / kPhysicalMemoryPerReaderCeilingDivisor),
+                kNumberOfCachedChunksInMemory);
+        if (numberOfChunks > maxNumberOfChunks) {
+            kLogger.warning()
+                    << "Limiting the number of cached chunks for"
+                    << group
+                    << "from"
+                    << numberOfChunks
+                    << "to"
+                    << maxNumberOfChunks;
+            numberOfChunks = maxNumberOfChunks;
+        }
+    }
+    return numberOfChunks;
+}
+
 CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config)
         : m_pConfig(config),
+          m_numberOfCachedChunks(numberOfCachedChunks(group, config)),
+          // Hints of jump targets cover more than a single engine buffer
+          // if the pool is larger than the default, up to a whole chunk.
+          // This avoids cache misses after jumping with large buffers or
+          // high rates while scratching.
+          m_defaultHintFrames(math_min(
+                  kDefaultHintFrames * math_max(m_numberOfCachedChunks /
+                                  kNumberOfCachedChunksInMemory,
+                          SINT(1)),
+                  CachingReaderChunk::kFrames)),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
@@ -53,21 +154,33 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
+          m_chunkReadRequestFIFO(math_max(m_numberOfCachedChunks / 4, SINT(1))),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(m_numberOfCachedChunks),
           m_state(STATE_IDLE),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+          m_sampleBuffer(CachingReaderChunk::kSamples * m_numberOfCachedChunks),
+          m_stats(group),
+          m_pResidentTrackSlot(createResidentTrackSlot(group, config)),
+          m_worker(group,
+                  &m_chunkReadRequestFIFO,
+                  &m_readerStatusUpdateFIFO,
+                  &m_stats,
+                  m_pResidentTrackSlot.get(),
+                  config && config->getValue(kConfigKeyResidentTracksMemoryMapped, false)) {
+    kLogger.debug()
+            << "Caching"
+            << m_numberOfCachedChunks
+            << "chunks for"
+            << group;
+    m_allocatedCachingReaderChunks.reserve(m_numberOfCachedChunks);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
+    for (SINT i = 0; i < m_numberOfCachedChunks; ++i) {
         CachingReaderChunkForOwner* c =
                 new CachingReaderChunkForOwner(
                         mixxx::SampleBuffer::WritableSlice(
@@ -166,6 +279,21 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     return pChunk;
 }
 
+bool CachingReader::readResidentSampleFrames(
+        const mixxx::IndexRange& frameIndexRange,
+        bool reverse,
+        CSAMPLE* buffer) {
+    if (!m_pResidentTrackSlot) {
+        return false;
+    }
+    if (!frameIndexRange.isSubrangeOf(m_readableFrameIndexRange)) {
+        return false;
+    }
+    const auto pResidentTrack = m_pResidentTrackSlot->lockForReading();
+    return pResidentTrack &&
+            pResidentTrack->readSampleFrames(buffer, frameIndexRange, reverse);
+}
+
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
     // Defaults to nullptr if it's not in the hash.
     auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
@@ -387,6 +515,20 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
             result = ReadResult::PARTIALLY_AVAILABLE;
         }
 
+        // Copy all samples at once if the whole track is decoded in
+        // the background and has already passed the requested frames.
+        if (!remainingFrameIndexRange.empty() &&
+                readResidentSampleFrames(remainingFrameIndexRange, reverse, buffer)) {
+            const SINT residentSamples =
+                    CachingReaderChunk::frames2samples(remainingFrameIndexRange.length());
+            DEBUG_ASSERT(residentSamples == samplesRemaining);
+            if (!reverse) {
+                buffer += residentSamples;
+            }
+            samplesRemaining -= residentSamples;
+            remainingFrameIndexRange.shrinkFront(remainingFrameIndexRange.length());
+        }
+
         // Read the actual samples from the audio source into the
         // buffer. The buffer will be filled with silence for every
         // unreadable sample or samples outside of the track region
@@ -453,7 +595,6 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -470,6 +611,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                         // the first required chunk. Inform the calling code that no
                         // data has been written into the buffer and to handle this
                         // situation appropriately.
+                        m_stats.countReadUnavailable();
                         return ReadResult::UNAVAILABLE;
                     }
                     // No more readable data available. Exit the loop and
@@ -516,6 +658,11 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
         SampleUtil::clear(buffer, samplesRemaining);
         result = ReadResult::PARTIALLY_AVAILABLE;
     }
+    if (result == ReadResult::AVAILABLE) {
+        m_stats.countReadAvailable();
+    } else {
+        m_stats.countReadPartiallyAvailable();
+    }
     return result;
 }
 
@@ -529,18 +676,37 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // any are not, then wake.
     bool shouldWake = false;
 
+    // Hints for frames that have already been decoded into the resident
+    // track are ignored, they don't need any chunks.
+    mixxx::IndexRange residentFrameIndexRange;
+    if (m_pResidentTrackSlot) {
+        const auto pResidentTrack = m_pResidentTrackSlot->lockForReading();
+        if (pResidentTrack) {
+            residentFrameIndexRange = pResidentTrack->decodedFrameIndexRange();
+        }
+    }
+
+    // The hints are ordered by priority, starting with the current position.
+    // If they span more chunks than we have, allocating the chunks for the
+    // last hints would expire the chunks of the first ones, which would then
+    // be requested again with the next callback. Stop before that happens.
+    // Chunks that are hinted more than once are counted multiple times,
+    // which only ever stops early. The first hint is always processed.
+    SINT remainingChunks = m_numberOfCachedChunks;
+    bool firstHint = true;
+
     for (const auto& hint: hintList) {
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
 
         // Handle some special length values
         if (hintFrameCount == Hint::kFrameCountForward) {
-        	hintFrameCount = kDefaultHintFrames;
+            hintFrameCount = m_defaultHintFrames;
         } else if (hintFrameCount == Hint::kFrameCountBackward) {
-        	hintFrame -= kDefaultHintFrames;
-        	hintFrameCount = kDefaultHintFrames;
+            hintFrame -= m_defaultHintFrames;
+            hintFrameCount = m_defaultHintFrames;
             if (hintFrame < 0) {
-            	hintFrameCount += hintFrame;
+                hintFrameCount += hintFrame;
                 if (hintFrameCount <= 0) {
                     continue;
                 }
@@ -556,12 +722,19 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         const auto readableFrameIndexRange = intersect(
                 m_readableFrameIndexRange,
                 mixxx::IndexRange::forward(hintFrame, hintFrameCount));
-        if (readableFrameIndexRange.empty()) {
+        if (readableFrameIndexRange.empty() ||
+                readableFrameIndexRange.isSubrangeOf(residentFrameIndexRange)) {
             continue;
         }
 
         const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
         const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+        remainingChunks -= lastChunkIndex - firstChunkIndex + 1;
+        if (remainingChunks < 0 && !firstHint) {
+            m_stats.countHintChunkPoolExhausted();
+            break;
+        }
+        firstHint = false;
         for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
@@ -583,7 +756,11 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "Requesting read of chunk"
                             << request.chunk;
                 }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                if (m_chunkReadRequestFIFO.write(&request, 1) == 1) {
+                    // The worker might already have answered the request,
+                    // the count only needs to be balanced between callbacks
+                    m_worker.addPendingRequest();
+                } else {
                     kLogger.warning()
                             << "Failed to submit read request for chunk"
                             << chunkIndex;
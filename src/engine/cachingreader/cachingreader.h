@@ -7,6 +7,7 @@
 #include <QVector>
 #include <list>
 
+#include "engine/cachingreader/cachingreaderresidenttrack.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "engine/engineworker.h"
 #include "preferences/usersettings.h"
@@ -29,7 +30,10 @@ typedef struct Hint {
         FirstSound,
         IntroStart,
         IntroEnd,
-        OutroStart
+        OutroStart,
+        OutroEnd,
+        LoopEnd,
+        HotCueEnd
     };
 
     // The frame to ensure is present in memory.
@@ -77,6 +81,14 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// The number of chunks is fixed for the lifetime of a CachingReader. It is
+// read from the user settings or, for decks, chosen according to the size of
+// the physical memory (see numberOfCachedChunks).
+//
+// Optionally decks and samplers decode the whole track in the background
+// (see CachingReaderResidentTrack). Frames that have already been decoded
+// are copied from there, all others are still read from the chunks.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -118,6 +130,32 @@ class CachingReader : public QObject {
         m_worker.setScheduler(pScheduler);
     }
 
+    SINT numberOfCachedChunks() const {
+        return m_numberOfCachedChunks;
+    }
+
+    // The number of chunks a CachingReader for group is created with.
+    static SINT numberOfCachedChunks(
+            const QString& group,
+            const UserSettingsPointer& pConfig);
+
+    // Statistics about the cache that are counted on the engine thread
+    // and may be read from any thread.
+    int readAvailableCount() const {
+        return m_stats.readAvailableCount();
+    }
+    int readPartiallyAvailableCount() const {
+        return m_stats.readPartiallyAvailableCount();
+    }
+    int readUnavailableCount() const {
+        return m_stats.readUnavailableCount();
+    }
+    // The number of calls of hintAndMaybeWake() that skipped hints,
+    // because they spanned more chunks than the pool holds.
+    int hintChunkPoolExhaustedCount() const {
+        return m_stats.hintChunkPoolExhaustedCount();
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -127,6 +165,14 @@ class CachingReader : public QObject {
   private:
     const UserSettingsPointer m_pConfig;
 
+    // The size of the chunk pool. Must be initialized before the FIFOs
+    // and the sample buffer.
+    const SINT m_numberOfCachedChunks;
+
+    // The number of frames requested by hints with the default frame
+    // count, i.e. for jump targets like cues and loop boundaries.
+    const SINT m_defaultHintFrames;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
@@ -157,6 +203,13 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Copies all frames of frameIndexRange from the resident track into
+    // buffer if they have already been decoded, otherwise returns false.
+    bool readResidentSampleFrames(
+            const mixxx::IndexRange& frameIndexRange,
+            bool reverse,
+            CSAMPLE* buffer);
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -186,5 +239,12 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // Reporting to the StatsManager allocates memory, so this is left
+    // to the worker.
+    CachingReaderStats m_stats;
+
+    // Only allocated if whole tracks are decoded
+    const std::unique_ptr<CachingReaderResidentTrackSlot> m_pResidentTrackSlot;
+
     CachingReaderWorker m_worker;
 };
@@ -0,0 +1,156 @@
+#include "engine/cachingreader/cachingreaderresidenttrack.h"
+
+#include <QDir>
+#include <QThread>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderResidentTrack");
+
+} // anonymous namespace
+
+// static
+std::unique_ptr<CachingReaderResidentTrack> CachingReaderResidentTrack::allocate(
+        mixxx::IndexRange frameIndexRange,
+        bool memoryMapped) {
+    VERIFY_OR_DEBUG_ASSERT(!frameIndexRange.empty()) {
+        return nullptr;
+    }
+    const SINT numSamples = CachingReaderChunk::frames2samples(frameIndexRange.length());
+    if (memoryMapped) {
+        auto pFile = std::make_unique<QTemporaryFile>(
+                QDir::tempPath() + QStringLiteral("/mixxx-resident-track-XXXXXX"));
+        const qint64 fileSize = static_cast<qint64>(numSamples) * sizeof(CSAMPLE);
+        if (pFile->open() && pFile->resize(fileSize)) {
+            uchar* pMapped = pFile->map(0, fileSize);
+            if (pMapped) {
+                return std::unique_ptr<CachingReaderResidentTrack>(
+                        new CachingReaderResidentTrack(
+                                frameIndexRange,
+                                std::move(pFile),
+                                reinterpret_cast<CSAMPLE*>(pMapped)));
+            }
+        }
+        kLogger.warning()
+                << "Failed to map a temporary file of"
+                << fileSize
+                << "bytes:"
+                << pFile->errorString();
+        return nullptr;
+    }
+    mixxx::SampleBuffer sampleBuffer(numSamples);
+    if (!sampleBuffer.data()) {
+        kLogger.warning()
+                << "Failed to allocate"
+                << numSamples
+                << "samples";
+        return nullptr;
+    }
+    return std::unique_ptr<CachingReaderResidentTrack>(
+            new CachingReaderResidentTrack(
+                    frameIndexRange,
+                    std::move(sampleBuffer)));
+}
+
+CachingReaderResidentTrack::CachingReaderResidentTrack(
+        mixxx::IndexRange frameIndexRange,
+        mixxx::SampleBuffer sampleBuffer)
+        : m_frameIndexRange(frameIndexRange),
+          m_sampleBuffer(std::move(sampleBuffer)),
+          m_pSamples(m_sampleBuffer.data()),
+          m_decodedFrameIndexStart(frameIndexRange.end()),
+          m_decodedFrameIndexEnd(frameIndexRange.start()) {
+}
+
+CachingReaderResidentTrack::CachingReaderResidentTrack(
+        mixxx::IndexRange frameIndexRange,
+        std::unique_ptr<QTemporaryFile> pMappedFile,
+        CSAMPLE* pMappedSamples)
+        : m_frameIndexRange(frameIndexRange),
+          m_pMappedFile(std::move(pMappedFile)),
+          m_pSamples(pMappedSamples),
+          m_decodedFrameIndexStart(frameIndexRange.end()),
+          m_decodedFrameIndexEnd(frameIndexRange.start()) {
+}
+
+const CSAMPLE* CachingReaderResidentTrack::samples(SINT frameIndex) const {
+    DEBUG_ASSERT(frameIndex >= m_frameIndexRange.start());
+    DEBUG_ASSERT(frameIndex <= m_frameIndexRange.end());
+    return m_pSamples +
+            CachingReaderChunk::frames2samples(frameIndex - m_frameIndexRange.start());
+}
+
+bool CachingReaderResidentTrack::readSampleFrames(
+        CSAMPLE* pBuffer,
+        mixxx::IndexRange frameIndexRange,
+        bool reverse) const {
+    DEBUG_ASSERT(frameIndexRange.orientation() != mixxx::IndexRange::Orientation::Backward);
+    if (!frameIndexRange.isSubrangeOf(decodedFrameIndexRange())) {
+        return false;
+    }
+    const SINT numSamples = CachingReaderChunk::frames2samples(frameIndexRange.length());
+    if (reverse) {
+        SampleUtil::copyReverse(pBuffer, samples(frameIndexRange.start()), numSamples);
+    } else {
+        SampleUtil::copy(pBuffer, samples(frameIndexRange.start()), numSamples);
+    }
+    return true;
+}
+
+mixxx::SampleBuffer::WritableSlice CachingReaderResidentTrack::writableSlice(
+        mixxx::IndexRange frameIndexRange) {
+    DEBUG_ASSERT(frameIndexRange.isSubrangeOf(m_frameIndexRange));
+    return mixxx::SampleBuffer::WritableSlice(
+            const_cast<CSAMPLE*>(samples(frameIndexRange.start())),
+            CachingReaderChunk::frames2samples(frameIndexRange.length()));
+}
+
+void CachingReaderResidentTrack::extendDecodedFrameIndexRange(
+        mixxx::IndexRange frameIndexRange) {
+    DEBUG_ASSERT(frameIndexRange.isSubrangeOf(m_frameIndexRange));
+    const auto decodedFrameIndexRange = this->decodedFrameIndexRange();
+    if (decodedFrameIndexRange.empty()) {
+        // The first decoded range, which may start anywhere. Both bounds
+        // are initialized to the opposite end of the track and only move
+        // towards the other one, so any combination of old and new values
+        // that readers might load is either empty or valid.
+        m_decodedFrameIndexEnd.store(
+                frameIndexRange.end(), std::memory_order_release);
+        m_decodedFrameIndexStart.store(
+                frameIndexRange.start(), std::memory_order_release);
+    } else if (frameIndexRange.start() == decodedFrameIndexRange.end()) {
+        m_decodedFrameIndexEnd.store(
+                frameIndexRange.end(), std::memory_order_release);
+    } else {
+        VERIFY_OR_DEBUG_ASSERT(frameIndexRange.end() == decodedFrameIndexRange.start()) {
+            return;
+        }
+        m_decodedFrameIndexStart.store(
+                frameIndexRange.start(), std::memory_order_release);
+    }
+}
+
+CachingReaderResidentTrackSlot::CachingReaderResidentTrackSlot()
+        : m_pPublishedTrack(nullptr),
+          m_readers(0) {
+}
+
+CachingReaderResidentTrackSlot::~CachingReaderResidentTrackSlot() {
+    reset();
+}
+
+void CachingReaderResidentTrackSlot::reset(
+        std::unique_ptr<CachingReaderResidentTrack> pTrack) {
+    m_pPublishedTrack.store(pTrack.get());
+    // Readers that have not yet loaded the pointer will see the new one.
+    // Wait for all others before deleting the previous track.
+    while (m_readers.load() > 0) {
+        QThread::yieldCurrentThread();
+    }
+    m_pTrack = std::move(pTrack);
+}
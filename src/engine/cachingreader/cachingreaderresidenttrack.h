@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QTemporaryFile>
+#include <atomic>
+#include <memory>
+
+#include "util/indexrange.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+// The decoded samples of a whole track in a single, contiguous buffer.
+//
+// The buffer is allocated when the track is loaded. The CachingReaderWorker
+// decodes the track into it in the background, starting at the position
+// that is requested first and extending the decoded range in both
+// directions. The CachingReader copies all frames from the buffer that
+// are already decoded instead of looking up chunks.
+//
+// The decoded frame index range is only ever extended and published with
+// release/acquire semantics. Readers may access all frames within a range
+// they have obtained from decodedFrameIndexRange() without any further
+// synchronization.
+class CachingReaderResidentTrack {
+  public:
+    // Allocates a buffer for all frames of frameIndexRange. If memoryMapped
+    // is true the buffer is backed by a temporary file instead of the heap,
+    // so the operating system may page it out. Returns nullptr if the
+    // memory could not be allocated.
+    static std::unique_ptr<CachingReaderResidentTrack> allocate(
+            mixxx::IndexRange frameIndexRange,
+            bool memoryMapped);
+
+    CachingReaderResidentTrack(const CachingReaderResidentTrack&) = delete;
+    CachingReaderResidentTrack(CachingReaderResidentTrack&&) = delete;
+
+    const mixxx::IndexRange& frameIndexRange() const {
+        return m_frameIndexRange;
+    }
+
+    // The range of frames that are ready for reading. Thread-safe.
+    mixxx::IndexRange decodedFrameIndexRange() const {
+        // The start is only ever decreased and the end only ever increased.
+        // Loading both values separately still yields a range that is
+        // completely decoded, or an empty one.
+        const SINT start = m_decodedFrameIndexStart.load(std::memory_order_acquire);
+        const SINT end = m_decodedFrameIndexEnd.load(std::memory_order_acquire);
+        return mixxx::IndexRange::between(start, math_max(start, end));
+    }
+
+    // Copies the frames of frameIndexRange into pBuffer, optionally in
+    // reverse order. Does nothing and returns false if not all frames
+    // have been decoded yet.
+    bool readSampleFrames(
+            CSAMPLE* pBuffer,
+            mixxx::IndexRange frameIndexRange,
+            bool reverse) const;
+
+    // The buffer for decoding the frames of frameIndexRange. Must only be
+    // used by the decoding thread.
+    mixxx::SampleBuffer::WritableSlice writableSlice(
+            mixxx::IndexRange frameIndexRange);
+
+    // Publishes the frames of frameIndexRange after they have been
+    // decoded. The range must adjoin the decoded range. Must only be
+    // called by the decoding thread.
+    void extendDecodedFrameIndexRange(
+            mixxx::IndexRange frameIndexRange);
+
+  private:
+    CachingReaderResidentTrack(
+            mixxx::IndexRange frameIndexRange,
+            mixxx::SampleBuffer sampleBuffer);
+    CachingReaderResidentTrack(
+            mixxx::IndexRange frameIndexRange,
+            std::unique_ptr<QTemporaryFile> pMappedFile,
+            CSAMPLE* pMappedSamples);
+
+    const CSAMPLE* samples(SINT frameIndex) const;
+
+    const mixxx::IndexRange m_frameIndexRange;
+
+    // Either the heap buffer or the memory mapped file is used.
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::unique_ptr<QTemporaryFile> m_pMappedFile;
+    CSAMPLE* const m_pSamples;
+
+    std::atomic<SINT> m_decodedFrameIndexStart;
+    std::atomic<SINT> m_decodedFrameIndexEnd;
+};
+
+// Hands over the CachingReaderResidentTrack from the CachingReaderWorker to
+// the engine thread without locking the engine thread.
+//
+// The engine thread only accesses the track while holding a ReadLock, that
+// merely increments an atomic counter. When replacing the track the worker
+// waits until no ReadLock refers to the previous one before deleting it.
+// ReadLocks are only held for the duration of a single read() or
+// hintAndMaybeWake() call, so the worker never waits for long.
+class CachingReaderResidentTrackSlot {
+  public:
+    class ReadLock {
+      public:
+        explicit ReadLock(CachingReaderResidentTrackSlot* pSlot)
+                : m_pSlot(pSlot) {
+            // Sequentially consistent ordering is required: The worker must
+            // either see the incremented counter or we must see the pointer
+            // it has exchanged.
+            m_pSlot->m_readers.fetch_add(1);
+            m_pTrack = m_pSlot->m_pPublishedTrack.load();
+        }
+        ReadLock(const ReadLock&) = delete;
+        ReadLock(ReadLock&&) = delete;
+        ~ReadLock() {
+            m_pSlot->m_readers.fetch_sub(1);
+        }
+
+        const CachingReaderResidentTrack* get() const {
+            return m_pTrack;
+        }
+        const CachingReaderResidentTrack* operator->() const {
+            return m_pTrack;
+        }
+        explicit operator bool() const {
+            return m_pTrack != nullptr;
+        }
+
+      private:
+        CachingReaderResidentTrackSlot* const m_pSlot;
+        const CachingReaderResidentTrack* m_pTrack;
+    };
+
+    CachingReaderResidentTrackSlot();
+    ~CachingReaderResidentTrackSlot();
+
+    // Engine thread
+    ReadLock lockForReading() {
+        return ReadLock(this);
+    }
+
+    // Worker thread: The current track for decoding, if any.
+    CachingReaderResidentTrack* get() const {
+        return m_pTrack.get();
+    }
+
+    // Worker thread: Replaces the current track and deletes the previous
+    // one as soon as no reader refers to it anymore.
+    void reset(std::unique_ptr<CachingReaderResidentTrack> pTrack = nullptr);
+
+  private:
+    std::unique_ptr<CachingReaderResidentTrack> m_pTrack;
+    std::atomic<const CachingReaderResidentTrack*> m_pPublishedTrack;
+    std::atomic<int> m_readers;
+};
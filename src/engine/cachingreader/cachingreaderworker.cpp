@@ -2,17 +2,21 @@
 
 #include <QAtomicInt>
 #include <QFileInfo>
+#include <QWaitCondition>
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
 #include "control/controlobject.h"
 #include "moc_cachingreaderworker.cpp"
+#include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
+#include "util/compatibility/qatomic.h"
 #include "util/compatibility/qmutex.h"
-#include "util/event.h"
 #include "util/logger.h"
+#include "util/physicalmemory.h"
 #include "util/span.h"
+#include "util/timer.h"
 
 namespace {
 
@@ -21,20 +25,99 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// A single resident track must not occupy more than 1/8 of the physical
+// memory, i.e. about 1 h 15 min of 44.1 kHz audio with 32 GiB.
+constexpr quint64 kPhysicalMemoryPerResidentTrackDivisor = 8;
+
+// Read requests and track loads of all workers that are not answered yet
+QAtomicInt s_pendingRequests;
+QMutex s_pendingRequestsMutex;
+QWaitCondition s_pendingRequestsAnswered;
+
+void releasePendingRequests(int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (s_pendingRequests.fetchAndSubOrdered(count) == count) {
+        const auto locker = lockMutex(&s_pendingRequestsMutex);
+        s_pendingRequestsAnswered.wakeAll();
+    }
+}
+
 } // anonymous namespace
 
+CachingReaderStats::CachingReaderStats(const QString& group)
+        : m_readAvailable(
+                  QStringLiteral("CachingReader::read() %1: cache hit").arg(group)),
+          m_readPartiallyAvailable(
+                  QStringLiteral("CachingReader::read() %1: partially available")
+                          .arg(group)),
+          m_readUnavailable(
+                  QStringLiteral("CachingReader::read() %1: cache miss").arg(group)),
+          m_hintChunkPoolExhausted(
+                  QStringLiteral("CachingReader::hintAndMaybeWake() %1: "
+                                 "Chunk pool exhausted")
+                          .arg(group)) {
+}
+
+void CachingReaderStats::report() {
+    m_readAvailable.report();
+    m_readPartiallyAvailable.report();
+    m_readUnavailable.report();
+    m_hintChunkPoolExhausted.report();
+}
+
+void CachingReaderStats::Statistic::report() {
+    const int count = value();
+    if (count != m_reported) {
+        m_counter.increment(count - m_reported);
+        m_reported = count;
+    }
+}
+
+void CachingReaderWorker::addPendingRequest() {
+    m_pendingRequests.ref();
+    s_pendingRequests.ref();
+}
+
+void CachingReaderWorker::removePendingRequest() {
+    m_pendingRequests.deref();
+    releasePendingRequests(1);
+}
+
+// static
+bool CachingReaderWorker::waitForPendingRequests(mixxx::Duration timeout) {
+    const auto locker = lockMutex(&s_pendingRequestsMutex);
+    while (atomicLoadAcquire(s_pendingRequests) > 0) {
+        if (!s_pendingRequestsAnswered.wait(&s_pendingRequestsMutex,
+                    static_cast<unsigned long>(timeout.toIntegerMillis()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
+        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+        CachingReaderStats* pStats,
+        CachingReaderResidentTrackSlot* pResidentTrackSlot,
+        bool residentTrackMemoryMapped)
         : m_group(group),
-          m_tag(QString("CachingReaderWorker %1").arg(m_group)),
+          m_traceTag(mixxx::TraceTag::intern(
+                  QStringLiteral("CachingReaderWorker %1").arg(m_group))),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_pStats(pStats),
+          m_pResidentTrackSlot(pResidentTrackSlot),
+          m_residentTrackMemoryMapped(residentTrackMemoryMapped),
+          m_residentTrackDecodeBackward(false) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         const CachingReaderChunkReadRequest& request) {
+    ScopedTimer t("CachingReaderWorker::processReadRequest");
     CachingReaderChunk* pChunk = request.chunk;
     DEBUG_ASSERT(pChunk);
 
@@ -95,7 +178,11 @@ void CachingReaderWorker::newTrack(TrackPointer pTrack) {
     {
         const auto locker = lockMutex(&m_newTrackMutex);
         m_pNewTrack = pTrack;
-        m_newTrackAvailable.storeRelease(1);
+        if (!m_newTrackAvailable.fetchAndStoreRelease(1)) {
+            // Replacing a track that has not been loaded yet
+            // still results in a single load
+            addPendingRequest();
+        }
     }
     workReady();
 }
@@ -107,7 +194,7 @@ void CachingReaderWorker::run() {
     QThread::currentThread()->setObjectName(
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
 
-    Event::start(m_tag);
+    mixxx::Tracing::begin(m_traceTag);
     while (!m_stop.loadAcquire()) {
         // Request is initialized by reading from FIFO
         CachingReaderChunkReadRequest request;
@@ -126,14 +213,24 @@ void CachingReaderWorker::run() {
                 // here, the engine is already stopped
                 unloadTrack();
             }
+            removePendingRequest();
         } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+            if (!m_residentTrackStartFrame && m_pAudioSource) {
+                m_residentTrackStartFrame =
+                        request.chunk->frameIndexRange(m_pAudioSource).start();
+            }
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+            removePendingRequest();
+        } else if (decodeResidentTrack()) {
+            // Requests of the engine take precedence, so only a single
+            // chunk of the resident track is decoded at once.
         } else {
-            Event::end(m_tag);
+            m_pStats->report();
+            mixxx::Tracing::end(m_traceTag);
             m_semaRun.acquire();
-            Event::start(m_tag);
+            mixxx::Tracing::begin(m_traceTag);
         }
     }
 }
@@ -143,12 +240,19 @@ void CachingReaderWorker::discardAllPendingRequests() {
     while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
         const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
         m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        removePendingRequest();
     }
 }
 
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    if (m_pResidentTrackSlot) {
+        m_pResidentTrackSlot->reset();
+    }
+    m_residentTrackStartFrame.reset();
+    m_residentTrackDecodableFrameIndexRange = mixxx::IndexRange();
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -228,6 +332,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    allocateResidentTrack();
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
                     m_pAudioSource->frameIndexRange());
@@ -256,10 +362,131 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             sampleCount);
 }
 
+void CachingReaderWorker::allocateResidentTrack() {
+    if (!m_pResidentTrackSlot) {
+        return;
+    }
+    DEBUG_ASSERT(!m_pResidentTrackSlot->get());
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    const quint64 residentTrackBytes =
+            static_cast<quint64>(CachingReaderChunk::frames2samples(
+                    frameIndexRange.length())) *
+            sizeof(CSAMPLE);
+    const quint64 physicalMemoryBytes = mixxx::PhysicalMemory::totalBytes();
+    if (physicalMemoryBytes > 0 &&
+            residentTrackBytes > physicalMemoryBytes / kPhysicalMemoryPerResidentTrackDivisor) {
+        kLogger.info()
+                << m_group
+                << "Not decoding the whole track, it would occupy"
+                << residentTrackBytes
+                << "bytes";
+        return;
+    }
+    auto pResidentTrack = CachingReaderResidentTrack::allocate(
+            frameIndexRange, m_residentTrackMemoryMapped);
+    if (!pResidentTrack) {
+        return;
+    }
+    m_pResidentTrackSlot->reset(std::move(pResidentTrack));
+    m_residentTrackDecodableFrameIndexRange = frameIndexRange;
+    m_residentTrackDecodeBackward = false;
+}
+
+bool CachingReaderWorker::decodeResidentTrack() {
+    if (!m_pResidentTrackSlot || !m_residentTrackStartFrame || !m_pAudioSource) {
+        return false;
+    }
+    CachingReaderResidentTrack* const pResidentTrack = m_pResidentTrackSlot->get();
+    if (!pResidentTrack) {
+        return false;
+    }
+    // The readable range of the audio source shrinks if decoding fails
+    const auto decodableFrameIndexRange = intersect(
+            m_residentTrackDecodableFrameIndexRange,
+            m_pAudioSource->frameIndexRange());
+    if (decodableFrameIndexRange.empty()) {
+        return false;
+    }
+    const auto decodedFrameIndexRange = pResidentTrack->decodedFrameIndexRange();
+    mixxx::IndexRange forwardFrameIndexRange;
+    mixxx::IndexRange backwardFrameIndexRange;
+    if (decodedFrameIndexRange.empty()) {
+        const SINT startFrame = math_clamp(
+                *m_residentTrackStartFrame,
+                decodableFrameIndexRange.start(),
+                decodableFrameIndexRange.end() - 1);
+        forwardFrameIndexRange = intersect(
+                mixxx::IndexRange::forward(startFrame, CachingReaderChunk::kFrames),
+                decodableFrameIndexRange);
+    } else {
+        if (decodedFrameIndexRange.end() < decodableFrameIndexRange.end()) {
+            forwardFrameIndexRange = intersect(
+                    mixxx::IndexRange::forward(
+                            decodedFrameIndexRange.end(),
+                            CachingReaderChunk::kFrames),
+                    decodableFrameIndexRange);
+        }
+        if (decodedFrameIndexRange.start() > decodableFrameIndexRange.start()) {
+            backwardFrameIndexRange = intersect(
+                    mixxx::IndexRange::between(
+                            decodedFrameIndexRange.start() - CachingReaderChunk::kFrames,
+                            decodedFrameIndexRange.start()),
+                    decodableFrameIndexRange);
+        }
+    }
+    const bool backward = !backwardFrameIndexRange.empty() &&
+            (m_residentTrackDecodeBackward || forwardFrameIndexRange.empty());
+    const auto frameIndexRange = backward ? backwardFrameIndexRange : forwardFrameIndexRange;
+    if (frameIndexRange.empty()) {
+        return false;
+    }
+    m_residentTrackDecodeBackward = !backward;
+
+    const auto writableSlice = pResidentTrack->writableSlice(frameIndexRange);
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+            mixxx::WritableSampleFrames(frameIndexRange, writableSlice));
+    if (readableSampleFrames.frameIndexRange() != frameIndexRange) {
+        // Leave the remaining frames in this direction to the chunks
+        kLogger.warning()
+                << m_group
+                << "Failed to decode the resident track:"
+                << "expected =" << frameIndexRange
+                << ", actual =" << readableSampleFrames.frameIndexRange();
+        if (decodedFrameIndexRange.empty()) {
+            m_residentTrackDecodableFrameIndexRange = mixxx::IndexRange();
+        } else if (backward) {
+            m_residentTrackDecodableFrameIndexRange = mixxx::IndexRange::between(
+                    decodedFrameIndexRange.start(),
+                    m_residentTrackDecodableFrameIndexRange.end());
+        } else {
+            m_residentTrackDecodableFrameIndexRange = mixxx::IndexRange::between(
+                    m_residentTrackDecodableFrameIndexRange.start(),
+                    decodedFrameIndexRange.end());
+        }
+        return true;
+    }
+    DEBUG_ASSERT(readableSampleFrames.readableData() == writableSlice.data());
+    pResidentTrack->extendDecodedFrameIndexRange(frameIndexRange);
+    if (kLogger.debugEnabled() &&
+            pResidentTrack->decodedFrameIndexRange() == pResidentTrack->frameIndexRange()) {
+        kLogger.debug()
+                << m_group
+                << "Decoded the whole track";
+    }
+    return true;
+}
+
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
     m_semaRun.release();
     wait();
+    // Requests that are still queued or a new track that has not been
+    // loaded will never be answered and must not block the other workers
+    releasePendingRequests(m_pendingRequests.fetchAndStoreOrdered(0));
+    m_pStats->report();
 }
 
 void CachingReaderWorker::verifyFirstSound(const CachingReaderChunk* pChunk) {
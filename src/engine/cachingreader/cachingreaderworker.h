@@ -5,13 +5,19 @@
 #include <QString>
 #include <QThread>
 #include <QtDebug>
+#include <optional>
 
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderresidenttrack.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
+#include "util/compatibility/qatomic.h"
+#include "util/counter.h"
+#include "util/duration.h"
 #include "util/fifo.h"
+#include "util/tracering.h"
 
 // POD with trivial ctor/dtor/copy for passing through FIFO
 typedef struct CachingReaderChunkReadRequest {
@@ -92,14 +98,83 @@ typedef struct ReaderStatusUpdate {
     }
 } ReaderStatusUpdate;
 
+// Cache statistics of a CachingReader. They are counted lock-free and
+// without allocations on the engine thread and reported to the
+// StatsManager by the CachingReaderWorker.
+class CachingReaderStats {
+  public:
+    explicit CachingReaderStats(const QString& group);
+
+    void countReadAvailable() {
+        m_readAvailable.count();
+    }
+    void countReadPartiallyAvailable() {
+        m_readPartiallyAvailable.count();
+    }
+    void countReadUnavailable() {
+        m_readUnavailable.count();
+    }
+    void countHintChunkPoolExhausted() {
+        m_hintChunkPoolExhausted.count();
+    }
+
+    int readAvailableCount() const {
+        return m_readAvailable.value();
+    }
+    int readPartiallyAvailableCount() const {
+        return m_readPartiallyAvailable.value();
+    }
+    int readUnavailableCount() const {
+        return m_readUnavailable.value();
+    }
+    int hintChunkPoolExhaustedCount() const {
+        return m_hintChunkPoolExhausted.value();
+    }
+
+    // Reports the counts since the previous report to the StatsManager.
+    // Not real-time safe and must only be called by a single thread.
+    void report();
+
+  private:
+    class Statistic {
+      public:
+        explicit Statistic(const QString& tag)
+                : m_counter(tag),
+                  m_reported(0) {
+        }
+
+        void count() {
+            m_count.fetchAndAddRelaxed(1);
+        }
+        int value() const {
+            return atomicLoadRelaxed(m_count);
+        }
+        void report();
+
+      private:
+        QAtomicInt m_count;
+        Counter m_counter;
+        int m_reported;
+    };
+
+    Statistic m_readAvailable;
+    Statistic m_readPartiallyAvailable;
+    Statistic m_readUnavailable;
+    Statistic m_hintChunkPoolExhausted;
+};
+
 class CachingReaderWorker : public EngineWorker {
     Q_OBJECT
 
   public:
-    // Construct a CachingReader with the given group.
+    // Construct a CachingReader with the given group. Tracks are only
+    // decoded completely if a pResidentTrackSlot is provided.
     CachingReaderWorker(const QString& group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
+            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+            CachingReaderStats* pStats,
+            CachingReaderResidentTrackSlot* pResidentTrackSlot = nullptr,
+            bool residentTrackMemoryMapped = false);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
@@ -109,8 +184,20 @@ class CachingReaderWorker : public EngineWorker {
     // thread pool via the EngineWorkerScheduler.
     void run() override;
 
+    // Stops the thread, releases the requests that have not been
+    // answered yet and reports the remaining statistics
     void quitWait();
 
+    // Counts a read request that has been written into the request FIFO
+    // of this worker. Lock-free, called from the engine callback.
+    void addPendingRequest();
+
+    // Blocks until all workers have answered all pending read requests
+    // and track loads. The engine callback never waits for the workers,
+    // this is only needed for rendering the engine output deterministically
+    // without an audio device. Returns false on timeout.
+    static bool waitForPendingRequests(mixxx::Duration timeout);
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -119,13 +206,17 @@ class CachingReaderWorker : public EngineWorker {
 
   private:
     const QString m_group;
-    QString m_tag;
+    const mixxx::TraceTag m_traceTag;
 
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
 
+    // Counted by the engine callback, reported whenever this worker
+    // runs out of work
+    CachingReaderStats* const m_pStats;
+
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
     QMutex m_newTrackMutex;
@@ -150,6 +241,13 @@ class CachingReaderWorker : public EngineWorker {
 
     void verifyFirstSound(const CachingReaderChunk* pChunk);
 
+    /// Allocates the resident track for the current audio source
+    void allocateResidentTrack();
+
+    /// Decodes the next chunk of the resident track, alternating between
+    /// both directions. Returns false if there is nothing left to decode.
+    bool decodeResidentTrack();
+
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
@@ -159,5 +257,20 @@ class CachingReaderWorker : public EngineWorker {
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
 
+    CachingReaderResidentTrackSlot* const m_pResidentTrackSlot;
+    const bool m_residentTrackMemoryMapped;
+    // Decoding of the resident track starts at the first chunk that is
+    // requested after loading the track, usually the play position.
+    std::optional<SINT> m_residentTrackStartFrame;
+    // The frames that are not known to be unreadable
+    mixxx::IndexRange m_residentTrackDecodableFrameIndexRange;
+    bool m_residentTrackDecodeBackward;
+
+    void removePendingRequest();
+
+    // Read requests and track loads of this worker that are not answered
+    // yet, also included in the count of all workers
+    QAtomicInt m_pendingRequests;
+
     QAtomicInt m_stop;
 };
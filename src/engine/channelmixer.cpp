@@ -60,7 +60,8 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
         const ChannelHandle& outputHandle,
         unsigned int iBufferSize,
         unsigned int iSampleRate,
-        EngineEffectsManager* pEngineEffectsManager) {
+        EngineEffectsManager* pEngineEffectsManager,
+        EngineChannelThreadPool* pThreadPool) {
     // Signal flow overview:
     // 1. Calculate gains for each channel
     // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
@@ -69,6 +70,40 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t("EngineMaster::applyEffectsInPlaceAndMixChannels");
     SampleUtil::clear(pOutput, iBufferSize);
+    if (pThreadPool && activeChannels.size() > 1) {
+        QVarLengthArray<EngineEffectsManager::PostFaderChannel, kPreallocatedChannels>
+                postFaderChannels;
+        for (auto* pChannelInfo : activeChannels) {
+            EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
+            EngineEffectsManager::PostFaderChannel postFaderChannel;
+            postFaderChannel.inputHandle = pChannelInfo->m_handle;
+            postFaderChannel.pInOut = pChannelInfo->m_pBuffer;
+            postFaderChannel.pGroupFeatures = &pChannelInfo->m_features;
+            postFaderChannel.oldGain = gainCache.m_gain;
+            postFaderChannel.fadeout = gainCache.m_fadeout ||
+                    (pChannelInfo->m_pChannel &&
+                            !pChannelInfo->m_pChannel->isActive());
+            if (postFaderChannel.fadeout) {
+                postFaderChannel.newGain = 0;
+                gainCache.m_fadeout = false;
+            } else {
+                postFaderChannel.newGain = gainCalculator.getGain(pChannelInfo);
+            }
+            gainCache.m_gain = postFaderChannel.newGain;
+            postFaderChannels.append(postFaderChannel);
+        }
+        pEngineEffectsManager->processPostFaderInPlaceConcurrently(pThreadPool,
+                outputHandle,
+                postFaderChannels.constData(),
+                postFaderChannels.size(),
+                iBufferSize,
+                iSampleRate);
+        // Mix in the same order as below to get bit-identical results
+        for (auto* pChannelInfo : activeChannels) {
+            SampleUtil::add(pOutput, pChannelInfo->m_pBuffer, iBufferSize);
+        }
+        return;
+    }
     for (auto* pChannelInfo : activeChannels) {
         EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -23,6 +23,8 @@ class ChannelMixer {
             unsigned int iSampleRate,
             EngineEffectsManager* pEngineEffectsManager);
     // This does modify the input channel buffers, then mixes them to make the output buffer.
+    // If pThreadPool is provided, the effects of the channels are processed
+    // concurrently. The output is the same in both cases.
     static void applyEffectsInPlaceAndMixChannels(
             const EngineMaster::GainCalculator& gainCalculator,
             const QVarLengthArray<EngineMaster::ChannelInfo*,
@@ -33,5 +35,6 @@ class ChannelMixer {
             const ChannelHandle& outputHandle,
             unsigned int iBufferSize,
             unsigned int iSampleRate,
-            EngineEffectsManager* pEngineEffectsManager);
+            EngineEffectsManager* pEngineEffectsManager,
+            EngineChannelThreadPool* pThreadPool = nullptr);
 };
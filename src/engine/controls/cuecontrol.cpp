@@ -82,6 +82,20 @@ void appendCueHint(gsl::not_null<HintVector*> pHintList,
     }
 }
 
+// Loop ends are jump targets while playing in reverse and playback continues
+// backwards from there, so the frames before the end are hinted.
+void appendCueEndHint(gsl::not_null<HintVector*> pHintList,
+        const mixxx::audio::FramePos& frame,
+        Hint::Type type) {
+    if (frame.isValid()) {
+        const Hint cueHint = {
+                /*.frame =*/static_cast<SINT>(frame.toUpperFrameBoundary().value()),
+                /*.frameCount =*/Hint::kFrameCountBackward,
+                /*.type =*/type};
+        pHintList->append(cueHint);
+    }
+}
+
 void appendCueHint(gsl::not_null<HintVector*> pHintList, const double playPos, Hint::Type type) {
     const auto frame = mixxx::audio::FramePos::fromEngineSamplePosMaybeInvalid(playPos);
     appendCueHint(pHintList, frame, type);
@@ -1262,6 +1276,17 @@ void CueControl::hintReader(gsl::not_null<HintVector*> pHintList) {
     appendCueHint(pHintList, m_pIntroStartPosition->get(), Hint::Type::IntroStart);
     appendCueHint(pHintList, m_pIntroEndPosition->get(), Hint::Type::IntroEnd);
     appendCueHint(pHintList, m_pOutroStartPosition->get(), Hint::Type::OutroStart);
+    appendCueEndHint(pHintList,
+            mixxx::audio::FramePos::fromEngineSamplePosMaybeInvalid(
+                    m_pOutroEndPosition->get()),
+            Hint::Type::OutroEnd);
+
+    // The ends of saved loops have the lowest priority. They are hinted
+    // last so they are the first to be skipped if the CachingReader runs
+    // out of chunks.
+    for (const auto& pControl : qAsConst(m_hotcueControls)) {
+        appendCueEndHint(pHintList, pControl->getEndPosition(), Hint::Type::HotCueEnd);
+    }
 }
 
 // Moves the cue point to current position or to closest beat in case
@@ -16,7 +16,6 @@
 #include "util/sample.h"
 
 namespace {
-constexpr mixxx::audio::FrameDiff_t kMinimumAudibleLoopSizeFrames = 150;
 
 // returns true if a is valid and is fairly close to target (within +/- 1 frame).
 bool positionNear(mixxx::audio::FramePos a, mixxx::audio::FramePos target) {
@@ -575,6 +574,15 @@ void LoopingControl::hintReader(gsl::not_null<HintVector*> pHintList) {
             loop_hint.frameCount = Hint::kFrameCountForward;
             pHintList->append(loop_hint);
         }
+        // The end becomes a jump target if the loop is enabled again while
+        // playing in reverse
+        if (loopInfo.endPosition.isValid()) {
+            loop_hint.type = Hint::Type::LoopEnd;
+            loop_hint.frame = static_cast<SINT>(
+                    loopInfo.endPosition.toUpperFrameBoundary().value());
+            loop_hint.frameCount = Hint::kFrameCountBackward;
+            pHintList->append(loop_hint);
+        }
     }
 }
 
@@ -21,6 +21,9 @@ class BeatLoopingControl;
 class LoopingControl : public EngineControl {
     Q_OBJECT
   public:
+    // Shorter loops are abandoned or extended to this length
+    static constexpr mixxx::audio::FrameDiff_t kMinimumAudibleLoopSizeFrames = 150;
+
     static QList<double> getBeatSizes();
 
     LoopingControl(const QString& group, UserSettingsPointer pConfig);
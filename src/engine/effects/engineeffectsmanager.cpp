@@ -1,5 +1,7 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <thread>
+
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
@@ -8,7 +10,16 @@
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
         : m_pResponsePipe(std::move(pResponsePipe)),
           m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_buffer2(MAX_BUFFER_LEN),
+          m_pConcurrentChains(nullptr),
+          m_pConcurrentChannels(nullptr),
+          m_concurrentNumSamples(0),
+          m_concurrentSampleRate(0),
+          m_postFaderChainProgressSize(0),
+          m_pPreFaderConcurrentChains(nullptr),
+          m_pPreFaderConcurrentHandles(nullptr),
+          m_preFaderConcurrentNumChannels(0),
+          m_preFaderChainProgressSize(0) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
@@ -99,6 +110,35 @@ void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHand
     // Feature state is gathered after prefader effects processing.
     // This is okay because the equalizer effects do not make use of it.
     GroupFeatureState featureState;
+    if (m_pPreFaderConcurrentHandles) {
+        const int channelIndex = preFaderChannelIndex(inputHandle);
+        VERIFY_OR_DEBUG_ASSERT(channelIndex >= 0) {
+            return;
+        }
+        if (!m_pPreFaderConcurrentChains) {
+            return;
+        }
+        for (int i = 0; i < m_pPreFaderConcurrentChains->size(); ++i) {
+            // Wait until the channel before this one has left the chain
+            std::atomic<int>& chainProgress = m_preFaderChainProgress[i];
+            while (chainProgress.load(std::memory_order_acquire) < channelIndex) {
+                std::this_thread::yield();
+            }
+            EngineEffectChain* pChain = m_pPreFaderConcurrentChains->at(i);
+            if (pChain) {
+                pChain->process(inputHandle,
+                        outputHandle,
+                        pInOut,
+                        pInOut,
+                        numSamples,
+                        sampleRate,
+                        featureState,
+                        false);
+            }
+            chainProgress.store(channelIndex + 1, std::memory_order_release);
+        }
+        return;
+    }
     processInner(SignalProcessingStage::Prefader,
             inputHandle,
             outputHandle,
@@ -109,6 +149,64 @@ void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHand
             featureState);
 }
 
+bool EngineEffectsManager::beginPreFaderConcurrently(
+        const ChannelHandle* pInputHandles,
+        int numChannels) {
+    DEBUG_ASSERT(!m_pPreFaderConcurrentHandles);
+    const auto chainsIt = m_chainsByStage.constFind(SignalProcessingStage::Prefader);
+    const QList<EngineEffectChain*>* pChains =
+            (chainsIt != m_chainsByStage.constEnd()) ? &chainsIt.value() : nullptr;
+    if (pChains) {
+        VERIFY_OR_DEBUG_ASSERT(pChains->size() <= m_preFaderChainProgressSize) {
+            return false;
+        }
+        for (int i = 0; i < pChains->size(); ++i) {
+            m_preFaderChainProgress[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    m_pPreFaderConcurrentChains = pChains;
+    m_pPreFaderConcurrentHandles = pInputHandles;
+    m_preFaderConcurrentNumChannels = numChannels;
+    return true;
+}
+
+void EngineEffectsManager::finishPreFader(const ChannelHandle& inputHandle) {
+    if (!m_pPreFaderConcurrentHandles || !m_pPreFaderConcurrentChains) {
+        return;
+    }
+    const int channelIndex = preFaderChannelIndex(inputHandle);
+    VERIFY_OR_DEBUG_ASSERT(channelIndex >= 0) {
+        return;
+    }
+    // Let the following channels pass the chains that this channel
+    // has skipped
+    for (int i = 0; i < m_pPreFaderConcurrentChains->size(); ++i) {
+        std::atomic<int>& chainProgress = m_preFaderChainProgress[i];
+        if (chainProgress.load(std::memory_order_acquire) > channelIndex) {
+            continue;
+        }
+        while (chainProgress.load(std::memory_order_acquire) < channelIndex) {
+            std::this_thread::yield();
+        }
+        chainProgress.store(channelIndex + 1, std::memory_order_release);
+    }
+}
+
+void EngineEffectsManager::endPreFaderConcurrently() {
+    m_pPreFaderConcurrentChains = nullptr;
+    m_pPreFaderConcurrentHandles = nullptr;
+    m_preFaderConcurrentNumChannels = 0;
+}
+
+int EngineEffectsManager::preFaderChannelIndex(const ChannelHandle& inputHandle) const {
+    for (int i = 0; i < m_preFaderConcurrentNumChannels; ++i) {
+        if (m_pPreFaderConcurrentHandles[i] == inputHandle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void EngineEffectsManager::processPostFaderInPlace(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
@@ -156,6 +254,82 @@ void EngineEffectsManager::processPostFaderAndMix(
             fadeout);
 }
 
+void EngineEffectsManager::processPostFaderInPlaceConcurrently(
+        EngineChannelThreadPool* pThreadPool,
+        const ChannelHandle& outputHandle,
+        const PostFaderChannel* pChannels,
+        int numChannels,
+        unsigned int numSamples,
+        unsigned int sampleRate) {
+    DEBUG_ASSERT(pThreadPool);
+    const auto chainsIt = m_chainsByStage.constFind(SignalProcessingStage::Postfader);
+    const QList<EngineEffectChain*>* pChains =
+            (chainsIt != m_chainsByStage.constEnd()) ? &chainsIt.value() : nullptr;
+    if (pChains) {
+        VERIFY_OR_DEBUG_ASSERT(pChains->size() <= m_postFaderChainProgressSize) {
+            // Not enough progress counters, process the channels serially
+            for (int i = 0; i < numChannels; ++i) {
+                const PostFaderChannel& channel = pChannels[i];
+                processPostFaderInPlace(channel.inputHandle,
+                        outputHandle,
+                        channel.pInOut,
+                        numSamples,
+                        sampleRate,
+                        *channel.pGroupFeatures,
+                        channel.oldGain,
+                        channel.newGain,
+                        channel.fadeout);
+            }
+            return;
+        }
+        for (int i = 0; i < pChains->size(); ++i) {
+            m_postFaderChainProgress[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    m_pConcurrentChains = pChains;
+    m_pConcurrentChannels = pChannels;
+    m_concurrentOutputHandle = outputHandle;
+    m_concurrentNumSamples = numSamples;
+    m_concurrentSampleRate = sampleRate;
+
+    pThreadPool->processJobs(this, 0, numChannels);
+
+    m_pConcurrentChains = nullptr;
+    m_pConcurrentChannels = nullptr;
+}
+
+void EngineEffectsManager::processJob(int jobIndex) {
+    const PostFaderChannel& channel = m_pConcurrentChannels[jobIndex];
+    SampleUtil::applyRampingGain(channel.pInOut,
+            channel.oldGain,
+            channel.newGain,
+            m_concurrentNumSamples);
+    if (!m_pConcurrentChains) {
+        return;
+    }
+    for (int i = 0; i < m_pConcurrentChains->size(); ++i) {
+        // Wait until the channel before this one has left the chain.
+        // That channel was claimed earlier by another thread and is being
+        // processed, see EngineChannelThreadPool.
+        std::atomic<int>& chainProgress = m_postFaderChainProgress[i];
+        while (chainProgress.load(std::memory_order_acquire) < jobIndex) {
+            std::this_thread::yield();
+        }
+        EngineEffectChain* pChain = m_pConcurrentChains->at(i);
+        if (pChain) {
+            pChain->process(channel.inputHandle,
+                    m_concurrentOutputHandle,
+                    channel.pInOut,
+                    channel.pInOut,
+                    m_concurrentNumSamples,
+                    m_concurrentSampleRate,
+                    *channel.pGroupFeatures,
+                    channel.fadeout);
+        }
+        chainProgress.store(jobIndex + 1, std::memory_order_release);
+    }
+}
+
 void EngineEffectsManager::processInner(
         const SignalProcessingStage stage,
         const ChannelHandle& inputHandle,
@@ -242,6 +416,18 @@ bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
     // This might allocate in the audio thread, but it is only used when Mixxx
     // is starting up so there is no issue.
     chains.append(pChain);
+    if (stage == SignalProcessingStage::Postfader &&
+            chains.size() > m_postFaderChainProgressSize) {
+        // Grow in larger steps to avoid reallocating for every chain
+        m_postFaderChainProgressSize = chains.size() + 16;
+        m_postFaderChainProgress = std::make_unique<std::atomic<int>[]>(
+                m_postFaderChainProgressSize);
+    } else if (stage == SignalProcessingStage::Prefader &&
+            chains.size() > m_preFaderChainProgressSize) {
+        m_preFaderChainProgressSize = chains.size() + 16;
+        m_preFaderChainProgress = std::make_unique<std::atomic<int>[]>(
+                m_preFaderChainProgressSize);
+    }
     return true;
 }
 
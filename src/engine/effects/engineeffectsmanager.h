@@ -1,8 +1,11 @@
 #pragma once
 
 #include <QScopedPointer>
+#include <atomic>
+#include <memory>
 
 #include "engine/channelhandle.h"
+#include "engine/enginechannelthreadpool.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
 #include "util/fifo.h"
@@ -20,8 +23,20 @@ class EngineEffect;
 /// EngineChannel ---> EqualizerEffectChains --> channel faders & crossfader --> QuickEffectChains & StandardEffectChains --> mix channels into main mix --> main mix effect processing
 ///                                          |
 ///                                      PFL switch --> QuickEffectChains & StandardEffectChains --> mix channels into headphone mix --> headphone effect processing
-class EngineEffectsManager final : public EffectsRequestHandler {
+class EngineEffectsManager final : public EffectsRequestHandler,
+                                   private EngineChannelThreadPool::JobRunner {
   public:
+    /// The parameters of a single channel for
+    /// processPostFaderInPlaceConcurrently()
+    struct PostFaderChannel {
+        ChannelHandle inputHandle;
+        CSAMPLE* pInOut;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+
     EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe);
     ~EngineEffectsManager() override = default;
 
@@ -36,6 +51,22 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             unsigned int numSamples,
             unsigned int sampleRate);
 
+    /// Allows processing the prefader EngineEffectChains of the given
+    /// channels concurrently until endPreFaderConcurrently() is called.
+    ///
+    /// Like processPostFaderInPlaceConcurrently(), each prefader chain
+    /// processes the channels one after another in the given order, so
+    /// processPreFaderInPlace() of a channel waits until all channels
+    /// before it have left a chain. Each channel must call finishPreFader()
+    /// when done, even if it has not called processPreFaderInPlace().
+    ///
+    /// Returns false if the channels must be processed serially.
+    bool beginPreFaderConcurrently(
+            const ChannelHandle* pInputHandles,
+            int numChannels);
+    void finishPreFader(const ChannelHandle& inputHandle);
+    void endPreFaderConcurrently();
+
     /// Process the postfader EngineEffectChains on the pInOut buffer, modifying
     /// the contents of the input buffer.
     void processPostFaderInPlace(
@@ -49,6 +80,24 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Same as calling processPostFaderInPlace() for each of the channels in
+    /// order, but the channels are processed concurrently on pThreadPool.
+    ///
+    /// The EngineEffectChains keep state across the channels they process
+    /// within a callback (enable state ramping, group delay compensation,
+    /// intermediate buffers and the state of the effects), so each chain
+    /// still processes the channels one after another in the given order.
+    /// Only different chains run at the same time: while the second channel
+    /// is in the first chain, the first channel is already in the second
+    /// chain, and so on. The output is bit-identical to the serial processing.
+    void processPostFaderInPlaceConcurrently(
+            EngineChannelThreadPool* pThreadPool,
+            const ChannelHandle& outputHandle,
+            const PostFaderChannel* pChannels,
+            int numChannels,
+            unsigned int numSamples,
+            unsigned int sampleRate);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -97,10 +146,37 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    // Processes a single channel of processPostFaderInPlaceConcurrently()
+    void processJob(int jobIndex) override;
+
+    // The index of the channel passed to beginPreFaderConcurrently(),
+    // -1 if not found
+    int preFaderChannelIndex(const ChannelHandle& inputHandle) const;
+
     std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    // The state of the current processPostFaderInPlaceConcurrently() call
+    const QList<EngineEffectChain*>* m_pConcurrentChains;
+    const PostFaderChannel* m_pConcurrentChannels;
+    ChannelHandle m_concurrentOutputHandle;
+    unsigned int m_concurrentNumSamples;
+    unsigned int m_concurrentSampleRate;
+    // The number of channels each postfader chain has completed in the
+    // current processPostFaderInPlaceConcurrently() call.
+    std::unique_ptr<std::atomic<int>[]> m_postFaderChainProgress;
+    int m_postFaderChainProgressSize;
+
+    // The state between beginPreFaderConcurrently() and
+    // endPreFaderConcurrently()
+    const QList<EngineEffectChain*>* m_pPreFaderConcurrentChains;
+    const ChannelHandle* m_pPreFaderConcurrentHandles;
+    int m_preFaderConcurrentNumChannels;
+    // The number of channels each prefader chain has completed
+    std::unique_ptr<std::atomic<int>[]> m_preFaderChainProgress;
+    int m_preFaderChainProgressSize;
 };
@@ -100,7 +100,8 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_bPlayAfterLoading(false),
           m_pCrossfadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
           m_bCrossfadeReady(false),
-          m_iLastBufferSize(0) {
+          m_iLastBufferSize(0),
+          m_bProcessedConcurrently(false) {
     // This should be a static assertion, but isValid() is not constexpr.
     DEBUG_ASSERT(kInitialPlayPosition.isValid());
 
@@ -163,6 +164,8 @@ EngineBuffer::EngineBuffer(const QString& group,
 
     m_playposSlider = new ControlLinPotmeter(
         ConfigKey(m_group, "playposition"), 0.0, 1.0, 0, 0, true);
+    // Updated on every callback, listeners only need the latest position
+    m_playposSlider->setPublishMode(ControlPublishMode::Deferred);
     connect(m_playposSlider, &ControlObject::valueChanged,
             this, &EngineBuffer::slotControlSeek,
             Qt::DirectConnection);
@@ -825,8 +828,10 @@ void EngineBuffer::processTrackLocked(
         baserate = m_trackSampleRateOld / sampleRate;
     }
 
-    // Sync requests can affect rate, so process those first.
-    processSyncRequests();
+    if (!m_bProcessedConcurrently) {
+        // Sync requests can affect rate, so process those first.
+        processSyncRequests();
+    }
 
     // Note: play is also active during cue preview
     bool paused = !m_playButton->toBool();
@@ -1177,12 +1182,38 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     }
 #endif
 
-    m_pSyncControl->updateAudible();
+    if (!m_bProcessedConcurrently) {
+        m_pSyncControl->updateAudible();
+    }
 
     m_iLastBufferSize = iBufferSize;
     m_bCrossfadeReady = false;
 }
 
+void EngineBuffer::processCrossChannelRequests() {
+    m_bProcessedConcurrently = true;
+    bool hasStableTrack = m_pTrackLoaded->toBool() && m_iTrackLoading.loadAcquire() == 0;
+    if (!hasStableTrack || !m_pause.tryLock()) {
+        // Postponed until the track has been loaded
+        return;
+    }
+    // Sync requests can affect rate, so process those before processing
+    // any channel.
+    processSyncRequests();
+    // Check if we are cloning another channel before doing any seeking.
+    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
+    if (pChannel) {
+        seekCloneBuffer(pChannel->getEngineBuffer());
+    }
+    m_pause.unlock();
+}
+
+void EngineBuffer::processCrossChannelUpdates() {
+    DEBUG_ASSERT(m_bProcessedConcurrently);
+    m_pSyncControl->updateAudible();
+    m_bProcessedConcurrently = false;
+}
+
 void EngineBuffer::processSlip(int iBufferSize) {
     // Do a single read from m_bSlipEnabled so we don't run in to race conditions.
     bool enabled = m_pSlipButton->toBool();
@@ -1254,10 +1285,12 @@ void EngineBuffer::processSyncRequests() {
 
 void EngineBuffer::processSeek(bool paused) {
     m_previousBufferSeek = false;
-    // Check if we are cloning another channel before doing any seeking.
-    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
-    if (pChannel) {
-        seekCloneBuffer(pChannel->getEngineBuffer());
+    if (!m_bProcessedConcurrently) {
+        // Check if we are cloning another channel before doing any seeking.
+        EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
+        if (pChannel) {
+            seekCloneBuffer(pChannel->getEngineBuffer());
+        }
     }
 
     const QueuedSeek queuedSeek = m_queuedSeek.getValue();
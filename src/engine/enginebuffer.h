@@ -122,6 +122,15 @@ class EngineBuffer : public EngineObject {
     void requestClonePosition(EngineChannel* pChannel);
 
     // The process methods all run in the audio callback.
+    // If the channels are processed concurrently, EngineMaster invokes
+    // processCrossChannelRequests() for all active channels before any of
+    // them is processed and processCrossChannelUpdates() after all of them
+    // have been processed. They handle the requests and updates that affect
+    // other channels, i.e. changing the sync mode, cloning the position of
+    // another deck and picking the sync leader. Otherwise process() handles
+    // them in between.
+    void processCrossChannelRequests();
+    void processCrossChannelUpdates();
     void process(CSAMPLE* pOut, const int iBufferSize) override;
     void processSlip(int iBufferSize);
     void postProcess(const int iBufferSize);
@@ -443,6 +452,10 @@ class EngineBuffer : public EngineObject {
     bool m_bCrossfadeReady;
     int m_iLastBufferSize;
 
+    // Set between processCrossChannelRequests() and
+    // processCrossChannelUpdates()
+    bool m_bProcessedConcurrently;
+
     QSharedPointer<VisualPlayPosition> m_visualPlayPos;
 };
 
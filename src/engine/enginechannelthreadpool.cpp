@@ -0,0 +1,142 @@
+#include "engine/enginechannelthreadpool.h"
+
+#include <QtDebug>
+#include <thread>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "moc_enginechannelthreadpool.cpp"
+#include "util/assert.h"
+#include "util/audiothreadguard.h"
+
+namespace {
+
+constexpr int kJobRangeShift = 32;
+constexpr quint64 kJobIndexMask = (Q_UINT64_C(1) << kJobRangeShift) - 1;
+
+inline quint64 packJobRange(int firstJobIndex, int lastJobIndex) {
+    return (static_cast<quint64>(lastJobIndex) << kJobRangeShift) |
+            static_cast<quint64>(firstJobIndex);
+}
+
+} // anonymous namespace
+
+EngineChannelThreadPool::EngineChannelThreadPool(int numThreads)
+        : m_jobRange(0),
+          m_pJobRunner(nullptr),
+          m_floatingPointControl(0),
+          m_pendingJobs(0),
+          m_bQuit(false) {
+    DEBUG_ASSERT(numThreads > 0);
+    // Pin the workers to distinct CPUs, if there are enough of them.
+    const int numCpus = QThread::idealThreadCount();
+    for (int i = 0; i < numThreads; ++i) {
+        const int cpu = (numThreads < numCpus) ? i + 1 : -1;
+        m_threads.push_back(std::make_unique<EngineChannelThread>(this, cpu));
+    }
+    for (const auto& pThread : m_threads) {
+        pThread->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineChannelThreadPool::~EngineChannelThreadPool() {
+    m_bQuit.store(true);
+    m_semaWork.release(numThreads());
+    for (const auto& pThread : m_threads) {
+        pThread->wait();
+    }
+}
+
+void EngineChannelThreadPool::processJobs(
+        JobRunner* pJobRunner, int firstJobIndex, int lastJobIndex) {
+    DEBUG_ASSERT(pJobRunner);
+    const int jobCount = lastJobIndex - firstJobIndex;
+    if (jobCount <= 0) {
+        return;
+    }
+    if (jobCount == 1) {
+        // Nothing to fork
+        pJobRunner->processJob(firstJobIndex);
+        return;
+    }
+
+    m_pJobRunner = pJobRunner;
+#ifdef __SSE__
+    // The workers must handle denormals like the callback thread, e.g.
+    // flush them to zero, for bit-identical results
+    m_floatingPointControl.store(_mm_getcsr(), std::memory_order_relaxed);
+#endif
+    m_pendingJobs.store(jobCount, std::memory_order_relaxed);
+    // The release store publishes all data the jobs depend on
+    m_jobRange.store(packJobRange(firstJobIndex, lastJobIndex),
+            std::memory_order_release);
+
+    // The callback thread processes one job itself
+    m_semaWork.release(qMin(numThreads(), jobCount - 1));
+    processPendingJobs();
+
+    // Join. The remaining jobs are already running, so this will not take
+    // longer than the slowest job.
+    while (m_pendingJobs.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void EngineChannelThreadPool::processPendingJobs() {
+    while (true) {
+        const quint64 jobRange = m_jobRange.fetch_add(1, std::memory_order_acquire);
+        const auto jobIndex = static_cast<int>(jobRange & kJobIndexMask);
+        const auto lastJobIndex = static_cast<int>(jobRange >> kJobRangeShift);
+        if (jobIndex >= lastJobIndex) {
+            return;
+        }
+        m_pJobRunner->processJob(jobIndex);
+        m_pendingJobs.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+EngineChannelThread::EngineChannelThread(EngineChannelThreadPool* pPool, int cpu)
+        : m_pPool(pPool),
+          m_cpu(cpu) {
+    setObjectName(QStringLiteral("EngineChannel"));
+}
+
+void EngineChannelThread::run() {
+#ifdef __LINUX__
+    // Same realtime priority as the engine callback of the network clock,
+    // see SoundDeviceNetworkThread
+    struct sched_param spm = {0};
+    spm.sched_priority = 1;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &spm)) {
+        qWarning() << "EngineChannelThread: Failed bumping priority";
+    }
+    if (m_cpu >= 0) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(m_cpu, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet)) {
+            qWarning() << "EngineChannelThread: Failed pinning to CPU" << m_cpu;
+        }
+    }
+#endif
+
+    while (true) {
+        m_pPool->m_semaWork.acquire();
+        if (m_pPool->m_bQuit.load()) {
+            return;
+        }
+        // Waiting for work is fine, but processing it is subject to
+        // the same restrictions as the engine callback
+        const mixxx::AudioThreadGuard::Scope audioThreadScope;
+#ifdef __SSE__
+        _mm_setcsr(m_pPool->m_floatingPointControl.load(std::memory_order_relaxed));
+#endif
+        m_pPool->processPendingJobs();
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class EngineChannelThread;
+
+// EngineChannelThreadPool runs independent jobs of a single engine callback,
+// i.e. the processing of independent EngineChannels, on a fixed set of
+// realtime worker threads.
+//
+// processJobs() is a fork/join barrier: it wakes the workers, takes part in
+// the processing itself and returns when all jobs are done. Jobs are claimed
+// with an atomic counter and the completion is detected with another one,
+// so neither the callback thread nor the workers ever take a lock or allocate
+// memory while processing. Only waking up the sleeping workers requires a
+// (futex based) semaphore release which does not block the callback thread.
+//
+// The results are bit-identical to processing the jobs one after another as
+// long as the jobs do not depend on each other.
+//
+// Jobs are claimed strictly in the order of their indices and a claimed job
+// is processed without interruption. A job may therefore busy-wait for
+// partial results of jobs with a lower index without risking a deadlock.
+class EngineChannelThreadPool {
+  public:
+    class JobRunner {
+      public:
+        virtual ~JobRunner() = default;
+        virtual void processJob(int jobIndex) = 0;
+    };
+
+    // Creates numThreads worker threads. The callback thread itself is not
+    // counted, so numThreads + 1 jobs are processed concurrently.
+    explicit EngineChannelThreadPool(int numThreads);
+    ~EngineChannelThreadPool();
+
+    int numThreads() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    // Processes the jobs with the indices [firstJobIndex, lastJobIndex) and
+    // blocks until all of them are finished. Must only be called from the
+    // engine callback thread.
+    void processJobs(JobRunner* pJobRunner, int firstJobIndex, int lastJobIndex);
+
+  private:
+    friend class EngineChannelThread;
+
+    // Claims and processes jobs until no job is left. Called by both the
+    // callback thread and the worker threads.
+    void processPendingJobs();
+
+    std::vector<std::unique_ptr<EngineChannelThread>> m_threads;
+
+    // Released once per worker and callback to wake up the workers.
+    QSemaphore m_semaWork;
+
+    // The next job index to claim (low 32 bits) and the end of the job
+    // range (high 32 bits). Both are packed into a single atomic so a worker
+    // that wakes up late can never combine the index of one callback with
+    // the range of the next.
+    std::atomic<quint64> m_jobRange;
+    // The runner of the current jobs. Published by the store to m_jobRange.
+    JobRunner* m_pJobRunner;
+    // The SSE control and status register (MXCSR) of the callback thread,
+    // adopted by the workers before processing jobs.
+    std::atomic<unsigned int> m_floatingPointControl;
+    // The number of jobs that are not finished yet.
+    std::atomic<int> m_pendingJobs;
+    std::atomic<bool> m_bQuit;
+};
+
+class EngineChannelThread : public QThread {
+    Q_OBJECT
+  public:
+    EngineChannelThread(EngineChannelThreadPool* pPool, int cpu);
+
+  protected:
+    void run() override;
+
+  private:
+    EngineChannelThreadPool* const m_pPool;
+    // The CPU this thread is pinned to, or -1 if not pinned
+    const int m_cpu;
+};
@@ -23,6 +23,7 @@
 #include "mixer/playermanager.h"
 #include "moc_enginemaster.cpp"
 #include "preferences/usersettings.h"
+#include "util/audiothreadguard.h"
 #include "util/defs.h"
 #include "util/sample.h"
 #include "util/timer.h"
@@ -66,6 +67,12 @@ EngineMaster::EngineMaster(
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    // Opt-in: Process independent channels on additional realtime threads.
+    // The value is the number of threads in addition to the callback thread.
+    setChannelThreads(pConfig->getValue(
+            ConfigKey(group, "channel_threads"), 0));
+    m_iChannelBufferSize = 0;
+
     // Master sample rate
     m_pMasterSampleRate = new ControlObject(ConfigKey(group, "samplerate"), true, true);
     m_pMasterSampleRate->set(44100.);
@@ -240,6 +247,8 @@ EngineMaster::~EngineMaster() {
         SampleUtil::free(m_pOutputBusBuffers[o]);
     }
 
+    // Stop the channel threads before any channel is deleted
+    m_pChannelThreadPool.reset();
     delete m_pWorkerScheduler;
 
     for (int i = 0; i < m_channels.size(); ++i) {
@@ -279,7 +288,7 @@ void EngineMaster::processChannels(int iBufferSize) {
     m_activeTalkoverChannels.clear();
     m_activeChannels.clear();
 
-    //ScopedTimer timer("EngineMaster::processChannels");
+    ScopedTimer timer("EngineMaster::processChannels");
     EngineChannel* pLeaderChannel = m_pEngineSync->getLeaderChannel();
     // Reserve the first place for the master channel which
     // should be processed first
@@ -357,17 +366,14 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    m_iChannelBufferSize = iBufferSize;
+    if (m_pChannelThreadPool) {
+        processActiveChannelsConcurrently(activeChannelsStartIndex);
+    } else {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            processActiveChannel(i);
         }
     }
 
@@ -388,13 +394,81 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMaster::processActiveChannelsConcurrently(int activeChannelsStartIndex) {
+    DEBUG_ASSERT(m_pChannelThreadPool);
+    // Requests that affect other channels are handled serially before
+    // processing any channel. Otherwise they would race with processing
+    // the other channels on the thread pool.
+    m_activeChannelHandles.clear();
+    for (int i = activeChannelsStartIndex;
+            i < m_activeChannels.size();
+            ++i) {
+        EngineBuffer* pBuffer = m_activeChannels[i]->m_pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->processCrossChannelRequests();
+        }
+        m_activeChannelHandles.append(m_activeChannels[i]->m_handle);
+    }
+
+    // The prefader effect chains process the channels in the same order
+    // as the serial processing
+    if (!m_pEngineEffectsManager ||
+            m_pEngineEffectsManager->beginPreFaderConcurrently(
+                    m_activeChannelHandles.constData(),
+                    m_activeChannelHandles.size())) {
+        // The sync leader must be processed before all followers, so only
+        // the followers are processed concurrently.
+        if (activeChannelsStartIndex == 0) {
+            processActiveChannel(0);
+        }
+        m_pChannelThreadPool->processJobs(this, 1, m_activeChannels.size());
+        if (m_pEngineEffectsManager) {
+            m_pEngineEffectsManager->endPreFaderConcurrently();
+        }
+    } else {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            processActiveChannel(i);
+        }
+    }
+
+    // Updates that affect other channels, e.g. picking a new sync leader
+    // when a deck becomes audible, are also handled serially
+    for (int i = activeChannelsStartIndex;
+            i < m_activeChannels.size();
+            ++i) {
+        EngineBuffer* pBuffer = m_activeChannels[i]->m_pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->processCrossChannelUpdates();
+        }
+    }
+}
+
+void EngineMaster::processActiveChannel(int activeChannelIndex) {
+    ChannelInfo* pChannelInfo = m_activeChannels[activeChannelIndex];
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->process(pChannelInfo->m_pBuffer, m_iChannelBufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        // Lets the following channels pass the prefader chains
+        // if processed concurrently
+        m_pEngineEffectsManager->finishPreFader(pChannelInfo->m_handle);
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
 void EngineMaster::process(const int iBufferSize) {
     static bool haveSetName = false;
     if (!haveSetName) {
         QThread::currentThread()->setObjectName("Engine");
         haveSetName = true;
     }
-    //Trace t("EngineMaster::process");
+    const mixxx::AudioThreadGuard::Scope audioThreadGuardScope;
+    ScopedTimer t("EngineMaster::process");
 
     bool masterEnabled = m_pMasterEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -533,7 +607,8 @@ void EngineMaster::process(const int iBufferSize) {
                 m_masterHandle.handle(),
                 iBufferSize,
                 static_cast<int>(m_sampleRate.value()),
-                m_pEngineEffectsManager);
+                m_pEngineEffectsManager,
+                m_pChannelThreadPool.get());
     }
 
     // Process crossfader orientation bus channel effects
@@ -804,6 +879,21 @@ void EngineMaster::process(const int iBufferSize) {
     m_pWorkerScheduler->runWorkers();
 }
 
+void EngineMaster::setChannelThreads(int numThreads) {
+    m_pChannelThreadPool.reset();
+    if (numThreads > 0) {
+        qDebug() << "EngineMaster: Processing channels with"
+                 << numThreads << "additional threads";
+        m_pChannelThreadPool = std::make_unique<EngineChannelThreadPool>(
+                numThreads);
+    }
+}
+
+void EngineMaster::wakeWorkers() {
+    m_pWorkerScheduler->workerReady();
+    m_pWorkerScheduler->runWorkers();
+}
+
 void EngineMaster::applyMasterEffects(int iBufferSize) {
     // Apply master effects
     if (m_pEngineEffectsManager) {
@@ -8,6 +8,7 @@
 #include "control/controlpushbutton.h"
 #include "engine/channelhandle.h"
 #include "engine/channels/enginechannel.h"
+#include "engine/enginechannelthreadpool.h"
 #include "engine/engineobject.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
@@ -35,7 +36,9 @@ class EngineDelay;
 // engine. Prevents memory allocation in EngineMaster::addChannel.
 static constexpr int kPreallocatedChannels = 64;
 
-class EngineMaster : public QObject, public AudioSource {
+class EngineMaster : public QObject,
+                     public AudioSource,
+                     private EngineChannelThreadPool::JobRunner {
     Q_OBJECT
   public:
     EngineMaster(UserSettingsPointer pConfig,
@@ -69,6 +72,16 @@ class EngineMaster : public QObject, public AudioSource {
 
     void process(const int iBufferSize);
 
+    // Processes the channels concurrently on numThreads additional threads,
+    // or serially on the callback thread if 0. Must not be called while
+    // the engine is processing a callback.
+    void setChannelThreads(int numThreads);
+
+    // Wakes all engine workers that have work to do, even if the wakeup at
+    // the end of the last callback has been missed. Only for driving the
+    // engine without an audio device, see EngineOfflineRenderer.
+    void wakeWorkers();
+
     // Add an EngineChannel to the mixing engine. This is not thread safe --
     // only call it before the engine has started mixing.
     void addChannel(EngineChannel* pChannel);
@@ -261,6 +274,15 @@ class EngineMaster : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    // Processes the channels of m_activeChannels on m_pChannelThreadPool.
+    // Called by processChannels().
+    void processActiveChannelsConcurrently(int activeChannelsStartIndex);
+    // Processes a single channel of m_activeChannels. Called by
+    // processChannels(), either directly or from m_pChannelThreadPool.
+    void processActiveChannel(int activeChannelIndex);
+    void processJob(int jobIndex) override {
+        processActiveChannel(jobIndex);
+    }
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMasterEffects(int iBufferSize);
@@ -285,6 +307,8 @@ class EngineMaster : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeBusChannels[3];
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
+    // The handles of the channels that are processed concurrently
+    QVarLengthArray<ChannelHandle, kPreallocatedChannels> m_activeChannelHandles;
 
     mixxx::audio::SampleRate m_sampleRate;
 
@@ -297,6 +321,11 @@ class EngineMaster : public QObject, public AudioSource {
     CSAMPLE* m_pSidechainMix;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    // Optional worker threads for processing the channels concurrently.
+    // nullptr if all channels are processed in the callback thread.
+    std::unique_ptr<EngineChannelThreadPool> m_pChannelThreadPool;
+    // The buffer size of the current callback, for processActiveChannel()
+    int m_iChannelBufferSize;
     EngineSync* m_pEngineSync;
 
     ControlObject* m_pMasterGain;
@@ -0,0 +1,250 @@
+#include "engine/engineofflinerenderer.h"
+
+#include <QThread>
+
+#include "control/controlobject.h"
+#include "engine/cachingreader/cachingreaderworker.h"
+#include "engine/engine.h"
+#include "engine/enginemaster.h"
+#include "recording/defs_recording.h"
+#include "util/defs.h"
+#include "util/denormalsarezero.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+#include "util/timer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineOfflineRenderer");
+
+const QString kMasterGroup = QStringLiteral("[Master]");
+
+// Wakes the workers again if they didn't respond within this interval
+constexpr auto kWorkerWakeInterval = mixxx::Duration::fromMillis(10);
+// Even loading a long track from a slow disk shouldn't take that long
+constexpr auto kWorkerTimeout = mixxx::Duration::fromSeconds(60);
+
+} // anonymous namespace
+
+double EngineOfflineRenderer::Stats::realtimeFactor() const {
+    if (wallDuration <= mixxx::Duration::empty()) {
+        return 0.0;
+    }
+    return audioDuration.toDoubleSeconds() / wallDuration.toDoubleSeconds();
+}
+
+mixxx::Duration EngineOfflineRenderer::Stats::meanCallbackDuration() const {
+    if (callbacks <= 0) {
+        return mixxx::Duration::empty();
+    }
+    return mixxx::Duration::fromNanos(sumCallbackDuration.toIntegerNanos() / callbacks);
+}
+
+EngineOfflineRenderer::EngineOfflineRenderer(
+        UserSettingsPointer pConfig,
+        EngineMaster* pEngineMaster,
+        mixxx::audio::SampleRate sampleRate,
+        SINT framesPerBuffer)
+        : m_pConfig(pConfig),
+          m_pEngineMaster(pEngineMaster),
+          m_sampleRate(sampleRate),
+          m_framesPerBuffer(framesPerBuffer),
+          m_maxRealtimeFactor(0.0) {
+    DEBUG_ASSERT(m_pEngineMaster);
+    DEBUG_ASSERT(m_sampleRate.isValid());
+    DEBUG_ASSERT(m_framesPerBuffer > 0);
+    DEBUG_ASSERT(mixxx::kEngineChannelCount * m_framesPerBuffer <= MAX_BUFFER_LEN);
+}
+
+EngineOfflineRenderer::~EngineOfflineRenderer() {
+    close();
+}
+
+bool EngineOfflineRenderer::open(const QString& fileName,
+        const QString& encoding,
+        QString* pUserErrorMessage) {
+    close();
+
+    if (encoding != ENCODING_WAVE &&
+            encoding != ENCODING_AIFF &&
+            encoding != ENCODING_FLAC) {
+        kLogger.warning() << "Unsupported encoding for offline rendering" << encoding;
+        return false;
+    }
+
+    const Encoder::Format format = EncoderFactory::getFactory().getFormatFor(encoding);
+    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            format, m_pConfig, this);
+    VERIFY_OR_DEBUG_ASSERT(m_pEncoder) {
+        return false;
+    }
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning()
+                << "Failed to open"
+                << fileName
+                << m_file.errorString();
+        m_pEncoder.reset();
+        return false;
+    }
+
+    if (m_pEncoder->initEncoder(m_sampleRate, pUserErrorMessage) < 0) {
+        kLogger.warning() << "Failed to initialize" << format.label << "encoder";
+        m_pEncoder.reset();
+        m_file.close();
+        return false;
+    }
+
+    // The engine reads the sample rate from the control on every callback
+    ControlObject::set(ConfigKey(kMasterGroup, "samplerate"), m_sampleRate.toDouble());
+    ControlObject::set(ConfigKey(kMasterGroup, "latency"),
+            mixxx::Duration::fromSeconds(m_framesPerBuffer / m_sampleRate.toDouble())
+                    .toDoubleMillis());
+
+    m_stats = Stats();
+    return true;
+}
+
+void EngineOfflineRenderer::close() {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (m_pEncoder) {
+        m_pEncoder->flush();
+        m_pEncoder.reset();
+    }
+    m_file.close();
+
+    kLogger.info()
+            << "Rendered"
+            << m_stats.audioDuration.formatSecondsWithUnit()
+            << "in"
+            << m_stats.wallDuration.formatSecondsWithUnit()
+            << "realtime factor:" << m_stats.realtimeFactor();
+    if (m_stats.callbacks > 0) {
+        kLogger.info()
+                << "Callback duration min/avg/max:"
+                << m_stats.minCallbackDuration.formatMicrosWithUnit()
+                << m_stats.meanCallbackDuration().formatMicrosWithUnit()
+                << m_stats.maxCallbackDuration.formatMicrosWithUnit();
+    }
+}
+
+EngineOfflineRenderer::Stats EngineOfflineRenderer::render(mixxx::Duration duration) {
+    VERIFY_OR_DEBUG_ASSERT(isOpen()) {
+        return m_stats;
+    }
+
+#ifdef __SSE__
+    // Same as in the audio callback of the sound devices, see
+    // SoundDeviceNetwork::callbackProcessClkRef()
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+    const auto framesToRender = static_cast<SINT>(
+            duration.toDoubleSeconds() * m_sampleRate.toDouble());
+    const SINT framesRendered = m_stats.frames;
+
+    PerformanceTimer wallTimer;
+    wallTimer.start();
+    const mixxx::Duration wallDurationBefore = m_stats.wallDuration;
+    while (m_stats.frames - framesRendered < framesToRender) {
+        if (m_callbackHook) {
+            m_callbackHook(m_stats.frames);
+        }
+        if (!waitForEngineWorkers()) {
+            break;
+        }
+        processCallback();
+        m_stats.wallDuration = wallDurationBefore + wallTimer.elapsed();
+
+        if (m_maxRealtimeFactor > 0) {
+            const auto minWallDuration = mixxx::Duration::fromSeconds(
+                    (m_stats.frames - framesRendered) /
+                    (m_sampleRate.toDouble() * m_maxRealtimeFactor));
+            const auto ahead = minWallDuration - wallTimer.elapsed();
+            if (ahead > mixxx::Duration::empty()) {
+                QThread::usleep(static_cast<unsigned long>(ahead.toIntegerMicros()));
+            }
+        }
+    }
+    m_stats.wallDuration = wallDurationBefore + wallTimer.elapsed();
+    return m_stats;
+}
+
+bool EngineOfflineRenderer::waitForEngineWorkers() {
+    PerformanceTimer timer;
+    timer.start();
+    do {
+        // The scheduler might have missed the wakeup at the end of the
+        // last callback while it was still busy
+        m_pEngineMaster->wakeWorkers();
+        if (CachingReaderWorker::waitForPendingRequests(kWorkerWakeInterval)) {
+            return true;
+        }
+    } while (timer.elapsed() < kWorkerTimeout);
+    kLogger.warning()
+            << "Aborting, the engine workers didn't respond within"
+            << kWorkerTimeout.formatSecondsWithUnit();
+    return false;
+}
+
+void EngineOfflineRenderer::processCallback() {
+    ScopedTimer t("EngineOfflineRenderer::processCallback");
+    const SINT samplesPerBuffer = mixxx::kEngineChannelCount * m_framesPerBuffer;
+
+    PerformanceTimer callbackTimer;
+    callbackTimer.start();
+    m_pEngineMaster->process(static_cast<int>(samplesPerBuffer));
+    m_pEncoder->encodeBuffer(m_pEngineMaster->getMasterBuffer(),
+            static_cast<int>(samplesPerBuffer));
+    const mixxx::Duration callbackDuration = callbackTimer.elapsed();
+
+    if (m_stats.callbacks == 0 || callbackDuration < m_stats.minCallbackDuration) {
+        m_stats.minCallbackDuration = callbackDuration;
+    }
+    if (callbackDuration > m_stats.maxCallbackDuration) {
+        m_stats.maxCallbackDuration = callbackDuration;
+    }
+    m_stats.sumCallbackDuration += callbackDuration;
+    ++m_stats.callbacks;
+    m_stats.frames += m_framesPerBuffer;
+    m_stats.audioDuration = mixxx::Duration::fromSeconds(
+            m_stats.frames / m_sampleRate.toDouble());
+}
+
+void EngineOfflineRenderer::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (headerLen > 0) {
+        m_file.write(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_file.write(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int EngineOfflineRenderer::tell() {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void EngineOfflineRenderer::seek(int pos) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.seek(static_cast<qint64>(pos));
+}
+
+int EngineOfflineRenderer::filelen() {
+    if (!m_file.isOpen()) {
+        return 0;
+    }
+    return static_cast<int>(m_file.size());
+}
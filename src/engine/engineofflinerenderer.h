@@ -0,0 +1,128 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <functional>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+class EngineMaster;
+
+/// EngineOfflineRenderer drives EngineMaster::process() without an audio
+/// device. It is the clock-free counterpart of SoundDeviceNetwork's clock
+/// reference thread: instead of sleeping until the deadline of the next
+/// buffer it calls the engine again as soon as the previous callback returned
+/// and passes the master output to a WAV/AIFF or FLAC encoder.
+///
+/// This allows rendering whole mixes, including sync, effects and control
+/// automation, faster than realtime on machines without audio hardware,
+/// e.g. for regression tests on CI or for producing archive mixes.
+///
+/// All methods must be called from the same thread. That thread becomes the
+/// engine thread for the duration of the rendering, so no SoundDevice must be
+/// open at the same time.
+class EngineOfflineRenderer : public EncoderCallback {
+  public:
+    /// Statistics of a finished (or aborted) rendering
+    struct Stats {
+        Stats()
+                : callbacks(0),
+                  frames(0) {
+        }
+
+        /// The realtime factor, i.e. how many seconds of audio have been
+        /// rendered per second of wall clock time.
+        double realtimeFactor() const;
+        mixxx::Duration meanCallbackDuration() const;
+
+        int callbacks;
+        SINT frames;
+        mixxx::Duration audioDuration;
+        mixxx::Duration wallDuration;
+        mixxx::Duration minCallbackDuration;
+        mixxx::Duration maxCallbackDuration;
+        mixxx::Duration sumCallbackDuration;
+    };
+
+    /// Invoked between two engine callbacks with the number of frames that
+    /// have been rendered so far. This is the place for automating controls,
+    /// e.g. moving the crossfader or pressing play on a deck.
+    typedef std::function<void(SINT framesRendered)> CallbackHook;
+
+    EngineOfflineRenderer(
+            UserSettingsPointer pConfig,
+            EngineMaster* pEngineMaster,
+            mixxx::audio::SampleRate sampleRate,
+            SINT framesPerBuffer);
+    ~EngineOfflineRenderer() override;
+
+    /// Open the output file. Only the lossless file formats
+    /// ENCODING_WAVE, ENCODING_AIFF and ENCODING_FLAC are supported.
+    /// The encoder settings are taken from the recording preferences.
+    bool open(const QString& fileName,
+            const QString& encoding,
+            QString* pUserErrorMessage = nullptr);
+    void close();
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    void setCallbackHook(CallbackHook hook) {
+        m_callbackHook = std::move(hook);
+    }
+
+    /// Limit the rendering speed to the given realtime factor, e.g. for
+    /// listening to the output. A value <= 0 (the default) renders as fast
+    /// as possible.
+    void setMaxRealtimeFactor(double maxRealtimeFactor) {
+        m_maxRealtimeFactor = maxRealtimeFactor;
+    }
+
+    /// Render the given duration of audio into the opened file. Returns
+    /// the statistics of all callbacks since open().
+    ///
+    /// Before every callback the renderer waits until the engine workers
+    /// have answered all requests of the previous callbacks, e.g. reading
+    /// chunks or loading tracks. The output is therefore reproducible and
+    /// doesn't depend on the speed of the disk. Rendering is aborted if the
+    /// workers don't respond.
+    Stats render(mixxx::Duration duration);
+
+    /// Blocks until the engine workers have answered all pending requests.
+    /// Returns false on timeout.
+    bool waitForEngineWorkers();
+
+    const Stats& stats() const {
+        return m_stats;
+    }
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    void processCallback();
+
+    const UserSettingsPointer m_pConfig;
+    EngineMaster* const m_pEngineMaster;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const SINT m_framesPerBuffer;
+
+    EncoderPointer m_pEncoder;
+    QFile m_file;
+
+    CallbackHook m_callbackHook;
+    double m_maxRealtimeFactor;
+
+    Stats m_stats;
+};
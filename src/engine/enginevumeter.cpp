@@ -36,6 +36,13 @@ EngineVuMeter::EngineVuMeter(const QString& group)
                                               0., 1.);
     m_ctrlPeakIndicatorR = new ControlPotmeter(ConfigKey(group, "PeakIndicatorR"),
                                               0., 1.);
+    // Display only, a single update per GUI tick is sufficient
+    m_ctrlVuMeter->setPublishMode(ControlPublishMode::Deferred);
+    m_ctrlVuMeterL->setPublishMode(ControlPublishMode::Deferred);
+    m_ctrlVuMeterR->setPublishMode(ControlPublishMode::Deferred);
+    m_ctrlPeakIndicator->setPublishMode(ControlPublishMode::Deferred);
+    m_ctrlPeakIndicatorL->setPublishMode(ControlPublishMode::Deferred);
+    m_ctrlPeakIndicatorR->setPublishMode(ControlPublishMode::Deferred);
     // Initialize the calculation:
     reset();
 }
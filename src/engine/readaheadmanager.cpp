@@ -7,9 +7,25 @@
 #include "util/math.h"
 #include "util/sample.h"
 
+namespace {
+
+// The log is consumed on every callback. Within a callback every loop jump
+// or change of direction starts a new entry, so the worst case is a loop of
+// the minimum length that is repeated while reading MAX_BUFFER_LEN samples,
+// plus the partial passes at both ends. CircularBuffer keeps one slot empty.
+constexpr unsigned int kReadAheadLogMaxEntries =
+        static_cast<unsigned int>(MAX_BUFFER_LEN /
+                (mixxx::kEngineChannelCount *
+                        LoopingControl::kMinimumAudibleLoopSizeFrames)) +
+        2;
+constexpr unsigned int kReadAheadLogCapacity = kReadAheadLogMaxEntries + 1;
+
+} // namespace
+
 ReadAheadManager::ReadAheadManager()
         : m_pLoopingControl(nullptr),
           m_pRateControl(nullptr),
+          m_readAheadLog(kReadAheadLogCapacity),
           m_currentPosition(0),
           m_pReader(nullptr),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
@@ -21,6 +37,7 @@ ReadAheadManager::ReadAheadManager(CachingReader* pReader,
         LoopingControl* pLoopingControl)
         : m_pLoopingControl(pLoopingControl),
           m_pRateControl(nullptr),
+          m_readAheadLog(kReadAheadLogCapacity),
           m_currentPosition(0),
           m_pReader(pReader),
           m_pCrossFadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
@@ -246,13 +263,18 @@ void ReadAheadManager::addReadLogEntry(double virtualPlaypositionStart,
                                        double virtualPlaypositionEndNonInclusive) {
     ReadLogEntry newEntry(virtualPlaypositionStart,
                           virtualPlaypositionEndNonInclusive);
-    if (m_readAheadLog.size() > 0) {
+    if (!m_readAheadLog.isEmpty()) {
         ReadLogEntry& last = m_readAheadLog.back();
         if (last.merge(newEntry)) {
             return;
         }
     }
-    m_readAheadLog.push_back(newEntry);
+    VERIFY_OR_DEBUG_ASSERT(!m_readAheadLog.isFull()) {
+        // The log is not consumed or the callback exceeds the assumed
+        // maximum. The play position will be inaccurate.
+        return;
+    }
+    m_readAheadLog.push(newEntry);
 }
 
 // Not thread-save, call from engine thread only
@@ -263,7 +285,7 @@ double ReadAheadManager::getFilePlaypositionFromLog(
         return currentFilePlayposition;
     }
 
-    if (m_readAheadLog.size() == 0) {
+    if (m_readAheadLog.isEmpty()) {
         // No log entries to read from.
         qDebug() << this << "No read ahead log entries to read from. Case not currently handled.";
         // TODO(rryan) log through a stats pipe eventually
@@ -272,7 +294,7 @@ double ReadAheadManager::getFilePlaypositionFromLog(
 
     double filePlayposition = 0;
     bool shouldNotifySeek = false;
-    while (m_readAheadLog.size() > 0 && numConsumedSamples > 0) {
+    while (!m_readAheadLog.isEmpty() && numConsumedSamples > 0) {
         ReadLogEntry& entry = m_readAheadLog.front();
 
         // Notify EngineControls that we have taken a seek.
@@ -293,7 +315,7 @@ double ReadAheadManager::getFilePlaypositionFromLog(
 
         if (entry.length() == 0) {
             // This entry is empty now.
-            m_readAheadLog.pop_front();
+            m_readAheadLog.pop();
         }
         shouldNotifySeek = true;
     }
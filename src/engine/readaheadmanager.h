@@ -3,10 +3,10 @@
 #include <QList>
 #include <QPair>
 #include <gsl/pointers>
-#include <list>
 
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreader.h"
+#include "util/circularbuffer.h"
 #include "util/math.h"
 #include "util/types.h"
 
@@ -70,6 +70,11 @@ class ReadAheadManager {
         double virtualPlaypositionStart;
         double virtualPlaypositionEndNonInclusive;
 
+        ReadLogEntry()
+                : virtualPlaypositionStart(0),
+                  virtualPlaypositionEndNonInclusive(0) {
+        }
+
         ReadLogEntry(double virtualPlaypositionStart,
                      double virtualPlaypositionEndNonInclusive) {
             this->virtualPlaypositionStart = virtualPlaypositionStart;
@@ -121,7 +126,9 @@ class ReadAheadManager {
 
     LoopingControl* m_pLoopingControl;
     RateControl* m_pRateControl;
-    std::list<ReadLogEntry> m_readAheadLog;
+    /// Preallocated, because entries are added and removed on the
+    /// engine thread on every callback.
+    CircularBuffer<ReadLogEntry> m_readAheadLog;
     double m_currentPosition;
     CachingReader* m_pReader;
     CSAMPLE* m_pCrossFadeBuffer;
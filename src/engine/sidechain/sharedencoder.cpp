@@ -0,0 +1,281 @@
+#include "engine/sidechain/sharedencoder.h"
+
+#include "engine/sidechain/enginenetworkstream.h"
+#include "moc_sharedencoder.cpp"
+#include "recording/defs_recording.h"
+#include "util/compatibility/qatomic.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+QString encoderKey(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate) {
+    return QStringLiteral("%1 quality %2 channels %3 %4 Hz")
+            .arg(pSettings->getFormat(),
+                    QString::number(pSettings->getQuality()),
+                    QString::number(static_cast<int>(pSettings->getChannelMode())),
+                    QString::number(sampleRate.value()));
+}
+
+} // namespace
+
+SharedEncoder::SharedEncoder(QString key, EncoderSettingsPointer pSettings)
+        : m_key(std::move(key)),
+          m_pSettings(std::move(pSettings)),
+          m_threadWaiting(false),
+          m_stop(false),
+          m_packetsPushed(false) {
+    setState(NETWORKSTREAMWORKER_STATE_INIT);
+}
+
+SharedEncoder::~SharedEncoder() {
+    stop();
+}
+
+int SharedEncoder::initEncoder(
+        mixxx::audio::SampleRate sampleRate, QString* pUserErrorMessage) {
+    m_pEncoder = EncoderFactory::getFactory().createEncoder(m_pSettings, this);
+    if (!m_pEncoder) {
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return -1;
+    }
+    const int ret = m_pEncoder->initEncoder(sampleRate, pUserErrorMessage);
+    if (ret < 0) {
+        m_pEncoder.reset();
+        setState(NETWORKSTREAMWORKER_STATE_ERROR);
+        return ret;
+    }
+    setState(NETWORKSTREAMWORKER_STATE_READY);
+    return ret;
+}
+
+void SharedEncoder::subscribe(const EncodedPacketQueuePointer& pQueue) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    m_subscribers.append(pQueue);
+    kLogger.debug() << m_key << "subscribers:" << m_subscribers.size();
+}
+
+int SharedEncoder::unsubscribe(const EncodedPacketQueuePointer& pQueue) {
+    const auto locker = lockMutex(&m_subscribersMutex);
+    m_subscribers.removeAll(pQueue);
+    kLogger.debug() << m_key << "subscribers:" << m_subscribers.size();
+    return m_subscribers.size();
+}
+
+void SharedEncoder::stop() {
+    m_stop = true;
+    m_readSema.release();
+    wait();
+}
+
+void SharedEncoder::process(const CSAMPLE* pBuffer, const int iBufferSize) {
+    if (iBufferSize <= 0 || !m_pEncoder) {
+        return;
+    }
+    setState(NETWORKSTREAMWORKER_STATE_BUSY);
+    const auto locker = lockMutex(&m_subscribersMutex);
+    m_packetsPushed = false;
+    // The encoded packets are received by the write() callback
+    m_pEncoder->encodeBuffer(pBuffer, iBufferSize);
+    if (m_packetsPushed) {
+        for (const auto& pQueue : qAsConst(m_subscribers)) {
+            pQueue->notify();
+        }
+    }
+    setState(NETWORKSTREAMWORKER_STATE_READY);
+}
+
+void SharedEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (headerLen + bodyLen <= 0) {
+        // The encoder has buffered the samples
+        return;
+    }
+    // Encoded once, the payload is shared by all subscribers
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    // Called from process() with the subscribers locked
+    for (const auto& pQueue : qAsConst(m_subscribers)) {
+        pQueue->push(packet);
+    }
+    m_packetsPushed = true;
+}
+
+void SharedEncoder::outputAvailable() {
+    m_readSema.release();
+}
+
+void SharedEncoder::setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) {
+    m_pOutputFifo = pOutputFifo;
+}
+
+QSharedPointer<FIFO<CSAMPLE>> SharedEncoder::getOutputFifo() {
+    return m_pOutputFifo;
+}
+
+bool SharedEncoder::threadWaiting() {
+    return atomicLoadRelaxed(m_threadWaiting);
+}
+
+void SharedEncoder::run() {
+    QThread::currentThread()->setObjectName(
+            QStringLiteral("SharedEncoder '%1'").arg(m_key));
+    kLogger.debug() << "run: Starting thread" << m_key;
+
+    VERIFY_OR_DEBUG_ASSERT(m_pOutputFifo) {
+        kLogger.warning() << "run: Broadcast FIFO handle is not available. Aborting";
+        return;
+    }
+
+    // Samples are only written into the FIFO while the thread is waiting
+    m_threadWaiting = true;
+    while (!atomicLoadAcquire(m_stop)) {
+        if (!m_readSema.tryAcquire(1, 1000)) {
+            continue;
+        }
+
+        const int readAvailable = m_pOutputFifo->readAvailable();
+        if (readAvailable) {
+            CSAMPLE* dataPtr1;
+            ring_buffer_size_t size1;
+            CSAMPLE* dataPtr2;
+            ring_buffer_size_t size2;
+
+            // We use size1 and size2, so we can ignore the return value
+            (void)m_pOutputFifo->aquireReadRegions(
+                    readAvailable, &dataPtr1, &size1, &dataPtr2, &size2);
+
+            process(dataPtr1, size1);
+            if (size2 > 0) {
+                process(dataPtr2, size2);
+            }
+
+            m_pOutputFifo->releaseReadRegions(readAvailable);
+        }
+    }
+    m_threadWaiting = false;
+
+    kLogger.debug() << "run: Thread stopped" << m_key;
+}
+
+SharedEncoderPool::SharedEncoderPool(QSharedPointer<EngineNetworkStream> pNetworkStream)
+        : m_pNetworkStream(pNetworkStream) {
+}
+
+SharedEncoderPool::~SharedEncoderPool() {
+    // Pending invocations are discarded with the pool. All connections
+    // have been removed at this point and no other thread modifies the
+    // slots of the stream.
+    const auto pNetworkStream = m_pNetworkStream.toStrongRef();
+    for (const auto& pEncoder : qAsConst(m_streamingEncoders)) {
+        if (pNetworkStream) {
+            pNetworkStream->removeOutputWorker(pEncoder);
+        }
+        pEncoder->stop();
+    }
+}
+
+// static
+bool SharedEncoderPool::isShareable(const QString& format) {
+    // MP3 frames and ADTS frames of AAC are self-contained
+    return format == QLatin1String(ENCODING_MP3) ||
+            format == QLatin1String(ENCODING_AAC) ||
+            format == QLatin1String(ENCODING_HEAAC) ||
+            format == QLatin1String(ENCODING_HEAACV2);
+}
+
+EncodedPacketQueuePointer SharedEncoderPool::subscribe(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate,
+        int maxQueuedBytes,
+        QSemaphore* pPacketsAvailable,
+        QString* pUserErrorMessage) {
+    DEBUG_ASSERT(isShareable(pSettings->getFormat()));
+    const QString key = encoderKey(pSettings, sampleRate);
+
+    const auto locker = lockMutex(&m_mutex);
+    SharedEncoderPointer pEncoder = m_encoders.value(key);
+    if (!pEncoder) {
+        if (m_pNetworkStream.isNull()) {
+            return EncodedPacketQueuePointer();
+        }
+        pEncoder = SharedEncoderPointer::create(key, pSettings);
+        if (pEncoder->initEncoder(sampleRate, pUserErrorMessage) < 0) {
+            return EncodedPacketQueuePointer();
+        }
+        m_encoders.insert(key, pEncoder);
+        // Invoked directly on the thread of the pool, otherwise queued
+        // in order with the removal
+        QMetaObject::invokeMethod(this, [this, pEncoder] {
+            addToNetworkStream(pEncoder);
+        });
+    }
+
+    auto pQueue = EncodedPacketQueuePointer::create(
+            key, maxQueuedBytes, pPacketsAvailable);
+    pEncoder->subscribe(pQueue);
+    return pQueue;
+}
+
+void SharedEncoderPool::unsubscribe(const EncodedPacketQueuePointer& pQueue) {
+    if (!pQueue) {
+        return;
+    }
+
+    const auto locker = lockMutex(&m_mutex);
+    const SharedEncoderPointer pEncoder = m_encoders.value(pQueue->encoderKey());
+    VERIFY_OR_DEBUG_ASSERT(pEncoder) {
+        return;
+    }
+    if (pEncoder->unsubscribe(pQueue) > 0) {
+        return;
+    }
+
+    // The last subscriber has left. A new subscriber with the same key
+    // gets a new encoder.
+    m_encoders.remove(pEncoder->key());
+    QMetaObject::invokeMethod(this, [this, pEncoder] {
+        removeFromNetworkStream(pEncoder);
+    });
+}
+
+void SharedEncoderPool::addToNetworkStream(const SharedEncoderPointer& pEncoder) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    const auto pNetworkStream = m_pNetworkStream.toStrongRef();
+    if (!pNetworkStream) {
+        return;
+    }
+    pNetworkStream->addOutputWorker(pEncoder);
+    if (!pEncoder->getOutputFifo()) {
+        kLogger.warning() << "addToNetworkStream: Failed to add the encoder"
+                          << pEncoder->key() << "to the network stream";
+        return;
+    }
+    m_streamingEncoders.append(pEncoder);
+    pEncoder->start(QThread::HighPriority);
+    kLogger.info() << "addToNetworkStream: Started encoder" << pEncoder->key();
+}
+
+void SharedEncoderPool::removeFromNetworkStream(const SharedEncoderPointer& pEncoder) {
+    DEBUG_ASSERT(QThread::currentThread() == thread());
+    if (!m_streamingEncoders.removeOne(pEncoder)) {
+        // Never started
+        return;
+    }
+    const auto pNetworkStream = m_pNetworkStream.toStrongRef();
+    if (pNetworkStream) {
+        pNetworkStream->removeOutputWorker(pEncoder);
+    }
+    pEncoder->stop();
+    kLogger.info() << "removeFromNetworkStream: Stopped encoder" << pEncoder->key();
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+#include <QVector>
+#include <QWeakPointer>
+#include <atomic>
+#include <utility>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "engine/sidechain/networkoutputstreamworker.h"
+#include "rigtorp/SPSCQueue.h"
+
+class EngineNetworkStream;
+
+/// The encoded packets for a single subscriber of a SharedEncoder.
+///
+/// Packets are pushed by the encoder thread and popped by the thread of the
+/// subscriber without locking. The payload of a packet is shared between all
+/// subscribers. If the subscriber falls behind more than maxQueuedBytes the
+/// new packets are dropped for this subscriber only.
+class EncodedPacketQueue {
+  public:
+    EncodedPacketQueue(
+            QString encoderKey,
+            int maxQueuedBytes,
+            QSemaphore* pPacketsAvailable = nullptr)
+            : m_encoderKey(std::move(encoderKey)),
+              m_maxQueuedBytes(maxQueuedBytes),
+              m_pPacketsAvailable(pPacketsAvailable),
+              m_packets(kMaxQueuedPackets),
+              m_queuedBytes(0),
+              m_droppedPacketCount(0) {
+    }
+
+    const QString& encoderKey() const {
+        return m_encoderKey;
+    }
+
+    /// Called by the encoder thread. Returns false if the packet has been
+    /// dropped.
+    bool push(const QByteArray& packet) {
+        if (m_queuedBytes.load(std::memory_order_acquire) + packet.size() >
+                        m_maxQueuedBytes ||
+                !m_packets.try_push(packet)) {
+            m_droppedPacketCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_queuedBytes.fetch_add(packet.size(), std::memory_order_release);
+        return true;
+    }
+
+    /// Called by the encoder thread after pushing all packets of an
+    /// encoded buffer.
+    void notify() {
+        if (m_pPacketsAvailable) {
+            m_pPacketsAvailable->release();
+        }
+    }
+
+    /// Called by the subscriber. Returns false if the queue is empty.
+    bool pop(QByteArray* pPacket) {
+        QByteArray* pFront = m_packets.front();
+        if (!pFront) {
+            return false;
+        }
+        *pPacket = std::move(*pFront);
+        m_packets.pop();
+        m_queuedBytes.fetch_sub(pPacket->size(), std::memory_order_release);
+        return true;
+    }
+
+    /// Called by the subscriber to discard all queued packets, e.g. while
+    /// the connection has not been established yet.
+    void clear() {
+        QByteArray packet;
+        while (pop(&packet)) {
+        }
+    }
+
+    /// Returns and resets the number of packets that have been dropped
+    /// because the subscriber did not keep up.
+    int takeDroppedPacketCount() {
+        return m_droppedPacketCount.exchange(0, std::memory_order_relaxed);
+    }
+
+  private:
+    // More than 30 s of MP3 frames for any bitrate. The actual limit is
+    // the number of queued bytes.
+    static constexpr std::size_t kMaxQueuedPackets = 2048;
+
+    const QString m_encoderKey;
+    const int m_maxQueuedBytes;
+    QSemaphore* const m_pPacketsAvailable;
+    rigtorp::SPSCQueue<QByteArray> m_packets;
+    std::atomic<int> m_queuedBytes;
+    std::atomic<int> m_droppedPacketCount;
+};
+
+typedef QSharedPointer<EncodedPacketQueue> EncodedPacketQueuePointer;
+
+/// Encodes the broadcast mix once for all connections with the same encoder
+/// settings and fans out the encoded packets to the EncodedPacketQueue of
+/// each subscriber.
+///
+/// It is registered as an output worker of the EngineNetworkStream, just
+/// like a ShoutConnection, and runs its own thread. A slow subscriber
+/// never stalls the encoder or the other subscribers.
+class SharedEncoder
+        : public QThread,
+          public EncoderCallback,
+          public NetworkOutputStreamWorker {
+    Q_OBJECT
+  public:
+    SharedEncoder(QString key, EncoderSettingsPointer pSettings);
+    ~SharedEncoder() override;
+
+    const QString& key() const {
+        return m_key;
+    }
+
+    int initEncoder(mixxx::audio::SampleRate sampleRate, QString* pUserErrorMessage);
+
+    void subscribe(const EncodedPacketQueuePointer& pQueue);
+    /// Returns the number of remaining subscribers
+    int unsubscribe(const EncodedPacketQueuePointer& pQueue);
+
+    /// Stops the thread and waits until it has finished
+    void stop();
+
+    // NetworkOutputStreamWorker
+    void process(const CSAMPLE* pBuffer, const int iBufferSize) override;
+    void shutdown() override {
+    }
+    void outputAvailable() override;
+    void setOutputFifo(QSharedPointer<FIFO<CSAMPLE>> pOutputFifo) override;
+    QSharedPointer<FIFO<CSAMPLE>> getOutputFifo() override;
+    bool threadWaiting() override;
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    const QString m_key;
+    const EncoderSettingsPointer m_pSettings;
+    EncoderPointer m_pEncoder;
+
+    QSharedPointer<FIFO<CSAMPLE>> m_pOutputFifo;
+    QSemaphore m_readSema;
+    QAtomicInt m_threadWaiting;
+    QAtomicInt m_stop;
+
+    // Only locked by the encoder thread and while (un-)subscribing
+    QMutex m_subscribersMutex;
+    QVector<EncodedPacketQueuePointer> m_subscribers;
+    bool m_packetsPushed;
+};
+
+typedef QSharedPointer<SharedEncoder> SharedEncoderPointer;
+
+/// Owns one SharedEncoder per distinct combination of format, bitrate,
+/// channels and sample rate. Thread-safe.
+///
+/// The slots of the EngineNetworkStream are not synchronized with the
+/// engine, so they must only be modified by a single thread. The encoders
+/// are added to and removed from the stream by the thread of the pool,
+/// like the connections of the BroadcastManager, no matter which thread
+/// subscribes or unsubscribes.
+class SharedEncoderPool : public QObject {
+    Q_OBJECT
+  public:
+    explicit SharedEncoderPool(QSharedPointer<EngineNetworkStream> pNetworkStream);
+    ~SharedEncoderPool() override;
+
+    /// Only formats with self-contained frames can be shared, because a
+    /// subscriber may start in the middle of the stream. Ogg streams need
+    /// their own headers for each connection.
+    static bool isShareable(const QString& format);
+
+    /// Returns a null pointer if no encoder could be initialized. The
+    /// semaphore is released whenever new packets are available.
+    EncodedPacketQueuePointer subscribe(
+            const EncoderSettingsPointer& pSettings,
+            mixxx::audio::SampleRate sampleRate,
+            int maxQueuedBytes,
+            QSemaphore* pPacketsAvailable,
+            QString* pUserErrorMessage);
+    void unsubscribe(const EncodedPacketQueuePointer& pQueue);
+
+  private:
+    // Invoked on the thread of the pool
+    void addToNetworkStream(const SharedEncoderPointer& pEncoder);
+    void removeFromNetworkStream(const SharedEncoderPointer& pEncoder);
+
+    // The connections that own the pool are workers of the stream
+    const QWeakPointer<EngineNetworkStream> m_pNetworkStream;
+
+    QMutex m_mutex;
+    QHash<QString, SharedEncoderPointer> m_encoders;
+
+    // Only accessed by the thread of the pool
+    QVector<SharedEncoderPointer> m_streamingEncoders;
+};
+
+typedef QSharedPointer<SharedEncoderPool> SharedEncoderPoolPointer;
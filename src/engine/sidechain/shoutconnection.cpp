@@ -40,7 +40,8 @@ const mixxx::Logger kLogger("ShoutConnection");
 } // namespace
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
-        UserSettingsPointer pConfig)
+        UserSettingsPointer pConfig,
+        SharedEncoderPoolPointer pSharedEncoders)
         : m_pTextCodec(nullptr),
           m_pMetaData(),
           m_pShout(nullptr),
@@ -51,6 +52,7 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_pConfig(pConfig),
           m_pProfile(profile),
           m_encoder(nullptr),
+          m_pSharedEncoders(pSharedEncoders),
           m_masterSamplerate("[Master]", "samplerate"),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -120,6 +122,8 @@ ShoutConnection::~ShoutConnection() {
        qWarning() << "ShoutOutput::~ShoutOutput(): Thread didn't die.\
        Ignored but file a bug report if problems rise!";
     }
+
+    unsubscribeEncodedPackets();
 }
 
 bool ShoutConnection::isConnected() {
@@ -184,6 +188,7 @@ void ShoutConnection::updateFromPreferences() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    unsubscribeEncodedPackets();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -450,10 +455,25 @@ void ShoutConnection::updateFromPreferences() {
     // Initialize m_encoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
+    QString userErrorMsg;
+    if (m_pSharedEncoders &&
+            SharedEncoderPool::isShareable(pBroadcastSettings->getFormat())) {
+        // Connections with the same settings share a single encoder
+        m_pEncodedPackets = m_pSharedEncoders->subscribe(pBroadcastSettings,
+                masterSamplerate,
+                kMaxNetworkCache,
+                &m_readSema,
+                &userErrorMsg);
+        if (m_pEncodedPackets) {
+            setState(NETWORKSTREAMWORKER_STATE_READY);
+            return;
+        }
+        // Otherwise fall back to a dedicated encoder that reports the error
+        userErrorMsg.clear();
+    }
     m_encoder = EncoderFactory::getFactory().createEncoder(
                     pBroadcastSettings, this);
 
-    QString userErrorMsg;
     int ret = -1;
     if (m_encoder) {
         ret = m_encoder->initEncoder(masterSamplerate, &userErrorMsg);
@@ -496,7 +516,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_encoder && !m_pEncodedPackets) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -592,7 +612,14 @@ bool ShoutConnection::processConnect() {
             if(m_pOutputFifo->readAvailable()) {
             	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
             }
-            m_threadWaiting = true;
+            if (m_pEncodedPackets) {
+                // Start with the next packet of the shared encoder. No
+                // samples are needed from the FIFO.
+                m_pEncodedPackets->clear();
+                m_pEncodedPackets->takeDroppedPacketCount();
+            } else {
+                m_threadWaiting = true;
+            }
 
             setStatus(BroadcastProfile::STATUS_CONNECTED);
             emit broadcastConnected();
@@ -623,6 +650,7 @@ bool ShoutConnection::processConnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    unsubscribeEncodedPackets();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -648,9 +676,17 @@ bool ShoutConnection::processDisconnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    unsubscribeEncodedPackets();
     return disconnected;
 }
 
+void ShoutConnection::unsubscribeEncodedPackets() {
+    if (m_pEncodedPackets) {
+        m_pSharedEncoders->unsubscribe(m_pEncodedPackets);
+        m_pEncodedPackets.reset();
+    }
+}
+
 void ShoutConnection::write(const unsigned char* header, const unsigned char* body,
                             int headerLen, int bodyLen) {
     setFunctionCode(7);
@@ -754,6 +790,46 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const int iBufferSize) {
     setState(NETWORKSTREAMWORKER_STATE_READY);
 }
 
+void ShoutConnection::processEncodedPackets() {
+    setFunctionCode(15);
+    if (!m_pProfile->getEnabled()) {
+        return;
+    }
+
+    setState(NETWORKSTREAMWORKER_STATE_BUSY);
+
+    // If we aren't connected, bail.
+    if (m_iShoutStatus != SHOUTERR_CONNECTED) {
+        return;
+    }
+
+    // write() may reconnect and subscribe again
+    const EncodedPacketQueuePointer pEncodedPackets = m_pEncodedPackets;
+
+    // The shared encoder does not wait for us
+    if (pEncodedPackets->takeDroppedPacketCount() > 0) {
+        m_lastErrorStr = tr("Network cache overflow");
+        tryReconnect();
+        return;
+    }
+
+    QByteArray packet;
+    while (m_iShoutStatus == SHOUTERR_CONNECTED &&
+            pEncodedPackets == m_pEncodedPackets &&
+            pEncodedPackets->pop(&packet)) {
+        write(nullptr,
+                reinterpret_cast<const unsigned char*>(packet.constData()),
+                0,
+                packet.size());
+    }
+
+    // Check if track metadata has changed and if so, update.
+    if (metaDataHasChanged()) {
+        updateMetaData();
+    }
+    setState(NETWORKSTREAMWORKER_STATE_READY);
+}
+
 bool ShoutConnection::metaDataHasChanged() {
     TrackPointer pTrack;
 
@@ -1034,6 +1110,11 @@ void ShoutConnection::run() {
             continue;
         }
 
+        if (m_pEncodedPackets) {
+            processEncodedPackets();
+            continue;
+        }
+
         int readAvailable = m_pOutputFifo->readAvailable();
         if (readAvailable) {
             setFunctionCode(3);
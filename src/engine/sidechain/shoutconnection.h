@@ -16,6 +16,7 @@
 #include "control/pollingcontrolproxy.h"
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "errordialoghandler.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
@@ -33,7 +34,9 @@ class ShoutConnection
         : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
-    ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
+    ShoutConnection(BroadcastProfilePtr profile,
+            UserSettingsPointer pConfig,
+            SharedEncoderPoolPointer pSharedEncoders);
     ~ShoutConnection() override;
 
     // This is called by the Engine implementation for each sample. Encode and
@@ -83,6 +86,9 @@ class ShoutConnection
   private:
     bool processConnect();
     bool processDisconnect();
+    // Sends the packets of the shared encoder to the server
+    void processEncodedPackets();
+    void unsubscribeEncodedPackets();
 
     // Update the libshout struct with info from the current broadcast profile.
     void updateFromPreferences();
@@ -125,6 +131,9 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    SharedEncoderPoolPointer m_pSharedEncoders;
+    // Replaces m_encoder if the encoder is shared with other connections
+    EncodedPacketQueuePointer m_pEncodedPackets;
     PollingControlProxy m_masterSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
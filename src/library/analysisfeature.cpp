@@ -6,12 +6,16 @@
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
+#include "library/dao/playlistdao.h"
 #include "library/dlganalysis.h"
 #include "library/library.h"
 #include "library/librarytablemodel.h"
+#include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
+#include "mixer/playerinfo.h"
 #include "moc_analysisfeature.cpp"
 #include "sources/soundsourceproxy.h"
+#include "track/track.h"
 #include "util/debug.h"
 #include "util/dnd.h"
 #include "util/logger.h"
@@ -57,6 +61,18 @@ AnalysisFeature::AnalysisFeature(
           m_pSidebarModel(make_parented<TreeItemModel>(this)),
           m_pAnalysisView(nullptr),
           m_title(m_baseTitle) {
+    connect(&pLibrary->trackCollectionManager()->internalCollection()->getPlaylistDAO(),
+            &PlaylistDAO::trackAdded,
+            this,
+            &AnalysisFeature::slotPlaylistTrackAdded);
+    connect(&PlayerInfo::instance(),
+            &PlayerInfo::trackChanged,
+            this,
+            &AnalysisFeature::slotPlayerTrackChanged);
+    connect(&PlayerInfo::instance(),
+            &PlayerInfo::currentPlayingTrackChanged,
+            this,
+            &AnalysisFeature::slotPlayingTrackChanged);
 }
 
 void AnalysisFeature::resetTitle() {
@@ -169,6 +185,64 @@ void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks)
     }
 }
 
+void AnalysisFeature::slotPlaylistTrackAdded(
+        int playlistId,
+        TrackId trackId,
+        int /*position*/) {
+    if (!m_pTrackAnalysisScheduler) {
+        return; // inactive
+    }
+    const PlaylistDAO& playlistDao =
+            m_pLibrary->trackCollectionManager()->internalCollection()->getPlaylistDAO();
+    if (playlistId != playlistDao.getPlaylistIdFromName(AUTODJ_TABLE)) {
+        return;
+    }
+    // Tracks in the Auto DJ queue are played soon and are analyzed
+    // before the remaining tracks of a running batch analysis. The
+    // workers pick it up after finishing their current track.
+    m_pTrackAnalysisScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            trackId,
+            AnalyzerTrack::Options(),
+            AnalyzerScheduledTrack::Priority::High));
+}
+
+void AnalysisFeature::slotPlayerTrackChanged(
+        const QString& /*group*/,
+        TrackPointer pNewTrack,
+        TrackPointer /*pOldTrack*/) {
+    if (!m_pTrackAnalysisScheduler || !pNewTrack) {
+        return;
+    }
+    // Loaded tracks are analyzed by the player manager anyway. Only
+    // move them up if they are part of the running batch analysis.
+    m_pTrackAnalysisScheduler->raisePriority(
+            pNewTrack->getId(),
+            AnalyzerScheduledTrack::Priority::High);
+}
+
+void AnalysisFeature::slotPlayingTrackChanged(TrackPointer pTrack) {
+    if (!m_pTrackAnalysisScheduler || !pTrack) {
+        return;
+    }
+    // The remaining tracks of the playlists that contain the playing
+    // track are likely to be played next
+    const PlaylistDAO& playlistDao =
+            m_pLibrary->trackCollectionManager()->internalCollection()->getPlaylistDAO();
+    QSet<int> playlistIds;
+    playlistDao.getPlaylistsTrackIsIn(pTrack->getId(), &playlistIds);
+    for (const int playlistId : qAsConst(playlistIds)) {
+        if (playlistDao.getHiddenType(playlistId) != PlaylistDAO::PLHT_NOT_HIDDEN) {
+            continue;
+        }
+        const QList<TrackId> trackIds = playlistDao.getTrackIds(playlistId);
+        for (const auto& trackId : trackIds) {
+            m_pTrackAnalysisScheduler->raisePriority(
+                    trackId,
+                    AnalyzerScheduledTrack::Priority::Normal);
+        }
+    }
+}
+
 void AnalysisFeature::suspendAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
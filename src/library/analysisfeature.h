@@ -50,6 +50,11 @@ class AnalysisFeature : public LibraryFeature {
   private slots:
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
     void onTrackAnalysisSchedulerFinished();
+    void slotPlaylistTrackAdded(int playlistId, TrackId trackId, int position);
+    void slotPlayerTrackChanged(const QString& group,
+            TrackPointer pNewTrack,
+            TrackPointer pOldTrack);
+    void slotPlayingTrackChanged(TrackPointer pTrack);
 
   private:
     // Sets the title of this feature to the default name, given by
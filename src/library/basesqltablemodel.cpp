@@ -44,7 +44,7 @@ BaseSqlTableModel::BaseSqlTableModel(
         const char* settingsNamespace)
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
-          m_database(pTrackCollectionManager->internalCollection()->database()),
+          m_database(pTrackCollectionManager->internalCollection()->readOnlyDatabase()),
           m_bInitialized(false) {
 }
 
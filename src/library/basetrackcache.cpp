@@ -13,6 +13,45 @@ namespace {
 
 constexpr bool sDebug = false;
 
+// The sort order of the preview column, which must not be cached
+const QString kRandomOrder = QStringLiteral("RANDOM()");
+
+const ColumnCache::Column kStringColumns[] = {
+        ColumnCache::COLUMN_LIBRARYTABLE_ARTIST,
+        ColumnCache::COLUMN_LIBRARYTABLE_TITLE,
+        ColumnCache::COLUMN_LIBRARYTABLE_ALBUM,
+        ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST,
+        ColumnCache::COLUMN_LIBRARYTABLE_YEAR,
+        ColumnCache::COLUMN_LIBRARYTABLE_GENRE,
+        ColumnCache::COLUMN_LIBRARYTABLE_COMPOSER,
+        ColumnCache::COLUMN_LIBRARYTABLE_GROUPING,
+        ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER,
+        ColumnCache::COLUMN_LIBRARYTABLE_FILETYPE,
+        ColumnCache::COLUMN_LIBRARYTABLE_COMMENT,
+        ColumnCache::COLUMN_LIBRARYTABLE_KEY,
+        ColumnCache::COLUMN_LIBRARYTABLE_COVERART_LOCATION,
+        ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION,
+};
+
+const ColumnCache::Column kNumberColumns[] = {
+        ColumnCache::COLUMN_LIBRARYTABLE_ID,
+        ColumnCache::COLUMN_LIBRARYTABLE_DURATION,
+        ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+        ColumnCache::COLUMN_LIBRARYTABLE_BPM,
+        ColumnCache::COLUMN_LIBRARYTABLE_REPLAYGAIN,
+        ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+        ColumnCache::COLUMN_LIBRARYTABLE_CHANNELS,
+        ColumnCache::COLUMN_LIBRARYTABLE_MIXXXDELETED,
+        ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+        ColumnCache::COLUMN_LIBRARYTABLE_PLAYED,
+        ColumnCache::COLUMN_LIBRARYTABLE_RATING,
+        ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID,
+        ColumnCache::COLUMN_LIBRARYTABLE_BPM_LOCK,
+        ColumnCache::COLUMN_LIBRARYTABLE_COVERART_SOURCE,
+        ColumnCache::COLUMN_LIBRARYTABLE_COVERART_TYPE,
+        ColumnCache::COLUMN_TRACKLOCATIONSTABLE_FSDELETED,
+};
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -25,12 +64,27 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_idColumn(std::move(idColumn)),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
-          m_columnCache(std::move(columns)),
+          m_columnCache(columns),
+          m_trackIndex(std::move(columns)),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_sortedIndexRowsValid(false),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
           m_database(pTrackCollection->database()) {
+    // All other columns store their values unmodified
+    for (const auto column : kStringColumns) {
+        const int index = fieldIndex(column);
+        if (index >= 0) {
+            m_trackIndex.setColumnType(index, ColumnarTrackIndex::ColumnType::String);
+        }
+    }
+    for (const auto column : kNumberColumns) {
+        const int index = fieldIndex(column);
+        if (index >= 0) {
+            m_trackIndex.setColumnType(index, ColumnarTrackIndex::ColumnType::Number);
+        }
+    }
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -77,9 +131,10 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
     for (const auto& trackId : qAsConst(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_trackIndex.removeRow(trackId);
         m_dirtyTracks.remove(trackId);
     }
+    invalidateSortedIndexRows();
 }
 
 void BaseTrackCache::slotTrackDirty(TrackId trackId) {
@@ -99,7 +154,7 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
-    return m_trackInfo.contains(trackId);
+    return m_trackIndex.contains(trackId);
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
@@ -200,14 +255,15 @@ bool BaseTrackCache::updateTrackInIndex(
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        const int row = m_trackIndex.insertRow(trackId);
         for (int i = 0; i < numColumns; ++i) {
-            getTrackValueForColumn(pTrack, i, record[i]);
+            // Columns that are not available from the track object
+            // keep their current value
+            QVariant value = m_trackIndex.value(row, i);
+            getTrackValueForColumn(pTrack, i, value);
+            m_trackIndex.setValue(row, i, value);
         }
+        invalidateSortedIndexRows();
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
         }
@@ -244,23 +300,24 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
 
     int numColumns = columnCount();
     int idColumn = query.record().indexOf(m_idColumn);
+    const int locationColumn = fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
 
+    invalidateSortedIndexRows();
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
-
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
+        VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+            continue;
+        }
+        const int row = m_trackIndex.insertRow(trackId);
 
         for (int i = 0; i < numColumns; ++i) {
-            if (fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION) == i) {
+            if (locationColumn == i) {
                 // Database stores all locations with Qt separators: "/"
                 // Here we want to cache the display string with native separators.
                 QString location = query.value(i).toString();
-                record[i] = QDir::toNativeSeparators(location);
+                m_trackIndex.setValue(row, i, QDir::toNativeSeparators(location));
             } else {
-                record[i] = query.value(i);
+                m_trackIndex.setValue(row, i, query.value(i));
             }
         }
     }
@@ -284,7 +341,7 @@ void BaseTrackCache::buildIndex() {
     // TODO(rryan) for very large tables, it probably makes more sense to NOT
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
-    m_trackInfo.clear();
+    m_trackIndex.clear();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -426,11 +483,10 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // TODO(rryan) this code is flawed for columns that contains row-specific
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
-    if (!result.isValid()) {
-        auto it = m_trackInfo.constFind(trackId);
-        if (it != m_trackInfo.constEnd()) {
-            const QVector<QVariant>& fields = it.value();
-            result = fields.value(column, result);
+    if (!result.isValid() && column >= 0 && column < m_trackIndex.columnCount()) {
+        const int row = m_trackIndex.findRow(trackId);
+        if (row >= 0) {
+            result = m_trackIndex.value(row, column);
         }
     }
     return result;
@@ -452,71 +508,80 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
     QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
+    std::unique_ptr<QueryNode> pQuery;
+    if (extraFilter.isEmpty() && !orderByClause.contains(kRandomOrder)) {
+        // The search query can be evaluated entirely in memory
+        pQuery = m_pQueryParser->parseQuery(searchQuery, QString());
+        filterAndSortIndex(trackIds, *pQuery, orderByClause, trackToIndex);
+    } else {
+        QStringList idStrings;
+        // TODO(rryan) consider making this the data passed in and a separate
+        // QVector for output
+        for (const auto& trackId: trackIds) {
+            idStrings << trackId.toString();
+        }
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
+        QStringList queryFragments;
+        if (!extraFilter.isNull() && extraFilter != "") {
+            queryFragments << QString("(%1)").arg(extraFilter);
+        }
+        if (idStrings.size() > 0) {
+            queryFragments << QString("%1 in (%2)")
+                    .arg(m_idColumn, idStrings.join(","));
+        }
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
+        pQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                queryFragments.join(" AND "));
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+        QString filter = pQuery->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
+        QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+                .arg(m_idColumn, m_tableName, filter, orderByClause);
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+        if (sDebug) {
+            qDebug() << this << "select() executing:" << queryString;
+        }
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+        QSqlQuery query(m_database);
+        // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+        // won't allocate a giant in-memory table that we won't use at all.
+        query.setForwardOnly(true);
+        query.prepare(queryString);
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
-    }
+        int idColumn = query.record().indexOf(m_idColumn);
+        int rows = query.size();
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
+        if (sDebug) {
+            qDebug() << "Rows returned:" << rows;
+        }
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+        m_trackOrder.resize(0); // keeps allocated memory
+        trackToIndex->clear();
+        if (rows > 0) {
+            trackToIndex->reserve(rows);
+            m_trackOrder.reserve(rows);
+        }
+
+        while (query.next()) {
+            TrackId trackId(query.value(idColumn));
+            (*trackToIndex)[trackId] = m_trackOrder.size();
+            m_trackOrder.append(trackId);
+        }
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -594,6 +659,80 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+void BaseTrackCache::filterAndSortIndex(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause,
+        QHash<TrackId, int>* trackToIndex) {
+    PerformanceTimer timer;
+    timer.start();
+
+    const QVector<int>& sortedRows = sortedIndexRows(orderByClause);
+
+    m_trackOrder.resize(0); // keeps allocated memory
+    trackToIndex->clear();
+    trackToIndex->reserve(trackIds.size());
+    m_trackOrder.reserve(trackIds.size());
+
+    for (const int row : sortedRows) {
+        const TrackId trackId = m_trackIndex.trackId(row);
+        if (!trackIds.contains(trackId) || !query.match(m_trackIndex, row)) {
+            continue;
+        }
+        (*trackToIndex)[trackId] = m_trackOrder.size();
+        m_trackOrder.append(trackId);
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortIndex took"
+                 << timer.elapsed().debugMillisWithUnit()
+                 << "for" << m_trackOrder.size() << "of" << trackIds.size()
+                 << "tracks";
+    }
+}
+
+const QVector<int>& BaseTrackCache::sortedIndexRows(const QString& orderByClause) {
+    if (m_sortedIndexRowsValid && m_sortedIndexRowsOrderBy == orderByClause) {
+        return m_sortedIndexRows;
+    }
+
+    PerformanceTimer timer;
+    timer.start();
+
+    // Let the database sort all tracks once to get exactly the same
+    // order as when filtering with SQL, including all collations.
+    QString queryString = QString("SELECT %1 FROM %2 %3")
+            .arg(m_idColumn, m_tableName, orderByClause);
+
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(queryString);
+
+    m_sortedIndexRows.resize(0); // keeps allocated memory
+    m_sortedIndexRows.reserve(m_trackIndex.size());
+    if (query.exec()) {
+        const int idColumn = query.record().indexOf(m_idColumn);
+        while (query.next()) {
+            const int row = m_trackIndex.findRow(TrackId(query.value(idColumn)));
+            if (row >= 0) {
+                m_sortedIndexRows.append(row);
+            }
+        }
+    } else {
+        LOG_FAILED_QUERY(query);
+    }
+    m_sortedIndexRowsOrderBy = orderByClause;
+    m_sortedIndexRowsValid = true;
+
+    if (sDebug) {
+        qDebug() << this << "sortedIndexRows took" << timer.elapsed().debugMillisWithUnit();
+    }
+    return m_sortedIndexRows;
+}
+
+void BaseTrackCache::invalidateSortedIndexRows() {
+    m_sortedIndexRowsValid = false;
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -624,7 +763,7 @@ int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
 
         // This should not happen, but it's a recoverable error so we should
         // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
+        if (!m_trackIndex.contains(otherTrackId)) {
             qDebug() << "WARNING: track" << otherTrackId << "was not in index";
             //updateTrackInIndex(otherTrackId);
         }
@@ -10,12 +10,14 @@
 #include <QVector>
 #include <memory>
 
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -99,6 +101,15 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    // Filters the tracks in memory and sorts them according to the
+    // cached order of all tracks in the index.
+    void filterAndSortIndex(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause,
+            QHash<TrackId, int>* trackToIndex);
+    const QVector<int>& sortedIndexRows(const QString& orderByClause);
+    void invalidateSortedIndexRows();
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -122,6 +133,8 @@ class BaseTrackCache : public QObject {
 
     const ColumnCache m_columnCache;
 
+    ColumnarTrackIndex m_trackIndex;
+
     const std::unique_ptr<SearchQueryParser> m_pQueryParser;
 
     const mixxx::StringCollator m_collator;
@@ -130,6 +143,14 @@ class BaseTrackCache : public QObject {
 
     QVector<TrackId> m_trackOrder;
 
+    // The rows of all tracks in the index sorted by the ORDER BY clause
+    // of the most recent in-memory search. Sorting is delegated to the
+    // database once and only repeated after the index has been modified,
+    // i.e. not for every modification of the search query.
+    QString m_sortedIndexRowsOrderBy;
+    QVector<int> m_sortedIndexRows;
+    bool m_sortedIndexRowsValid;
+
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
     // of a single row. These members serve as a single-valued private cache.
@@ -144,7 +165,6 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant>> m_trackInfo;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
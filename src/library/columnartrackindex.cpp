@@ -0,0 +1,251 @@
+#include "library/columnartrackindex.h"
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+// Negative tags for cells that don't contain a packed value
+constexpr int kInvalidValue = -1;
+constexpr int kNullString = -2;
+constexpr int kOtherValue = -3;
+
+int tagForUnpackedValue(const QVariant& value) {
+    if (!value.isValid()) {
+        return kInvalidValue;
+    }
+    if (value.userType() == QMetaType::QString && value.toString().isNull()) {
+        return kNullString;
+    }
+    return kOtherValue;
+}
+
+// Only numbers that can be restored exactly are packed
+bool packNumber(const QVariant& value, double* pNumber) {
+    if (value.isNull()) {
+        return false;
+    }
+    switch (value.userType()) {
+    case QMetaType::Bool:
+        *pNumber = value.toBool() ? 1.0 : 0.0;
+        return true;
+    case QMetaType::Int:
+        *pNumber = value.toInt();
+        return true;
+    case QMetaType::UInt:
+        *pNumber = value.toUInt();
+        return true;
+    case QMetaType::LongLong: {
+        const qlonglong number = value.toLongLong();
+        *pNumber = static_cast<double>(number);
+        return static_cast<qlonglong>(*pNumber) == number;
+    }
+    case QMetaType::ULongLong: {
+        const qulonglong number = value.toULongLong();
+        *pNumber = static_cast<double>(number);
+        return static_cast<qulonglong>(*pNumber) == number;
+    }
+    case QMetaType::Float:
+    case QMetaType::Double:
+        *pNumber = value.toDouble();
+        return true;
+    default:
+        return false;
+    }
+}
+
+QVariant unpackNumber(double number, int metaType) {
+    switch (metaType) {
+    case QMetaType::Bool:
+        return QVariant(number != 0.0);
+    case QMetaType::Int:
+        return QVariant(static_cast<int>(number));
+    case QMetaType::UInt:
+        return QVariant(static_cast<uint>(number));
+    case QMetaType::LongLong:
+        return QVariant(static_cast<qlonglong>(number));
+    case QMetaType::ULongLong:
+        return QVariant(static_cast<qulonglong>(number));
+    case QMetaType::Float:
+        return QVariant(static_cast<float>(number));
+    case QMetaType::Double:
+        return QVariant(number);
+    default:
+        DEBUG_ASSERT(!"unreachable");
+        return QVariant();
+    }
+}
+
+} // namespace
+
+ColumnarTrackIndex::ColumnarTrackIndex(QStringList columnNames)
+        : m_columns(columnNames.size()) {
+    for (int i = 0; i < columnNames.size(); ++i) {
+        m_columnIndices.insert(columnNames[i], i);
+    }
+}
+
+void ColumnarTrackIndex::setColumnType(int column, ColumnType type) {
+    Column& col = m_columns[column];
+    if (col.type == type) {
+        return;
+    }
+    const int rowCount = static_cast<int>(m_rowTrackIds.size());
+    col = Column();
+    col.type = type;
+    resizeColumn(&col, rowCount);
+}
+
+void ColumnarTrackIndex::resizeColumn(Column* pColumn, int rowCount) {
+    switch (pColumn->type) {
+    case ColumnType::String:
+        pColumn->strings.resize(rowCount, kInvalidValue);
+        break;
+    case ColumnType::Number:
+        pColumn->numbers.resize(rowCount, 0.0);
+        pColumn->numberTypes.resize(rowCount, kInvalidValue);
+        break;
+    case ColumnType::Variant:
+        pColumn->variants.resize(rowCount);
+        break;
+    }
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        const ColumnType type = column.type;
+        column = Column();
+        column.type = type;
+    }
+    m_rows.clear();
+    m_rowTrackIds.clear();
+    m_freeRows.clear();
+    m_stringIds.clear();
+    m_strings.clear();
+    m_foldedStrings.clear();
+}
+
+int ColumnarTrackIndex::insertRow(TrackId trackId) {
+    DEBUG_ASSERT(trackId.isValid());
+    const auto it = m_rows.constFind(trackId);
+    if (it != m_rows.constEnd()) {
+        return it.value();
+    }
+    int row;
+    if (m_freeRows.empty()) {
+        row = static_cast<int>(m_rowTrackIds.size());
+        m_rowTrackIds.push_back(trackId);
+        for (auto& column : m_columns) {
+            resizeColumn(&column, row + 1);
+        }
+    } else {
+        row = m_freeRows.back();
+        m_freeRows.pop_back();
+        m_rowTrackIds[row] = trackId;
+    }
+    m_rows.insert(trackId, row);
+    return row;
+}
+
+void ColumnarTrackIndex::removeRow(TrackId trackId) {
+    const auto it = m_rows.find(trackId);
+    if (it == m_rows.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rows.erase(it);
+    for (int column = 0; column < columnCount(); ++column) {
+        setValue(row, column, QVariant());
+    }
+    m_rowTrackIds[row] = TrackId();
+    m_freeRows.push_back(row);
+}
+
+QVariant ColumnarTrackIndex::value(int row, int column) const {
+    const Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::String: {
+        const int stringId = col.strings[row];
+        if (stringId >= 0) {
+            return m_strings[stringId];
+        }
+        switch (stringId) {
+        case kNullString:
+            return QString();
+        case kOtherValue:
+            return col.otherValues.value(row);
+        default:
+            return QVariant();
+        }
+    }
+    case ColumnType::Number: {
+        const int metaType = col.numberTypes[row];
+        if (metaType >= 0) {
+            return unpackNumber(col.numbers[row], metaType);
+        }
+        switch (metaType) {
+        case kNullString:
+            return QString();
+        case kOtherValue:
+            return col.otherValues.value(row);
+        default:
+            return QVariant();
+        }
+    }
+    case ColumnType::Variant:
+        return col.variants[row];
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QVariant();
+}
+
+void ColumnarTrackIndex::setValue(int row, int column, const QVariant& value) {
+    Column& col = m_columns[column];
+    switch (col.type) {
+    case ColumnType::String: {
+        if (col.strings[row] == kOtherValue) {
+            col.otherValues.remove(row);
+        }
+        if (value.userType() == QMetaType::QString && !value.toString().isNull()) {
+            col.strings[row] = internString(value.toString());
+            return;
+        }
+        col.strings[row] = tagForUnpackedValue(value);
+        break;
+    }
+    case ColumnType::Number: {
+        if (col.numberTypes[row] == kOtherValue) {
+            col.otherValues.remove(row);
+        }
+        double number;
+        if (packNumber(value, &number)) {
+            col.numbers[row] = number;
+            col.numberTypes[row] = value.userType();
+            return;
+        }
+        col.numbers[row] = 0.0;
+        col.numberTypes[row] = tagForUnpackedValue(value);
+        break;
+    }
+    case ColumnType::Variant:
+        col.variants[row] = value;
+        return;
+    }
+    if (tagForUnpackedValue(value) == kOtherValue) {
+        col.otherValues.insert(row, value);
+    }
+}
+
+int ColumnarTrackIndex::internString(const QString& string) {
+    const auto it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    const int stringId = m_strings.size();
+    m_strings.append(string);
+    QString foldedString = string;
+    mixxx::DbConnection::makeStringLatinLow(&foldedString);
+    m_foldedStrings.append(foldedString);
+    m_stringIds.insert(string, stringId);
+    return stringId;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <vector>
+
+#include "track/trackid.h"
+
+// An in-memory table of track properties that is organized in columns
+// instead of rows.
+//
+// Text columns only store indices into a pool of interned strings. Each
+// distinct string is stored once together with its case-folded search key
+// that is prepared for comparisons with the LIKE operator of the database.
+// Numeric columns are packed into contiguous arrays. Values that don't fit
+// the type of their column are kept aside and returned unmodified, i.e.
+// value() always returns exactly what has been passed to setValue().
+class ColumnarTrackIndex {
+  public:
+    enum class ColumnType {
+        Variant,
+        String,
+        Number,
+    };
+
+    // The string id of cells that don't contain an interned string
+    static constexpr int kNoString = -1;
+
+    explicit ColumnarTrackIndex(QStringList columnNames);
+
+    // Changing the type of a column discards all of its values
+    void setColumnType(int column, ColumnType type);
+    ColumnType columnType(int column) const {
+        return m_columns[column].type;
+    }
+
+    int columnCount() const {
+        return static_cast<int>(m_columns.size());
+    }
+    // Returns -1 if the column does not exist
+    int columnIndex(const QString& columnName) const {
+        return m_columnIndices.value(columnName, -1);
+    }
+
+    // The number of rows
+    int size() const {
+        return m_rows.size();
+    }
+
+    void clear();
+
+    bool contains(TrackId trackId) const {
+        return m_rows.contains(trackId);
+    }
+
+    // Returns -1 if no row exists for the track
+    int findRow(TrackId trackId) const {
+        return m_rows.value(trackId, -1);
+    }
+
+    // Returns the existing row of the track or inserts a new
+    // row with all values set to invalid
+    int insertRow(TrackId trackId);
+
+    void removeRow(TrackId trackId);
+
+    TrackId trackId(int row) const {
+        return m_rowTrackIds[row];
+    }
+
+    QVariant value(int row, int column) const;
+    void setValue(int row, int column, const QVariant& value);
+
+    // Returns the id of the interned string of a cell in a text column
+    // or kNoString for all other values.
+    int stringId(int row, int column) const {
+        const Column& col = m_columns[column];
+        if (col.type != ColumnType::String) {
+            return kNoString;
+        }
+        const int stringId = col.strings[row];
+        return stringId >= 0 ? stringId : kNoString;
+    }
+
+    // The upper bound for all string ids
+    int stringCount() const {
+        return m_strings.size();
+    }
+
+    // The string in lower case without diacritics
+    const QString& foldedString(int stringId) const {
+        return m_foldedStrings[stringId];
+    }
+
+  private:
+    struct Column {
+        ColumnType type = ColumnType::Variant;
+        // String: The id of the interned string or a negative tag
+        std::vector<int> strings;
+        // Number: The packed value and either its QMetaType id
+        // or a negative tag
+        std::vector<double> numbers;
+        std::vector<int> numberTypes;
+        // String, Number: Values that don't fit the type of the column
+        QHash<int, QVariant> otherValues;
+        // Variant: All values
+        std::vector<QVariant> variants;
+    };
+
+    void resizeColumn(Column* pColumn, int rowCount);
+    int internString(const QString& string);
+
+    QHash<QString, int> m_columnIndices;
+    std::vector<Column> m_columns;
+
+    QHash<TrackId, int> m_rows;
+    std::vector<TrackId> m_rowTrackIds;
+    // Rows of removed tracks that are reused for new tracks
+    std::vector<int> m_freeRows;
+
+    QHash<QString, int> m_stringIds;
+    QVector<QString> m_strings;
+    QVector<QString> m_foldedStrings;
+};
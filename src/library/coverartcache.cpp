@@ -5,6 +5,7 @@
 #include <QtConcurrentRun>
 #include <QtDebug>
 
+#include "library/coverartdiskcache.h"
 #include "library/coverartutils.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
@@ -43,6 +44,11 @@ CoverArtCache::CoverArtCache() {
     QPixmapCache::setCacheLimit(kPixmapCacheLimit);
 }
 
+CoverArtCache::~CoverArtCache() {
+    // The worker accesses the CoverArtDiskCache that is destroyed afterwards
+    m_prefetchFuture.waitForFinished();
+}
+
 //static
 void CoverArtCache::requestCover(
         const QObject* pRequester,
@@ -180,6 +186,24 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             signalWhenDone);
     DEBUG_ASSERT(!res.coverInfoUpdated);
 
+    // Thumbnails that have been scaled before are stored on disk, keyed
+    // by the image digest. This avoids decoding the full-size image.
+    CoverArtDiskCache* const pDiskCache = CoverArtDiskCache::instance();
+    if (pDiskCache && desiredWidth > 0) {
+        QImage thumbnail = pDiskCache->load(res.requestedCacheKey, desiredWidth);
+        if (!thumbnail.isNull()) {
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(thumbnail);
+            loadedImage.location = pDiskCache->entryFilePath(
+                    res.requestedCacheKey, desiredWidth);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     auto loadedImage = coverInfo.loadImage(
             pTrack ? pTrack->getFileAccess().token() : SecurityTokenPointer());
     if (!loadedImage.image.isNull()) {
@@ -197,6 +221,9 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             // Adjust the cover size according to the request
             // or downsize the image for efficiency.
             loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            if (pDiskCache) {
+                pDiskCache->save(coverInfo.cacheKey(), loadedImage.image);
+            }
         }
     }
 
@@ -207,6 +234,62 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     return res;
 }
 
+void CoverArtCache::prefetchCovers(
+        const QList<CoverInfo>& coverInfos,
+        int desiredWidth) {
+    CoverArtDiskCache* const pDiskCache = CoverArtDiskCache::instance();
+    if (!pDiskCache || desiredWidth <= 0 || m_prefetchFuture.isRunning()) {
+        return;
+    }
+    QList<CoverInfo> missingCoverInfos;
+    for (const auto& coverInfo : coverInfos) {
+        const auto cacheKey = coverInfo.cacheKey();
+        // Covers without a digest are only loaded on demand, because
+        // the updated cover info needs to be stored in the track
+        if (coverInfo.type == CoverInfo::NONE ||
+                !mixxx::isValidCacheKey(cacheKey) ||
+                QPixmapCache::find(pixmapCacheKey(cacheKey, desiredWidth), nullptr) ||
+                pDiskCache->contains(cacheKey, desiredWidth)) {
+            continue;
+        }
+        missingCoverInfos.append(coverInfo);
+    }
+    if (missingCoverInfos.isEmpty()) {
+        return;
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Prefetching"
+                << missingCoverInfos.size()
+                << "covers";
+    }
+    // A single task for the whole batch keeps the thread pool
+    // available for the covers that are requested for painting
+    m_prefetchFuture = QtConcurrent::run(
+            &CoverArtCache::prefetchThumbnails,
+            std::move(missingCoverInfos),
+            desiredWidth);
+}
+
+//static
+void CoverArtCache::prefetchThumbnails(
+        QList<CoverInfo> coverInfos,
+        int desiredWidth) {
+    CoverArtDiskCache* const pDiskCache = CoverArtDiskCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pDiskCache) {
+        return;
+    }
+    for (const auto& coverInfo : qAsConst(coverInfos)) {
+        const auto loadedImage = coverInfo.loadImage(SecurityTokenPointer());
+        if (loadedImage.image.isNull()) {
+            continue;
+        }
+        pDiskCache->save(
+                coverInfo.cacheKey(),
+                resizeImageWidth(loadedImage.image, desiredWidth));
+    }
+}
+
 // watcher
 void CoverArtCache::coverLoaded() {
     FutureResult res;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QFuture>
+#include <QList>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
@@ -52,6 +54,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
                 loading);
     }
 
+    /// Scales the given covers to the desired width and stores the
+    /// thumbnails in the CoverArtDiskCache in a worker thread, without
+    /// signaling. Covers that are already cached are skipped. The request
+    /// is dropped if the previous one is still running.
+    void prefetchCovers(
+            const QList<CoverInfo>& coverInfos,
+            int desiredWidth);
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -100,7 +110,7 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
 
   protected:
     CoverArtCache();
-    ~CoverArtCache() override = default;
+    ~CoverArtCache() override;
     friend class Singleton<CoverArtCache>;
 
   private:
@@ -116,7 +126,12 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             int desiredWidth,
             Loading loading);
 
+    static void prefetchThumbnails(
+            QList<CoverInfo> coverInfos,
+            int desiredWidth);
+
     QSet<QPair<const QObject*, mixxx::cache_key_t>> m_runningRequests;
+    QFuture<void> m_prefetchFuture;
 };
 
 inline
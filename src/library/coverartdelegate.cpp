@@ -10,6 +10,7 @@
 #include "track/track.h"
 #include "util/logger.h"
 #include "util/make_const_iterator.h"
+#include "util/math.h"
 
 namespace {
 
@@ -29,7 +30,9 @@ CoverArtDelegate::CoverArtDelegate(QTableView* parent)
         : TableItemDelegate(parent),
           m_pTrackModel(asTrackModel(parent)),
           m_pCache(CoverArtCache::instance()),
-          m_inhibitLazyLoading(false) {
+          m_inhibitLazyLoading(false),
+          m_lastPaintedColumn(-1),
+          m_lastPaintedWidth(0) {
     if (m_pCache) {
         connect(m_pCache,
                 &CoverArtCache::coverFound,
@@ -62,7 +65,11 @@ void CoverArtDelegate::emitRowsChanged(
 void CoverArtDelegate::slotInhibitLazyLoading(
         bool inhibitLazyLoading) {
     m_inhibitLazyLoading = inhibitLazyLoading;
-    if (m_inhibitLazyLoading || m_cacheMissRows.isEmpty()) {
+    if (m_inhibitLazyLoading) {
+        return;
+    }
+    prefetchAdjacentRows();
+    if (m_cacheMissRows.isEmpty()) {
         return;
     }
     // If we can request non-cache covers now, request updates
@@ -106,6 +113,49 @@ void CoverArtDelegate::slotCoverFound(
     }
 }
 
+void CoverArtDelegate::prefetchAdjacentRows() {
+    if (!m_pCache || m_lastPaintedColumn < 0 || m_lastPaintedWidth <= 0) {
+        return;
+    }
+    auto* pTableView = qobject_cast<QTableView*>(parent());
+    VERIFY_OR_DEBUG_ASSERT(pTableView) {
+        return;
+    }
+    const QAbstractItemModel* pModel = pTableView->model();
+    if (!pModel) {
+        return;
+    }
+    const int rowCount = pModel->rowCount();
+    const int firstVisibleRow = pTableView->rowAt(0);
+    if (firstVisibleRow < 0) {
+        return;
+    }
+    int lastVisibleRow = pTableView->rowAt(pTableView->viewport()->height() - 1);
+    if (lastVisibleRow < 0) {
+        lastVisibleRow = rowCount - 1;
+    }
+    // One page in each direction
+    const int pageRows = lastVisibleRow - firstVisibleRow + 1;
+    QList<CoverInfo> coverInfos;
+    const auto appendCoverInfo = [&](int row) {
+        const CoverInfo coverInfo = m_pTrackModel->getCoverInfo(
+                pModel->index(row, m_lastPaintedColumn));
+        if (coverInfo.hasImage()) {
+            coverInfos.append(coverInfo);
+        }
+    };
+    // Scrolling down is more common, so these are prefetched first
+    const int endRow = math_min(lastVisibleRow + 1 + pageRows, rowCount);
+    for (int row = lastVisibleRow + 1; row < endRow; ++row) {
+        appendCoverInfo(row);
+    }
+    const int beginRow = math_max(firstVisibleRow - pageRows, 0);
+    for (int row = firstVisibleRow - 1; row >= beginRow; --row) {
+        appendCoverInfo(row);
+    }
+    m_pCache->prefetchCovers(coverInfos, m_lastPaintedWidth);
+}
+
 TrackPointer CoverArtDelegate::loadTrackByLocation(
         const QString& trackLocation) const {
     VERIFY_OR_DEBUG_ASSERT(m_pTrackModel) {
@@ -131,9 +181,12 @@ void CoverArtDelegate::paintItem(
             return;
         }
         const double scaleFactor = qobject_cast<QWidget*>(parent())->devicePixelRatioF();
+        const int width = static_cast<int>(option.rect.width() * scaleFactor);
+        m_lastPaintedColumn = index.column();
+        m_lastPaintedWidth = width;
         QPixmap pixmap = m_pCache->tryLoadCover(this,
                 coverInfo,
-                static_cast<int>(option.rect.width() * scaleFactor),
+                width,
                 m_inhibitLazyLoading ? CoverArtCache::Loading::CachedOnly
                                      : CoverArtCache::Loading::Default);
         if (pixmap.isNull()) {
@@ -62,9 +62,19 @@ class CoverArtDelegate : public TableItemDelegate {
     TrackPointer loadTrackByLocation(
             const QString& trackLocation) const;
 
+    // Prefetches the thumbnails of the rows above and below
+    // the visible rows in the background, i.e. those that
+    // become visible when scrolling further.
+    void prefetchAdjacentRows();
+
     CoverArtCache* const m_pCache;
     bool m_inhibitLazyLoading;
 
+    // The column and width (in physical pixels) of the most
+    // recently painted cover, needed for prefetching.
+    mutable int m_lastPaintedColumn;
+    mutable int m_lastPaintedWidth;
+
     // We need to record rows in paint() (which is const) so
     // these are marked mutable.
     mutable QList<int> m_cacheMissRows;
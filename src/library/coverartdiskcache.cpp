@@ -0,0 +1,198 @@
+#include "library/coverartdiskcache.h"
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <vector>
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtDiskCache");
+
+const QString kConfigGroup = QStringLiteral("[CoverArtDiskCache]");
+const ConfigKey kEnabledConfigKey(kConfigGroup, QStringLiteral("Enabled"));
+const ConfigKey kMaxSizeMiBConfigKey(kConfigGroup, QStringLiteral("MaxSizeMiB"));
+
+constexpr bool kEnabledDefault = true;
+// Enough for the thumbnails of more than 100k tracks
+constexpr int kMaxSizeMiBDefault = 512;
+
+const QString kDirectoryName = QStringLiteral("cover_art_cache");
+const QString kFileNameSuffix = QStringLiteral(".jpg");
+constexpr const char* kImageFormat = "JPG";
+constexpr int kImageQuality = 90;
+
+// Evicting down to a lower watermark keeps the number of directory
+// scans low while the cache is full
+constexpr quint64 kEvictionTargetPercent = 90;
+
+} // anonymous namespace
+
+// static
+CoverArtDiskCache* CoverArtDiskCache::s_pInstance = nullptr;
+
+// static
+void CoverArtDiskCache::createInstance(
+        const UserSettingsPointer& pConfig) {
+    DEBUG_ASSERT(!s_pInstance);
+    if (!pConfig->getValue(kEnabledConfigKey, kEnabledDefault)) {
+        return;
+    }
+    const QDir directory(QDir(pConfig->getSettingsPath()).filePath(kDirectoryName));
+    if (!directory.exists() && !QDir().mkpath(directory.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << directory.absolutePath();
+        return;
+    }
+    const int maxSizeMiB = pConfig->getValue(kMaxSizeMiBConfigKey, kMaxSizeMiBDefault);
+    s_pInstance = new CoverArtDiskCache(
+            directory,
+            static_cast<quint64>(math_max(maxSizeMiB, 1)) * 1024 * 1024);
+}
+
+// static
+void CoverArtDiskCache::destroyInstance() {
+    delete s_pInstance;
+    s_pInstance = nullptr;
+}
+
+CoverArtDiskCache::CoverArtDiskCache(
+        const QDir& directory,
+        quint64 maxSizeInBytes)
+        : m_directory(directory),
+          m_maxSizeInBytes(maxSizeInBytes),
+          m_estimatedSizeInBytes(-1) {
+}
+
+QString CoverArtDiskCache::entryFilePath(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    const QString hexKey = QStringLiteral("%1").arg(cacheKey, 16, 16, QLatin1Char('0'));
+    // Spread the entries over 256 subdirectories to keep directory
+    // lookups fast for large libraries
+    return m_directory.filePath(hexKey.left(2) + QChar('/') + hexKey +
+            QChar('_') + QString::number(width) + kFileNameSuffix);
+}
+
+bool CoverArtDiskCache::contains(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    return QFileInfo::exists(entryFilePath(cacheKey, width));
+}
+
+QImage CoverArtDiskCache::load(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    if (!mixxx::isValidCacheKey(cacheKey) || width <= 0) {
+        return QImage();
+    }
+    QFile file(entryFilePath(cacheKey, width));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+    const QImage image = QImage::fromData(file.readAll(), kImageFormat);
+    if (image.isNull() || image.width() != width) {
+        kLogger.warning()
+                << "Discarding invalid entry"
+                << file.fileName();
+        file.remove();
+        return QImage();
+    }
+    // Mark as recently used
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return image;
+}
+
+bool CoverArtDiskCache::save(
+        mixxx::cache_key_t cacheKey,
+        const QImage& image) {
+    if (!mixxx::isValidCacheKey(cacheKey) || image.isNull()) {
+        return false;
+    }
+    const QString filePath = entryFilePath(cacheKey, image.width());
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+        return false;
+    }
+    // Concurrent writers of the same entry replace it atomically
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            !image.save(&file, kImageFormat, kImageQuality) ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write entry"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+
+    bool evictionNeeded;
+    {
+        const auto locker = lockMutex(&m_mutex);
+        if (m_estimatedSizeInBytes < 0) {
+            m_estimatedSizeInBytes = static_cast<qint64>(sizeInBytes());
+        } else {
+            m_estimatedSizeInBytes += QFileInfo(filePath).size();
+        }
+        evictionNeeded = static_cast<quint64>(m_estimatedSizeInBytes) > m_maxSizeInBytes;
+    }
+    if (evictionNeeded) {
+        evict();
+    }
+    return true;
+}
+
+quint64 CoverArtDiskCache::sizeInBytes() const {
+    quint64 sizeInBytes = 0;
+    QDirIterator it(m_directory.absolutePath(),
+            QStringList{QStringLiteral("*") + kFileNameSuffix},
+            QDir::Files,
+            QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        sizeInBytes += static_cast<quint64>(it.fileInfo().size());
+    }
+    return sizeInBytes;
+}
+
+void CoverArtDiskCache::evict() {
+    const auto locker = lockMutex(&m_mutex);
+    std::vector<QFileInfo> entries;
+    quint64 sizeInBytes = 0;
+    QDirIterator it(m_directory.absolutePath(),
+            QStringList{QStringLiteral("*") + kFileNameSuffix},
+            QDir::Files,
+            QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        entries.push_back(it.fileInfo());
+        sizeInBytes += static_cast<quint64>(entries.back().size());
+    }
+    if (sizeInBytes > m_maxSizeInBytes) {
+        const quint64 targetSizeInBytes = m_maxSizeInBytes / 100 * kEvictionTargetPercent;
+        std::sort(entries.begin(),
+                entries.end(),
+                [](const QFileInfo& lhs, const QFileInfo& rhs) {
+                    return lhs.lastModified() < rhs.lastModified();
+                });
+        for (const auto& entry : entries) {
+            if (sizeInBytes <= targetSizeInBytes) {
+                break;
+            }
+            if (QFile::remove(entry.absoluteFilePath())) {
+                sizeInBytes -= static_cast<quint64>(entry.size());
+            }
+        }
+        kLogger.debug()
+                << "Evicted entries, remaining size"
+                << sizeInBytes;
+    }
+    m_estimatedSizeInBytes = static_cast<qint64>(sizeInBytes);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QDir>
+#include <QImage>
+#include <QMutex>
+
+#include "preferences/usersettings.h"
+#include "util/cache.h"
+
+/// A size-bounded store of scaled cover art thumbnails on disk.
+///
+/// Decoding the full-size cover image of a track is expensive. The
+/// thumbnails that are displayed in the library table are therefore
+/// stored on disk and survive a restart. Entries are addressed by the
+/// cache key of the image digest and the width of the thumbnail. A
+/// modified cover image has a different digest and thus never matches
+/// an outdated entry.
+///
+/// When the total size of all entries exceeds the configured limit the
+/// least recently used entries are deleted. Loading an entry touches
+/// its modification time.
+///
+/// All functions are thread-safe.
+class CoverArtDiskCache final {
+  public:
+    /// Creates the global instance if enabled in the configuration.
+    static void createInstance(
+            const UserSettingsPointer& pConfig);
+    static void destroyInstance();
+
+    /// Returns nullptr if the cache is disabled.
+    static CoverArtDiskCache* instance() {
+        return s_pInstance;
+    }
+
+    CoverArtDiskCache(
+            const QDir& directory,
+            quint64 maxSizeInBytes);
+
+    /// Returns the file path of the entry, even if it doesn't exist.
+    QString entryFilePath(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    bool contains(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    /// Returns a null image if no entry exists.
+    QImage load(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    bool save(
+            mixxx::cache_key_t cacheKey,
+            const QImage& image);
+
+    /// The total size of all cache entries.
+    quint64 sizeInBytes() const;
+
+    /// Deletes the least recently used entries until the total size
+    /// of all entries is well below the limit.
+    void evict();
+
+  private:
+    static CoverArtDiskCache* s_pInstance;
+
+    const QDir m_directory;
+    const quint64 m_maxSizeInBytes;
+
+    // Serializes eviction
+    QMutex m_mutex;
+    // Estimated from the entries that have been saved since the last
+    // eviction, to avoid scanning the directory after each write.
+    // Negative until the directory has been scanned.
+    qint64 m_estimatedSizeInBytes;
+};
@@ -10,6 +10,7 @@
 #include "util/assert.h"
 #include "util/color/rgbcolor.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/sqlstatementcache.h"
 #include "util/logger.h"
 #include "util/performancetimer.h"
 
@@ -155,45 +156,44 @@ bool CueDAO::saveCue(TrackId trackId, Cue* cue) const {
         return false;
     }
 
-    // Prepare query
-    QSqlQuery query(m_database);
+    // Prepare query, the statements are reused for all cues
+    mixxx::CachedSqlQuery query(m_database,
+            cue->getId().isValid()
+                    // Update cue
+                    ? QStringLiteral("UPDATE " CUE_TABLE " SET "
+                                     "track_id=:track_id,"
+                                     "type=:type,"
+                                     "position=:position,"
+                                     "length=:length,"
+                                     "hotcue=:hotcue,"
+                                     "label=:label,"
+                                     "color=:color"
+                                     " WHERE id=:id")
+                    // New cue
+                    : QStringLiteral("INSERT INTO " CUE_TABLE
+                                     " (track_id, type, position, length, hotcue, "
+                                     "label, color) VALUES (:track_id, :type, "
+                                     ":position, :length, :hotcue, :label, :color)"));
     if (cue->getId().isValid()) {
-        // Update cue
-        query.prepare(QStringLiteral("UPDATE " CUE_TABLE " SET "
-                        "track_id=:track_id,"
-                        "type=:type,"
-                        "position=:position,"
-                        "length=:length,"
-                        "hotcue=:hotcue,"
-                        "label=:label,"
-                        "color=:color"
-                        " WHERE id=:id"));
-        query.bindValue(":id", cue->getId().toVariant());
-    } else {
-        // New cue
-        query.prepare(
-                QStringLiteral("INSERT INTO " CUE_TABLE
-                               " (track_id, type, position, length, hotcue, "
-                               "label, color) VALUES (:track_id, :type, "
-                               ":position, :length, :hotcue, :label, :color)"));
+        query->bindValue(":id", cue->getId().toVariant());
     }
 
     // Bind values and execute query
-    query.bindValue(":track_id", trackId.toVariant());
-    query.bindValue(":type", static_cast<int>(cue->getType()));
-    query.bindValue(":position", cue->getPosition().toEngineSamplePosMaybeInvalid());
-    query.bindValue(":length", cue->getLengthFrames() * mixxx::kEngineChannelCount);
-    query.bindValue(":hotcue", cue->getHotCue());
-    query.bindValue(":label", labelToQVariant(cue->getLabel()));
-    query.bindValue(":color", mixxx::RgbColor::toQVariant(cue->getColor()));
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    query->bindValue(":track_id", trackId.toVariant());
+    query->bindValue(":type", static_cast<int>(cue->getType()));
+    query->bindValue(":position", cue->getPosition().toEngineSamplePosMaybeInvalid());
+    query->bindValue(":length", cue->getLengthFrames() * mixxx::kEngineChannelCount);
+    query->bindValue(":hotcue", cue->getHotCue());
+    query->bindValue(":label", labelToQVariant(cue->getLabel()));
+    query->bindValue(":color", mixxx::RgbColor::toQVariant(cue->getColor()));
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
         return false;
     }
 
     if (!cue->getId().isValid()) {
         // New cue
-        const auto newId = DbId(query.lastInsertId());
+        const auto newId = DbId(query->lastInsertId());
         DEBUG_ASSERT(newId.isValid());
         cue->setId(newId);
     }
@@ -11,9 +11,22 @@
 #include "track/track.h"
 #include "util/db/dbconnection.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/sqlstatementcache.h"
 #include "util/make_const_iterator.h"
 #include "util/math.h"
 
+namespace {
+
+const QString kInsertTrackWithTimestampStatement = QStringLiteral(
+        "INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
+        "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)");
+
+const QString kMoveTracksUpStatement = QStringLiteral(
+        "UPDATE PlaylistTracks SET position=position+1 "
+        "WHERE position>=:position AND playlist_id=:id");
+
+} // anonymous namespace
+
 PlaylistDAO::PlaylistDAO()
         : m_pAutoDJProcessor(nullptr) {
 }
@@ -419,18 +432,15 @@ bool PlaylistDAO::appendTracksToPlaylist(const QList<TrackId>& trackIds, const i
     ++position;
 
     //Insert the song into the PlaylistTracks table
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
-            "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)"));
-    query.bindValue(":playlist_id", playlistId);
+    mixxx::CachedSqlQuery query(m_database, kInsertTrackWithTimestampStatement);
+    query->bindValue(":playlist_id", playlistId);
 
     int insertPosition = position;
     for (const auto& trackId : trackIds) {
-        query.bindValue(":track_id", trackId.toVariant());
-        query.bindValue(":position", insertPosition++);
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
+        query->bindValue(":track_id", trackId.toVariant());
+        query->bindValue(":position", insertPosition++);
+        if (!query->exec()) {
+            LOG_FAILED_QUERY(*query);
             return false;
         }
     }
@@ -698,28 +708,23 @@ bool PlaylistDAO::insertTrackIntoPlaylist(TrackId trackId, const int playlistId,
     }
 
     // Move all the tracks in the playlist up by one
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "UPDATE PlaylistTracks SET position=position+1 "
-            "WHERE position>=:position AND playlist_id=:id"));
-    query.bindValue(":id", playlistId);
-    query.bindValue(":position", position);
+    mixxx::CachedSqlQuery moveQuery(m_database, kMoveTracksUpStatement);
+    moveQuery->bindValue(":id", playlistId);
+    moveQuery->bindValue(":position", position);
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    if (!moveQuery->exec()) {
+        LOG_FAILED_QUERY(*moveQuery);
         return false;
     }
 
     //Insert the song into the PlaylistTracks table
-    query.prepare(QStringLiteral(
-            "INSERT INTO PlaylistTracks (playlist_id, track_id, position, pl_datetime_added)"
-            "VALUES (:playlist_id, :track_id, :position, CURRENT_TIMESTAMP)"));
-    query.bindValue(":playlist_id", playlistId);
-    query.bindValue(":track_id", trackId.toVariant());
-    query.bindValue(":position", position);
+    mixxx::CachedSqlQuery query(m_database, kInsertTrackWithTimestampStatement);
+    query->bindValue(":playlist_id", playlistId);
+    query->bindValue(":track_id", trackId.toVariant());
+    query->bindValue(":position", position);
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
         return false;
     }
     transaction.commit();
@@ -746,11 +751,11 @@ int PlaylistDAO::insertTracksIntoPlaylist(const QList<TrackId>& trackIds,
         position = max_position;
     }
 
-    QSqlQuery insertQuery(m_database);
-    insertQuery.prepare(QStringLiteral(
-            "INSERT INTO PlaylistTracks (playlist_id, track_id, position)"
-            "VALUES (:playlist_id, :track_id, :position)"));
-    QSqlQuery query(m_database);
+    mixxx::CachedSqlQuery insertQuery(m_database,
+            QStringLiteral(
+                    "INSERT INTO PlaylistTracks (playlist_id, track_id, position)"
+                    "VALUES (:playlist_id, :track_id, :position)"));
+    mixxx::CachedSqlQuery query(m_database, kMoveTracksUpStatement);
     int insertPositon = position;
     for (const auto& trackId : trackIds) {
         if (!trackId.isValid()) {
@@ -758,24 +763,20 @@ int PlaylistDAO::insertTracksIntoPlaylist(const QList<TrackId>& trackIds,
         }
         // Move all tracks in playlist up by 1.
         // TODO(XXX) We could do this in one query before the for loop.
-        query.prepare(QStringLiteral(
-                "UPDATE PlaylistTracks SET position=position+1 "
-                "WHERE position>=:position AND "
-                "playlist_id=:id"));
-        query.bindValue(":id", playlistId);
-        query.bindValue(":position", insertPositon);
+        query->bindValue(":id", playlistId);
+        query->bindValue(":position", insertPositon);
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
+        if (!query->exec()) {
+            LOG_FAILED_QUERY(*query);
             continue;
         }
 
         // Insert the track at the given position
-        insertQuery.bindValue(":playlist_id", playlistId);
-        insertQuery.bindValue(":track_id", trackId.toVariant());
-        insertQuery.bindValue(":position", insertPositon);
-        if (!insertQuery.exec()) {
-            LOG_FAILED_QUERY(insertQuery);
+        insertQuery->bindValue(":playlist_id", playlistId);
+        insertQuery->bindValue(":track_id", trackId.toVariant());
+        insertQuery->bindValue(":position", insertPositon);
+        if (!insertQuery->exec()) {
+            LOG_FAILED_QUERY(*insertQuery);
             continue;
         }
 
@@ -923,19 +924,19 @@ bool PlaylistDAO::copyPlaylistTracks(const int sourcePlaylistID, const int targe
 int PlaylistDAO::getMaxPosition(const int playlistId) const {
     // Find out the highest position existing in the playlist so we know what
     // position this track should have.
-    QSqlQuery query(m_database);
-    query.prepare(QStringLiteral(
-            "SELECT max(position) as position FROM PlaylistTracks "
-            "WHERE playlist_id = :id"));
-    query.bindValue(":id", playlistId);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    mixxx::CachedSqlQuery query(m_database,
+            QStringLiteral(
+                    "SELECT max(position) as position FROM PlaylistTracks "
+                    "WHERE playlist_id = :id"));
+    query->bindValue(":id", playlistId);
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
     }
 
     // Get the position of the highest track in the playlist.
     int position = 0;
-    if (query.next()) {
-        position = query.value(query.record().indexOf("position")).toInt();
+    if (query->next()) {
+        position = query->value(query->record().indexOf("position")).toInt();
     }
     return position;
 }
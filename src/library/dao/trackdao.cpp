@@ -34,6 +34,7 @@
 #include "util/datetime.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/db/sqlite.h"
+#include "util/db/sqlstatementcache.h"
 #include "util/db/sqlstringformatter.h"
 #include "util/db/sqltransaction.h"
 #include "util/fileinfo.h"
@@ -149,22 +150,22 @@ TrackId TrackDAO::getTrackIdByLocation(const QString& location) const {
         return {};
     }
 
-    QSqlQuery query(m_database);
-    query.prepare(
-            "SELECT library.id FROM library "
-            "INNER JOIN track_locations ON library.location = track_locations.id "
-            "WHERE track_locations.location=:location");
-    query.bindValue(":location", location);
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    mixxx::CachedSqlQuery query(m_database,
+            QStringLiteral(
+                    "SELECT library.id FROM library "
+                    "INNER JOIN track_locations ON library.location = track_locations.id "
+                    "WHERE track_locations.location=:location"));
+    query->bindValue(":location", location);
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
         DEBUG_ASSERT(!"Failed query");
         return {};
     }
-    if (!query.next()) {
+    if (!query->next()) {
         qDebug() << "TrackDAO::getTrackId(): Track location not found in library:" << location;
         return {};
     }
-    const auto trackId = TrackId(query.value(query.record().indexOf("id")));
+    const auto trackId = TrackId(query->value(query->record().indexOf("id")));
     DEBUG_ASSERT(trackId.isValid());
     return trackId;
 }
@@ -288,20 +289,21 @@ QSet<QString> TrackDAO::getAllTrackLocations() const {
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
     qDebug() << "TrackDAO::getTrackLocation"
              << QThread::currentThread() << m_database.connectionName();
-    QSqlQuery query(m_database);
+    mixxx::CachedSqlQuery query(m_database,
+            QStringLiteral(
+                    "SELECT track_locations.location FROM track_locations "
+                    "INNER JOIN library ON library.location = track_locations.id "
+                    "WHERE library.id=:id"));
     QString trackLocation = "";
-    query.prepare("SELECT track_locations.location FROM track_locations "
-                  "INNER JOIN library ON library.location = track_locations.id "
-                  "WHERE library.id=:id");
-    query.bindValue(":id", trackId.toVariant());
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    query->bindValue(":id", trackId.toVariant());
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
         DEBUG_ASSERT(!"Failed query");
         return "";
     }
-    const int locationColumn = query.record().indexOf("location");
-    while (query.next()) {
-        trackLocation = query.value(locationColumn).toString();
+    const int locationColumn = query->record().indexOf("location");
+    while (query->next()) {
+        trackLocation = query->value(locationColumn).toString();
     }
 
     return trackLocation;
@@ -820,7 +822,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedTrackMetadata* pPreImportedMetadata) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -870,7 +873,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pPreImportedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -1391,26 +1395,29 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
             columnsStr.append(columns[i].name);
         }
 
-        QSqlQuery query(m_database);
-        query.prepare(QString(
-                "SELECT %1 FROM Library "
-                "INNER JOIN track_locations ON library.location = track_locations.id "
-                "WHERE library.id = %2")
-                              .arg(columnsStr, trackId.toString()));
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query)
+        // The track id is bound instead of being formatted into the
+        // statement to reuse the prepared statement for all tracks
+        mixxx::CachedSqlQuery query(m_database,
+                QString(
+                        "SELECT %1 FROM Library "
+                        "INNER JOIN track_locations ON library.location = track_locations.id "
+                        "WHERE library.id=:id")
+                        .arg(columnsStr));
+        query->bindValue(":id", trackId.toVariant());
+        if (!query->exec()) {
+            LOG_FAILED_QUERY(*query)
                     << QString("getTrack(%1)").arg(trackId.toString());
             DEBUG_ASSERT(!"Failed query");
             return nullptr;
         }
 
-        if (!query.next()) {
+        if (!query->next()) {
             qDebug() << "Track with id =" << trackId << "not found";
             return nullptr;
         }
-        queryRecord = query.record();
+        queryRecord = query->record();
         // Only a single record is expected
-        DEBUG_ASSERT(!query.next());
+        DEBUG_ASSERT(!query->next());
     }
 
     {
@@ -1616,72 +1623,71 @@ bool TrackDAO::updateTrack(const Track& track) const {
     // PerformanceTimer time;
     // time.start();
 
-    QSqlQuery query(m_database);
-
     // Update everything but "location", since that's what we identify the track by.
-    query.prepare(
-            "UPDATE library SET "
-            "artist=:artist,"
-            "title=:title,"
-            "album=:album,"
-            "album_artist=:album_artist,"
-            "year=:year,"
-            "genre=:genre,"
-            "composer=:composer,"
-            "grouping=:grouping,"
-            "filetype=:filetype,"
-            "tracknumber=:tracknumber,"
-            "tracktotal=:tracktotal,"
-            "color=:color,"
-            "comment=:comment,"
-            "url=:url,"
-            "rating=:rating,"
-            "key=:key,"
-            "key_id=:key_id,"
-            "cuepoint=:cuepoint,"
-            "bpm=:bpm,"
-            "replaygain=:replaygain,"
-            "replaygain_peak=:replaygain_peak,"
-            "timesplayed=:timesplayed,"
-            "last_played_at=:last_played_at,"
-            "played=:played,"
-            "header_parsed=:header_parsed,"
-            "source_synchronized_ms=:source_synchronized_ms,"
-            "channels=:channels,"
-            "bitrate=:bitrate,"
-            "samplerate=:samplerate,"
-            "bitrate=:bitrate,"
-            "duration=:duration,"
-            "beats_version=:beats_version,"
-            "beats_sub_version=:beats_sub_version,"
-            "beats=:beats,"
-            "bpm_lock=:bpm_lock,"
-            "keys_version=:keys_version,"
-            "keys_sub_version=:keys_sub_version,"
-            "keys=:keys,"
-            "coverart_source=:coverart_source,"
-            "coverart_type=:coverart_type,"
-            "coverart_location=:coverart_location,"
-            "coverart_color=:coverart_color,"
-            "coverart_digest=:coverart_digest,"
-            "coverart_hash=:coverart_hash "
-            "WHERE id=:track_id");
-
-    query.bindValue(":track_id", trackId.toVariant());
+    mixxx::CachedSqlQuery query(m_database,
+            QStringLiteral(
+                    "UPDATE library SET "
+                    "artist=:artist,"
+                    "title=:title,"
+                    "album=:album,"
+                    "album_artist=:album_artist,"
+                    "year=:year,"
+                    "genre=:genre,"
+                    "composer=:composer,"
+                    "grouping=:grouping,"
+                    "filetype=:filetype,"
+                    "tracknumber=:tracknumber,"
+                    "tracktotal=:tracktotal,"
+                    "color=:color,"
+                    "comment=:comment,"
+                    "url=:url,"
+                    "rating=:rating,"
+                    "key=:key,"
+                    "key_id=:key_id,"
+                    "cuepoint=:cuepoint,"
+                    "bpm=:bpm,"
+                    "replaygain=:replaygain,"
+                    "replaygain_peak=:replaygain_peak,"
+                    "timesplayed=:timesplayed,"
+                    "last_played_at=:last_played_at,"
+                    "played=:played,"
+                    "header_parsed=:header_parsed,"
+                    "source_synchronized_ms=:source_synchronized_ms,"
+                    "channels=:channels,"
+                    "bitrate=:bitrate,"
+                    "samplerate=:samplerate,"
+                    "bitrate=:bitrate,"
+                    "duration=:duration,"
+                    "beats_version=:beats_version,"
+                    "beats_sub_version=:beats_sub_version,"
+                    "beats=:beats,"
+                    "bpm_lock=:bpm_lock,"
+                    "keys_version=:keys_version,"
+                    "keys_sub_version=:keys_sub_version,"
+                    "keys=:keys,"
+                    "coverart_source=:coverart_source,"
+                    "coverart_type=:coverart_type,"
+                    "coverart_location=:coverart_location,"
+                    "coverart_color=:coverart_color,"
+                    "coverart_digest=:coverart_digest,"
+                    "coverart_hash=:coverart_hash "
+                    "WHERE id=:track_id"));
+
+    query->bindValue(":track_id", trackId.toVariant());
 
     const auto trackRecord = track.getRecord();
     bindTrackLibraryValues(
-            &query,
+            query.get(),
             trackRecord,
             track.getBeats());
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
         DEBUG_ASSERT(!"Failed query");
         return false;
     }
 
-    if (query.numRowsAffected() == 0) {
+    if (query->numRowsAffected() == 0) {
         qWarning() << "updateTrack had no effect: trackId" << trackId << "invalid";
         return false;
     }
@@ -1701,6 +1707,31 @@ bool TrackDAO::updateTrack(const Track& track) const {
     return true;
 }
 
+bool TrackDAO::updateTrackSourceSynchronizedAt(
+        TrackId trackId,
+        const QDateTime& sourceSynchronizedAt) const {
+    DEBUG_ASSERT(trackId.isValid());
+    mixxx::CachedSqlQuery query(m_database,
+            QStringLiteral(
+                    "UPDATE library SET "
+                    "source_synchronized_ms=:source_synchronized_ms "
+                    "WHERE id=:track_id"));
+    query->bindValue(":track_id", trackId.toVariant());
+    if (sourceSynchronizedAt.isValid()) {
+        DEBUG_ASSERT(sourceSynchronizedAt.timeSpec() == Qt::UTC);
+        query->bindValue(":source_synchronized_ms",
+                sourceSynchronizedAt.toMSecsSinceEpoch());
+    } else {
+        query->bindValue(":source_synchronized_ms",
+                QVariant());
+    }
+    if (!query->exec()) {
+        LOG_FAILED_QUERY(*query);
+        return false;
+    }
+    return query->numRowsAffected() > 0;
+}
+
 // Mark all the tracks in the library as invalid.
 // That means we'll need to later check that those tracks actually
 // (still) exist as part of the library scanning procedure.
@@ -10,6 +10,7 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 #include "util/memory.h"
@@ -151,20 +152,32 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// The optional metadata that has been imported from the file in
+    /// advance avoids reading the file again when adding a new track.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedTrackMetadata* pPreImportedMetadata = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove) {
+            bool unremove,
+            const SoundSourceProxy::ImportedTrackMetadata* pPreImportedMetadata = nullptr) {
         return addTracksAddFile(
                 mixxx::FileAccess(mixxx::FileInfo(filePath)),
-                unremove);
+                unremove,
+                pPreImportedMetadata);
     }
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
 
+    /// Stores the time stamp after metadata has been exported
+    /// asynchronously. An invalid time stamp marks the file tags
+    /// as not synchronized.
+    bool updateTrackSourceSynchronizedAt(
+            TrackId trackId,
+            const QDateTime& sourceSynchronizedAt) const;
+
     void hideAllTracks(const QDir& rootDir) const;
 
     bool hideTracks(
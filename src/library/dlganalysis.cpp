@@ -170,7 +170,12 @@ void DlgAnalysis::analyze() {
                 selectedIndex.row(),
                 m_pAnalysisLibraryTableModel->fieldIndex(LIBRARYTABLE_ID)).data());
             if (trackId.isValid()) {
-                tracks.append(trackId);
+                // The batch analysis yields to tracks that are
+                // requested elsewhere
+                tracks.append(AnalyzerScheduledTrack(
+                        trackId,
+                        AnalyzerTrack::Options(),
+                        AnalyzerScheduledTrack::Priority::Low));
             }
         }
         emit analyzeTracks(tracks);
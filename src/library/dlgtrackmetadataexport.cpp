@@ -1,5 +1,6 @@
 #include "library/dlgtrackmetadataexport.h"
 
+#include <QDir>
 #include <QMessageBox>
 
 #include "moc_dlgtrackmetadataexport.cpp"
@@ -9,6 +10,9 @@ namespace mixxx {
 //static
 bool DlgTrackMetadataExport::s_bShownDuringThisSession = false;
 
+//static
+bool DlgTrackMetadataExport::s_bFailedShownDuringThisSession = false;
+
 void DlgTrackMetadataExport::showMessageBoxOncePerSession() {
     if (!s_bShownDuringThisSession) {
         QMessageBox::information(
@@ -21,4 +25,19 @@ void DlgTrackMetadataExport::showMessageBoxOncePerSession() {
     }
 }
 
+void DlgTrackMetadataExport::showFailedMessageBoxOncePerSession(const QString& location) {
+    if (!s_bFailedShownDuringThisSession) {
+        // Set before showing the modal message box that processes
+        // events and might receive more failures
+        s_bFailedShownDuringThisSession = true;
+        QMessageBox::warning(
+                nullptr,
+                tr("Export Modified Track Metadata"),
+                tr("Mixxx failed to write the modified metadata into the file tags of "
+                   "%1. Further failures are only reported in the log during this "
+                   "session.")
+                        .arg(QDir::toNativeSeparators(location)));
+    }
+}
+
 } // namespace mixxx
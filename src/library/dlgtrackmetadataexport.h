@@ -13,9 +13,11 @@ class DlgTrackMetadataExport: private QDialog {
     Q_OBJECT
   public:
     static void showMessageBoxOncePerSession();
+    static void showFailedMessageBoxOncePerSession(const QString& location);
 
   private:
     static bool s_bShownDuringThisSession;
+    static bool s_bFailedShownDuringThisSession;
 };
 
 } // namespace mixxx
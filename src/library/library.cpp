@@ -6,6 +6,8 @@
 #include <QPointer>
 #include <QTranslator>
 
+#include "control/controlobject.h"
+#include "control/pollingcontrolproxy.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
 #include "library/analysisfeature.h"
@@ -271,7 +273,10 @@ namespace {
 class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
   public:
     explicit TrackAnalysisSchedulerEnvironmentImpl(const Library* pLibrary)
-            : m_pLibrary(pLibrary) {
+            : m_pLibrary(pLibrary),
+              m_audioLatencyUsage(ConfigKey(QStringLiteral("[Master]"),
+                                          QStringLiteral("audio_latency_usage")),
+                      ControlFlag::AllowMissingOrInvalid) {
         DEBUG_ASSERT(m_pLibrary);
     }
     ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
@@ -280,9 +285,41 @@ class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedule
         return m_pLibrary->trackCollectionManager()->getTrackById(trackId);
     }
 
+    // PlayerInfo only considers decks that are audible on the main
+    // output, but cueing in the headphones and previewing tracks keeps
+    // the engine busy as well.
+    bool isAnyDeckPlaying() const final {
+        for (unsigned int i = 0; i < PlayerManager::numDecks(); ++i) {
+            if (isPlaying(PlayerManager::groupForDeck(i))) {
+                return true;
+            }
+        }
+        for (unsigned int i = 0; i < PlayerManager::numSamplers(); ++i) {
+            if (isPlaying(PlayerManager::groupForSampler(i))) {
+                return true;
+            }
+        }
+        for (unsigned int i = 0; i < PlayerManager::numPreviewDecks(); ++i) {
+            if (isPlaying(PlayerManager::groupForPreviewDeck(i))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    double engineLoad() const final {
+        return m_audioLatencyUsage.get();
+    }
+
   private:
+    static bool isPlaying(const QString& group) {
+        return ControlObject::get(ConfigKey(group, QStringLiteral("play"))) > 0.0;
+    }
+
     // TODO: Use std::shared_ptr or std::weak_ptr instead of a plain pointer?
     const Library* const m_pLibrary;
+
+    const PollingControlProxy m_audioLatencyUsage;
 };
 } // namespace
 
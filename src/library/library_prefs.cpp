@@ -89,3 +89,18 @@ const ConfigKey mixxx::library::prefs::kCoverArtFetcherQualityConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("CoverArtFetcherQuality")};
+
+const ConfigKey mixxx::library::prefs::kScannerThreadCountConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("ScannerThreadCount")};
+
+const ConfigKey mixxx::library::prefs::kIncrementalRescanConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("IncrementalRescan")};
+
+const ConfigKey mixxx::library::prefs::kAsyncTrackMetadataExportConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("AsyncTrackMetadataExport")};
@@ -48,6 +48,24 @@ extern const ConfigKey kUseRelativePathOnExportConfigKey;
 
 extern const ConfigKey kCoverArtFetcherQualityConfigKey;
 
+/// The number of worker threads of the library scanner that list
+/// directories and read file tags. 0 = number of CPU cores.
+extern const ConfigKey kScannerThreadCountConfigKey;
+
+const int kScannerThreadCountDefault = 0;
+
+/// Rescan only the directories with changes that have been recorded
+/// since the last full scan, if supported.
+extern const ConfigKey kIncrementalRescanConfigKey;
+
+const bool kIncrementalRescanDefault = true;
+
+/// Export metadata into file tags on worker threads when tracks are
+/// evicted from the cache instead of blocking the caller.
+extern const ConfigKey kAsyncTrackMetadataExportConfigKey;
+
+const bool kAsyncTrackMetadataExportDefault = true;
+
 } // namespace prefs
 
 } // namespace library
@@ -2,6 +2,7 @@
 
 #include "library/scanner/libraryscanner.h"
 #include "moc_importfilestask.cpp"
+#include "sources/soundsourceproxy.h"
 #include "util/timer.h"
 
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
@@ -50,6 +51,25 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
+            // Read the file tags here in parallel with the other worker
+            // threads. The scanner thread only needs to insert the track.
+            if (!m_scannerGlobal->acquireImportedTrackSlot()) {
+                setSuccess(false);
+                return;
+            }
+            auto importedMetadata =
+                    SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->syncTrackMetadataParams()
+                                    .resetMissingTagMetadataOnImport);
+            if (importedMetadata) {
+                m_scannerGlobal->addImportedTrack(
+                        trackLocation, std::move(*importedMetadata));
+            } else {
+                // The file will be read by the scanner thread
+                m_scannerGlobal->releaseImportedTrackSlot();
+            }
+
             emit addNewTrack(trackLocation);
         }
     }
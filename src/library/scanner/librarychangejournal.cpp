@@ -0,0 +1,279 @@
+#include "library/scanner/librarychangejournal.h"
+
+#include <QSocketNotifier>
+
+#include "moc_librarychangejournal.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+#ifdef __LINUX__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryChangeJournal");
+
+#ifdef __LINUX__
+
+// Only structural changes affect the directory hashes of the
+// scanner. Modified file contents are ignored.
+constexpr quint32 kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+        IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+bool isOnNetworkFileSystem(const QString& location) {
+    struct statfs buf;
+    if (statfs(location.toLocal8Bit().constData(), &buf) != 0) {
+        // Better safe than sorry
+        return true;
+    }
+    switch (static_cast<quint32>(buf.f_type)) {
+    case 0x6969:     // NFS
+    case 0x517B:     // SMB
+    case 0xFF534D42: // CIFS
+    case 0xFE534D42: // SMB2
+    case 0x65735546: // FUSE, e.g. sshfs
+    case 0x73757245: // CODA
+    case 0x5346414F: // AFS
+    case 0x01021997: // 9P
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString parentLocation(const QString& location) {
+    const int index = location.lastIndexOf(QChar('/'));
+    if (index <= 0) {
+        return QStringLiteral("/");
+    }
+    return location.left(index);
+}
+
+#endif // __LINUX__
+
+QStringList rootDirLocations(const QList<mixxx::FileInfo>& rootDirs) {
+    QStringList locations;
+    locations.reserve(rootDirs.size());
+    for (const auto& rootDir : rootDirs) {
+        locations.append(rootDir.location());
+    }
+    locations.sort();
+    return locations;
+}
+
+} // anonymous namespace
+
+bool LibraryChangeJournal::Changes::isRemoved(
+        const QString& directoryLocation) const {
+    for (const auto& removedDirectory : removedDirectories) {
+        if (mixxx::FileInfo::isRootSubCanonicalLocation(
+                    removedDirectory, directoryLocation)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+LibraryChangeJournal::LibraryChangeJournal(QObject* pParent)
+        : QObject(pParent),
+          m_fd(-1),
+          m_pNotifier(nullptr),
+          m_valid(false),
+          m_failed(false) {
+#ifdef __LINUX__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        kLogger.warning()
+                << "Failed to initialize inotify:"
+                << strerror(errno);
+        return;
+    }
+    m_pNotifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_pNotifier,
+            &QSocketNotifier::activated,
+            this,
+            [this] {
+                processPendingEvents();
+            });
+#endif
+}
+
+LibraryChangeJournal::~LibraryChangeJournal() {
+#ifdef __LINUX__
+    if (m_fd >= 0) {
+        delete m_pNotifier;
+        // Implicitly removes all watches
+        close(m_fd);
+    }
+#endif
+}
+
+// static
+bool LibraryChangeJournal::isSupported() {
+#ifdef __LINUX__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LibraryChangeJournal::beginFullScan(
+        const QList<mixxx::FileInfo>& rootDirs) {
+    processPendingEvents();
+    const auto locker = lockMutex(&m_mutex);
+    m_changes = Changes();
+    m_rootDirLocations = rootDirLocations(rootDirs);
+    m_valid = false;
+    m_failed = m_fd < 0;
+#ifdef __LINUX__
+    for (const auto& rootDirLocation : qAsConst(m_rootDirLocations)) {
+        if (isOnNetworkFileSystem(rootDirLocation)) {
+            kLogger.info()
+                    << "Changes of"
+                    << rootDirLocation
+                    << "cannot be watched, rescanning requires a full scan";
+            m_failed = true;
+        }
+    }
+#endif
+}
+
+void LibraryChangeJournal::endFullScan(bool finishedCleanly) {
+    const auto locker = lockMutex(&m_mutex);
+    m_valid = finishedCleanly && !m_failed;
+    if (m_valid) {
+        kLogger.info()
+                << "Watching"
+                << m_watchedDirectories.size()
+                << "directories for changes";
+    }
+}
+
+void LibraryChangeJournal::watchDirectory(
+        const QString& directoryLocation) {
+#ifdef __LINUX__
+    const auto locker = lockMutex(&m_mutex);
+    if (m_failed) {
+        // Avoid pointless system calls
+        return;
+    }
+    const int watchDescriptor = inotify_add_watch(
+            m_fd, directoryLocation.toLocal8Bit().constData(), kWatchMask);
+    if (watchDescriptor < 0) {
+        if (errno == ENOSPC) {
+            kLogger.warning()
+                    << "Exceeded the maximum number of watches after"
+                    << m_watchedDirectories.size()
+                    << "directories, rescanning requires a full scan."
+                    << "Increase fs.inotify.max_user_watches to enable"
+                    << "incremental scans.";
+        } else {
+            kLogger.warning()
+                    << "Failed to watch directory"
+                    << directoryLocation
+                    << strerror(errno);
+        }
+        m_failed = true;
+        m_valid = false;
+        return;
+    }
+    // Adding a watch for the same directory again returns
+    // the existing watch descriptor
+    m_watchedDirectories.insert(watchDescriptor, directoryLocation);
+#else
+    Q_UNUSED(directoryLocation);
+#endif
+}
+
+bool LibraryChangeJournal::isValidFor(
+        const QList<mixxx::FileInfo>& rootDirs) const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_valid && m_rootDirLocations == rootDirLocations(rootDirs);
+}
+
+void LibraryChangeJournal::invalidate() {
+    const auto locker = lockMutex(&m_mutex);
+    m_valid = false;
+}
+
+LibraryChangeJournal::Changes LibraryChangeJournal::takeChanges() {
+    processPendingEvents();
+    const auto locker = lockMutex(&m_mutex);
+    Changes changes = std::move(m_changes);
+    m_changes = Changes();
+    return changes;
+}
+
+void LibraryChangeJournal::processPendingEvents() {
+#ifdef __LINUX__
+    if (m_fd < 0) {
+        return;
+    }
+    // Properly aligned for struct inotify_event
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    const auto locker = lockMutex(&m_mutex);
+    while (true) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN: No more events
+            break;
+        }
+        for (const char* pEvent = buffer; pEvent < buffer + length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(pEvent);
+            recordEvent(event->wd,
+                    event->mask,
+                    event->len > 0 ? QString::fromLocal8Bit(event->name) : QString());
+            pEvent += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#endif
+}
+
+void LibraryChangeJournal::recordEvent(
+        int watchDescriptor,
+        quint32 mask,
+        const QString& name) {
+#ifdef __LINUX__
+    if (mask & IN_Q_OVERFLOW) {
+        kLogger.warning()
+                << "Lost events, rescanning requires a full scan";
+        m_valid = false;
+        return;
+    }
+    const auto it = m_watchedDirectories.constFind(watchDescriptor);
+    if (it == m_watchedDirectories.constEnd()) {
+        return;
+    }
+    const QString directoryLocation = it.value();
+    if (mask & IN_IGNORED) {
+        // The watch has been removed after the directory has been deleted
+        m_watchedDirectories.remove(watchDescriptor);
+        return;
+    }
+    if (mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+        m_changes.removedDirectories.append(directoryLocation);
+        m_changes.changedDirectories.insert(parentLocation(directoryLocation));
+        if (mask & IN_MOVE_SELF) {
+            // The watch would follow the directory to its new location
+            inotify_rm_watch(m_fd, watchDescriptor);
+            m_watchedDirectories.remove(watchDescriptor);
+        }
+        return;
+    }
+    m_changes.changedDirectories.insert(directoryLocation);
+    if ((mask & IN_ISDIR) && (mask & (IN_DELETE | IN_MOVED_FROM))) {
+        m_changes.removedDirectories.append(
+                directoryLocation + QChar('/') + name);
+    }
+#else
+    Q_UNUSED(watchDescriptor);
+    Q_UNUSED(mask);
+    Q_UNUSED(name);
+#endif
+}
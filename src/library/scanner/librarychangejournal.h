@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "util/fileinfo.h"
+
+class QSocketNotifier;
+
+/// Records the structural changes of the library directories between
+/// scans, i.e. files and subdirectories that have been created, deleted,
+/// or renamed.
+///
+/// Every directory that is listed during a full scan is watched. After a
+/// full scan has finished cleanly the next scan only needs to visit the
+/// directories with recorded changes instead of listing and hashing all
+/// directories.
+///
+/// Only supported on Linux by using inotify. Changes on network mounts
+/// are not reported by the kernel and the journal is never valid if one
+/// of the library root directories is located on a network file system.
+/// The journal also becomes invalid if the kernel event queue overflows
+/// or if the limit for the number of watches has been reached. In all
+/// these cases the hash-based full scan is required.
+///
+/// Changes that happen while Mixxx is not running cannot be recorded.
+/// The first scan of every session is a full scan.
+///
+/// Lives in the thread of the LibraryScanner. Only watchDirectory() may
+/// be invoked from the worker threads.
+class LibraryChangeJournal : public QObject {
+    Q_OBJECT
+  public:
+    struct Changes {
+        /// The directories with created, deleted, or renamed entries
+        QSet<QString> changedDirectories;
+        /// The directories that have been deleted or renamed,
+        /// including all their subdirectories
+        QStringList removedDirectories;
+
+        bool isEmpty() const {
+            return changedDirectories.isEmpty() && removedDirectories.isEmpty();
+        }
+
+        /// Checks if the directory itself or one of its parent directories
+        /// has been removed.
+        bool isRemoved(const QString& directoryLocation) const;
+    };
+
+    explicit LibraryChangeJournal(QObject* pParent = nullptr);
+    ~LibraryChangeJournal() override;
+
+    static bool isSupported();
+
+    /// Discards all recorded changes. The journal becomes valid for
+    /// the given root directories after endFullScan() if all listed
+    /// directories could be watched.
+    void beginFullScan(const QList<mixxx::FileInfo>& rootDirs);
+    void endFullScan(bool finishedCleanly);
+
+    /// Starts watching a directory that has been listed while scanning.
+    ///
+    /// Thread-safe.
+    void watchDirectory(const QString& directoryLocation);
+
+    /// Returns true if all changes of the library root directories
+    /// since the last full scan have been recorded.
+    bool isValidFor(const QList<mixxx::FileInfo>& rootDirs) const;
+
+    /// Forces a full scan, e.g. after an incremental scan has been
+    /// aborted before all changes have been handled.
+    void invalidate();
+
+    /// Reads all events that are pending in the kernel queue and
+    /// returns the changes recorded since the last invocation.
+    Changes takeChanges();
+
+  private:
+    void processPendingEvents();
+    void recordEvent(
+            int watchDescriptor,
+            quint32 mask,
+            const QString& name);
+
+    int m_fd;
+    QSocketNotifier* m_pNotifier;
+
+    // Guards the watch descriptors and the validity
+    mutable QMutex m_mutex;
+    QHash<int, QString> m_watchedDirectories;
+    QStringList m_rootDirLocations;
+    bool m_valid;
+    bool m_failed;
+
+    Changes m_changes;
+};
@@ -1,7 +1,9 @@
 #include "library/scanner/libraryscanner.h"
 
 #include "library/coverartutils.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
+#include "library/scanner/librarychangejournal.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
@@ -13,14 +15,19 @@
 #include "util/db/dbconnectionpooler.h"
 #include "util/db/fwdsqlquery.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/performancetimer.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
+// Listing directories and reading file tags is mostly I/O bound.
+// More threads than this don't pay off even on network shares.
+constexpr int kScannerThreadCountMax = 16;
+
+// The minimum interval between two throughput updates
+constexpr mixxx::Duration kThroughputUpdateInterval = mixxx::Duration::fromSeconds(1);
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -71,6 +78,21 @@ void cleanUpDatabase(const QSqlDatabase& database) {
             << timer.elapsed().debugMillisWithUnit();
 }
 
+int scannerThreadCount(const UserSettings& config) {
+    const int threadCount = config.getValue(
+            mixxx::library::prefs::kScannerThreadCountConfigKey,
+            mixxx::library::prefs::kScannerThreadCountDefault);
+    if (threadCount > 0) {
+        return math_min(threadCount, kScannerThreadCountMax);
+    }
+    return math_clamp(QThread::idealThreadCount(), 1, kScannerThreadCountMax);
+}
+
+double perSecond(int count, mixxx::Duration elapsed) {
+    const double seconds = elapsed.toDoubleSeconds();
+    return seconds > 0 ? count / seconds : 0;
+}
+
 /// Update statistics for the query planner
 /// See also: https://www.sqlite.org/lang_analyze.html
 void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
@@ -98,6 +120,7 @@ LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
@@ -112,7 +135,7 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_pool.setMaxThreadCount(scannerThreadCount(*pConfig));
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -127,6 +150,10 @@ LibraryScanner::LibraryScanner(
             &LibraryScanner::progressHashing,
             m_pProgressDlg.data(),
             &LibraryScannerDlg::slotUpdate);
+    connect(this,
+            &LibraryScanner::progressThroughput,
+            m_pProgressDlg.data(),
+            &LibraryScannerDlg::slotUpdateThroughput);
     connect(this,
             &LibraryScanner::scanStarted,
             m_pProgressDlg.data(),
@@ -174,10 +201,19 @@ void LibraryScanner::run() {
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
 
+        if (LibraryChangeJournal::isSupported() &&
+                m_pConfig->getValue(
+                        mixxx::library::prefs::kIncrementalRescanConfigKey,
+                        mixxx::library::prefs::kIncrementalRescanDefault)) {
+            m_pChangeJournal = std::make_unique<LibraryChangeJournal>();
+        }
+
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        m_pChangeJournal.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -198,6 +234,9 @@ void LibraryScanner::slotStartScan() {
     }
     changeScannerState(SCANNING);
 
+    const bool incremental = m_pChangeJournal &&
+            m_pChangeJournal->isValidFor(m_libraryRootDirs);
+
     QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
     QHash<QString, mixxx::cache_key_t> directoryHashes = m_libraryHashDao.getDirectoryHashes();
     QRegularExpression extensionFilter(SoundSourceProxy::getSupportedFileNamesRegex());
@@ -207,10 +246,22 @@ void LibraryScanner::slotStartScan() {
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)));
+
+    m_scannerGlobal->setChangeJournal(m_pChangeJournal.get());
+    if (incremental) {
+        m_scannerGlobal->setIncrementalChanges(m_pChangeJournal->takeChanges());
+    } else if (m_pChangeJournal) {
+        m_pChangeJournal->beginFullScan(m_libraryRootDirs);
+    }
 
     m_scannerGlobal->startTimer();
+    m_throughputTimer.start();
 
     emit scanStarted();
 
@@ -245,6 +296,16 @@ void LibraryScanner::slotStartScan() {
             this,
             &LibraryScanner::slotFinishHashedScan);
 
+    if (incremental) {
+        const int numChangedDirectories = queueIncrementalScanTasks(directoryHashes);
+        kLogger.info()
+                << "Scanning"
+                << numChangedDirectories
+                << "changed directories incrementally";
+        pWatcher->taskDone();
+        return;
+    }
+
     for (const mixxx::FileInfo& rootDir : qAsConst(m_libraryRootDirs)) {
         // Acquire a security bookmark for this directory if we are in a
         // sandbox. For speed we avoid opening security bookmarks when recursive
@@ -263,6 +324,46 @@ void LibraryScanner::slotStartScan() {
     pWatcher->taskDone();
 }
 
+int LibraryScanner::queueIncrementalScanTasks(
+        const QHash<QString, mixxx::cache_key_t>& directoryHashes) {
+    const LibraryChangeJournal::Changes& changes =
+            m_scannerGlobal->incrementalChanges();
+
+    // All other known directories are unchanged since the last scan.
+    // Their tracks are verified without accessing the file system.
+    for (auto it = directoryHashes.constBegin(); it != directoryHashes.constEnd(); ++it) {
+        if (!changes.changedDirectories.contains(it.key()) &&
+                !changes.isRemoved(it.key())) {
+            m_scannerGlobal->addVerifiedDirectory(it.key());
+        }
+    }
+
+    int numChangedDirectories = 0;
+    for (const QString& directoryLocation : changes.changedDirectories) {
+        // Skip removed directories and parent directories of the
+        // library root directories
+        const mixxx::FileInfo dirInfo(directoryLocation);
+        if (!dirInfo.exists() || !dirInfo.isDir()) {
+            continue;
+        }
+        for (const mixxx::FileInfo& rootDir : qAsConst(m_libraryRootDirs)) {
+            if (!mixxx::FileInfo::isRootSubCanonicalLocation(
+                        rootDir.location(), directoryLocation)) {
+                continue;
+            }
+            ++numChangedDirectories;
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+                queueTask(new RecursiveScanDirectoryTask(this,
+                        m_scannerGlobal,
+                        mixxx::FileAccess(dirInfo, mixxx::FileAccess(rootDir).token()),
+                        false));
+            }
+            break;
+        }
+    }
+    return numChangedDirectories;
+}
+
 // is called when all tasks of the first stage are done (threads are finished)
 void LibraryScanner::slotFinishHashedScan() {
     kLogger.debug() << "slotFinishHashedScan";
@@ -422,6 +523,21 @@ void LibraryScanner::slotFinishUnhashedScan() {
         kLogger.debug() << "Scan cancelled";
     }
 
+    if (m_pChangeJournal) {
+        // The cleanup might have been canceled
+        const bool finishedCleanly =
+                !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly;
+        if (!m_scannerGlobal->isIncremental()) {
+            m_pChangeJournal->endFullScan(finishedCleanly);
+        } else if (!finishedCleanly) {
+            // Changes that have been taken from the journal might not
+            // have been handled
+            m_pChangeJournal->invalidate();
+        }
+    }
+
+    emitProgressThroughput();
+
     // TODO(XXX) doesn't take into account verifyRemainingTracks.
     qDebug("Scan took: %s. "
            "%d unchanged directories. "
@@ -547,6 +663,7 @@ void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
         m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0);
     }
     emit progressHashing(directoryPath);
+    maybeEmitProgressThroughput();
 }
 
 void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
@@ -556,6 +673,7 @@ void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
         m_scannerGlobal->addVerifiedDirectory(directoryPath);
     }
     emit progressHashing(directoryPath);
+    maybeEmitProgressThroughput();
 }
 
 void LibraryScanner::slotTrackExists(const QString& trackPath) {
@@ -569,10 +687,16 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
 void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
     //kLogger.debug() << "slotAddNewTrack" << trackPath;
     ScopedTimer timer("LibraryScanner::addNewTrack");
+    // The file tags have usually been read by a worker thread
+    std::optional<SoundSourceProxy::ImportedTrackMetadata> importedMetadata;
+    if (m_scannerGlobal) {
+        importedMetadata = m_scannerGlobal->takeImportedTrack(trackPath);
+    }
     // For statistics tracking and to detect moved tracks
     TrackPointer pTrack = m_trackDao.addTracksAddFile(
             trackPath,
-            false);
+            false,
+            importedMetadata ? &*importedMetadata : nullptr);
     if (pTrack) {
         DEBUG_ASSERT(!pTrack->isDirty());
         // The track's actual location might differ from the
@@ -597,6 +721,26 @@ void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
                 << "Failed to add track to library:"
                 << trackPath;
     }
+    maybeEmitProgressThroughput();
+}
+
+void LibraryScanner::maybeEmitProgressThroughput() {
+    if (m_throughputTimer.elapsed() < kThroughputUpdateInterval) {
+        return;
+    }
+    emitProgressThroughput();
+}
+
+void LibraryScanner::emitProgressThroughput() {
+    if (!m_scannerGlobal) {
+        return;
+    }
+    m_throughputTimer.restart();
+    const auto elapsed = m_scannerGlobal->timerElapsed();
+    emit progressThroughput(
+            perSecond(m_scannerGlobal->numListedDirectories(), elapsed),
+            perSecond(m_scannerGlobal->numImportedTracks(), elapsed),
+            perSecond(static_cast<int>(m_scannerGlobal->addedTracks().size()), elapsed));
 }
 
 bool LibraryScanner::changeScannerState(ScannerState newState) {
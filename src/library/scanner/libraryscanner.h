@@ -8,6 +8,7 @@
 #include <QString>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -19,9 +20,11 @@
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/performancetimer.h"
 
 class ScannerTask;
 class LibraryScannerDlg;
+class LibraryChangeJournal;
 
 class LibraryScanner : public QThread {
     FRIEND_TEST(LibraryScannerTest, ScannerRoundtrip);
@@ -46,6 +49,13 @@ class LibraryScanner : public QThread {
     void progressHashing(const QString&);
     void progressLoading(const QString& path);
     void progressCoverArt(const QString& file);
+    // The average throughput of the pipeline stages since the scan
+    // has been started: directories listed, file tags read by the
+    // worker threads, and tracks added to the database.
+    void progressThroughput(
+            double directoriesPerSecond,
+            double importedTracksPerSecond,
+            double addedTracksPerSecond);
     void trackAdded(TrackPointer pTrack);
     void tracksChanged(const QSet<TrackId>& changedTrackIds);
     void tracksRelocated(const QList<RelocatedTrack>& relocatedTracks);
@@ -96,7 +106,17 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    // Queues the scan tasks and returns the number of directories
+    // with recorded changes
+    int queueIncrementalScanTasks(
+            const QHash<QString, mixxx::cache_key_t>& directoryHashes);
+
+    // Rate limited
+    void maybeEmitProgressThroughput();
+    void emitProgressThroughput();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
@@ -120,5 +140,10 @@ class LibraryScanner : public QThread {
     volatile ScannerState m_state;
 
     QList<mixxx::FileInfo> m_libraryRootDirs;
+    PerformanceTimer m_throughputTimer;
+
+    // Only exists while the thread is running if incremental
+    // rescans are enabled and supported
+    std::unique_ptr<LibraryChangeJournal> m_pChangeJournal;
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 };
@@ -33,6 +33,11 @@ LibraryScannerDlg::LibraryScannerDlg(QWidget* parent, Qt::WindowFlags f)
     pCurrent->setWordWrap(true);
     connect(this, &LibraryScannerDlg::progress, pCurrent, &QLabel::setText);
     pLayout->addWidget(pCurrent);
+
+    QLabel* pThroughput = new QLabel(this);
+    pThroughput->setAlignment(Qt::AlignTop);
+    connect(this, &LibraryScannerDlg::throughput, pThroughput, &QLabel::setText);
+    pLayout->addWidget(pThroughput);
     setLayout(pLayout);
 }
 
@@ -63,6 +68,19 @@ void LibraryScannerDlg::slotUpdateCover(const QString& path) {
     }
 }
 
+void LibraryScannerDlg::slotUpdateThroughput(
+        double directoriesPerSecond,
+        double importedTracksPerSecond,
+        double addedTracksPerSecond) {
+    if (isVisible()) {
+        emit throughput(
+                tr("Directories: %1/s, reading tags: %2 files/s, adding: %3 tracks/s")
+                        .arg(QString::number(directoriesPerSecond, 'f', 1),
+                                QString::number(importedTracksPerSecond, 'f', 1),
+                                QString::number(addedTracksPerSecond, 'f', 1)));
+    }
+}
+
 void LibraryScannerDlg::slotCancel() {
     qDebug() << "Cancelling library scan...";
     m_bCancelled = true;
@@ -72,6 +90,7 @@ void LibraryScannerDlg::slotCancel() {
 
 void LibraryScannerDlg::slotScanStarted() {
     m_bCancelled = false;
+    emit throughput(QString());
     m_timer.start();
 }
 
@@ -15,6 +15,10 @@ class LibraryScannerDlg : public QWidget {
   public slots:
     void slotUpdate(const QString& path);
     void slotUpdateCover(const QString& path);
+    void slotUpdateThroughput(
+            double directoriesPerSecond,
+            double importedTracksPerSecond,
+            double addedTracksPerSecond);
     void slotCancel();
     void slotScanFinished();
     void slotScanStarted();
@@ -22,6 +26,7 @@ class LibraryScannerDlg : public QWidget {
   signals:
     void scanCancelled();
     void progress(const QString&);
+    void throughput(const QString&);
 
   private:
     PerformanceTimer m_timer;
@@ -38,7 +38,9 @@ void RecursiveScanDirectoryTask::run() {
     dir.setFilter(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::System);
     // sort directory by file name to increase chance that files are sorted sensible
     dir.setSorting(QDir::SortFlag::DirsFirst | QDir::SortFlag::Name);
+    m_scannerGlobal->watchDirectory(m_dirAccess.info().location());
     const QFileInfoList children = dir.entryInfoList();
+    m_scannerGlobal->directoryListed();
 
     std::list<QFileInfo> filesToImport;
     std::list<QFileInfo> possibleCovers;
@@ -77,7 +79,12 @@ void RecursiveScanDirectoryTask::run() {
                 // Art Folder since it is probably a waste of time.
                 continue;
             }
-            dirsToScan.push_back(mixxx::FileInfo(std::move(currentFileInfo)));
+            mixxx::FileInfo dirInfo(currentFileInfo);
+            if (!m_scannerGlobal->shouldScanSubdirectory(dirInfo.location())) {
+                // Unchanged subdirectory during an incremental scan
+                continue;
+            }
+            dirsToScan.push_back(std::move(dirInfo));
         }
     }
 
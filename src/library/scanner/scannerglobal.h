@@ -1,13 +1,20 @@
 #pragma once
 
+#include <QAtomicInt>
 #include <QDir>
 #include <QHash>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSemaphore>
 #include <QSet>
 #include <QSharedPointer>
 #include <QStringList>
+#include <optional>
 
+#include "library/scanner/librarychangejournal.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track_decl.h"
+#include "util/assert.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -20,18 +27,51 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            const SyncTrackMetadataParams& syncTrackMetadataParams)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_syncTrackMetadataParams(syncTrackMetadataParams),
+              m_importedTracksCapacity(kMaxImportedTracks),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
+              m_pChangeJournal(nullptr),
+              m_incremental(false),
               m_numScannedDirectories(0) {
     }
 
+    // The journal that starts watching all directories that are scanned.
+    // Must be set before any tasks are started.
+    void setChangeJournal(LibraryChangeJournal* pChangeJournal) {
+        m_pChangeJournal = pChangeJournal;
+    }
+
+    // Only directories with recorded changes are scanned. Subdirectories
+    // are only visited if they are new or have been replaced.
+    bool isIncremental() const {
+        return m_incremental;
+    }
+    void setIncrementalChanges(LibraryChangeJournal::Changes changes) {
+        m_incremental = true;
+        m_incrementalChanges = std::move(changes);
+    }
+    const LibraryChangeJournal::Changes& incrementalChanges() const {
+        return m_incrementalChanges;
+    }
+
+    bool shouldScanSubdirectory(const QString& directoryLocation) const {
+        if (!m_incremental) {
+            return true;
+        }
+        return !mixxx::isValidCacheKey(directoryHashInDatabase(directoryLocation)) ||
+                m_incrementalChanges.changedDirectories.contains(directoryLocation) ||
+                m_incrementalChanges.isRemoved(directoryLocation);
+    }
+
     TaskWatcher& getTaskWatcher() {
         return m_watcher;
     }
@@ -94,6 +134,62 @@ class ScannerGlobal {
         return match.hasMatch();
     }
 
+    const SyncTrackMetadataParams& syncTrackMetadataParams() const {
+        return m_syncTrackMetadataParams;
+    }
+
+    // The metadata of new tracks is imported by the worker threads
+    // and then handed over to the scanner thread that adds the tracks
+    // to the database. The number of pending tracks is limited to
+    // bound the memory for their cover images while the scanner
+    // thread is falling behind.
+
+    // Blocks the calling worker thread until the metadata of another
+    // track could be stored. Returns false if the scan has been canceled.
+    bool acquireImportedTrackSlot() {
+        while (!m_importedTracksCapacity.tryAcquire(1, kImportedTrackSlotTimeoutMillis)) {
+            if (shouldCancel()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns a slot that has been acquired without storing metadata.
+    void releaseImportedTrackSlot() {
+        m_importedTracksCapacity.release();
+    }
+
+    // Occupies the slot that has been acquired before.
+    void addImportedTrack(
+            const QString& trackLocation,
+            SoundSourceProxy::ImportedTrackMetadata importedMetadata) {
+        m_numImportedTracks.ref();
+        const auto locker = lockMutex(&m_importedTracksMutex);
+        VERIFY_OR_DEBUG_ASSERT(!m_importedTracks.contains(trackLocation)) {
+            // The replaced entry is discarded
+            m_importedTracksCapacity.release();
+        }
+        m_importedTracks.insert(trackLocation, std::move(importedMetadata));
+    }
+
+    // Frees the slot of the returned metadata.
+    std::optional<SoundSourceProxy::ImportedTrackMetadata> takeImportedTrack(
+            const QString& trackLocation) {
+        std::optional<SoundSourceProxy::ImportedTrackMetadata> importedMetadata;
+        {
+            const auto locker = lockMutex(&m_importedTracksMutex);
+            const auto it = m_importedTracks.find(trackLocation);
+            if (it == m_importedTracks.end()) {
+                return std::nullopt;
+            }
+            importedMetadata = std::move(it.value());
+            m_importedTracks.erase(it);
+        }
+        m_importedTracksCapacity.release();
+        return importedMetadata;
+    }
+
     bool shouldCancel() const {
         return m_shouldCancel;
     }
@@ -153,7 +249,29 @@ class ScannerGlobal {
         m_numScannedDirectories++;
     }
 
+    // Counters for the throughput of the individual stages. They
+    // are updated by the worker threads.
+    int numListedDirectories() const {
+        return m_numListedDirectories.loadAcquire();
+    }
+    void directoryListed() {
+        m_numListedDirectories.ref();
+    }
+    // Must be called before listing the directory, otherwise changes
+    // made in between would be missed by the journal.
+    void watchDirectory(const QString& directoryLocation) {
+        if (m_pChangeJournal) {
+            m_pChangeJournal->watchDirectory(directoryLocation);
+        }
+    }
+    int numImportedTracks() const {
+        return m_numImportedTracks.loadAcquire();
+    }
+
   private:
+    static constexpr int kMaxImportedTracks = 256;
+    static constexpr int kImportedTrackSlotTimeoutMillis = 100;
+
     TaskWatcher m_watcher;
 
     QSet<QString> m_trackLocations;
@@ -182,6 +300,12 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const SyncTrackMetadataParams m_syncTrackMetadataParams;
+
+    mutable QMutex m_importedTracksMutex;
+    QHash<QString, SoundSourceProxy::ImportedTrackMetadata> m_importedTracks;
+    QSemaphore m_importedTracksCapacity;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -194,9 +318,16 @@ class ScannerGlobal {
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
 
+    LibraryChangeJournal* m_pChangeJournal;
+    bool m_incremental;
+    // Read-only while scanning
+    LibraryChangeJournal::Changes m_incrementalChanges;
+
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
+    QAtomicInt m_numListedDirectories;
+    QAtomicInt m_numImportedTracks;
 };
 
 typedef QSharedPointer<ScannerGlobal> ScannerGlobalPointer;
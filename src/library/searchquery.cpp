@@ -3,6 +3,7 @@
 #include <QRegularExpression>
 #include <QtDebug>
 
+#include "library/columnartrackindex.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
@@ -78,6 +79,19 @@ QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& colum
     return QVariant();
 }
 
+QVariant getIndexValueForColumn(
+        const ColumnarTrackIndex& index, int row, const QString& column) {
+    const int columnIndex = index.columnIndex(column);
+    if (columnIndex < 0) {
+        return QVariant();
+    }
+    if (column == LIBRARYTABLE_YEAR) {
+        // Consistent with getTrackValueForColumn()
+        return index.value(row, columnIndex).toString().left(4);
+    }
+    return index.value(row, columnIndex);
+}
+
 QString concatSqlClauses(
         const QStringList& sqlClauses, const QString& sqlConcatOp) {
     switch (sqlClauses.size()) {
@@ -109,6 +123,15 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::match(const ColumnarTrackIndex& index, int row) const {
+    for (const auto& pNode : m_nodes) {
+        if (!pNode->match(index, row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -138,6 +161,18 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::match(const ColumnarTrackIndex& index, int row) const {
+    VERIFY_OR_DEBUG_ASSERT(!m_nodes.empty()) {
+        return true;
+    }
+    for (const auto& pNode : m_nodes) {
+        if (pNode->match(index, row)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -154,6 +189,10 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::match(const ColumnarTrackIndex& index, int row) const {
+    return !m_pNode->match(index, row);
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -171,8 +210,28 @@ TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QString& argument)
         : m_database(database),
           m_sqlColumns(sqlColumns),
-          m_argument(argument) {
+          m_argument(argument),
+          m_pMatchedIndex(nullptr) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
+    if (m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            (!m_argument.isEmpty() && m_argument.back().isSpace())) {
+        // Same pattern as in toSql()
+        m_likePattern = kSqlLikeMatchAll + m_argument;
+        if (m_argument.back().isSpace()) {
+            m_likePattern.append(kSqlLikeMatchOne);
+        }
+        m_likePattern.append(kSqlLikeMatchAll);
+    }
+}
+
+bool TextFilterNode::matchFoldedString(const QString& foldedString) const {
+    if (m_likePattern.isEmpty()) {
+        return foldedString.contains(m_argument);
+    }
+    QString pattern = m_likePattern;
+    QString string = foldedString;
+    return mixxx::DbConnection::likeCompareLatinLow(&pattern, &string, QChar()) != 0;
 }
 
 bool TextFilterNode::match(const TrackPointer& pTrack) const {
@@ -184,7 +243,46 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
 
         QString strValue = value.toString();
         mixxx::DbConnection::makeStringLatinLow(&strValue);
-        if (strValue.contains(m_argument)) {
+        if (matchFoldedString(strValue)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (m_pMatchedIndex != &index) {
+        m_pMatchedIndex = &index;
+        m_matchedIndexColumns.clear();
+        for (const auto& sqlColumn : m_sqlColumns) {
+            const int column = index.columnIndex(sqlColumn);
+            if (column >= 0) {
+                m_matchedIndexColumns.push_back(column);
+            }
+        }
+        // -1 = not yet evaluated, 0 = no match, 1 = match
+        m_matchedIndexStrings.assign(index.stringCount(), -1);
+    }
+    for (const int column : m_matchedIndexColumns) {
+        const int stringId = index.stringId(row, column);
+        if (stringId != ColumnarTrackIndex::kNoString) {
+            // Each distinct string is only searched once
+            qint8& stringMatch = m_matchedIndexStrings[stringId];
+            if (stringMatch < 0) {
+                stringMatch = matchFoldedString(index.foldedString(stringId)) ? 1 : 0;
+            }
+            if (stringMatch > 0) {
+                return true;
+            }
+            continue;
+        }
+        QVariant value = index.value(row, column);
+        if (!value.isValid() || !value.canConvert<QString>()) {
+            continue;
+        }
+        QString strValue = value.toString();
+        mixxx::DbConnection::makeStringLatinLow(&strValue);
+        if (matchFoldedString(strValue)) {
             return true;
         }
     }
@@ -222,6 +320,18 @@ bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullOrEmptyTextFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        QVariant value = getIndexValueForColumn(index, row, m_sqlColumns.first());
+        if (!value.isValid() || !value.canConvert<QString>()) {
+            return true;
+        }
+        return value.toString().isEmpty();
+    }
+    return false;
+}
+
 QString NullOrEmptyTextFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -238,6 +348,14 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
 }
 
 bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool CrateFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+bool CrateFilterNode::matchTrackId(TrackId trackId) const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
                 m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -249,7 +367,7 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
         m_matchInitialized = true;
     }
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString CrateFilterNode::toSql() const {
@@ -264,6 +382,14 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
 }
 
 bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    return matchTrackId(pTrack->getId());
+}
+
+bool NoCrateFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    return matchTrackId(index.trackId(row));
+}
+
+bool NoCrateFilterNode::matchTrackId(TrackId trackId) const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -275,7 +401,7 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
         m_matchInitialized = true;
     }
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), trackId);
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -339,27 +465,39 @@ double NumericFilterNode::parse(const QString& arg, bool* ok) {
 
 bool NumericFilterNode::match(const TrackPointer& pTrack) const {
     for (const auto& sqlColumn : m_sqlColumns) {
-        QVariant value = getTrackValueForColumn(pTrack, sqlColumn);
-        if (!value.isValid() || !value.canConvert<double>()) {
-            if (m_bNullQuery) {
-                return true;
-            }
-            continue;
+        if (matchValue(getTrackValueForColumn(pTrack, sqlColumn))) {
+            return true;
         }
+    }
+    return false;
+}
 
-        double dValue = value.toDouble();
-        if (m_bOperatorQuery) {
-            if ((m_operator == "=" && dValue == m_dOperatorArgument) ||
-                    (m_operator == "<" && dValue < m_dOperatorArgument) ||
-                    (m_operator == ">" && dValue > m_dOperatorArgument) ||
-                    (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
-                    (m_operator == ">=" && dValue >= m_dOperatorArgument)) {
-                return true;
-            }
-        } else if (m_bRangeQuery && dValue >= m_dRangeLow &&
-                dValue <= m_dRangeHigh) {
+bool NumericFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (matchValue(getIndexValueForColumn(index, row, sqlColumn))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool NumericFilterNode::matchValue(const QVariant& value) const {
+    if (!value.isValid() || !value.canConvert<double>()) {
+        return m_bNullQuery;
+    }
+
+    double dValue = value.toDouble();
+    if (m_bOperatorQuery) {
+        if ((m_operator == "=" && dValue == m_dOperatorArgument) ||
+                (m_operator == "<" && dValue < m_dOperatorArgument) ||
+                (m_operator == ">" && dValue > m_dOperatorArgument) ||
+                (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
+                (m_operator == ">=" && dValue >= m_dOperatorArgument)) {
             return true;
         }
+    } else if (m_bRangeQuery && dValue >= m_dRangeLow &&
+            dValue <= m_dRangeHigh) {
+        return true;
     }
     return false;
 }
@@ -414,6 +552,17 @@ bool NullNumericFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullNumericFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    if (!m_sqlColumns.isEmpty()) {
+        // only use the major column
+        QVariant value = getIndexValueForColumn(index, row, m_sqlColumns.first());
+        if (!value.isValid() || !value.canConvert<double>()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QString NullNumericFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -472,6 +621,12 @@ bool KeyFilterNode::match(const TrackPointer& pTrack) const {
     return m_matchKeys.contains(pTrack->getKey());
 }
 
+bool KeyFilterNode::match(const ColumnarTrackIndex& index, int row) const {
+    const QVariant value = getIndexValueForColumn(index, row, LIBRARYTABLE_KEY_ID);
+    return m_matchKeys.contains(
+            static_cast<mixxx::track::io::key::ChromaticKey>(value.toInt()));
+}
+
 QString KeyFilterNode::toSql() const {
     QStringList searchClauses;
     for (const auto& matchKey : m_matchKeys) {
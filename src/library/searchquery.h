@@ -14,6 +14,8 @@
 #include "util/assert.h"
 #include "util/memory.h"
 
+class ColumnarTrackIndex;
+
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
 class QueryNode {
@@ -22,6 +24,9 @@ class QueryNode {
     virtual ~QueryNode() = default;
 
     virtual bool match(const TrackPointer& pTrack) const = 0;
+    // Evaluates the query for a row of the in-memory track index
+    // instead of a track object with the same results.
+    virtual bool match(const ColumnarTrackIndex& index, int row) const = 0;
     virtual QString toSql() const = 0;
 
   protected:
@@ -45,12 +50,14 @@ class GroupNode : public QueryNode {
 class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 };
 
@@ -62,6 +69,7 @@ class NotNode : public QueryNode {
     }
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
@@ -75,12 +83,24 @@ class TextFilterNode : public QueryNode {
             const QString& argument);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
+    bool matchFoldedString(const QString& foldedString) const;
+
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
+    // The pattern of the LIKE operator if a plain substring
+    // search would yield different results
+    QString m_likePattern;
+
+    // The columns and the results for each distinct string
+    // of the most recently matched track index
+    mutable const ColumnarTrackIndex* m_pMatchedIndex;
+    mutable std::vector<int> m_matchedIndexColumns;
+    mutable std::vector<qint8> m_matchedIndexStrings;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -92,6 +112,7 @@ class NullOrEmptyTextFilterNode : public QueryNode {
     }
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
@@ -105,9 +126,12 @@ class CrateFilterNode : public QueryNode {
             const QString& crateNameLike);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -119,9 +143,12 @@ class NoCrateFilterNode : public QueryNode {
     explicit NoCrateFilterNode(const CrateStorage* pCrateStorage);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
+    bool matchTrackId(TrackId trackId) const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -133,6 +160,7 @@ class NumericFilterNode : public QueryNode {
     NumericFilterNode(const QStringList& sqlColumns, const QString& argument);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   protected:
@@ -147,6 +175,8 @@ class NumericFilterNode : public QueryNode {
 
     virtual double parse(const QString& arg, bool* ok);
 
+    bool matchValue(const QVariant& value) const;
+
     QStringList m_sqlColumns;
     bool m_bOperatorQuery;
     bool m_bNullQuery;
@@ -162,6 +192,7 @@ class NullNumericFilterNode : public QueryNode {
     explicit NullNumericFilterNode(const QStringList& sqlColumns);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
     QStringList m_sqlColumns;
@@ -180,6 +211,7 @@ class KeyFilterNode : public QueryNode {
     KeyFilterNode(mixxx::track::io::key::ChromaticKey key, bool fuzzy);
 
     bool match(const TrackPointer& pTrack) const override;
+    bool match(const ColumnarTrackIndex& index, int row) const override;
     QString toSql() const override;
 
   private:
@@ -202,6 +234,12 @@ class SqlNode : public QueryNode {
         return true;
     }
 
+    bool match(const ColumnarTrackIndex& index, int row) const override {
+        Q_UNUSED(index);
+        Q_UNUSED(row);
+        return true;
+    }
+
     QString toSql() const override {
         return m_sql;
     }
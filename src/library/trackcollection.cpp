@@ -86,10 +86,19 @@ void TrackCollection::connectDatabase(const QSqlDatabase& database) {
     m_crates.connectDatabase(database);
 }
 
+void TrackCollection::connectReadOnlyDatabase(const QSqlDatabase& database) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    kLogger.info() << "Connecting read-only database";
+    DEBUG_ASSERT(database.isOpen());
+    m_readOnlyDatabase = database;
+}
+
 void TrackCollection::disconnectDatabase() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
 
     kLogger.info() << "Disconnecting database";
+    m_readOnlyDatabase = QSqlDatabase();
     m_database = QSqlDatabase();
     m_trackDao.finish();
     m_crates.disconnectDatabase();
@@ -43,6 +43,16 @@ class TrackCollection : public QObject,
         return m_database;
     }
 
+    // The library models only query the database. Their read-only
+    // connection is not blocked while other threads are writing.
+    // Falls back to database() if not connected.
+    void connectReadOnlyDatabase(
+            const QSqlDatabase& database);
+    QSqlDatabase readOnlyDatabase() const {
+        DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+        return m_readOnlyDatabase.isOpen() ? m_readOnlyDatabase : m_database;
+    }
+
     QList<mixxx::FileInfo> loadRootDirs(
             bool skipInvalidOrMissing = false) const;
 
@@ -166,6 +176,7 @@ class TrackCollection : public QObject,
     bool saveTrack(Track* pTrack) const;
 
     QSqlDatabase m_database;
+    QSqlDatabase m_readOnlyDatabase;
 
     PlaylistDAO m_playlistDao;
     CrateStorage m_crates;
@@ -6,6 +6,7 @@
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/trackmetadataexportqueue.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -53,6 +54,8 @@ TrackCollectionManager::TrackCollectionManager(
     }
 
     m_pInternalCollection->connectDatabase(dbConnection);
+    m_pInternalCollection->connectReadOnlyDatabase(mixxx::DbConnectionPooled(
+            pDbConnectionPool, mixxx::DbConnection::AccessMode::ReadOnly));
 
     if (deleteTrackForTestingFn) {
         kLogger.info() << "External collections are disabled in test mode";
@@ -126,6 +129,51 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    // Tests expect that metadata has been exported synchronously
+    // after a track has been evicted
+    if (!deleteTrackForTestingFn &&
+            pConfig->getValue(
+                    mixxx::library::prefs::kAsyncTrackMetadataExportConfigKey,
+                    mixxx::library::prefs::kAsyncTrackMetadataExportDefault)) {
+        m_pMetadataExportQueue = std::make_unique<TrackMetadataExportQueue>(
+                nullptr,
+                [] {
+                    return GlobalTrackCacheLocker().getCachedTrackIds();
+                });
+        connect(m_pMetadataExportQueue.get(),
+                &TrackMetadataExportQueue::trackMetadataExported,
+                /*receiver thread context*/ this,
+                [this](TrackId trackId, const QDateTime& sourceSynchronizedAt) {
+                    afterTrackMetadataExported(trackId, sourceSynchronizedAt);
+                });
+        connect(m_pMetadataExportQueue.get(),
+                &TrackMetadataExportQueue::trackMetadataExportFailed,
+                /*receiver thread context*/ this,
+                [this](TrackId trackId, const QString& location) {
+                    // The file tags are no longer synchronized
+                    afterTrackMetadataExported(trackId, QDateTime());
+                    emit trackMetadataExportFailed(location);
+                });
+        connect(m_pMetadataExportQueue.get(),
+                &TrackMetadataExportQueue::progress,
+                /*receiver thread context*/ this,
+                [](int finishedTracks, int totalTracks) {
+                    if (finishedTracks == totalTracks) {
+                        kLogger.info()
+                                << "Exported metadata of"
+                                << totalTracks
+                                << "track(s) in the background";
+                    } else if (kLogger.debugEnabled()) {
+                        kLogger.debug()
+                                << "Exported metadata of"
+                                << finishedTracks
+                                << "of"
+                                << totalTracks
+                                << "track(s) in the background";
+                    }
+                });
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
@@ -151,6 +199,16 @@ TrackCollectionManager::~TrackCollectionManager() {
     // components are accessing those files at this point.
     GlobalTrackCacheLocker().deactivateCache();
 
+    if (m_pMetadataExportQueue) {
+        kLogger.info()
+                << "Exporting metadata of"
+                << m_pMetadataExportQueue->numPendingTracks()
+                << "track(s)";
+        // Requires the database for storing the synchronization time stamps
+        m_pMetadataExportQueue->finishPendingExports();
+        m_pMetadataExportQueue.reset();
+    }
+
     for (const auto& externalCollection : std::as_const(m_externalCollections)) {
         kLogger.info()
                 << "Disconnecting from"
@@ -304,10 +362,21 @@ ExportTrackMetadataResult TrackCollectionManager::exportTrackMetadataBeforeSavin
                                     .toInt() == 1)) {
         switch (mode) {
         case TrackMetadataExportMode::Immediate: {
+            const auto syncParams =
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig);
+            // Writing file tags is slow. Export a snapshot of the track
+            // on a worker thread to avoid blocking the cache. The library
+            // is updated after the file tags have been written.
+            if (m_pMetadataExportQueue &&
+                    pTrack->getId().isValid() &&
+                    m_pMetadataExportQueue->enqueue(
+                            pTrack->cloneForMetadataExport(), syncParams)) {
+                return ExportTrackMetadataResult::Skipped;
+            }
             // Export track metadata now by saving as file tags.
             const auto result = SoundSourceProxy::exportTrackMetadataBeforeSaving(
                     pTrack,
-                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+                    syncParams);
             if (result == ExportTrackMetadataResult::Failed) {
                 const auto fileInfo = pTrack->getFileInfo();
                 if (fileInfo.checkFileExists()) {
@@ -563,6 +632,22 @@ void TrackCollectionManager::afterTracksRelocated(
     }
 }
 
+void TrackCollectionManager::afterTrackMetadataExported(
+        TrackId trackId,
+        const QDateTime& sourceSynchronizedAt) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    // Only the time stamp needs to be updated. All other metadata has
+    // already been saved when the track has been evicted.
+    if (!m_pInternalCollection->getTrackDAO().updateTrackSourceSynchronizedAt(
+                trackId, sourceSynchronizedAt)) {
+        kLogger.debug()
+                << "Track"
+                << trackId
+                << "has been purged while exporting metadata";
+    }
+}
+
 TrackPointer TrackCollectionManager::getTrackById(
         TrackId trackId) const {
     return internalCollection()->getTrackById(
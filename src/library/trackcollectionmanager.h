@@ -16,6 +16,7 @@
 class LibraryScanner;
 class TrackCollection;
 class ExternalTrackCollection;
+class TrackMetadataExportQueue;
 
 // Manages Mixxx's internal database of tracks as well as external track collections.
 //
@@ -95,6 +96,9 @@ class TrackCollectionManager: public QObject,
     void libraryScanStarted();
     void libraryScanFinished();
 
+    /// Exporting metadata into the file tags in the background failed
+    void trackMetadataExportFailed(const QString& location);
+
   public slots:
     void startLibraryScan();
     void stopLibraryScan();
@@ -103,6 +107,9 @@ class TrackCollectionManager: public QObject,
     void afterTrackAdded(const TrackPointer& pTrack) const;
     void afterTracksUpdated(const QSet<TrackId>& updatedTrackIds) const;
     void afterTracksRelocated(const QList<RelocatedTrack>& relocatedTracks) const;
+    void afterTrackMetadataExported(
+            TrackId trackId,
+            const QDateTime& sourceSynchronizedAt) const;
 
     // Callback for GlobalTrackCache
     void saveEvictedTrack(Track* pTrack) noexcept override;
@@ -127,4 +134,8 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    // Exports the metadata of evicted tracks asynchronously. Disabled
+    // in test mode.
+    std::unique_ptr<TrackMetadataExportQueue> m_pMetadataExportQueue;
 };
@@ -0,0 +1,211 @@
+#include "library/trackmetadataexportqueue.h"
+
+#include <QtConcurrentRun>
+
+#include "moc_trackmetadataexportqueue.cpp"
+#include "sources/soundsourceproxy.h"
+#include "track/globaltrackcache.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackMetadataExportQueue");
+
+constexpr int kRetryIntervalMillis = 1000;
+
+} // anonymous namespace
+
+TrackMetadataExportQueue::TrackMetadataExportQueue(
+        QObject* pParent,
+        getTrackIdsInUseFn_t getTrackIdsInUseFn,
+        int maxPendingTracks,
+        int maxThreadCount)
+        : QObject(pParent),
+          m_getTrackIdsInUseFn(std::move(getTrackIdsInUseFn)),
+          m_maxPendingTracks(maxPendingTracks),
+          m_dispatchScheduled(false),
+          m_finishedTracks(0),
+          m_totalTracks(0) {
+    DEBUG_ASSERT(m_maxPendingTracks > 0);
+    m_threadPool.setMaxThreadCount(maxThreadCount);
+    m_retryTimer.setSingleShot(true);
+    m_retryTimer.setInterval(kRetryIntervalMillis);
+    connect(&m_retryTimer,
+            &QTimer::timeout,
+            this,
+            &TrackMetadataExportQueue::slotDispatch);
+}
+
+TrackMetadataExportQueue::~TrackMetadataExportQueue() {
+    finishPendingExports();
+}
+
+//static
+ExportTrackMetadataResult TrackMetadataExportQueue::exportTrackMetadata(
+        Track* pTrack,
+        SyncTrackMetadataParams syncParams) {
+    // Keep the shard of the file locked while writing. Importing metadata
+    // from the file and loading the track lock the same shard and have
+    // to wait until the file tags have been written.
+    GlobalTrackCacheLocker locker(TrackRef::fromFileInfo(pTrack->getFileInfo()));
+    return SoundSourceProxy::exportTrackMetadataBeforeSaving(pTrack, syncParams);
+}
+
+bool TrackMetadataExportQueue::enqueue(
+        TrackPointer pDetachedTrack,
+        const SyncTrackMetadataParams& syncParams) {
+    VERIFY_OR_DEBUG_ASSERT(pDetachedTrack) {
+        return true;
+    }
+    const QString location = pDetachedTrack->getLocation();
+    const auto it = m_pendingJobs.find(location);
+    if (it != m_pendingJobs.end()) {
+        // Coalesce with the pending export that has not been started yet.
+        // Only the most recent metadata needs to be written.
+        kLogger.debug()
+                << "Replacing pending export of"
+                << location;
+        it.value() = PendingJob{std::move(pDetachedTrack), syncParams};
+        return true;
+    }
+    if (numPendingTracks() >= m_maxPendingTracks) {
+        kLogger.debug()
+                << "Queue is full, unable to export"
+                << location;
+        return false;
+    }
+    m_pendingJobs.insert(location, PendingJob{std::move(pDetachedTrack), syncParams});
+    m_pendingLocations.append(location);
+    ++m_totalTracks;
+    // Tracks are evicted while the GlobalTrackCache is locked.
+    // Defer the dispatching to not block the cache any longer.
+    scheduleDispatch();
+    return true;
+}
+
+void TrackMetadataExportQueue::scheduleDispatch() {
+    if (m_dispatchScheduled) {
+        return;
+    }
+    m_dispatchScheduled = true;
+    QMetaObject::invokeMethod(
+            this,
+            &TrackMetadataExportQueue::slotDispatch,
+            Qt::QueuedConnection);
+}
+
+void TrackMetadataExportQueue::slotDispatch() {
+    m_dispatchScheduled = false;
+    dispatch(false);
+}
+
+void TrackMetadataExportQueue::dispatch(bool exportTracksInUse) {
+    if (m_pendingLocations.isEmpty()) {
+        return;
+    }
+    QSet<TrackId> trackIdsInUse;
+    if (!exportTracksInUse && m_getTrackIdsInUseFn) {
+        trackIdsInUse = m_getTrackIdsInUseFn();
+    }
+    bool postponed = false;
+    auto locationIt = m_pendingLocations.begin();
+    while (locationIt != m_pendingLocations.end() &&
+            m_runningJobs.size() < m_threadPool.maxThreadCount()) {
+        const QString location = *locationIt;
+        if (m_runningJobs.contains(location)) {
+            // Wait until the previous export of the same file has finished
+            ++locationIt;
+            continue;
+        }
+        const auto jobIt = m_pendingJobs.find(location);
+        DEBUG_ASSERT(jobIt != m_pendingJobs.end());
+        if (trackIdsInUse.contains(jobIt.value().pTrack->getId())) {
+            // Writing into a file that is currently opened for playback
+            // might fail or interrupt the playback
+            postponed = true;
+            ++locationIt;
+            continue;
+        }
+        PendingJob job = std::move(jobIt.value());
+        m_pendingJobs.erase(jobIt);
+        locationIt = m_pendingLocations.erase(locationIt);
+        startJob(location, std::move(job));
+    }
+    if (postponed && m_runningJobs.isEmpty()) {
+        m_retryTimer.start();
+    }
+}
+
+void TrackMetadataExportQueue::startJob(
+        const QString& location,
+        PendingJob job) {
+    DEBUG_ASSERT(!m_runningJobs.contains(location));
+    auto* pWatcher = new QFutureWatcher<ExportTrackMetadataResult>(this);
+    connect(pWatcher,
+            &QFutureWatcher<ExportTrackMetadataResult>::finished,
+            this,
+            [this, location] {
+                finishJob(location);
+                dispatch(false);
+            });
+    // The running job keeps the track alive until the export has
+    // finished and releases it in this thread
+    pWatcher->setFuture(QtConcurrent::run(
+            &m_threadPool,
+            &TrackMetadataExportQueue::exportTrackMetadata,
+            job.pTrack.get(),
+            job.syncParams));
+    m_runningJobs.insert(location, RunningJob{std::move(job.pTrack), pWatcher});
+}
+
+void TrackMetadataExportQueue::finishJob(const QString& location) {
+    const auto it = m_runningJobs.find(location);
+    if (it == m_runningJobs.end()) {
+        // Already finished synchronously
+        return;
+    }
+    const RunningJob job = it.value();
+    m_runningJobs.erase(it);
+    job.pWatcher->waitForFinished();
+    const ExportTrackMetadataResult result = job.pWatcher->result();
+    job.pWatcher->deleteLater();
+
+    switch (result) {
+    case ExportTrackMetadataResult::Succeeded:
+        DEBUG_ASSERT(job.pTrack->getSourceSynchronizedAt().isValid());
+        emit trackMetadataExported(
+                job.pTrack->getId(),
+                job.pTrack->getSourceSynchronizedAt());
+        break;
+    case ExportTrackMetadataResult::Failed:
+        kLogger.warning()
+                << "Failed to export track metadata"
+                << location;
+        emit trackMetadataExportFailed(
+                job.pTrack->getId(),
+                location);
+        break;
+    case ExportTrackMetadataResult::Skipped:
+        break;
+    }
+
+    ++m_finishedTracks;
+    emit progress(m_finishedTracks, m_totalTracks);
+    if (numPendingTracks() == 0) {
+        m_finishedTracks = 0;
+        m_totalTracks = 0;
+    }
+}
+
+void TrackMetadataExportQueue::finishPendingExports() {
+    m_retryTimer.stop();
+    while (numPendingTracks() > 0) {
+        dispatch(true);
+        const QStringList runningLocations = m_runningJobs.keys();
+        for (const auto& location : runningLocations) {
+            finishJob(location);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <functional>
+
+#include "track/track_decl.h"
+#include "track/trackid.h"
+
+/// Exports the metadata of evicted tracks into their file tags on
+/// worker threads, i.e. without blocking the caller on file I/O.
+///
+/// The queue is bounded. Multiple exports of the same file that are
+/// still pending are coalesced into a single write with the most
+/// recent metadata, and a file is never written by more than one
+/// worker at a time. Tracks that are currently in use, e.g. loaded
+/// into a deck, are postponed until they are no longer in use.
+///
+/// Each worker keeps the shard of the GlobalTrackCache that contains
+/// the file locked during the export. The file is neither imported nor
+/// loaded concurrently. Must not wait for pending exports while the
+/// GlobalTrackCache is locked.
+///
+/// Must only be used from the thread of this object.
+class TrackMetadataExportQueue : public QObject {
+    Q_OBJECT
+  public:
+    static constexpr int kDefaultMaxPendingTracks = 4096;
+    static constexpr int kDefaultMaxThreadCount = 2;
+
+    /// Returns the ids of all tracks that are currently in use
+    typedef std::function<QSet<TrackId>()> getTrackIdsInUseFn_t;
+
+    TrackMetadataExportQueue(
+            QObject* pParent,
+            getTrackIdsInUseFn_t getTrackIdsInUseFn,
+            int maxPendingTracks = kDefaultMaxPendingTracks,
+            int maxThreadCount = kDefaultMaxThreadCount);
+    /// Finishes all pending exports.
+    ~TrackMetadataExportQueue() override;
+
+    /// Takes a detached track, see Track::cloneForMetadataExport().
+    ///
+    /// Returns false if the queue is full. The caller should then
+    /// export the metadata synchronously.
+    bool enqueue(
+            TrackPointer pDetachedTrack,
+            const SyncTrackMetadataParams& syncParams);
+
+    /// Blocks until all pending exports have finished, including those
+    /// of tracks that are still in use.
+    void finishPendingExports();
+
+    /// Both pending and running exports
+    int numPendingTracks() const {
+        return m_pendingLocations.size() + m_runningJobs.size();
+    }
+
+  signals:
+    /// The metadata has been exported and the file tags are
+    /// synchronized since the given time stamp.
+    void trackMetadataExported(
+            TrackId trackId,
+            const QDateTime& sourceSynchronizedAt);
+    /// The file tags are no longer synchronized with the metadata
+    /// in the library.
+    void trackMetadataExportFailed(
+            TrackId trackId,
+            const QString& location);
+    /// The number of finished exports since the queue has been
+    /// idle for the last time.
+    void progress(
+            int finishedTracks,
+            int totalTracks);
+
+  private slots:
+    void slotDispatch();
+
+  private:
+    static ExportTrackMetadataResult exportTrackMetadata(
+            Track* pTrack,
+            SyncTrackMetadataParams syncParams);
+
+    struct PendingJob {
+        TrackPointer pTrack;
+        SyncTrackMetadataParams syncParams;
+    };
+    struct RunningJob {
+        TrackPointer pTrack;
+        QFutureWatcher<ExportTrackMetadataResult>* pWatcher;
+    };
+
+    void scheduleDispatch();
+    void dispatch(bool exportTracksInUse);
+    void startJob(const QString& location, PendingJob job);
+    void finishJob(const QString& location);
+
+    const getTrackIdsInUseFn_t m_getTrackIdsInUseFn;
+    const int m_maxPendingTracks;
+
+    QThreadPool m_threadPool;
+
+    // Indexed by location
+    QHash<QString, PendingJob> m_pendingJobs;
+    // The order of the pending jobs
+    QStringList m_pendingLocations;
+    // Indexed by location
+    QHash<QString, RunningJob> m_runningJobs;
+
+    bool m_dispatchScheduled;
+    // Retries postponed exports of tracks that are in use
+    QTimer m_retryTimer;
+
+    int m_finishedTracks;
+    int m_totalTracks;
+};
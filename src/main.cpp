@@ -1,5 +1,6 @@
 #include <QApplication>
 #include <QDir>
+#include <QFileInfo>
 #include <QString>
 #include <QStringList>
 #include <QTextCodec>
@@ -10,7 +11,10 @@
 
 #include "config.h"
 #include "controllers/controllermanager.h"
+#include "control/controlobject.h"
 #include "coreservices.h"
+#include "engine/enginemaster.h"
+#include "engine/engineofflinerenderer.h"
 #include "errordialoghandler.h"
 #include "mixxxapplication.h"
 #ifdef MIXXX_USE_QML
@@ -18,6 +22,9 @@
 #else
 #include "mixxxmainwindow.h"
 #endif
+#include "mixer/playermanager.h"
+#include "recording/defs_recording.h"
+#include "soundio/soundmanager.h"
 #include "sources/soundsourceproxy.h"
 #include "util/cmdlineargs.h"
 #include "util/console.h"
@@ -31,11 +38,111 @@ namespace {
 constexpr int kFatalErrorOnStartupExitCode = 1;
 #endif
 constexpr int kParseCmdlineArgsErrorExitCode = 2;
+constexpr int kRenderOfflineErrorExitCode = 3;
+
+// Without --render-duration rendering stops when all decks have stopped,
+// checked after each slice
+constexpr auto kRenderOfflineSliceDuration = mixxx::Duration::fromSeconds(1);
 
 constexpr char kScaleFactorEnvVar[] = "QT_SCALE_FACTOR";
 const QString kConfigGroup = QStringLiteral("[Config]");
 const QString kScaleFactorKey = QStringLiteral("ScaleFactor");
 
+QString encodingForRenderOfflinePath(const QString& path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == QStringLiteral("wav")) {
+        return ENCODING_WAVE;
+    }
+    if (suffix == QStringLiteral("aif") || suffix == QStringLiteral("aiff")) {
+        return ENCODING_AIFF;
+    }
+    if (suffix == QStringLiteral("flac")) {
+        return ENCODING_FLAC;
+    }
+    return QString();
+}
+
+/// Plays the music files from the command line simultaneously from their
+/// start, starting from the main cue if one is set, and renders the mix
+/// into a file. No audio device is opened and no window is shown.
+int runOfflineRenderer(MixxxApplication* pApp, const CmdlineArgs& args) {
+    const QString encoding = encodingForRenderOfflinePath(args.getRenderOfflinePath());
+    if (encoding.isEmpty()) {
+        qWarning() << "Unsupported file type for rendering offline"
+                   << args.getRenderOfflinePath();
+        return kRenderOfflineErrorExitCode;
+    }
+
+    const auto pCoreServices = std::make_shared<mixxx::CoreServices>(args, pApp);
+
+    CmdlineArgs::Instance().parseForUserFeedback();
+
+    // Loads the music files from the command line into the decks
+    pCoreServices->initialize(pApp);
+
+    const SoundManagerConfig soundConfig = pCoreServices->getSoundManager()->getConfig();
+    EngineOfflineRenderer renderer(pCoreServices->getSettings(),
+            pCoreServices->getEngineMaster().get(),
+            mixxx::audio::SampleRate(soundConfig.getSampleRate()),
+            static_cast<SINT>(soundConfig.getFramesPerBuffer()));
+    QString errorMessage;
+    if (!renderer.open(args.getRenderOfflinePath(), encoding, &errorMessage)) {
+        qWarning() << "Failed to open" << args.getRenderOfflinePath() << errorMessage;
+        return kRenderOfflineErrorExitCode;
+    }
+
+    // Loading the tracks continues on the engine workers and is finished
+    // by queued signals in the main thread
+    if (!renderer.waitForEngineWorkers()) {
+        return kRenderOfflineErrorExitCode;
+    }
+    pApp->processEvents();
+
+    QList<ConfigKey> playKeys;
+    const int deckCount = static_cast<int>(PlayerManager::numDecks());
+    for (int i = 0; i < deckCount && i < args.getMusicFiles().size(); ++i) {
+        const QString group = PlayerManager::groupForDeck(i);
+        if (ControlObject::get(ConfigKey(group, QStringLiteral("track_loaded"))) > 0) {
+            playKeys.append(ConfigKey(group, QStringLiteral("play")));
+        } else {
+            qWarning() << "Failed to load" << args.getMusicFiles().at(i);
+        }
+    }
+    if (playKeys.isEmpty()) {
+        return kRenderOfflineErrorExitCode;
+    }
+    for (const auto& playKey : qAsConst(playKeys)) {
+        ControlObject::set(playKey, 1.0);
+    }
+
+    // Rendering is aborted if the engine workers don't respond
+    const auto renderSlice = [&renderer, &soundConfig](mixxx::Duration duration) {
+        const SINT framesBefore = renderer.stats().frames;
+        renderer.render(duration);
+        return renderer.stats().frames - framesBefore >=
+                static_cast<SINT>(duration.toDoubleSeconds() * soundConfig.getSampleRate());
+    };
+    bool finished;
+    if (args.getRenderDurationSeconds() > 0) {
+        finished = renderSlice(mixxx::Duration::fromSeconds(args.getRenderDurationSeconds()));
+    } else {
+        const auto isAnyDeckPlaying = [&playKeys] {
+            for (const auto& playKey : qAsConst(playKeys)) {
+                if (ControlObject::get(playKey) > 0) {
+                    return true;
+                }
+            }
+            return false;
+        };
+        finished = true;
+        while (finished && isAnyDeckPlaying()) {
+            finished = renderSlice(kRenderOfflineSliceDuration);
+        }
+    }
+    renderer.close();
+    return finished ? 0 : kRenderOfflineErrorExitCode;
+}
+
 int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     const auto pCoreServices = std::make_shared<mixxx::CoreServices>(args, pApp);
 
@@ -210,7 +317,12 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int exitCode = runMixxx(&app, args);
+    int exitCode;
+    if (args.getRenderOffline()) {
+        exitCode = runOfflineRenderer(&app, args);
+    } else {
+        exitCode = runMixxx(&app, args);
+    }
 
     qDebug() << "Mixxx shutdown complete with code" << exitCode;
 
@@ -32,6 +32,7 @@
 #include "controllers/controllermanager.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
+#include "library/dlgtrackmetadataexport.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
 #ifdef __ENGINEPRIME__
@@ -275,6 +276,11 @@ void MixxxMainWindow::initialize() {
             WaveformWidgetFactory::instance(),
             &WaveformWidgetFactory::slotSkinLoaded);
 
+    connect(m_pCoreServices->getTrackCollectionManager().get(),
+            &TrackCollectionManager::trackMetadataExportFailed,
+            this,
+            &mixxx::DlgTrackMetadataExport::showFailedMessageBoxOncePerSession);
+
     // Initialize preference dialog
     m_pPrefDlg = new DlgPreferences(
             m_pCoreServices->getScreensaverManager(),
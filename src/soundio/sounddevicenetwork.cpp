@@ -14,7 +14,6 @@
 #include "util/logger.h"
 #include "util/sample.h"
 #include "util/timer.h"
-#include "util/trace.h"
 #include "waveform/visualplayposition.h"
 
 namespace {
@@ -432,8 +431,7 @@ void SoundDeviceNetwork::callbackProcessClkRef() {
     //       size
     updateCallbackEntryToDacTime(framesPerBuffer);
 
-    Trace trace("SoundDeviceNetwork::callbackProcessClkRef %1",
-                m_deviceId.name);
+    ScopedTimer trace("SoundDeviceNetwork::callbackProcessClkRef");
 
 
     if (!m_denormals) {
@@ -485,8 +483,7 @@ void SoundDeviceNetwork::callbackProcessClkRef() {
     m_pSoundManager->readProcess(framesPerBuffer);
 
     {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess prepare %1",
-                m_deviceId.name);
+        ScopedTimer t("SoundDeviceNetwork::callbackProcessClkRef prepare");
         m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
     }
 
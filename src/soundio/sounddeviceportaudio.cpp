@@ -17,7 +17,6 @@
 #include "util/math.h"
 #include "util/sample.h"
 #include "util/timer.h"
-#include "util/trace.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "waveform/visualplayposition.h"
 
@@ -118,6 +117,15 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
     }
     m_deviceId.portAudioIndex = devIndex;
     m_strDisplayName = QString::fromUtf8(deviceInfo->name);
+    for (auto* pTraceTag : {&m_callbackProcessTraceTag,
+                 &m_callbackProcessDriftTraceTag,
+                 &m_callbackProcessClkRefTraceTag,
+                 &m_callbackInputTraceTag,
+                 &m_callbackPrepareTraceTag,
+                 &m_callbackOutputTraceTag}) {
+        *pTraceTag = mixxx::TraceTag::intern(QStringLiteral("%1 %2").arg(
+                QString::fromUtf8(pTraceTag->name()), m_deviceId.debugName()));
+    }
     m_iNumInputChannels = m_deviceInfo->maxInputChannels;
     m_iNumOutputChannels = m_deviceInfo->maxOutputChannels;
 
@@ -693,8 +701,7 @@ int SoundDevicePortAudio::callbackProcessDrift(
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
-    Trace trace("SoundDevicePortAudio::callbackProcessDrift %1",
-            m_deviceId.debugName());
+    ScopedTimer trace(m_callbackProcessDriftTraceTag);
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(7);
@@ -826,7 +833,7 @@ int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
-    Trace trace("SoundDevicePortAudio::callbackProcess %1", m_deviceId.debugName());
+    ScopedTimer trace(m_callbackProcessTraceTag);
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(1);
@@ -880,8 +887,7 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     // This must be the very first call, else timeInfo becomes invalid
     updateCallbackEntryToDacTime(framesPerBuffer, timeInfo);
 
-    Trace trace("SoundDevicePortAudio::callbackProcessClkRef %1",
-            m_deviceId.debugName());
+    ScopedTimer trace(m_callbackProcessClkRefTraceTag);
 
     //qDebug() << "SoundDevicePortAudio::callbackProcess:" << m_deviceId;
 
@@ -975,8 +981,7 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     // Send audio from the soundcard's input off to the SoundManager...
     if (in) {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess input %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_callbackInputTraceTag);
         composeInputBuffer(in, framesPerBuffer, 0, m_inputParams.channelCount);
         m_pSoundManager->pushInputBuffers(m_audioInputs, framesPerBuffer);
     }
@@ -984,14 +989,12 @@ int SoundDevicePortAudio::callbackProcessClkRef(
     m_pSoundManager->readProcess(framesPerBuffer);
 
     {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess prepare %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_callbackPrepareTraceTag);
         m_pSoundManager->onDeviceOutputCallback(framesPerBuffer);
     }
 
     if (out) {
-        ScopedTimer t("SoundDevicePortAudio::callbackProcess output %1",
-                m_deviceId.debugName());
+        ScopedTimer t(m_callbackOutputTraceTag);
 
         if (m_outputParams.channelCount <= 0) {
             qWarning()
@@ -9,6 +9,7 @@
 #include "soundio/sounddevice.h"
 #include "util/duration.h"
 #include "util/performancetimer.h"
+#include "util/tracering.h"
 
 class SoundManager;
 class ControlProxy;
@@ -82,4 +83,15 @@ class SoundDevicePortAudio : public SoundDevice {
     int m_invalidTimeInfoCount;
     PerformanceTimer m_clkRefTimer;
     PaTime m_lastCallbackEntrytoDacSecs;
+
+    // Interned with the name of the device when it is known
+    mixxx::TraceTag m_callbackProcessTraceTag = "SoundDevicePortAudio::callbackProcess";
+    mixxx::TraceTag m_callbackProcessDriftTraceTag =
+            "SoundDevicePortAudio::callbackProcessDrift";
+    mixxx::TraceTag m_callbackProcessClkRefTraceTag =
+            "SoundDevicePortAudio::callbackProcessClkRef";
+    mixxx::TraceTag m_callbackInputTraceTag = "SoundDevicePortAudio::callbackProcess input";
+    mixxx::TraceTag m_callbackPrepareTraceTag =
+            "SoundDevicePortAudio::callbackProcess prepare";
+    mixxx::TraceTag m_callbackOutputTraceTag = "SoundDevicePortAudio::callbackProcess output";
 };
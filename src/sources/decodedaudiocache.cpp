@@ -0,0 +1,455 @@
+#include "sources/decodedaudiocache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DecodedAudioCache");
+
+const QString kConfigGroup = QStringLiteral("[DecodedAudioCache]");
+const ConfigKey kEnabledConfigKey(kConfigGroup, QStringLiteral("Enabled"));
+const ConfigKey kMaxSizeMiBConfigKey(kConfigGroup, QStringLiteral("MaxSizeMiB"));
+
+constexpr bool kEnabledDefault = false;
+constexpr int kMaxSizeMiBDefault = 4096;
+
+const QString kDirectoryName = QStringLiteral("decoded_audio_cache");
+const QString kFileNameSuffix = QStringLiteral(".pcm");
+
+constexpr audio::ChannelCount kChannelCount = audio::ChannelCount::stereo();
+
+constexpr char kMagic[8] = {'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M'};
+constexpr quint32 kVersion = 1;
+
+// Stored in native byte order, because the cache is never shared
+// between different machines. The size of the header is a multiple
+// of the cache line size to keep the samples that follow aligned.
+struct EntryHeader {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+    qint64 fileSize;
+    qint64 fileLastModifiedMillis;
+    quint8 reserved[8];
+};
+static_assert(sizeof(EntryHeader) == 64, "unexpected padding");
+
+// The properties of the original file that are used for detecting
+// modifications.
+struct SourceFileKey {
+    QString location;
+    qint64 size;
+    qint64 lastModifiedMillis;
+
+    bool isValid() const {
+        return !location.isEmpty();
+    }
+};
+
+SourceFileKey sourceFileKey(const FileInfo& fileInfo) {
+    // The cached file info of a track might be outdated
+    const QFileInfo freshFileInfo(fileInfo.location());
+    if (!freshFileInfo.exists()) {
+        return SourceFileKey{};
+    }
+    return SourceFileKey{
+            FileInfo::canonicalLocation(freshFileInfo),
+            freshFileInfo.size(),
+            freshFileInfo.lastModified().toMSecsSinceEpoch()};
+}
+
+qint64 entryFileSize(
+        const audio::SignalInfo& signalInfo,
+        IndexRange frameIndexRange) {
+    return static_cast<qint64>(sizeof(EntryHeader)) +
+            static_cast<qint64>(signalInfo.frames2samples(frameIndexRange.length())) *
+            static_cast<qint64>(sizeof(CSAMPLE));
+}
+
+class DecodedAudioCacheSource final : public AudioSource {
+  public:
+    DecodedAudioCacheSource(
+            const QUrl& url,
+            const QString& entryFilePath,
+            SourceFileKey sourceFileKey)
+            : AudioSource(url),
+              m_file(entryFilePath),
+              m_sourceFileKey(std::move(sourceFileKey)),
+              m_pSamples(nullptr) {
+    }
+    ~DecodedAudioCacheSource() override {
+        close();
+    }
+
+    void close() override {
+        m_pSamples = nullptr;
+        // Implicitly unmaps the file
+        m_file.close();
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return OpenResult::Aborted;
+        }
+        const qint64 fileSize = m_file.size();
+        if (fileSize < static_cast<qint64>(sizeof(EntryHeader))) {
+            kLogger.warning()
+                    << "Truncated cache entry"
+                    << m_file.fileName();
+            return OpenResult::Aborted;
+        }
+        const uchar* pMapped = m_file.map(0, fileSize);
+        if (!pMapped) {
+            kLogger.warning()
+                    << "Failed to map cache entry"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return OpenResult::Aborted;
+        }
+        EntryHeader header;
+        std::memcpy(&header, pMapped, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+                header.version != kVersion ||
+                header.fileSize != m_sourceFileKey.size ||
+                header.fileLastModifiedMillis != m_sourceFileKey.lastModifiedMillis) {
+            kLogger.warning()
+                    << "Invalid or outdated cache entry"
+                    << m_file.fileName();
+            return OpenResult::Aborted;
+        }
+        const auto frameIndexRange = IndexRange::between(
+                static_cast<SINT>(header.frameIndexStart),
+                static_cast<SINT>(header.frameIndexEnd));
+        if (!initChannelCountOnce(static_cast<int>(header.channelCount)) ||
+                !initSampleRateOnce(static_cast<SINT>(header.sampleRate)) ||
+                !initFrameIndexRangeOnce(frameIndexRange)) {
+            return OpenResult::Aborted;
+        }
+        if (header.bitrate > 0) {
+            initBitrateOnce(static_cast<SINT>(header.bitrate));
+        }
+        if (fileSize != entryFileSize(getSignalInfo(), frameIndexRange)) {
+            kLogger.warning()
+                    << "Unexpected size of cache entry"
+                    << m_file.fileName()
+                    << fileSize;
+            return OpenResult::Aborted;
+        }
+        m_pSamples = reinterpret_cast<const CSAMPLE*>(pMapped + sizeof(EntryHeader));
+        // Mark the entry as recently used
+        m_file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+        return OpenResult::Succeeded;
+    }
+
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames) override {
+        const SINT numberOfSamples =
+                getSignalInfo().frames2samples(writableSampleFrames.frameLength());
+        if (writableSampleFrames.writableData()) {
+            SampleUtil::copy(
+                    writableSampleFrames.writableData(),
+                    m_pSamples +
+                            getSignalInfo().frames2samples(
+                                    writableSampleFrames.frameIndexRange().start() -
+                                    frameIndexMin()),
+                    numberOfSamples);
+        }
+        return ReadableSampleFrames(
+                writableSampleFrames.frameIndexRange(),
+                SampleBuffer::ReadableSlice(
+                        writableSampleFrames.writableData(),
+                        numberOfSamples));
+    }
+
+  private:
+    QFile m_file;
+    const SourceFileKey m_sourceFileKey;
+    const CSAMPLE* m_pSamples;
+};
+
+} // anonymous namespace
+
+// static
+DecodedAudioCache* DecodedAudioCache::s_pInstance = nullptr;
+
+// static
+void DecodedAudioCache::createInstance(
+        const UserSettingsPointer& pConfig) {
+    DEBUG_ASSERT(!s_pInstance);
+    if (!pConfig->getValue(kEnabledConfigKey, kEnabledDefault)) {
+        return;
+    }
+    const int maxSizeMiB = pConfig->getValue(kMaxSizeMiBConfigKey, kMaxSizeMiBDefault);
+    if (maxSizeMiB <= 0) {
+        return;
+    }
+    const QDir directory(QDir(pConfig->getSettingsPath()).filePath(kDirectoryName));
+    if (!directory.exists() && !QDir().mkpath(directory.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << directory.absolutePath();
+        return;
+    }
+    s_pInstance = new DecodedAudioCache(
+            directory,
+            static_cast<quint64>(maxSizeMiB) * 1024 * 1024);
+    kLogger.info()
+            << "Caching up to"
+            << maxSizeMiB
+            << "MiB of decoded audio data in"
+            << directory.absolutePath();
+}
+
+// static
+void DecodedAudioCache::destroyInstance() {
+    delete s_pInstance;
+    s_pInstance = nullptr;
+}
+
+DecodedAudioCache::DecodedAudioCache(
+        const QDir& directory,
+        quint64 maxSizeInBytes)
+        : m_directory(directory),
+          m_maxSizeInBytes(maxSizeInBytes) {
+}
+
+QString DecodedAudioCache::entryFilePath(const FileInfo& fileInfo) const {
+    const auto key = sourceFileKey(fileInfo);
+    if (!key.isValid()) {
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(key.location.toUtf8());
+    hash.addData(QByteArray::number(key.size));
+    hash.addData(QByteArray::number(key.lastModifiedMillis));
+    return m_directory.filePath(QString::fromLatin1(hash.result().toHex()) + kFileNameSuffix);
+}
+
+bool DecodedAudioCache::contains(const FileInfo& fileInfo) const {
+    const QString filePath = entryFilePath(fileInfo);
+    return !filePath.isEmpty() && QFileInfo::exists(filePath);
+}
+
+AudioSourcePointer DecodedAudioCache::openAudioSource(
+        const FileInfo& fileInfo,
+        const AudioSource::OpenParams& params) {
+    if (params.getSignalInfo().getChannelCount() != kChannelCount) {
+        return nullptr;
+    }
+    const QString filePath = entryFilePath(fileInfo);
+    if (filePath.isEmpty() || !QFileInfo::exists(filePath)) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<DecodedAudioCacheSource>(
+            fileInfo.toQUrl(),
+            filePath,
+            sourceFileKey(fileInfo));
+    if (pAudioSource->open(AudioSource::OpenMode::Strict, params) !=
+            AudioSource::OpenResult::Succeeded) {
+        // Invalid entries will be replaced when written again
+        return nullptr;
+    }
+    kLogger.debug()
+            << "Reading cached audio data of"
+            << fileInfo.location();
+    return pAudioSource;
+}
+
+std::unique_ptr<DecodedAudioCache::Writer> DecodedAudioCache::createWriter(
+        const FileInfo& fileInfo,
+        const AudioSource& audioSource) {
+    const auto key = sourceFileKey(fileInfo);
+    if (!key.isValid()) {
+        return nullptr;
+    }
+    const audio::SignalInfo signalInfo(
+            kChannelCount,
+            audioSource.getSignalInfo().getSampleRate());
+    VERIFY_OR_DEBUG_ASSERT(signalInfo.isValid()) {
+        return nullptr;
+    }
+    const IndexRange frameIndexRange = audioSource.frameIndexRange();
+    if (static_cast<quint64>(entryFileSize(signalInfo, frameIndexRange)) > m_maxSizeInBytes) {
+        return nullptr;
+    }
+    EntryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.channelCount = signalInfo.getChannelCount();
+    header.sampleRate = signalInfo.getSampleRate();
+    header.bitrate = audioSource.getBitrate().isValid()
+            ? static_cast<quint32>(audioSource.getBitrate())
+            : 0;
+    header.frameIndexStart = frameIndexRange.start();
+    header.frameIndexEnd = frameIndexRange.end();
+    header.fileSize = key.size;
+    header.fileLastModifiedMillis = key.lastModifiedMillis;
+    auto pWriter = std::unique_ptr<Writer>(new Writer(
+            this,
+            entryFilePath(fileInfo),
+            QByteArray(reinterpret_cast<const char*>(&header), sizeof(header)),
+            signalInfo,
+            frameIndexRange));
+    if (pWriter->m_failed) {
+        return nullptr;
+    }
+    return pWriter;
+}
+
+quint64 DecodedAudioCache::sizeInBytes() const {
+    quint64 sizeInBytes = 0;
+    QDirIterator it(m_directory.absolutePath(),
+            QStringList{QStringLiteral("*") + kFileNameSuffix},
+            QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        sizeInBytes += static_cast<quint64>(it.fileInfo().size());
+    }
+    return sizeInBytes;
+}
+
+void DecodedAudioCache::evict() {
+    QMutexLocker locker(&m_evictionMutex);
+    std::vector<QFileInfo> entries;
+    quint64 sizeInBytes = 0;
+    QDirIterator it(m_directory.absolutePath(),
+            QStringList{QStringLiteral("*") + kFileNameSuffix},
+            QDir::Files);
+    while (it.hasNext()) {
+        it.next();
+        entries.push_back(it.fileInfo());
+        sizeInBytes += static_cast<quint64>(entries.back().size());
+    }
+    if (sizeInBytes <= m_maxSizeInBytes) {
+        return;
+    }
+    std::sort(entries.begin(),
+            entries.end(),
+            [](const QFileInfo& lhs, const QFileInfo& rhs) {
+                return lhs.lastModified() < rhs.lastModified();
+            });
+    for (const auto& entry : entries) {
+        if (sizeInBytes <= m_maxSizeInBytes) {
+            break;
+        }
+        // Deleting a file that is currently mapped by a reader fails
+        // on Windows. It will be deleted later.
+        if (QFile::remove(entry.absoluteFilePath())) {
+            sizeInBytes -= static_cast<quint64>(entry.size());
+        } else {
+            kLogger.debug()
+                    << "Failed to evict cache entry"
+                    << entry.absoluteFilePath();
+        }
+    }
+}
+
+DecodedAudioCache::Writer::Writer(
+        DecodedAudioCache* pCache,
+        const QString& fileName,
+        const QByteArray& header,
+        const audio::SignalInfo& signalInfo,
+        IndexRange frameIndexRange)
+        : m_pCache(pCache),
+          m_file(fileName),
+          m_signalInfo(signalInfo),
+          m_frameIndexRange(frameIndexRange),
+          m_writtenFrameIndexRange(IndexRange::between(
+                  frameIndexRange.start(), frameIndexRange.start())),
+          m_header(header),
+          m_failed(false) {
+    if (!m_file.open(QIODevice::WriteOnly) ||
+            m_file.write(m_header) != m_header.size()) {
+        kLogger.warning()
+                << "Failed to create cache entry"
+                << fileName
+                << m_file.errorString();
+        fail();
+    }
+}
+
+void DecodedAudioCache::Writer::fail() {
+    m_failed = true;
+    // The temporary file is discarded when the writer is destroyed
+    m_file.cancelWriting();
+}
+
+void DecodedAudioCache::Writer::write(const ReadableSampleFrames& sampleFrames) {
+    if (m_failed || sampleFrames.frameIndexRange().empty()) {
+        return;
+    }
+    if (sampleFrames.frameIndexRange().start() != m_writtenFrameIndexRange.end()) {
+        // Gaps are not supported
+        fail();
+        return;
+    }
+    DEBUG_ASSERT(sampleFrames.readableLength() ==
+            m_signalInfo.frames2samples(sampleFrames.frameLength()));
+    const qint64 numberOfBytes =
+            static_cast<qint64>(sampleFrames.readableLength()) * sizeof(CSAMPLE);
+    if (m_file.write(reinterpret_cast<const char*>(sampleFrames.readableData()),
+                numberOfBytes) != numberOfBytes) {
+        kLogger.warning()
+                << "Failed to write cache entry"
+                << m_file.fileName()
+                << m_file.errorString();
+        fail();
+        return;
+    }
+    m_writtenFrameIndexRange.growBack(sampleFrames.frameLength());
+}
+
+bool DecodedAudioCache::Writer::commit(IndexRange frameIndexRange) {
+    if (m_failed) {
+        return false;
+    }
+    DEBUG_ASSERT(frameIndexRange.isSubrangeOf(m_frameIndexRange));
+    if (m_writtenFrameIndexRange != frameIndexRange) {
+        fail();
+        return false;
+    }
+    if (frameIndexRange != m_frameIndexRange) {
+        // The audio source has been shrunk while reading
+        auto* pHeader = reinterpret_cast<EntryHeader*>(m_header.data());
+        pHeader->frameIndexStart = frameIndexRange.start();
+        pHeader->frameIndexEnd = frameIndexRange.end();
+        if (!m_file.seek(0) || m_file.write(m_header) != m_header.size()) {
+            fail();
+            return false;
+        }
+    }
+    if (!m_file.commit()) {
+        kLogger.warning()
+                << "Failed to commit cache entry"
+                << m_file.fileName()
+                << m_file.errorString();
+        m_failed = true;
+        return false;
+    }
+    m_failed = true; // committed only once
+    m_pCache->evict();
+    return true;
+}
+
+} // namespace mixxx
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QDir>
+#include <QMutex>
+#include <QSaveFile>
+#include <memory>
+
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "util/fileinfo.h"
+
+namespace mixxx {
+
+/// A size-bounded cache of decoded audio data on disk.
+///
+/// Each entry contains all decoded sample frames of a file together
+/// with its signal properties. Entries are keyed by the canonical
+/// location, the size, and the modification time of the original file.
+/// Modified files are therefore never served from the cache, stale
+/// entries are evicted eventually.
+///
+/// Cached audio data is read directly from memory mapped files,
+/// bypassing the decoder. The cache is populated while analyzing
+/// tracks, i.e. when all sample frames are decoded sequentially anyway.
+///
+/// When the total size of all entries exceeds the configured limit
+/// the least recently used entries are deleted. Using an entry touches
+/// its modification time.
+///
+/// All functions are thread-safe.
+class DecodedAudioCache final {
+  public:
+    /// Writes a new cache entry while the audio data is decoded.
+    ///
+    /// The entry only becomes visible after commit() succeeded. It is
+    /// discarded if the writer is destroyed before, or if writing fails.
+    class Writer final {
+      public:
+        /// Appends the decoded sample frames. The frames must be
+        /// consecutive, otherwise the entry is discarded.
+        void write(const ReadableSampleFrames& sampleFrames);
+
+        /// Publishes the cache entry if all sample frames of
+        /// frameIndexRange have been written.
+        ///
+        /// The frame index range of an audio source may shrink while
+        /// reading and must be passed again after all frames have been
+        /// read.
+        bool commit(IndexRange frameIndexRange);
+
+      private:
+        friend class DecodedAudioCache;
+        Writer(
+                DecodedAudioCache* pCache,
+                const QString& fileName,
+                const QByteArray& header,
+                const audio::SignalInfo& signalInfo,
+                IndexRange frameIndexRange);
+
+        void fail();
+
+        DecodedAudioCache* const m_pCache;
+        QSaveFile m_file;
+        const audio::SignalInfo m_signalInfo;
+        const IndexRange m_frameIndexRange;
+        IndexRange m_writtenFrameIndexRange;
+        QByteArray m_header;
+        bool m_failed;
+    };
+
+    /// Creates the global instance if enabled in the configuration.
+    static void createInstance(
+            const UserSettingsPointer& pConfig);
+    static void destroyInstance();
+
+    /// Returns nullptr if the cache is disabled.
+    static DecodedAudioCache* instance() {
+        return s_pInstance;
+    }
+
+    DecodedAudioCache(
+            const QDir& directory,
+            quint64 maxSizeInBytes);
+
+    /// Opens the cached audio data of a file for reading.
+    ///
+    /// Only returns an audio source if the requested channel count
+    /// matches the cached audio data, because the number of channels
+    /// is only a hint that decoders are free to ignore. Returns nullptr
+    /// if the file is not cached.
+    AudioSourcePointer openAudioSource(
+            const FileInfo& fileInfo,
+            const AudioSource::OpenParams& params);
+
+    bool contains(const FileInfo& fileInfo) const;
+
+    /// Returns a writer for caching the stereo audio data of a file
+    /// or nullptr if it could not be created.
+    std::unique_ptr<Writer> createWriter(
+            const FileInfo& fileInfo,
+            const AudioSource& audioSource);
+
+    /// The total size of all cache entries.
+    quint64 sizeInBytes() const;
+
+    /// Deletes the least recently used entries until the total size
+    /// of all entries does not exceed the limit.
+    void evict();
+
+  private:
+    static DecodedAudioCache* s_pInstance;
+
+    QString entryFilePath(const FileInfo& fileInfo) const;
+
+    const QDir m_directory;
+    const quint64 m_maxSizeInBytes;
+
+    // Serializes eviction
+    QMutex m_evictionMutex;
+};
+
+} // namespace mixxx
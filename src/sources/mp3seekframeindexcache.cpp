@@ -0,0 +1,271 @@
+#include "sources/mp3seekframeindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("Mp3SeekFrameIndexCache");
+
+const QString kConfigGroup = QStringLiteral("[Mp3SeekFrameIndexCache]");
+const ConfigKey kEnabledConfigKey(kConfigGroup, QStringLiteral("Enabled"));
+
+constexpr bool kEnabledDefault = true;
+
+// Next to the waveforms in the analysis storage directory
+const QString kDirectoryName = QStringLiteral("analysis/mp3_seek_frames");
+const QString kFileNameSuffix = QStringLiteral(".idx");
+
+constexpr quint32 kMagic = 0x4D503349; // "MP3I"
+// Must be incremented when changing the scan in SoundSourceMp3
+constexpr quint32 kVersion = 1;
+
+// Unsigned LEB128
+void writeVarUInt(QByteArray* pData, quint64 value) {
+    do {
+        auto byte = static_cast<char>(value & 0x7f);
+        value >>= 7;
+        if (value != 0) {
+            byte |= static_cast<char>(0x80);
+        }
+        pData->append(byte);
+    } while (value != 0);
+}
+
+bool readVarUInt(const QByteArray& data, int* pPos, quint64* pValue) {
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*pPos >= data.size()) {
+            return false;
+        }
+        const auto byte = static_cast<quint8>(data.at((*pPos)++));
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *pValue = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Both deltas of a seek frame are encoded with at least 1 byte each
+constexpr int kMinEncodedSeekFrameBytes = 2;
+
+// Frame indices and file offsets are strictly increasing. The deltas
+// of consecutive frames are mostly constant and compress very well.
+QByteArray encodeSeekFrames(const std::vector<Mp3SeekFrameIndex::SeekFrame>& seekFrames) {
+    QByteArray data;
+    data.reserve(static_cast<int>(seekFrames.size()) * 4);
+    SINT prevFrameIndex = 0;
+    qint64 prevFileOffset = 0;
+    for (const auto& seekFrame : seekFrames) {
+        writeVarUInt(&data, static_cast<quint64>(seekFrame.frameIndex - prevFrameIndex));
+        writeVarUInt(&data, static_cast<quint64>(seekFrame.fileOffset - prevFileOffset));
+        prevFrameIndex = seekFrame.frameIndex;
+        prevFileOffset = seekFrame.fileOffset;
+    }
+    return qCompress(data);
+}
+
+bool decodeSeekFrames(
+        const QByteArray& compressedData,
+        quint32 seekFrameCount,
+        std::vector<Mp3SeekFrameIndex::SeekFrame>* pSeekFrames) {
+    const QByteArray data = qUncompress(compressedData);
+    pSeekFrames->clear();
+    // The count has been read from disk and must not be trusted before
+    // reserving memory for it
+    if (seekFrameCount >
+            static_cast<quint32>(data.size() / kMinEncodedSeekFrameBytes)) {
+        return false;
+    }
+    pSeekFrames->reserve(seekFrameCount);
+    SINT frameIndex = 0;
+    qint64 fileOffset = 0;
+    int pos = 0;
+    for (quint32 i = 0; i < seekFrameCount; ++i) {
+        quint64 frameIndexDelta;
+        quint64 fileOffsetDelta;
+        if (!readVarUInt(data, &pos, &frameIndexDelta) ||
+                !readVarUInt(data, &pos, &fileOffsetDelta)) {
+            return false;
+        }
+        frameIndex += static_cast<SINT>(frameIndexDelta);
+        fileOffset += static_cast<qint64>(fileOffsetDelta);
+        pSeekFrames->push_back(Mp3SeekFrameIndex::SeekFrame{frameIndex, fileOffset});
+    }
+    return pos == data.size();
+}
+
+} // anonymous namespace
+
+bool Mp3SeekFrameIndex::isValid() const {
+    if (!channelCount.isValid() || !sampleRate.isValid() ||
+            seekFrames.empty() || seekFrames.front().frameIndex != 0) {
+        return false;
+    }
+    for (std::size_t i = 1; i < seekFrames.size(); ++i) {
+        if (seekFrames[i].frameIndex <= seekFrames[i - 1].frameIndex ||
+                seekFrames[i].fileOffset <= seekFrames[i - 1].fileOffset) {
+            return false;
+        }
+    }
+    return seekFrames.back().frameIndex < frameLength;
+}
+
+// static
+Mp3SeekFrameIndexCache* Mp3SeekFrameIndexCache::s_pInstance = nullptr;
+
+// static
+void Mp3SeekFrameIndexCache::createInstance(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig->getValue(kEnabledConfigKey, kEnabledDefault)) {
+        return;
+    }
+    createInstance(QDir(QDir(pConfig->getSettingsPath()).filePath(kDirectoryName)));
+}
+
+// static
+void Mp3SeekFrameIndexCache::createInstance(
+        const QDir& directory) {
+    DEBUG_ASSERT(!s_pInstance);
+    if (!directory.exists() && !QDir().mkpath(directory.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << directory.absolutePath();
+        return;
+    }
+    s_pInstance = new Mp3SeekFrameIndexCache(directory);
+}
+
+// static
+void Mp3SeekFrameIndexCache::destroyInstance() {
+    delete s_pInstance;
+    s_pInstance = nullptr;
+}
+
+Mp3SeekFrameIndexCache::Mp3SeekFrameIndexCache(
+        const QDir& directory)
+        : m_directory(directory) {
+}
+
+QString Mp3SeekFrameIndexCache::entryFilePath(const QString& canonicalLocation) const {
+    // A modified file replaces the entry of its previous version
+    const QByteArray hash = QCryptographicHash::hash(
+            canonicalLocation.toUtf8(), QCryptographicHash::Sha1);
+    return m_directory.filePath(QString::fromLatin1(hash.toHex()) + kFileNameSuffix);
+}
+
+bool Mp3SeekFrameIndexCache::load(
+        const QString& filePath,
+        Mp3SeekFrameIndex* pSeekFrameIndex) const {
+    const QFileInfo fileInfo(filePath);
+    const QString canonicalLocation = FileInfo::canonicalLocation(fileInfo);
+    if (canonicalLocation.isEmpty()) {
+        return false;
+    }
+    QFile file(entryFilePath(canonicalLocation));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    QString location;
+    qint64 fileSize;
+    qint64 lastModifiedMillis;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok || magic != kMagic || version != kVersion) {
+        return false;
+    }
+    stream >> location >> fileSize >> lastModifiedMillis;
+    if (stream.status() != QDataStream::Ok ||
+            location != canonicalLocation ||
+            fileSize != fileInfo.size() ||
+            lastModifiedMillis != fileInfo.lastModified().toMSecsSinceEpoch()) {
+        kLogger.debug()
+                << "Outdated seek frame index of"
+                << filePath;
+        return false;
+    }
+
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameLength;
+    quint32 seekFrameCount;
+    QByteArray compressedSeekFrames;
+    stream >> channelCount >> sampleRate >> bitrate >> frameLength >> seekFrameCount >>
+            compressedSeekFrames;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    Mp3SeekFrameIndex seekFrameIndex;
+    seekFrameIndex.channelCount = audio::ChannelCount(static_cast<int>(channelCount));
+    seekFrameIndex.sampleRate = audio::SampleRate(sampleRate);
+    seekFrameIndex.bitrate = audio::Bitrate(bitrate);
+    seekFrameIndex.frameLength = static_cast<SINT>(frameLength);
+    if (!decodeSeekFrames(compressedSeekFrames, seekFrameCount, &seekFrameIndex.seekFrames) ||
+            !seekFrameIndex.isValid() ||
+            seekFrameIndex.seekFrames.back().fileOffset >= fileSize) {
+        kLogger.warning()
+                << "Corrupt seek frame index of"
+                << filePath;
+        return false;
+    }
+    *pSeekFrameIndex = std::move(seekFrameIndex);
+    return true;
+}
+
+bool Mp3SeekFrameIndexCache::save(
+        const QString& filePath,
+        const Mp3SeekFrameIndex& seekFrameIndex) const {
+    VERIFY_OR_DEBUG_ASSERT(seekFrameIndex.isValid()) {
+        return false;
+    }
+    const QFileInfo fileInfo(filePath);
+    const QString canonicalLocation = FileInfo::canonicalLocation(fileInfo);
+    if (canonicalLocation.isEmpty()) {
+        return false;
+    }
+    // Concurrent writers for the same file replace the entry atomically
+    QSaveFile file(entryFilePath(canonicalLocation));
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to create seek frame index"
+                << file.fileName()
+                << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream << kMagic << kVersion
+           << canonicalLocation
+           << static_cast<qint64>(fileInfo.size())
+           << static_cast<qint64>(fileInfo.lastModified().toMSecsSinceEpoch())
+           << static_cast<quint32>(seekFrameIndex.channelCount)
+           << static_cast<quint32>(seekFrameIndex.sampleRate)
+           << static_cast<quint32>(seekFrameIndex.bitrate)
+           << static_cast<qint64>(seekFrameIndex.frameLength)
+           << static_cast<quint32>(seekFrameIndex.seekFrames.size())
+           << encodeSeekFrames(seekFrameIndex.seekFrames);
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write seek frame index"
+                << file.fileName()
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace mixxx
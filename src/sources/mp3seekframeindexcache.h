@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QDir>
+#include <QString>
+#include <vector>
+
+#include "audio/types.h"
+#include "preferences/usersettings.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+/// The result of scanning all frame headers of an MP3 file.
+struct Mp3SeekFrameIndex {
+    struct SeekFrame {
+        SINT frameIndex;
+        /// The byte offset of the MP3 frame in the file
+        qint64 fileOffset;
+    };
+
+    audio::ChannelCount channelCount;
+    audio::SampleRate sampleRate;
+    /// In kbps, invalid if unknown
+    audio::Bitrate bitrate;
+    /// The total number of sample frames
+    SINT frameLength = 0;
+    /// Ordered by frame index, starting at 0
+    std::vector<SeekFrame> seekFrames;
+
+    bool isValid() const;
+};
+
+/// Stores the seek frame index of MP3 files on disk, so that the frame
+/// headers of a file only need to be scanned when it is opened for the
+/// first time.
+///
+/// The frame indices and file offsets of consecutive frames are delta
+/// encoded and compressed. For a constant bitrate file the entry needs
+/// only a few bytes per minute of audio. Entries are keyed by the
+/// canonical location of the file. The size and the modification time
+/// of the file are stored in the entry and a modified file is scanned
+/// again.
+///
+/// All functions are thread-safe.
+class Mp3SeekFrameIndexCache final {
+  public:
+    /// Creates the global instance if enabled in the configuration.
+    static void createInstance(
+            const UserSettingsPointer& pConfig);
+    static void createInstance(
+            const QDir& directory);
+    static void destroyInstance();
+
+    /// Returns nullptr if the cache is disabled.
+    static Mp3SeekFrameIndexCache* instance() {
+        return s_pInstance;
+    }
+
+    explicit Mp3SeekFrameIndexCache(
+            const QDir& directory);
+
+    /// Returns false if no valid entry exists for the current version of
+    /// the file.
+    bool load(
+            const QString& filePath,
+            Mp3SeekFrameIndex* pSeekFrameIndex) const;
+
+    bool save(
+            const QString& filePath,
+            const Mp3SeekFrameIndex& seekFrameIndex) const;
+
+  private:
+    static Mp3SeekFrameIndexCache* s_pInstance;
+
+    QString entryFilePath(const QString& canonicalLocation) const;
+
+    const QDir m_directory;
+};
+
+} // namespace mixxx
@@ -226,6 +226,13 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+
+    // Scanning all frame headers of a large file is expensive and the
+    // results don't change unless the file is modified
+    if (tryOpenFromSeekFrameIndex()) {
+        return OpenResult::Succeeded;
+    }
+
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -464,9 +471,87 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         return OpenResult::Failed;
     }
 
+    saveSeekFrameIndex();
+
     return OpenResult::Succeeded;
 }
 
+bool SoundSourceMp3::tryOpenFromSeekFrameIndex() {
+    const auto* const pCache = Mp3SeekFrameIndexCache::instance();
+    if (!pCache) {
+        return false;
+    }
+    Mp3SeekFrameIndex seekFrameIndex;
+    if (!pCache->load(m_file.fileName(), &seekFrameIndex)) {
+        return false;
+    }
+    // Validate everything before initializing the AudioSource
+    if (seekFrameIndex.channelCount > kChannelCountMax ||
+            getIndexBySampleRate(seekFrameIndex.sampleRate) >= kSampleRateCount ||
+            seekFrameIndex.seekFrames.back().fileOffset >=
+                    static_cast<qint64>(m_fileSize)) {
+        kLogger.warning()
+                << "Ignoring invalid seek frame index of"
+                << m_file.fileName();
+        return false;
+    }
+
+    for (const auto& seekFrame : seekFrameIndex.seekFrames) {
+        addSeekFrame(seekFrame.frameIndex, m_pFileData + seekFrame.fileOffset);
+    }
+    initChannelCountOnce(seekFrameIndex.channelCount);
+    initSampleRateOnce(seekFrameIndex.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, seekFrameIndex.frameLength));
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+    if (seekFrameIndex.bitrate.isValid()) {
+        initBitrateOnce(seekFrameIndex.bitrate);
+    }
+
+    // Terminate m_seekFrameList
+    addSeekFrame(seekFrameIndex.frameLength, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Start decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+    DEBUG_ASSERT(m_curFrameIndex == frameIndexMin());
+
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Loaded seek frame index with"
+                << seekFrameIndex.seekFrames.size()
+                << "frames of"
+                << m_file.fileName();
+    }
+    return true;
+}
+
+void SoundSourceMp3::saveSeekFrameIndex() const {
+    const auto* const pCache = Mp3SeekFrameIndexCache::instance();
+    if (!pCache) {
+        return;
+    }
+    DEBUG_ASSERT(m_seekFrameList.size() > 1);
+    Mp3SeekFrameIndex seekFrameIndex;
+    seekFrameIndex.channelCount = getSignalInfo().getChannelCount();
+    seekFrameIndex.sampleRate = getSignalInfo().getSampleRate();
+    seekFrameIndex.bitrate = getBitrate();
+    seekFrameIndex.frameLength = frameLength();
+    seekFrameIndex.seekFrames.reserve(m_seekFrameList.size() - 1);
+    // Skip the terminating seek frame
+    for (auto i = m_seekFrameList.begin(); i != m_seekFrameList.end() - 1; ++i) {
+        if (i->pInputData == &*m_leftoverBuffer.begin()) {
+            // The last frame of a truncated file is decoded from
+            // m_leftoverBuffer and cannot be restored from an offset
+            return;
+        }
+        const qint64 fileOffset = i->pInputData - m_pFileData;
+        DEBUG_ASSERT(fileOffset >= 0 && fileOffset < static_cast<qint64>(m_fileSize));
+        seekFrameIndex.seekFrames.push_back(
+                Mp3SeekFrameIndex::SeekFrame{i->frameIndex, fileOffset});
+    }
+    pCache->save(m_file.fileName(), seekFrameIndex);
+}
+
 void SoundSourceMp3::close() {
     finishDecoding();
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/mp3seekframeindexcache.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef _MSC_VER
@@ -53,6 +54,13 @@ class SoundSourceMp3 final : public SoundSource {
 
     void addSeekFrame(SINT frameIndex, const unsigned char* pInputData);
 
+    /// Initializes the source from a previously saved seek frame index
+    /// instead of scanning all frame headers. Returns false if no valid
+    /// index is available.
+    bool tryOpenFromSeekFrameIndex();
+    /// Saves the seek frame index after scanning all frame headers
+    void saveSeekFrameIndex() const;
+
     /** Returns the position in m_seekFrameList of the requested frame index. */
     SINT findSeekFrameIndex(SINT frameIndex) const;
 
@@ -5,8 +5,10 @@
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
+#include "sources/decodedaudiocache.h"
 
 #ifdef __MAD__
 #include "sources/soundsourcemp3.h"
@@ -556,9 +558,10 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
     TrackPointer pTrack;
     // Lock the global track cache while accessing the file to ensure
     // that no metadata is written. Since locking individual files
-    // is not possible the whole cache has to be locked.
-    GlobalTrackCacheLocker locker;
-    pTrack = locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()));
+    // is not possible the whole shard of the file has to be locked.
+    const auto trackRef = TrackRef::fromFileInfo(trackFileAccess.info());
+    GlobalTrackCacheLocker locker(trackRef);
+    pTrack = locker.lookupTrackByRef(trackRef);
     if (pTrack) {
         // We can safely unlock the cache if the track object is already cached.
         locker.unlockCache();
@@ -573,6 +576,35 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
             resetMissingTagMetadata);
 }
 
+//static
+std::optional<SoundSourceProxy::ImportedTrackMetadata>
+SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+        mixxx::FileAccess trackFileAccess,
+        bool resetMissingTagMetadata) {
+    ImportedTrackMetadata imported;
+    if (!trackFileAccess.info().checkFileExists()) {
+        return imported;
+    }
+    {
+        GlobalTrackCacheLocker locker;
+        if (locker.lookupTrackByRef(TrackRef::fromFileInfo(trackFileAccess.info()))) {
+            // The cached track object might be modified and exported
+            // concurrently
+            return std::nullopt;
+        }
+    }
+    const auto pTrack = Track::newTemporary(std::move(trackFileAccess));
+    // Start with the same defaults as updateTrackFromSource() does
+    // for a new track object
+    imported.trackMetadata = pTrack->getMetadata();
+    std::tie(imported.importResult, imported.sourceSynchronizedAt) =
+            SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                    &imported.trackMetadata,
+                    &imported.coverImage,
+                    resetMissingTagMetadata);
+    return imported;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -618,7 +650,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedTrackMetadata* pPreImportedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -690,11 +723,25 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    // Metadata that has been imported in advance started from the defaults
+    // of a new track object and is only valid in this case.
+    mixxx::MetadataSource::ImportResult metadataImportResult;
+    QDateTime sourceSynchronizedAt;
+    if (pPreImportedMetadata &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void) {
+        metadataImportResult = pPreImportedMetadata->importResult;
+        sourceSynchronizedAt = pPreImportedMetadata->sourceSynchronizedAt;
+        trackMetadata = pPreImportedMetadata->trackMetadata;
+        if (pCoverImg) {
+            *pCoverImg = pPreImportedMetadata->coverImage;
+        }
+    } else {
+        std::tie(metadataImportResult, sourceSynchronizedAt) =
+                importTrackMetadataAndCoverImage(
+                        &trackMetadata,
+                        pCoverImg,
+                        syncParams.resetMissingTagMetadataOnImport);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -927,6 +974,18 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
+    auto* const pDecodedAudioCache = mixxx::DecodedAudioCache::instance();
+    if (pDecodedAudioCache) {
+        auto pCachedAudioSource = pDecodedAudioCache->openAudioSource(
+                m_pTrack->getFileInfo(), params);
+        if (pCachedAudioSource) {
+            // Bypass the decoder
+            m_pTrack->updateStreamInfoFromSource(
+                    pCachedAudioSource->getStreamInfo());
+            return mixxx::AudioSourceTrackProxy::create(
+                    m_pTrack, std::move(pCachedAudioSource));
+        }
+    }
     if (!openSoundSource(params)) {
         return nullptr;
     }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QMimeType>
+#include <optional>
 
+#include "sources/metadatasource.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 #include "util/sandbox.h"
@@ -121,6 +123,32 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata) const;
 
+    /// Track metadata and embedded cover image of a new track that
+    /// have been imported in advance.
+    struct ImportedTrackMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        QImage coverImage;
+    };
+
+    /// Import both track metadata and the embedded cover image from
+    /// a file that is not referenced by any cached track object.
+    ///
+    /// Unlike importTrackMetadataAndCoverImageFromFile() the
+    /// GlobalTrackCache is only locked briefly for the lookup and
+    /// not while reading the file. This allows to import multiple
+    /// files concurrently, e.g. by the worker threads of the library
+    /// scanner. Returns std::nullopt if the file is referenced by a
+    /// cached track object.
+    ///
+    /// This function is thread-safe and can be invoked from any thread.
+    static std::optional<ImportedTrackMetadata>
+    importNewTrackMetadataAndCoverImageFromFile(
+            mixxx::FileAccess trackFileAccess,
+            bool resetMissingTagMetadata);
+
     /// Controls which (metadata/coverart) and how tags are (re-)imported from
     /// audio files when creating a SoundSourceProxy.
     ///
@@ -173,9 +201,13 @@ class SoundSourceProxy {
     /// analysis in case unexpected behavior has been reported.
     ///
     /// Returns true if the track has been modified and false otherwise.
+    ///
+    /// The optional pre-imported metadata replaces reading the file if
+    /// the track object has never been synchronized with the file.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedTrackMetadata* pPreImportedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
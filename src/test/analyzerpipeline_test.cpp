@@ -0,0 +1,114 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr int kNumChunks = 4;
+constexpr SINT kSamplesPerChunk = 1024;
+
+// Records a checksum that depends on the order of all samples
+class ChecksumAnalyzer : public Analyzer {
+  public:
+    explicit ChecksumAnalyzer(quint64* pChecksum, SINT* pSampleCount)
+            : m_pChecksum(pChecksum),
+              m_pSampleCount(pSampleCount) {
+    }
+
+    bool initialize(const AnalyzerTrack& /*track*/,
+            mixxx::audio::SampleRate /*sampleRate*/,
+            SINT /*frameLength*/) override {
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        for (SINT i = 0; i < count; ++i) {
+            *m_pChecksum = *m_pChecksum * 31 + static_cast<quint64>(pIn[i]);
+        }
+        *m_pSampleCount += count;
+        return true;
+    }
+
+    void storeResults(TrackPointer /*pTrack*/) override {
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    quint64* const m_pChecksum;
+    SINT* const m_pSampleCount;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void analyze(int numLanes, int numAnalyzers, int numTracks) {
+        std::vector<quint64> checksums(numAnalyzers);
+        std::vector<SINT> sampleCounts(numAnalyzers);
+        std::vector<AnalyzerWithState> analyzers;
+        for (int i = 0; i < numAnalyzers; ++i) {
+            analyzers.emplace_back(std::make_unique<ChecksumAnalyzer>(
+                    &checksums[i], &sampleCounts[i]));
+        }
+        const AnalyzerTrack track(Track::newTemporary());
+
+        AnalyzerPipeline pipeline(numLanes, kNumChunks, kSamplesPerChunk);
+        EXPECT_EQ(numLanes, pipeline.numLanes());
+        for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex) {
+            std::fill(checksums.begin(), checksums.end(), 0);
+            std::fill(sampleCounts.begin(), sampleCounts.end(), 0);
+            for (auto& analyzer : analyzers) {
+                analyzer.initialize(track, mixxx::audio::SampleRate(44100), 0);
+            }
+            pipeline.assignAnalyzers(&analyzers);
+
+            quint64 expectedChecksum = 0;
+            SINT expectedSampleCount = 0;
+            for (int chunkIndex = 0; chunkIndex < 10 * kNumChunks; ++chunkIndex) {
+                auto slice = pipeline.acquireChunk();
+                ASSERT_EQ(kSamplesPerChunk, slice.length());
+                // Vary the number of samples including empty chunks
+                const SINT sampleCount = (chunkIndex * 97) % kSamplesPerChunk;
+                for (SINT i = 0; i < sampleCount; ++i) {
+                    slice[i] = static_cast<CSAMPLE>((trackIndex + chunkIndex + i) % 251);
+                    expectedChecksum = expectedChecksum * 31 + static_cast<quint64>(slice[i]);
+                }
+                expectedSampleCount += sampleCount;
+                pipeline.publishChunk(slice.data(), sampleCount);
+            }
+            pipeline.drain();
+
+            for (int i = 0; i < numAnalyzers; ++i) {
+                EXPECT_EQ(expectedChecksum, checksums[i]);
+                EXPECT_EQ(expectedSampleCount, sampleCounts[i]);
+            }
+            for (auto& analyzer : analyzers) {
+                analyzer.cancel();
+            }
+        }
+    }
+};
+
+TEST_F(AnalyzerPipelineTest, singleLane) {
+    analyze(1, 3, 2);
+}
+
+TEST_F(AnalyzerPipelineTest, lanePerAnalyzer) {
+    analyze(4, 4, 3);
+}
+
+TEST_F(AnalyzerPipelineTest, moreAnalyzersThanLanes) {
+    analyze(2, 5, 3);
+}
+
+TEST_F(AnalyzerPipelineTest, moreLanesThanAnalyzers) {
+    analyze(3, 1, 2);
+}
+
+} // namespace
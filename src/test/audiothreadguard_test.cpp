@@ -0,0 +1,86 @@
+#include "util/audiothreadguard.h"
+
+#include <gtest/gtest.h>
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+class AudioThreadGuardTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mixxx::AudioThreadGuard::setEnabled(true);
+    }
+
+    void TearDown() override {
+        mixxx::AudioThreadGuard::setEnabled(false);
+    }
+};
+
+TEST_F(AudioThreadGuardTest, allocationOutsideOfScope) {
+    const auto violationCount = mixxx::AudioThreadGuard::violationCount();
+    auto pValue = std::make_unique<int>(1);
+    pValue.reset();
+    EXPECT_EQ(violationCount, mixxx::AudioThreadGuard::violationCount());
+}
+
+TEST_F(AudioThreadGuardTest, allocationWithinScope) {
+    const auto violationCount = mixxx::AudioThreadGuard::violationCount();
+    {
+        const mixxx::AudioThreadGuard::Scope scope;
+        EXPECT_TRUE(mixxx::AudioThreadGuard::isActive());
+        // Both allocating and freeing are reported
+        auto pValue = std::make_unique<int>(1);
+        pValue.reset();
+    }
+    EXPECT_EQ(violationCount + 2, mixxx::AudioThreadGuard::violationCount());
+    EXPECT_FALSE(mixxx::AudioThreadGuard::isActive());
+}
+
+TEST_F(AudioThreadGuardTest, suspend) {
+    const auto violationCount = mixxx::AudioThreadGuard::violationCount();
+    {
+        const mixxx::AudioThreadGuard::Scope scope;
+        const mixxx::AudioThreadGuard::Suspend suspend;
+        std::vector<int> values(100);
+    }
+    EXPECT_EQ(violationCount, mixxx::AudioThreadGuard::violationCount());
+}
+
+TEST_F(AudioThreadGuardTest, lockWait) {
+    QMutex mutex;
+    QSemaphore locked;
+    QSemaphore unlock;
+    std::unique_ptr<QThread> pThread(QThread::create([&] {
+        const auto locker = lockMutex(&mutex);
+        locked.release();
+        unlock.acquire();
+    }));
+    pThread->start();
+    locked.acquire();
+
+    const auto violationCount = mixxx::AudioThreadGuard::violationCount();
+    {
+        const mixxx::AudioThreadGuard::Scope scope;
+        mixxx::AudioThreadGuard::checkLock(&mutex);
+    }
+    EXPECT_EQ(violationCount + 1, mixxx::AudioThreadGuard::violationCount());
+
+    unlock.release();
+    pThread->wait();
+
+    // Locking an unlocked mutex is fine
+    {
+        const mixxx::AudioThreadGuard::Scope scope;
+        const auto locker = lockMutex(&mutex);
+    }
+    EXPECT_EQ(violationCount + 1, mixxx::AudioThreadGuard::violationCount());
+}
+
+} // namespace
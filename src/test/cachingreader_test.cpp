@@ -0,0 +1,163 @@
+#include "engine/cachingreader/cachingreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Channel1]");
+
+// 1 MiB holds 16 chunks of 8192 stereo frames
+constexpr int kMemoryMiB = 1;
+constexpr SINT kNumberOfChunks = 16;
+
+class CachingReaderTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        config()->setValue(ConfigKey(QStringLiteral("[CachingReader]"),
+                                   QStringLiteral("MemoryMiB")),
+                kMemoryMiB);
+        m_pReader = std::make_unique<CachingReader>(kGroup, config());
+        m_pReader->setScheduler(&m_scheduler);
+        m_scheduler.start();
+        m_trackLoaded = false;
+        QObject::connect(m_pReader.get(),
+                &CachingReader::trackLoaded,
+                [this](TrackPointer, int, double) { m_trackLoaded = true; });
+
+        const QString location = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        m_pReader->newTrack(Track::newTemporary(location));
+        ASSERT_TRUE(processUntil([this] { return m_trackLoaded.load(); }));
+        // Receive the update of the track state from the worker
+        m_pReader->process();
+    }
+
+    void TearDown() override {
+        m_pReader.reset();
+    }
+
+    // Hints, runs the worker and processes its results like the engine
+    // callback does, until condition is met. The hints are repeated,
+    // because the request FIFO only holds a quarter of the chunks.
+    bool processUntil(const std::function<bool()>& condition,
+            const HintVector& hints = HintVector()) {
+        for (int i = 0; i < 10000; ++i) {
+            if (!hints.isEmpty()) {
+                m_pReader->hintAndMaybeWake(hints);
+            }
+            m_scheduler.workerReady();
+            m_scheduler.runWorkers();
+            m_pReader->process();
+            if (condition()) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    CachingReader::ReadResult readChunk(SINT chunkIndex) {
+        std::vector<CSAMPLE> buffer(CachingReaderChunk::kSamples);
+        return m_pReader->read(
+                CachingReaderChunk::frames2samples(chunkIndex * CachingReaderChunk::kFrames),
+                CachingReaderChunk::kSamples,
+                false,
+                buffer.data());
+    }
+
+    static Hint chunksHint(SINT firstChunkIndex, SINT chunkCount) {
+        Hint hint;
+        hint.frame = firstChunkIndex * CachingReaderChunk::kFrames;
+        hint.frameCount = chunkCount * CachingReaderChunk::kFrames;
+        hint.type = Hint::Type::HotCue;
+        return hint;
+    }
+
+    EngineWorkerScheduler m_scheduler;
+    std::unique_ptr<CachingReader> m_pReader;
+    std::atomic<bool> m_trackLoaded;
+};
+
+TEST_F(CachingReaderTest, numberOfCachedChunks) {
+    EXPECT_EQ(kNumberOfChunks, m_pReader->numberOfCachedChunks());
+    EXPECT_EQ(kNumberOfChunks, CachingReader::numberOfCachedChunks(kGroup, config()));
+
+    // The deck setting overrides the global one
+    config()->setValue(ConfigKey(kGroup, QStringLiteral("cachingreader_memory_mib")),
+            2 * kMemoryMiB);
+    EXPECT_EQ(2 * kNumberOfChunks, CachingReader::numberOfCachedChunks(kGroup, config()));
+    EXPECT_EQ(kNumberOfChunks,
+            CachingReader::numberOfCachedChunks(QStringLiteral("[Channel2]"), config()));
+}
+
+TEST_F(CachingReaderTest, readHintedChunks) {
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readChunk(0));
+    EXPECT_EQ(1, m_pReader->readUnavailableCount());
+
+    HintVector hints;
+    hints.append(chunksHint(0, 4));
+    ASSERT_TRUE(processUntil(
+            [this] {
+                return readChunk(3) == CachingReader::ReadResult::AVAILABLE;
+            },
+            hints));
+    for (SINT chunkIndex = 0; chunkIndex < 3; ++chunkIndex) {
+        EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(chunkIndex));
+    }
+    EXPECT_EQ(4, m_pReader->readAvailableCount());
+    EXPECT_EQ(0, m_pReader->hintChunkPoolExhaustedCount());
+}
+
+TEST_F(CachingReaderTest, hintsStopWhenChunkPoolIsExhausted) {
+    HintVector hints;
+    hints.append(chunksHint(0, kNumberOfChunks - 2));
+    // Exceeds the remaining chunks and would expire the first ones
+    hints.append(chunksHint(100, 4));
+    m_pReader->hintAndMaybeWake(hints);
+    EXPECT_EQ(1, m_pReader->hintChunkPoolExhaustedCount());
+
+    ASSERT_TRUE(processUntil(
+            [this] {
+                return readChunk(kNumberOfChunks - 3) ==
+                        CachingReader::ReadResult::AVAILABLE;
+            },
+            hints));
+    EXPECT_EQ(CachingReader::ReadResult::AVAILABLE, readChunk(0));
+    EXPECT_EQ(CachingReader::ReadResult::UNAVAILABLE, readChunk(100));
+}
+
+TEST_F(CachingReaderTest, firstHintIsAlwaysProcessed) {
+    HintVector hints;
+    // The current position is hinted even if it spans more chunks than
+    // the pool holds
+    hints.append(chunksHint(0, kNumberOfChunks + 4));
+    m_pReader->hintAndMaybeWake(hints);
+    EXPECT_EQ(0, m_pReader->hintChunkPoolExhaustedCount());
+}
+
+TEST_F(CachingReaderTest, releasePendingRequestsOnDestruction) {
+    EngineWorkerScheduler scheduler;
+    auto pReader = std::make_unique<CachingReader>(
+            QStringLiteral("[Channel2]"), config());
+    pReader->setScheduler(&scheduler);
+    // The scheduler never runs the worker, so the track is not
+    // loaded before the reader is destroyed
+    pReader->newTrack(Track::newTemporary(
+            getTestDir().filePath(QStringLiteral("sine-30.wav"))));
+    pReader.reset();
+    EXPECT_TRUE(CachingReaderWorker::waitForPendingRequests(
+            mixxx::Duration::fromMillis(0)));
+}
+
+} // namespace
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderresidenttrack.h"
+
+namespace {
+
+constexpr SINT kChannels = 2;
+constexpr SINT kFrames = 1000;
+
+class CachingReaderResidentTrackTest : public testing::Test {
+  protected:
+    static void decode(
+            CachingReaderResidentTrack* pTrack,
+            mixxx::IndexRange frameIndexRange) {
+        auto slice = pTrack->writableSlice(frameIndexRange);
+        for (SINT i = 0; i < slice.length(); ++i) {
+            slice[i] = static_cast<CSAMPLE>(frameIndexRange.start() * kChannels + i);
+        }
+        pTrack->extendDecodedFrameIndexRange(frameIndexRange);
+    }
+
+    static void decodeOutward(bool memoryMapped) {
+        const auto frameIndexRange = mixxx::IndexRange::forward(0, kFrames);
+        auto pTrack = CachingReaderResidentTrack::allocate(frameIndexRange, memoryMapped);
+        ASSERT_NE(nullptr, pTrack);
+        EXPECT_EQ(frameIndexRange, pTrack->frameIndexRange());
+        EXPECT_TRUE(pTrack->decodedFrameIndexRange().empty());
+
+        std::vector<CSAMPLE> buffer(kFrames * kChannels);
+        EXPECT_FALSE(pTrack->readSampleFrames(
+                buffer.data(), mixxx::IndexRange::forward(500, 10), false));
+
+        // Start in the middle and extend in both directions
+        decode(pTrack.get(), mixxx::IndexRange::forward(500, 100));
+        EXPECT_EQ(mixxx::IndexRange::forward(500, 100), pTrack->decodedFrameIndexRange());
+        decode(pTrack.get(), mixxx::IndexRange::forward(600, 100));
+        decode(pTrack.get(), mixxx::IndexRange::forward(400, 100));
+        EXPECT_EQ(mixxx::IndexRange::between(400, 700), pTrack->decodedFrameIndexRange());
+
+        EXPECT_FALSE(pTrack->readSampleFrames(
+                buffer.data(), mixxx::IndexRange::forward(390, 20), false));
+        EXPECT_FALSE(pTrack->readSampleFrames(
+                buffer.data(), mixxx::IndexRange::forward(690, 20), false));
+
+        ASSERT_TRUE(pTrack->readSampleFrames(
+                buffer.data(), mixxx::IndexRange::forward(450, 200), false));
+        for (SINT i = 0; i < 200 * kChannels; ++i) {
+            EXPECT_EQ(static_cast<CSAMPLE>(450 * kChannels + i), buffer[i]);
+        }
+
+        ASSERT_TRUE(pTrack->readSampleFrames(
+                buffer.data(), mixxx::IndexRange::forward(450, 200), true));
+        for (SINT i = 0; i < 200; ++i) {
+            // The frames are reversed, but not the channels within each frame
+            const SINT frameIndex = 450 + 200 - 1 - i;
+            EXPECT_EQ(static_cast<CSAMPLE>(frameIndex * kChannels), buffer[i * kChannels]);
+            EXPECT_EQ(static_cast<CSAMPLE>(frameIndex * kChannels + 1),
+                    buffer[i * kChannels + 1]);
+        }
+
+        decode(pTrack.get(), mixxx::IndexRange::between(0, 400));
+        decode(pTrack.get(), mixxx::IndexRange::between(700, kFrames));
+        EXPECT_EQ(frameIndexRange, pTrack->decodedFrameIndexRange());
+    }
+};
+
+TEST_F(CachingReaderResidentTrackTest, decodeOutward) {
+    decodeOutward(false);
+}
+
+TEST_F(CachingReaderResidentTrackTest, decodeOutwardMemoryMapped) {
+    decodeOutward(true);
+}
+
+TEST_F(CachingReaderResidentTrackTest, slot) {
+    CachingReaderResidentTrackSlot slot;
+    EXPECT_FALSE(slot.lockForReading());
+
+    slot.reset(CachingReaderResidentTrack::allocate(
+            mixxx::IndexRange::forward(0, kFrames), false));
+    ASSERT_NE(nullptr, slot.get());
+    decode(slot.get(), mixxx::IndexRange::forward(0, kFrames));
+    {
+        const auto pTrack = slot.lockForReading();
+        ASSERT_TRUE(pTrack);
+        EXPECT_EQ(slot.get(), pTrack.get());
+        EXPECT_EQ(mixxx::IndexRange::forward(0, kFrames), pTrack->decodedFrameIndexRange());
+    }
+
+    slot.reset();
+    EXPECT_EQ(nullptr, slot.get());
+    EXPECT_FALSE(slot.lockForReading());
+}
+
+} // namespace
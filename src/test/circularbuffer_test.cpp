@@ -0,0 +1,85 @@
+#include "util/circularbuffer.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(CircularBufferTest, capacityIsOneLessThanLength) {
+    CircularBuffer<int> buffer(4);
+    EXPECT_EQ(4u, buffer.length());
+    EXPECT_TRUE(buffer.isEmpty());
+    EXPECT_FALSE(buffer.isFull());
+
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_TRUE(buffer.push(2));
+    EXPECT_TRUE(buffer.push(3));
+    EXPECT_TRUE(buffer.isFull());
+    EXPECT_EQ(3u, buffer.size());
+
+    // One slot always remains empty
+    EXPECT_FALSE(buffer.push(4));
+    EXPECT_EQ(3u, buffer.size());
+    EXPECT_EQ(1, buffer.front());
+    EXPECT_EQ(3, buffer.back());
+}
+
+TEST(CircularBufferTest, pushAndPop) {
+    CircularBuffer<int> buffer(4);
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_EQ(1, buffer.front());
+    EXPECT_EQ(1, buffer.back());
+
+    EXPECT_TRUE(buffer.push(2));
+    EXPECT_EQ(1, buffer.front());
+    EXPECT_EQ(2, buffer.back());
+
+    buffer.pop();
+    EXPECT_EQ(1u, buffer.size());
+    EXPECT_EQ(2, buffer.front());
+    EXPECT_EQ(2, buffer.back());
+
+    buffer.pop();
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(CircularBufferTest, wrapAround) {
+    CircularBuffer<int> buffer(4);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(buffer.push(i));
+        EXPECT_TRUE(buffer.push(i + 100));
+        EXPECT_EQ(2u, buffer.size());
+        EXPECT_EQ(i, buffer.front());
+        EXPECT_EQ(i + 100, buffer.back());
+        buffer.pop();
+        EXPECT_EQ(i + 100, buffer.front());
+        buffer.pop();
+        EXPECT_TRUE(buffer.isEmpty());
+    }
+}
+
+TEST(CircularBufferTest, modifyBack) {
+    CircularBuffer<int> buffer(4);
+    EXPECT_TRUE(buffer.push(1));
+    EXPECT_TRUE(buffer.push(2));
+    buffer.back() = 3;
+    buffer.pop();
+    EXPECT_EQ(3, buffer.front());
+}
+
+TEST(CircularBufferTest, writeAndRead) {
+    CircularBuffer<int> buffer(4);
+    const int input[] = {1, 2, 3, 4};
+    EXPECT_EQ(3u, buffer.write(input, 4));
+    EXPECT_TRUE(buffer.isFull());
+
+    int output[4] = {};
+    EXPECT_EQ(2u, buffer.read(output, 2));
+    EXPECT_EQ(1, output[0]);
+    EXPECT_EQ(2, output[1]);
+    EXPECT_EQ(3, buffer.front());
+
+    EXPECT_EQ(1u, buffer.skip(2));
+    EXPECT_TRUE(buffer.isEmpty());
+}
+
+} // namespace
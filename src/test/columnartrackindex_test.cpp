@@ -0,0 +1,287 @@
+#include "library/columnartrackindex.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <memory>
+
+#include "library/searchquery.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+const QStringList kColumns = {
+        QStringLiteral("id"),
+        QStringLiteral("artist"),
+        QStringLiteral("title"),
+        QStringLiteral("album"),
+        QStringLiteral("year"),
+        QStringLiteral("bpm"),
+        QStringLiteral("datetime_added"),
+        QStringLiteral("location"),
+};
+
+enum Column {
+    kId,
+    kArtist,
+    kTitle,
+    kAlbum,
+    kYear,
+    kBpm,
+    kDateTimeAdded,
+    kLocation,
+};
+
+const QStringList kSearchColumns = {
+        QStringLiteral("artist"),
+        QStringLiteral("title"),
+        QStringLiteral("album"),
+        QStringLiteral("location"),
+};
+
+ColumnarTrackIndex createIndex() {
+    ColumnarTrackIndex index(kColumns);
+    index.setColumnType(kId, ColumnarTrackIndex::ColumnType::Number);
+    index.setColumnType(kArtist, ColumnarTrackIndex::ColumnType::String);
+    index.setColumnType(kTitle, ColumnarTrackIndex::ColumnType::String);
+    index.setColumnType(kAlbum, ColumnarTrackIndex::ColumnType::String);
+    index.setColumnType(kYear, ColumnarTrackIndex::ColumnType::String);
+    index.setColumnType(kBpm, ColumnarTrackIndex::ColumnType::Number);
+    index.setColumnType(kLocation, ColumnarTrackIndex::ColumnType::String);
+    return index;
+}
+
+void expectValue(const ColumnarTrackIndex& index, int row, int column, const QVariant& expected) {
+    const QVariant actual = index.value(row, column);
+    EXPECT_EQ(expected.isValid(), actual.isValid());
+    EXPECT_EQ(expected.userType(), actual.userType());
+    EXPECT_EQ(expected, actual);
+}
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(createIndex()) {
+    }
+
+    int addTrack(int id,
+            const QString& artist,
+            const QString& title,
+            const QVariant& year,
+            const QVariant& bpm) {
+        const int row = m_index.insertRow(TrackId(id));
+        m_index.setValue(row, kId, qlonglong(id));
+        m_index.setValue(row, kArtist, artist);
+        m_index.setValue(row, kTitle, title);
+        m_index.setValue(row, kYear, year);
+        m_index.setValue(row, kBpm, bpm);
+        return row;
+    }
+
+    bool matches(const QueryNode& query, int id) const {
+        return query.match(m_index, m_index.findRow(TrackId(id)));
+    }
+
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(ColumnarTrackIndexTest, valuesAreRestoredExactly) {
+    const int row = m_index.insertRow(TrackId(1));
+    // Unset values are invalid
+    expectValue(m_index, row, kArtist, QVariant());
+    expectValue(m_index, row, kBpm, QVariant());
+
+    const QList<QVariant> values = {
+            QVariant(),
+            QVariant(QString()),
+            QVariant(QString("")),
+            QVariant(QString("Artist")),
+            QVariant(true),
+            QVariant(int(-3)),
+            QVariant(uint(3)),
+            QVariant(qlonglong(1) << 60),
+            QVariant(128.25),
+            QVariant(QDateTime::fromSecsSinceEpoch(1000000, Qt::UTC)),
+    };
+    for (const auto column : {kArtist, kBpm, kDateTimeAdded}) {
+        for (const auto& value : values) {
+            m_index.setValue(row, column, value);
+            expectValue(m_index, row, column, value);
+        }
+    }
+}
+
+TEST_F(ColumnarTrackIndexTest, internStrings) {
+    const int row1 = addTrack(1, "Artist", "Title 1", "2001", 120.0);
+    const int row2 = addTrack(2, "Artist", "Title 2", "2002", 121.0);
+    EXPECT_EQ(m_index.stringId(row1, kArtist), m_index.stringId(row2, kArtist));
+    EXPECT_NE(m_index.stringId(row1, kTitle), m_index.stringId(row2, kTitle));
+    EXPECT_EQ(ColumnarTrackIndex::kNoString, m_index.stringId(row1, kBpm));
+
+    m_index.setValue(row1, kAlbum, QString::fromUtf8("Ça Ira"));
+    EXPECT_EQ(QStringLiteral("ca ira"),
+            m_index.foldedString(m_index.stringId(row1, kAlbum)));
+}
+
+TEST_F(ColumnarTrackIndexTest, removeRow) {
+    addTrack(1, "Artist 1", "Title 1", "2001", 120.0);
+    const int row2 = addTrack(2, "Artist 2", "Title 2", "2002", 121.0);
+    EXPECT_EQ(2, m_index.size());
+
+    m_index.removeRow(TrackId(2));
+    EXPECT_EQ(1, m_index.size());
+    EXPECT_FALSE(m_index.contains(TrackId(2)));
+    EXPECT_EQ(-1, m_index.findRow(TrackId(2)));
+
+    // The row is reused without any stale values
+    const int row3 = m_index.insertRow(TrackId(3));
+    EXPECT_EQ(row2, row3);
+    EXPECT_EQ(TrackId(3), m_index.trackId(row3));
+    expectValue(m_index, row3, kArtist, QVariant());
+    expectValue(m_index, row3, kBpm, QVariant());
+}
+
+TEST_F(ColumnarTrackIndexTest, matchTextFilter) {
+    addTrack(1, QString::fromUtf8("Björk"), "Army of Me", "1995", 100.0);
+    addTrack(2, "Bjorn", "Abc", "1996", 100.0);
+    addTrack(3, "Other", "Title", "1997", 100.0);
+
+    const TextFilterNode bjo(QSqlDatabase(), kSearchColumns, "BJO");
+    EXPECT_TRUE(matches(bjo, 1));
+    EXPECT_TRUE(matches(bjo, 2));
+    EXPECT_FALSE(matches(bjo, 3));
+
+    const TextFilterNode army(QSqlDatabase(), kSearchColumns, "army");
+    EXPECT_TRUE(matches(army, 1));
+    EXPECT_FALSE(matches(army, 2));
+
+    // Wildcards are interpreted like the LIKE operator of the database
+    const TextFilterNode wildcard(QSqlDatabase(), kSearchColumns, "a_c");
+    EXPECT_FALSE(matches(wildcard, 1));
+    EXPECT_TRUE(matches(wildcard, 2));
+    EXPECT_FALSE(matches(wildcard, 3));
+
+    const NotNode notBjo(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), kSearchColumns, "bjo"));
+    EXPECT_FALSE(matches(notBjo, 1));
+    EXPECT_FALSE(matches(notBjo, 2));
+    EXPECT_TRUE(matches(notBjo, 3));
+}
+
+TEST_F(ColumnarTrackIndexTest, matchNumericFilter) {
+    addTrack(1, "Artist", "Title", "1995-05-01", 120.0);
+    addTrack(2, "Artist", "Title", "2005", 128.0);
+    addTrack(3, "Artist", "Title", QVariant(), QVariant());
+
+    const NumericFilterNode bpm({"bpm"}, ">125");
+    EXPECT_FALSE(matches(bpm, 1));
+    EXPECT_TRUE(matches(bpm, 2));
+    EXPECT_FALSE(matches(bpm, 3));
+
+    const NumericFilterNode bpmRange({"bpm"}, "110-125");
+    EXPECT_TRUE(matches(bpmRange, 1));
+    EXPECT_FALSE(matches(bpmRange, 2));
+
+    const NullNumericFilterNode noBpm({"bpm"});
+    EXPECT_FALSE(matches(noBpm, 1));
+    EXPECT_TRUE(matches(noBpm, 3));
+
+    const YearFilterNode year({"year"}, "<2000");
+    EXPECT_TRUE(matches(year, 1));
+    EXPECT_FALSE(matches(year, 2));
+}
+
+// A synthetic library with many unique titles and locations,
+// but a limited number of artists and albums.
+ColumnarTrackIndex createSyntheticIndex(int numTracks) {
+    ColumnarTrackIndex index = createIndex();
+    for (int i = 1; i <= numTracks; ++i) {
+        const int row = index.insertRow(TrackId(i));
+        const QString artist = QStringLiteral("Artist %1").arg(i % 5000);
+        const QString album = QStringLiteral("Album %1").arg(i % 20000);
+        const QString title = QStringLiteral("Title %1").arg(i);
+        index.setValue(row, kId, qlonglong(i));
+        index.setValue(row, kArtist, artist);
+        index.setValue(row, kTitle, title);
+        index.setValue(row, kAlbum, album);
+        index.setValue(row, kYear, QString::number(1950 + i % 70));
+        index.setValue(row, kBpm, 80.0 + i % 100);
+        index.setValue(row, kLocation,
+                QStringLiteral("/home/user/Music/%1/%2/%3.mp3")
+                        .arg(artist, album, title));
+    }
+    return index;
+}
+
+std::unique_ptr<QueryNode> createSyntheticQuery() {
+    auto pQuery = std::make_unique<AndNode>();
+    pQuery->addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), kSearchColumns, QStringLiteral("artist 12")));
+    pQuery->addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), kSearchColumns, QStringLiteral("title 3")));
+    return pQuery;
+}
+
+// Searching all rows of the index for every modification of the query
+static void BM_SearchColumnarTrackIndex(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    const ColumnarTrackIndex index = createSyntheticIndex(numTracks);
+    for (auto _ : state) {
+        const auto pQuery = createSyntheticQuery();
+        int matchCount = 0;
+        for (int row = 0; row < numTracks; ++row) {
+            if (pQuery->match(index, row)) {
+                ++matchCount;
+            }
+        }
+        benchmark::DoNotOptimize(matchCount);
+    }
+}
+BENCHMARK(BM_SearchColumnarTrackIndex)->Arg(10000)->Arg(200000);
+
+// The same search over rows of variants for comparison
+static void BM_SearchVariantRows(benchmark::State& state) {
+    const int numTracks = static_cast<int>(state.range(0));
+    const ColumnarTrackIndex index = createSyntheticIndex(numTracks);
+    QHash<TrackId, QVector<QVariant>> rows;
+    for (int row = 0; row < numTracks; ++row) {
+        QVector<QVariant>& record = rows[index.trackId(row)];
+        for (int column = 0; column < index.columnCount(); ++column) {
+            record.append(index.value(row, column));
+        }
+    }
+    const QStringList arguments = {
+            QStringLiteral("artist 12"),
+            QStringLiteral("title 3"),
+    };
+    for (auto _ : state) {
+        int matchCount = 0;
+        for (const auto& record : qAsConst(rows)) {
+            bool match = true;
+            for (const auto& argument : arguments) {
+                bool argumentMatch = false;
+                for (const auto column : {kArtist, kTitle, kAlbum, kLocation}) {
+                    QString value = record[column].toString();
+                    mixxx::DbConnection::makeStringLatinLow(&value);
+                    if (value.contains(argument)) {
+                        argumentMatch = true;
+                        break;
+                    }
+                }
+                if (!argumentMatch) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                ++matchCount;
+            }
+        }
+        benchmark::DoNotOptimize(matchCount);
+    }
+}
+BENCHMARK(BM_SearchVariantRows)->Arg(10000)->Arg(200000);
+
+} // namespace
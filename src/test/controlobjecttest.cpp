@@ -2,6 +2,7 @@
 #include <QtDebug>
 
 #include "control/controlobject.h"
+#include "control/controlproxy.h"
 #include "util/memory.h"
 #include "test/mixxxtest.h"
 
@@ -85,4 +86,49 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, DeferredPublishing) {
+    co1->setPublishMode(ControlPublishMode::Deferred);
+
+    QList<double> changes;
+    ControlProxy proxy(ck1);
+    proxy.connectValueChanged(
+            &proxy,
+            [&changes](double value) {
+                changes.append(value);
+            },
+            Qt::DirectConnection);
+    int ownerChanges = 0;
+    QObject::connect(co1.get(),
+            &ControlObject::valueChanged,
+            [&ownerChanges](double) {
+                ++ownerChanges;
+            });
+
+    // Published immediately until enabled
+    co1->set(1.0);
+    EXPECT_EQ(QList<double>{1.0}, changes);
+
+    changes.clear();
+    ControlDoublePrivate::setDeferredPublishingEnabled(true);
+    co1->set(2.0);
+    co1->set(3.0);
+    EXPECT_TRUE(changes.isEmpty());
+    EXPECT_DOUBLE_EQ(3.0, proxy.get());
+
+    // Coalesced into a single change with the latest value
+    ControlDoublePrivate::publishDeferredValueChanges();
+    EXPECT_EQ(QList<double>{3.0}, changes);
+    ControlDoublePrivate::publishDeferredValueChanges();
+    EXPECT_EQ(QList<double>{3.0}, changes);
+
+    // Changes of other setters are published immediately
+    changes.clear();
+    ControlProxy setter(ck1);
+    setter.set(4.0);
+    EXPECT_EQ(QList<double>{4.0}, changes);
+    EXPECT_EQ(1, ownerChanges);
+
+    ControlDoublePrivate::setDeferredPublishingEnabled(false);
+}
+
 } // namespace
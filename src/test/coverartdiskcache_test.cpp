@@ -0,0 +1,114 @@
+#include "library/coverartdiskcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kWidth = 64;
+
+class CoverArtDiskCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QDir cacheDir() const {
+        return QDir(m_tempDir.path());
+    }
+
+    // Noise doesn't compress well and results in entries of similar size
+    static QImage createImage(int width, uint seed) {
+        QImage image(width, width, QImage::Format_RGB32);
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                seed = seed * 1103515245 + 12345;
+                image.setPixel(x, y, seed >> 8);
+            }
+        }
+        return image;
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(CoverArtDiskCacheTest, saveAndLoad) {
+    CoverArtDiskCache cache(cacheDir(), 1024 * 1024);
+    const mixxx::cache_key_t cacheKey = 0x0123456789abcdef;
+    EXPECT_FALSE(cache.contains(cacheKey, kWidth));
+    EXPECT_TRUE(cache.load(cacheKey, kWidth).isNull());
+
+    const QImage image = createImage(kWidth, 1);
+    ASSERT_TRUE(cache.save(cacheKey, image));
+    EXPECT_TRUE(cache.contains(cacheKey, kWidth));
+    EXPECT_GT(cache.sizeInBytes(), 0u);
+
+    const QImage loaded = cache.load(cacheKey, kWidth);
+    ASSERT_FALSE(loaded.isNull());
+    EXPECT_EQ(image.size(), loaded.size());
+
+    // Other widths and keys are different entries
+    EXPECT_TRUE(cache.load(cacheKey, kWidth * 2).isNull());
+    EXPECT_TRUE(cache.load(cacheKey + 1, kWidth).isNull());
+}
+
+TEST_F(CoverArtDiskCacheTest, invalidCacheKey) {
+    CoverArtDiskCache cache(cacheDir(), 1024 * 1024);
+    EXPECT_FALSE(cache.save(mixxx::invalidCacheKey(), createImage(kWidth, 1)));
+    EXPECT_EQ(0u, cache.sizeInBytes());
+}
+
+TEST_F(CoverArtDiskCacheTest, corruptEntry) {
+    CoverArtDiskCache cache(cacheDir(), 1024 * 1024);
+    const mixxx::cache_key_t cacheKey = 42;
+    ASSERT_TRUE(cache.save(cacheKey, createImage(kWidth, 1)));
+
+    QFile entry(cache.entryFilePath(cacheKey, kWidth));
+    ASSERT_TRUE(entry.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    entry.write("garbage");
+    entry.close();
+
+    EXPECT_TRUE(cache.load(cacheKey, kWidth).isNull());
+    // Invalid entries are deleted
+    EXPECT_FALSE(cache.contains(cacheKey, kWidth));
+}
+
+TEST_F(CoverArtDiskCacheTest, evictLeastRecentlyUsed) {
+    constexpr int kEntryCount = 10;
+    {
+        CoverArtDiskCache cache(cacheDir(), 1024 * 1024 * 1024);
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        for (int i = 0; i < kEntryCount; ++i) {
+            const mixxx::cache_key_t cacheKey = i + 1;
+            ASSERT_TRUE(cache.save(cacheKey, createImage(kWidth, i)));
+            // Entry 1 has been used least recently
+            QFile entry(cache.entryFilePath(cacheKey, kWidth));
+            ASSERT_TRUE(entry.open(QIODevice::ReadWrite));
+            ASSERT_TRUE(entry.setFileTime(
+                    now.addSecs(-3600 + i * 60), QFileDevice::FileModificationTime));
+        }
+        // Loading entry 1 makes it the most recently used entry
+        ASSERT_FALSE(cache.load(1, kWidth).isNull());
+    }
+
+    CoverArtDiskCache cache(cacheDir(), 0);
+    const quint64 totalSize = cache.sizeInBytes();
+    ASSERT_LT(0u, totalSize);
+
+    // Keep about half of the entries
+    CoverArtDiskCache smallCache(cacheDir(), totalSize / 2);
+    smallCache.evict();
+    EXPECT_GE(totalSize / 2, smallCache.sizeInBytes());
+
+    EXPECT_TRUE(smallCache.contains(1, kWidth));
+    EXPECT_FALSE(smallCache.contains(2, kWidth));
+    EXPECT_FALSE(smallCache.contains(3, kWidth));
+    EXPECT_TRUE(smallCache.contains(kEntryCount, kWidth));
+}
+
+} // namespace
@@ -1,7 +1,14 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <atomic>
+#include <thread>
+
 #include "library/dao/settingsdao.h"
 #include "test/mixxxdbtest.h"
+#include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 
 class DbConnectionPoolTest : public MixxxTest {};
@@ -20,3 +27,140 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, Tuning) {
+    const auto pPool = MixxxDb(config()).connectionPool();
+    const mixxx::DbConnectionPooler pooler(pPool);
+    ASSERT_TRUE(pooler.isPooling());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+
+    QSqlQuery query(database);
+    ASSERT_TRUE(query.exec(QStringLiteral("PRAGMA journal_mode")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("wal"), query.value(0).toString());
+}
+
+TEST_F(DbConnectionPoolTest, ReadOnly) {
+    const auto pPool = MixxxDb(config()).connectionPool();
+    const mixxx::DbConnectionPooler pooler(pPool);
+    ASSERT_TRUE(pooler.isPooling());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+    QSqlQuery writeQuery(database);
+    ASSERT_TRUE(writeQuery.exec(QStringLiteral("CREATE TABLE test (value INTEGER)")));
+    ASSERT_TRUE(writeQuery.exec(QStringLiteral("INSERT INTO test VALUES (1)")));
+
+    const mixxx::DbConnectionPooler readOnlyPooler(
+            pPool, mixxx::DbConnection::AccessMode::ReadOnly);
+    ASSERT_TRUE(readOnlyPooler.isPooling());
+    const QSqlDatabase readOnlyDatabase = mixxx::DbConnectionPooled(
+            pPool, mixxx::DbConnection::AccessMode::ReadOnly);
+    EXPECT_NE(database.connectionName(), readOnlyDatabase.connectionName());
+
+    QSqlQuery readQuery(readOnlyDatabase);
+    EXPECT_FALSE(readQuery.exec(QStringLiteral("INSERT INTO test VALUES (2)")));
+    // The library models create temporary views
+    EXPECT_TRUE(readQuery.exec(QStringLiteral(
+            "CREATE TEMPORARY VIEW test_view AS SELECT value FROM test")));
+
+    // Not blocked by a pending write and only sees committed rows
+    ASSERT_TRUE(database.transaction());
+    ASSERT_TRUE(writeQuery.exec(QStringLiteral("INSERT INTO test VALUES (3)")));
+    ASSERT_TRUE(readQuery.exec(QStringLiteral("SELECT COUNT(*) FROM test_view")));
+    ASSERT_TRUE(readQuery.next());
+    EXPECT_EQ(1, readQuery.value(0).toInt());
+    readQuery.finish();
+    ASSERT_TRUE(database.commit());
+
+    ASSERT_TRUE(readQuery.exec(QStringLiteral("SELECT COUNT(*) FROM test_view")));
+    ASSERT_TRUE(readQuery.next());
+    EXPECT_EQ(2, readQuery.value(0).toInt());
+}
+
+// Latency of the query that populates the library view of the GUI while
+// the library scanner keeps adding tracks to the database. Both use the
+// schema and the connection settings of the main database, the GUI
+// queries through its read-only connection. Arg 0 uses the rollback
+// journal, arg 1 uses WAL.
+static void BM_LibraryViewLatencyWhileScanning(benchmark::State& state) {
+    const QTemporaryDir tempDir;
+    const auto pConfig = UserSettingsPointer::create(
+            tempDir.filePath(QStringLiteral("mixxx.cfg")));
+    pConfig->set(ConfigKey(QStringLiteral("[Database]"), QStringLiteral("JournalMode")),
+            ConfigValue(state.range(0) ? QStringLiteral("WAL") : QStringLiteral("DELETE")));
+    const MixxxDb mixxxDb(pConfig);
+    const auto pPool = mixxxDb.connectionPool();
+
+    // The connections of the GUI thread
+    const mixxx::DbConnectionPooler pooler(pPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+    const mixxx::DbConnectionPooler readOnlyPooler(
+            pPool, mixxx::DbConnection::AccessMode::ReadOnly);
+    const QSqlDatabase readOnlyDatabase = mixxx::DbConnectionPooled(
+            pPool, mixxx::DbConnection::AccessMode::ReadOnly);
+    if (!MixxxDb::initDatabaseSchema(database)) {
+        state.SkipWithError("Failed to initialize the database schema");
+        return;
+    }
+    // Adds the tracks like the scanner does, one transaction per directory
+    const auto addTracks = [](QSqlDatabase database, const QString& directory, int count) {
+        QSqlQuery insertLocation(database);
+        insertLocation.prepare(QStringLiteral(
+                "INSERT INTO track_locations "
+                "(location, filename, directory, filesize, fs_deleted, needs_verification) "
+                "VALUES (:location, :filename, :directory, 1000000, 0, 0)"));
+        QSqlQuery insertTrack(database);
+        insertTrack.prepare(QStringLiteral(
+                "INSERT INTO library (artist, title, album, location, mixxx_deleted) "
+                "VALUES (:artist, :title, :album, :location, 0)"));
+        database.transaction();
+        for (int i = 0; i < count; ++i) {
+            const QString fileName = QStringLiteral("%1.mp3").arg(i);
+            insertLocation.bindValue(QStringLiteral(":location"),
+                    directory + QChar('/') + fileName);
+            insertLocation.bindValue(QStringLiteral(":filename"), fileName);
+            insertLocation.bindValue(QStringLiteral(":directory"), directory);
+            insertLocation.exec();
+            insertTrack.bindValue(QStringLiteral(":artist"),
+                    QStringLiteral("Artist %1").arg(i % 100));
+            insertTrack.bindValue(QStringLiteral(":title"),
+                    QStringLiteral("Title %1").arg(i));
+            insertTrack.bindValue(QStringLiteral(":album"), directory);
+            insertTrack.bindValue(QStringLiteral(":location"),
+                    insertLocation.lastInsertId());
+            insertTrack.exec();
+        }
+        database.commit();
+    };
+    addTracks(database, QStringLiteral("/home/user/Music"), 10000);
+
+    std::atomic<bool> stopScanning(false);
+    std::thread scanner([&pPool, &stopScanning, &addTracks] {
+        const mixxx::DbConnectionPooler pooler(pPool);
+        const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+        int directory = 0;
+        while (!stopScanning.load()) {
+            addTracks(database, QStringLiteral("/media/new/%1").arg(++directory), 100);
+        }
+    });
+
+    // The library view of LibraryTableModel sorted by artist
+    QSqlQuery query(readOnlyDatabase);
+    query.setForwardOnly(true);
+    for (auto _ : state) {
+        query.exec(QStringLiteral(
+                "SELECT library.id, artist, title, album FROM library "
+                "INNER JOIN track_locations ON library.location=track_locations.id "
+                "WHERE (mixxx_deleted=0 AND fs_deleted=0) "
+                "ORDER BY artist, title"));
+        int rowCount = 0;
+        while (query.next()) {
+            ++rowCount;
+        }
+        benchmark::DoNotOptimize(rowCount);
+    }
+    query.finish();
+
+    stopScanning.store(true);
+    scanner.join();
+}
+BENCHMARK(BM_LibraryViewLatencyWhileScanning)->Arg(0)->Arg(1)->UseRealTime();
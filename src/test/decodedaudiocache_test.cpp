@@ -0,0 +1,207 @@
+#include "sources/decodedaudiocache.h"
+
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <QThread>
+#include <vector>
+
+namespace {
+
+constexpr SINT kChannels = 2;
+constexpr SINT kFrames = 10000;
+constexpr SINT kChunkFrames = 1024;
+constexpr SINT kSampleRate = 44100;
+
+// Generates the sample value of each sample from its index
+class SyntheticAudioSource : public mixxx::AudioSource {
+  public:
+    SyntheticAudioSource(const QUrl& url, SINT frameCount)
+            : mixxx::AudioSource(url),
+              m_frameCount(frameCount) {
+    }
+
+    void close() override {
+    }
+
+    static CSAMPLE sample(SINT sampleIndex) {
+        return static_cast<CSAMPLE>(sampleIndex % 65536) / 65536.0f;
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        initChannelCountOnce(static_cast<int>(kChannels));
+        initSampleRateOnce(kSampleRate);
+        initFrameIndexRangeOnce(mixxx::IndexRange::forward(0, m_frameCount));
+        return OpenResult::Succeeded;
+    }
+
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override {
+        const SINT firstSampleIndex = sampleFrames.frameIndexRange().start() * kChannels;
+        for (SINT i = 0; i < sampleFrames.writableLength(); ++i) {
+            sampleFrames.writableData()[i] = sample(firstSampleIndex + i);
+        }
+        return mixxx::ReadableSampleFrames(
+                sampleFrames.frameIndexRange(),
+                mixxx::SampleBuffer::ReadableSlice(
+                        sampleFrames.writableData(),
+                        sampleFrames.writableLength()));
+    }
+
+  private:
+    const SINT m_frameCount;
+};
+
+class DecodedAudioCacheTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        ASSERT_TRUE(QDir(m_tempDir.path()).mkdir(QStringLiteral("cache")));
+        m_cacheDir = QDir(m_tempDir.filePath(QStringLiteral("cache")));
+    }
+
+    mixxx::FileInfo createSourceFile(const QString& fileName) {
+        QFile file(m_tempDir.filePath(fileName));
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(fileName.toUtf8());
+        file.close();
+        return mixxx::FileInfo(file);
+    }
+
+    static mixxx::AudioSource::OpenParams stereoOpenParams() {
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
+        return openParams;
+    }
+
+    // Decodes all frames chunk-wise, like the analyzer does
+    static bool writeEntry(
+            mixxx::DecodedAudioCache* pCache,
+            const mixxx::FileInfo& fileInfo,
+            SINT frameCount) {
+        SyntheticAudioSource audioSource(fileInfo.toQUrl(), frameCount);
+        EXPECT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+                audioSource.open(mixxx::AudioSource::OpenMode::Strict));
+        const auto pWriter = pCache->createWriter(fileInfo, audioSource);
+        if (!pWriter) {
+            return false;
+        }
+        mixxx::SampleBuffer buffer(kChunkFrames * kChannels);
+        auto remainingFrameIndexRange = audioSource.frameIndexRange();
+        while (!remainingFrameIndexRange.empty()) {
+            const auto chunkFrameIndexRange = remainingFrameIndexRange.splitAndShrinkFront(
+                    math_min(kChunkFrames, remainingFrameIndexRange.length()));
+            pWriter->write(audioSource.readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            chunkFrameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(buffer))));
+        }
+        return pWriter->commit(audioSource.frameIndexRange());
+    }
+
+    QTemporaryDir m_tempDir;
+    QDir m_cacheDir;
+};
+
+TEST_F(DecodedAudioCacheTest, writeAndRead) {
+    mixxx::DecodedAudioCache cache(m_cacheDir, 1024 * 1024);
+    const auto fileInfo = createSourceFile(QStringLiteral("track.mp3"));
+    EXPECT_FALSE(cache.contains(fileInfo));
+    EXPECT_EQ(nullptr, cache.openAudioSource(fileInfo, stereoOpenParams()));
+
+    ASSERT_TRUE(writeEntry(&cache, fileInfo, kFrames));
+    EXPECT_TRUE(cache.contains(fileInfo));
+
+    // The number of channels must match
+    mixxx::AudioSource::OpenParams monoOpenParams;
+    monoOpenParams.setChannelCount(mixxx::audio::ChannelCount::mono());
+    EXPECT_EQ(nullptr, cache.openAudioSource(fileInfo, monoOpenParams));
+
+    const auto pAudioSource = cache.openAudioSource(fileInfo, stereoOpenParams());
+    ASSERT_NE(nullptr, pAudioSource);
+    EXPECT_EQ(kChannels, pAudioSource->getSignalInfo().getChannelCount());
+    EXPECT_EQ(kSampleRate, pAudioSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, kFrames), pAudioSource->frameIndexRange());
+
+    // Random access
+    const auto frameIndexRange = mixxx::IndexRange::forward(kFrames / 3, kChunkFrames);
+    mixxx::SampleBuffer buffer(kChunkFrames * kChannels);
+    const auto readableSampleFrames = pAudioSource->readSampleFrames(
+            mixxx::WritableSampleFrames(
+                    frameIndexRange,
+                    mixxx::SampleBuffer::WritableSlice(buffer)));
+    ASSERT_EQ(frameIndexRange, readableSampleFrames.frameIndexRange());
+    for (SINT i = 0; i < readableSampleFrames.readableLength(); ++i) {
+        EXPECT_EQ(SyntheticAudioSource::sample(frameIndexRange.start() * kChannels + i),
+                readableSampleFrames.readableData()[i]);
+    }
+}
+
+TEST_F(DecodedAudioCacheTest, modifiedSourceFile) {
+    mixxx::DecodedAudioCache cache(m_cacheDir, 1024 * 1024);
+    const auto fileInfo = createSourceFile(QStringLiteral("track.mp3"));
+    ASSERT_TRUE(writeEntry(&cache, fileInfo, kFrames));
+    EXPECT_TRUE(cache.contains(fileInfo));
+
+    QFile file(fileInfo.location());
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("modified");
+    file.close();
+    EXPECT_FALSE(cache.contains(fileInfo));
+    EXPECT_EQ(nullptr, cache.openAudioSource(fileInfo, stereoOpenParams()));
+}
+
+TEST_F(DecodedAudioCacheTest, incompleteEntry) {
+    mixxx::DecodedAudioCache cache(m_cacheDir, 1024 * 1024);
+    const auto fileInfo = createSourceFile(QStringLiteral("track.mp3"));
+    SyntheticAudioSource audioSource(fileInfo.toQUrl(), kFrames);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            audioSource.open(mixxx::AudioSource::OpenMode::Strict));
+    {
+        const auto pWriter = cache.createWriter(fileInfo, audioSource);
+        ASSERT_NE(nullptr, pWriter);
+        mixxx::SampleBuffer buffer(kChunkFrames * kChannels);
+        pWriter->write(audioSource.readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(0, kChunkFrames),
+                        mixxx::SampleBuffer::WritableSlice(buffer))));
+        EXPECT_FALSE(pWriter->commit(audioSource.frameIndexRange()));
+    }
+    EXPECT_FALSE(cache.contains(fileInfo));
+    EXPECT_EQ(0u, cache.sizeInBytes());
+}
+
+TEST_F(DecodedAudioCacheTest, evictLeastRecentlyUsed) {
+    // Room for 2 entries
+    constexpr quint64 kEntrySize = 64 + kFrames * kChannels * sizeof(CSAMPLE);
+    mixxx::DecodedAudioCache cache(m_cacheDir, 2 * kEntrySize + kEntrySize / 2);
+    const auto fileInfo1 = createSourceFile(QStringLiteral("track1.mp3"));
+    const auto fileInfo2 = createSourceFile(QStringLiteral("track2.mp3"));
+    const auto fileInfo3 = createSourceFile(QStringLiteral("track3.mp3"));
+
+    ASSERT_TRUE(writeEntry(&cache, fileInfo1, kFrames));
+    // Separate the modification times of the entries
+    QThread::msleep(20);
+    ASSERT_TRUE(writeEntry(&cache, fileInfo2, kFrames));
+    QThread::msleep(20);
+    // Reading the 1st entry makes the 2nd the least recently used
+    EXPECT_NE(nullptr, cache.openAudioSource(fileInfo1, stereoOpenParams()));
+    QThread::msleep(20);
+    ASSERT_TRUE(writeEntry(&cache, fileInfo3, kFrames));
+
+    EXPECT_TRUE(cache.contains(fileInfo1));
+    EXPECT_FALSE(cache.contains(fileInfo2));
+    EXPECT_TRUE(cache.contains(fileInfo3));
+    EXPECT_EQ(2 * kEntrySize, cache.sizeInBytes());
+
+    // Entries that exceed the size limit are not written at all
+    const auto fileInfo4 = createSourceFile(QStringLiteral("track4.mp3"));
+    EXPECT_FALSE(writeEntry(&cache, fileInfo4, 3 * kFrames));
+    EXPECT_TRUE(cache.contains(fileInfo1));
+    EXPECT_TRUE(cache.contains(fileInfo3));
+}
+
+} // namespace
@@ -0,0 +1,114 @@
+#include "engine/enginechannelthreadpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <atomic>
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderworker.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+constexpr int kNumJobs = 16;
+
+class EngineChannelThreadPoolTest : public testing::Test,
+                                    public EngineChannelThreadPool::JobRunner {
+  protected:
+    EngineChannelThreadPoolTest()
+            : m_jobCounts(kNumJobs) {
+    }
+
+    void processJob(int jobIndex) override {
+        m_jobCounts[jobIndex].fetch_add(1);
+    }
+
+    std::vector<std::atomic<int>> m_jobCounts;
+};
+
+TEST_F(EngineChannelThreadPoolTest, EachJobIsProcessedOncePerCallback) {
+    EngineChannelThreadPool pool(3);
+    constexpr int kCallbacks = 1000;
+    for (int i = 0; i < kCallbacks; ++i) {
+        pool.processJobs(this, 1, kNumJobs);
+    }
+    EXPECT_EQ(0, m_jobCounts[0].load());
+    for (int i = 1; i < kNumJobs; ++i) {
+        EXPECT_EQ(kCallbacks, m_jobCounts[i].load()) << "job" << i;
+    }
+}
+
+TEST_F(EngineChannelThreadPoolTest, VaryingJobRanges) {
+    EngineChannelThreadPool pool(2);
+    // Alternate between short and long job ranges to catch workers that
+    // wake up late and mix up the ranges of consecutive callbacks.
+    for (int i = 0; i < 1000; ++i) {
+        pool.processJobs(this, 0, 2);
+        pool.processJobs(this, 2, kNumJobs);
+        pool.processJobs(this, 5, 5);
+    }
+    for (int i = 0; i < kNumJobs; ++i) {
+        EXPECT_EQ(1000, m_jobCounts[i].load()) << "job" << i;
+    }
+}
+
+class EngineChannelThreadsTest : public SignalPathTest {
+  protected:
+    struct Output {
+        QByteArray master;
+        QByteArray headphone;
+    };
+
+    // Renders all decks from the start, waiting for the engine workers
+    // after each callback like EngineOfflineRenderer does
+    Output renderFromStart(int channelThreads) {
+        m_pEngineMaster->setChannelThreads(channelThreads);
+        for (const auto& group : {m_sGroup1, m_sGroup2, m_sGroup3}) {
+            ControlObject::set(ConfigKey(group, "playposition"), 0.0);
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+        Output output;
+        constexpr int kCallbacks = 100;
+        const int bufferBytes = kProcessBufferSize * static_cast<int>(sizeof(CSAMPLE));
+        for (int i = 0; i < kCallbacks; ++i) {
+            m_pEngineMaster->wakeWorkers();
+            EXPECT_TRUE(CachingReaderWorker::waitForPendingRequests(
+                    mixxx::Duration::fromSeconds(10)));
+            m_pEngineMaster->process(kProcessBufferSize);
+            output.master.append(reinterpret_cast<const char*>(
+                                         m_pEngineMaster->getMasterBuffer()),
+                    bufferBytes);
+            output.headphone.append(reinterpret_cast<const char*>(
+                                            m_pEngineMaster->getHeadphoneBuffer()),
+                    bufferBytes);
+        }
+        for (const auto& group : {m_sGroup1, m_sGroup2, m_sGroup3}) {
+            ControlObject::set(ConfigKey(group, "play"), 0.0);
+        }
+        m_pEngineMaster->setChannelThreads(0);
+        return output;
+    }
+};
+
+TEST_F(EngineChannelThreadsTest, OutputIsBitIdenticalToSerialProcessing) {
+    ControlObject::set(ConfigKey(m_sGroup1, "orientation"), EngineChannel::LEFT);
+    ControlObject::set(ConfigKey(m_sGroup2, "orientation"), EngineChannel::RIGHT);
+    ControlObject::set(ConfigKey(m_sGroup2, "pfl"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "pfl"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "rate"), getRateSliderValue(1.25));
+    ControlObject::set(ConfigKey(m_sMasterGroup, "crossfader"), -0.5);
+
+    const Output serial = renderFromStart(0);
+    ASSERT_FALSE(serial.master.isEmpty());
+    for (const int channelThreads : {1, 3}) {
+        const Output concurrent = renderFromStart(channelThreads);
+        // Compared byte by byte, not within a delta
+        EXPECT_TRUE(concurrent.master == serial.master)
+                << channelThreads << "channel threads";
+        EXPECT_TRUE(concurrent.headphone == serial.headphone)
+                << channelThreads << "channel threads";
+    }
+}
+
+} // namespace
@@ -33,6 +33,7 @@ class EngineMicrophoneTest : public SignalPathTest {
         SampleUtil::free(output);
         SampleUtil::free(test);
         delete m_pMicrophone;
+        SignalPathTest::TearDown();
     }
 
     void ClearBuffer(CSAMPLE* pBuffer, int length) {
@@ -0,0 +1,98 @@
+#include "engine/engineofflinerenderer.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kFramesPerBuffer = 512;
+
+class EngineOfflineRendererTest : public SignalPathTest {
+  protected:
+    QString outputFileName(const QString& extension) const {
+        return getTestDataDir().filePath(QStringLiteral("offline.") + extension);
+    }
+};
+
+TEST_F(EngineOfflineRendererTest, RenderWave) {
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+
+    EngineOfflineRenderer renderer(
+            config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer);
+    const QString fileName = outputFileName(QStringLiteral("wav"));
+    ASSERT_TRUE(renderer.open(fileName, ENCODING_WAVE));
+
+    const auto stats = renderer.render(mixxx::Duration::fromSeconds(2));
+    renderer.close();
+
+    EXPECT_GE(stats.frames, 2 * static_cast<SINT>(kSampleRate));
+    EXPECT_EQ(stats.frames, stats.callbacks * kFramesPerBuffer);
+    EXPECT_LE(stats.minCallbackDuration, stats.meanCallbackDuration());
+    EXPECT_LE(stats.meanCallbackDuration(), stats.maxCallbackDuration);
+    EXPECT_GT(stats.realtimeFactor(), 0.0);
+
+    // 16 bit stereo PCM plus header
+    EXPECT_GE(QFileInfo(fileName).size(), stats.frames * 2 * 2);
+}
+
+TEST_F(EngineOfflineRendererTest, CallbackHook) {
+    EngineOfflineRenderer renderer(
+            config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer);
+    ASSERT_TRUE(renderer.open(outputFileName(QStringLiteral("flac")), ENCODING_FLAC));
+
+    int hookCalls = 0;
+    SINT lastFramesRendered = -1;
+    renderer.setCallbackHook([&](SINT framesRendered) {
+        EXPECT_GT(framesRendered, lastFramesRendered);
+        lastFramesRendered = framesRendered;
+        // Automate the crossfader from left to right
+        ControlObject::set(ConfigKey(m_sMasterGroup, "crossfader"),
+                -1.0 + 2.0 * framesRendered / static_cast<SINT>(kSampleRate));
+        ++hookCalls;
+    });
+    const auto stats = renderer.render(mixxx::Duration::fromSeconds(1));
+
+    EXPECT_EQ(stats.callbacks, hookCalls);
+}
+
+TEST_F(EngineOfflineRendererTest, Reproducible) {
+    const auto renderFromStart = [this](const QString& fileName) {
+        for (const auto& group : {m_sGroup1, m_sGroup2, m_sGroup3}) {
+            ControlObject::set(ConfigKey(group, "playposition"), 0.0);
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+        EngineOfflineRenderer renderer(
+                config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer);
+        EXPECT_TRUE(renderer.open(fileName, ENCODING_WAVE));
+        const auto stats = renderer.render(mixxx::Duration::fromSeconds(1));
+        EXPECT_GE(stats.frames, static_cast<SINT>(kSampleRate));
+        renderer.close();
+        for (const auto& group : {m_sGroup1, m_sGroup2, m_sGroup3}) {
+            ControlObject::set(ConfigKey(group, "play"), 0.0);
+        }
+        QFile file(fileName);
+        EXPECT_TRUE(file.open(QIODevice::ReadOnly));
+        return file.readAll();
+    };
+
+    // The output must not depend on the timing of the engine workers
+    const QByteArray first = renderFromStart(outputFileName(QStringLiteral("1.wav")));
+    const QByteArray second = renderFromStart(outputFileName(QStringLiteral("2.wav")));
+    EXPECT_FALSE(first.isEmpty());
+    EXPECT_EQ(first, second);
+}
+
+TEST_F(EngineOfflineRendererTest, UnsupportedEncoding) {
+    EngineOfflineRenderer renderer(
+            config(), m_pEngineMaster, kSampleRate, kFramesPerBuffer);
+    EXPECT_FALSE(renderer.open(outputFileName(QStringLiteral("mp3")), ENCODING_MP3));
+    EXPECT_FALSE(renderer.isOpen());
+}
+
+} // namespace
@@ -1,8 +1,15 @@
 #include "track/globaltrackcache.h"
 
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+#include <QTemporaryDir>
 #include <QThread>
 #include <QtDebug>
 #include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
 
 #include "test/mixxxtest.h"
 #include "track/track.h"
@@ -69,12 +76,44 @@ void deleteTrack(Track* pTrack) {
     delete pTrack;
 };
 
+// Empty files that are spread over all shards of the cache
+std::vector<mixxx::FileAccess> createTrackFiles(
+        const QTemporaryDir& tempDir,
+        int count) {
+    std::vector<mixxx::FileAccess> fileAccesses;
+    fileAccesses.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const QString filePath = tempDir.filePath(QStringLiteral("%1.mp3").arg(i));
+        QFile file(filePath);
+        file.open(QIODevice::WriteOnly);
+        fileAccesses.emplace_back(mixxx::FileInfo(filePath));
+    }
+    return fileAccesses;
+}
+
+TrackPointer resolveTrack(
+        const mixxx::FileAccess& fileAccess,
+        TrackId trackId) {
+    GlobalTrackCacheResolver resolver(fileAccess, trackId);
+    return resolver.getTrack();
+}
+
+class NoopTrackCacheSaver : public virtual GlobalTrackCacheSaver {
+  public:
+    void saveEvictedTrack(Track* pTrack) noexcept override {
+        Q_UNUSED(pTrack);
+    }
+};
+
 } // anonymous namespace
 
 class GlobalTrackCacheTest: public MixxxTest, public virtual GlobalTrackCacheSaver {
   public:
     void saveEvictedTrack(Track* pTrack) noexcept override {
         ASSERT_FALSE(pTrack == nullptr);
+        if (m_onSaveEvictedTrack) {
+            m_onSaveEvictedTrack(pTrack);
+        }
     }
 
   protected:
@@ -86,6 +125,7 @@ class GlobalTrackCacheTest: public MixxxTest, public virtual GlobalTrackCacheSav
     }
 
     TrackPointer m_recentTrackPtr;
+    std::function<void(Track*)> m_onSaveEvictedTrack;
 };
 
 TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
@@ -139,6 +179,53 @@ TEST_F(GlobalTrackCacheTest, resolveByFileInfo) {
     }
 }
 
+TEST_F(GlobalTrackCacheTest, lookupByIdWhileSaving) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const TrackId trackId(1);
+    TrackPointer track;
+    {
+        GlobalTrackCacheResolver resolver(
+                mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(kTestFile))));
+        track = resolver.getTrack();
+        ASSERT_TRUE(static_cast<bool>(track));
+        resolver.initTrackIdAndUnlockCache(trackId);
+    }
+
+    std::atomic<bool> lookupStarted(false);
+    std::atomic<bool> lookupFinished(false);
+    std::atomic<bool> saved(false);
+    std::atomic<bool> savedBeforeLookupFinished(false);
+    std::thread lookupThread;
+    m_onSaveEvictedTrack = [&](Track* pTrack) {
+        EXPECT_EQ(trackId, pTrack->getId());
+        lookupThread = std::thread([&] {
+            lookupStarted.store(true);
+            // Must neither find the evicted track nor load the
+            // outdated track from the database before it has been saved
+            EXPECT_FALSE(static_cast<bool>(
+                    GlobalTrackCacheLocker().lookupTrackById(trackId)));
+            savedBeforeLookupFinished.store(saved.load());
+            lookupFinished.store(true);
+        });
+        while (!lookupStarted.load()) {
+            QThread::yieldCurrentThread();
+        }
+        QThread::msleep(50);
+        EXPECT_FALSE(lookupFinished.load());
+        saved.store(true);
+    };
+
+    // Evicts and saves the track synchronously on this thread
+    track.reset();
+    lookupThread.join();
+    m_onSaveEvictedTrack = nullptr;
+
+    EXPECT_TRUE(saved.load());
+    EXPECT_TRUE(savedBeforeLookupFinished.load());
+    EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
+}
+
 TEST_F(GlobalTrackCacheTest, concurrentDelete) {
     ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
 
@@ -221,3 +308,104 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
 
     EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
 }
+
+TEST_F(GlobalTrackCacheTest, concurrentResolve) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    constexpr int kTrackCount = 100;
+    constexpr int kThreadCount = 4;
+    const QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const auto fileAccesses = createTrackFiles(tempDir, kTrackCount);
+
+    // Every thread resolves all tracks in a different order and
+    // keeps the references
+    std::vector<std::vector<TrackPointer>> tracks(kThreadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreadCount; ++t) {
+        tracks[t].resize(kTrackCount);
+        threads.emplace_back([&fileAccesses, &tracks, t] {
+            for (int j = 0; j < kTrackCount; ++j) {
+                const int i = (j * (t + 1)) % kTrackCount;
+                const auto& fileAccess = fileAccesses[i];
+                // Resolve some tracks only by location
+                const TrackId trackId = (i % 2) ? TrackId(i) : TrackId();
+                tracks[t][i] = resolveTrack(fileAccess, trackId);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Each track has only been allocated once
+    for (int i = 0; i < kTrackCount; ++i) {
+        ASSERT_TRUE(tracks[0][i]);
+        for (int t = 1; t < kThreadCount; ++t) {
+            EXPECT_EQ(tracks[0][i], tracks[t][i]);
+        }
+        EXPECT_EQ(tracks[0][i],
+                GlobalTrackCacheLocker().lookupTrackByRef(
+                        TrackRef::fromFileInfo(fileAccesses[i].info())));
+    }
+
+    tracks.clear();
+    // Ensure that all track objects have been deleted
+    while (!GlobalTrackCacheLocker().isEmpty()) {
+        QCoreApplication::processEvents();
+    }
+}
+
+// Many threads resolve tracks by id and location while the main thread
+// evicts the tracks that are no longer referenced. Measures the latency
+// of resolving a track in the main thread and the throughput of all
+// other threads. Arg: The number of other threads.
+static void BM_ResolveWhileEvicting(benchmark::State& state) {
+    constexpr int kTrackCount = 256;
+    const int threadCount = static_cast<int>(state.range(0));
+    const QTemporaryDir tempDir;
+    const auto fileAccesses = createTrackFiles(tempDir, kTrackCount);
+
+    NoopTrackCacheSaver saver;
+    GlobalTrackCache::createInstance(&saver, deleteTrack);
+
+    std::atomic<bool> stopResolving(false);
+    std::atomic<qint64> resolveCount(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&fileAccesses, &stopResolving, &resolveCount, t] {
+            qint64 count = 0;
+            for (int i = t; !stopResolving.load(); ++i) {
+                const int index = i % kTrackCount;
+                // The track is released immediately and evicted
+                // by the main thread
+                benchmark::DoNotOptimize(resolveTrack(
+                        fileAccesses[index], TrackId(index)));
+                ++count;
+            }
+            resolveCount.fetch_add(count);
+        });
+    }
+
+    int i = 0;
+    for (auto _ : state) {
+        const int index = i++ % kTrackCount;
+        benchmark::DoNotOptimize(resolveTrack(
+                fileAccesses[index], TrackId(index)));
+        QCoreApplication::processEvents();
+    }
+
+    stopResolving.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    state.counters["OtherResolves"] = benchmark::Counter(
+            static_cast<double>(resolveCount.load()),
+            benchmark::Counter::kIsRate);
+
+    while (!GlobalTrackCacheLocker().isEmpty()) {
+        QCoreApplication::processEvents();
+    }
+    GlobalTrackCache::destroyInstance();
+}
+BENCHMARK(BM_ResolveWhileEvicting)->Arg(0)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
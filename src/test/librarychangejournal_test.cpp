@@ -0,0 +1,113 @@
+#include "library/scanner/librarychangejournal.h"
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+#ifdef __LINUX__
+
+namespace {
+
+class LibraryChangeJournalTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_rootDir = mixxx::FileInfo(m_tempDir.path());
+        ASSERT_TRUE(QDir(m_tempDir.path()).mkpath(QStringLiteral("album")));
+        m_albumLocation = m_rootDir.location() + QStringLiteral("/album");
+    }
+
+    // Simulates the full scan that lists all directories
+    void fullScan() {
+        m_journal.beginFullScan({m_rootDir});
+        m_journal.watchDirectory(m_rootDir.location());
+        m_journal.watchDirectory(m_albumLocation);
+        m_journal.endFullScan(true);
+    }
+
+    static void createFile(const QString& filePath) {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write("test");
+    }
+
+    QTemporaryDir m_tempDir;
+    mixxx::FileInfo m_rootDir;
+    QString m_albumLocation;
+    LibraryChangeJournal m_journal;
+};
+
+TEST_F(LibraryChangeJournalTest, validAfterFullScan) {
+    EXPECT_FALSE(m_journal.isValidFor({m_rootDir}));
+    fullScan();
+    EXPECT_TRUE(m_journal.isValidFor({m_rootDir}));
+    EXPECT_TRUE(m_journal.takeChanges().isEmpty());
+
+    // Different library directories
+    EXPECT_FALSE(m_journal.isValidFor({}));
+
+    m_journal.invalidate();
+    EXPECT_FALSE(m_journal.isValidFor({m_rootDir}));
+}
+
+TEST_F(LibraryChangeJournalTest, uncleanFullScan) {
+    m_journal.beginFullScan({m_rootDir});
+    m_journal.watchDirectory(m_rootDir.location());
+    m_journal.endFullScan(false);
+    EXPECT_FALSE(m_journal.isValidFor({m_rootDir}));
+}
+
+TEST_F(LibraryChangeJournalTest, createdFile) {
+    fullScan();
+    createFile(m_albumLocation + QStringLiteral("/track.mp3"));
+
+    const auto changes = m_journal.takeChanges();
+    EXPECT_EQ(QSet<QString>{m_albumLocation}, changes.changedDirectories);
+    EXPECT_TRUE(changes.removedDirectories.isEmpty());
+    EXPECT_FALSE(changes.isRemoved(m_albumLocation));
+
+    // Changes are only reported once
+    EXPECT_TRUE(m_journal.takeChanges().isEmpty());
+}
+
+TEST_F(LibraryChangeJournalTest, removedDirectory) {
+    fullScan();
+    ASSERT_TRUE(QDir(m_albumLocation).removeRecursively());
+
+    const auto changes = m_journal.takeChanges();
+    EXPECT_TRUE(changes.changedDirectories.contains(m_rootDir.location()));
+    EXPECT_TRUE(changes.isRemoved(m_albumLocation));
+    EXPECT_TRUE(changes.isRemoved(m_albumLocation + QStringLiteral("/cd1")));
+    EXPECT_FALSE(changes.isRemoved(m_albumLocation + QStringLiteral("2")));
+    EXPECT_FALSE(changes.isRemoved(m_rootDir.location()));
+    EXPECT_TRUE(m_journal.isValidFor({m_rootDir}));
+}
+
+TEST_F(LibraryChangeJournalTest, renamedDirectory) {
+    fullScan();
+    ASSERT_TRUE(QDir(m_rootDir.location())
+                        .rename(QStringLiteral("album"), QStringLiteral("renamed")));
+
+    const auto changes = m_journal.takeChanges();
+    EXPECT_EQ(QSet<QString>{m_rootDir.location()}, changes.changedDirectories);
+    EXPECT_TRUE(changes.isRemoved(m_albumLocation));
+
+    // The renamed directory is not watched at its new location
+    createFile(m_rootDir.location() + QStringLiteral("/renamed/track.mp3"));
+    EXPECT_TRUE(m_journal.takeChanges().isEmpty());
+}
+
+TEST_F(LibraryChangeJournalTest, fullScanDiscardsChanges) {
+    fullScan();
+    createFile(m_albumLocation + QStringLiteral("/track.mp3"));
+    fullScan();
+    EXPECT_TRUE(m_journal.takeChanges().isEmpty());
+}
+
+} // namespace
+
+#endif // __LINUX__
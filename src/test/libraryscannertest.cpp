@@ -4,6 +4,8 @@
 #include "test/librarytest.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
 
 class LibraryScannerTest : public LibraryTest {
   protected:
@@ -52,3 +54,71 @@ TEST_F(LibraryScannerTest, ScannerRoundtrip) {
     m_libraryScanner.changeScannerState(LibraryScanner::IDLE);
     EXPECT_EQ(m_libraryScanner.m_state, LibraryScanner::IDLE);
 }
+
+TEST_F(LibraryScannerTest, UpdateTrackFromPreImportedMetadata) {
+    const QString trackLocation =
+            getTestDir().filePath(QStringLiteral("id3-test-data/artist.mp3"));
+    auto importedMetadata =
+            SoundSourceProxy::importNewTrackMetadataAndCoverImageFromFile(
+                    mixxx::FileAccess(mixxx::FileInfo(trackLocation)),
+                    false);
+    ASSERT_TRUE(importedMetadata);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            importedMetadata->importResult);
+    EXPECT_TRUE(importedMetadata->sourceSynchronizedAt.isValid());
+    EXPECT_EQ(QStringLiteral("Test Artist"),
+            importedMetadata->trackMetadata.getTrackInfo().getArtist());
+
+    // The pre-imported metadata is used instead of reading the file
+    importedMetadata->trackMetadata.refTrackInfo().setArtist(
+            QStringLiteral("Pre-imported Artist"));
+    auto pTrack = Track::newTemporary(trackLocation);
+    EXPECT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{},
+                    &*importedMetadata));
+    EXPECT_EQ(QStringLiteral("Pre-imported Artist"), pTrack->getArtist());
+
+    // Only new tracks are updated from pre-imported metadata
+    EXPECT_EQ(
+            SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Always,
+                    SyncTrackMetadataParams{},
+                    &*importedMetadata));
+    EXPECT_EQ(QStringLiteral("Test Artist"), pTrack->getArtist());
+}
+
+TEST_F(LibraryScannerTest, HandOverImportedTracks) {
+    ScannerGlobal scannerGlobal(QSet<QString>(),
+            QHash<QString, mixxx::cache_key_t>(),
+            QRegularExpression(),
+            QRegularExpression(),
+            QStringList(),
+            SyncTrackMetadataParams{});
+    const QString trackLocation = QStringLiteral("/music/track.mp3");
+    EXPECT_FALSE(scannerGlobal.takeImportedTrack(trackLocation));
+
+    ASSERT_TRUE(scannerGlobal.acquireImportedTrackSlot());
+    SoundSourceProxy::ImportedTrackMetadata importedMetadata;
+    importedMetadata.importResult = mixxx::MetadataSource::ImportResult::Succeeded;
+    scannerGlobal.addImportedTrack(trackLocation, std::move(importedMetadata));
+    EXPECT_EQ(1, scannerGlobal.numImportedTracks());
+
+    const auto takenMetadata = scannerGlobal.takeImportedTrack(trackLocation);
+    ASSERT_TRUE(takenMetadata);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            takenMetadata->importResult);
+    EXPECT_FALSE(scannerGlobal.takeImportedTrack(trackLocation));
+
+    // Waiting for a free slot is aborted when canceling
+    scannerGlobal.cancel();
+    int acquiredSlots = 0;
+    while (scannerGlobal.acquireImportedTrackSlot()) {
+        ++acquiredSlots;
+        ASSERT_GT(10000, acquiredSlots);
+    }
+    EXPECT_LT(0, acquiredSlots);
+}
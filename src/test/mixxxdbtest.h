@@ -7,7 +7,9 @@ class MixxxDbTest : public MixxxTest {
   protected:
     MixxxDbTest(bool inMemoryDbConnection = false)
             : m_mixxxDb(config(), inMemoryDbConnection),
-              m_dbConnectionPooler(m_mixxxDb.connectionPool()) {
+              m_dbConnectionPooler(m_mixxxDb.connectionPool()),
+              m_readOnlyDbConnectionPooler(m_mixxxDb.connectionPool(),
+                      mixxx::DbConnection::AccessMode::ReadOnly) {
     }
 
     const mixxx::DbConnectionPoolPtr& dbConnectionPooler() const {
@@ -21,4 +23,6 @@ class MixxxDbTest : public MixxxTest {
   private:
     const MixxxDb m_mixxxDb;
     const mixxx::DbConnectionPooler m_dbConnectionPooler;
+    // For the library models
+    const mixxx::DbConnectionPooler m_readOnlyDbConnectionPooler;
 };
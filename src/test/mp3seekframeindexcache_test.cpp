@@ -0,0 +1,238 @@
+#include "sources/mp3seekframeindexcache.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDataStream>
+#include <QFile>
+#include <QTemporaryDir>
+#include <limits>
+
+#include "test/mixxxtest.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#include "util/samplebuffer.h"
+#endif
+
+namespace {
+
+class Mp3SeekFrameIndexCacheTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("test.mp3"));
+        writeFile(QByteArray(4096, 'x'));
+    }
+
+    void writeFile(const QByteArray& content) {
+        QFile file(m_filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+    }
+
+    QDir cacheDir() const {
+        return QDir(m_tempDir.filePath(QStringLiteral("cache")));
+    }
+
+    static mixxx::Mp3SeekFrameIndex createSeekFrameIndex() {
+        mixxx::Mp3SeekFrameIndex seekFrameIndex;
+        seekFrameIndex.channelCount = mixxx::audio::ChannelCount::stereo();
+        seekFrameIndex.sampleRate = mixxx::audio::SampleRate(44100);
+        seekFrameIndex.bitrate = mixxx::audio::Bitrate(128);
+        for (SINT i = 0; i < 10; ++i) {
+            // Vary the frame size like a VBR file
+            seekFrameIndex.seekFrames.push_back(
+                    mixxx::Mp3SeekFrameIndex::SeekFrame{i * 1152, 100 + i * 300 + (i % 3)});
+        }
+        seekFrameIndex.frameLength = 10 * 1152;
+        return seekFrameIndex;
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(Mp3SeekFrameIndexCacheTest, saveAndLoad) {
+    const mixxx::Mp3SeekFrameIndexCache cache(cacheDir());
+    ASSERT_TRUE(QDir().mkpath(cacheDir().absolutePath()));
+    const auto seekFrameIndex = createSeekFrameIndex();
+    ASSERT_TRUE(seekFrameIndex.isValid());
+
+    mixxx::Mp3SeekFrameIndex loaded;
+    EXPECT_FALSE(cache.load(m_filePath, &loaded));
+    ASSERT_TRUE(cache.save(m_filePath, seekFrameIndex));
+    ASSERT_TRUE(cache.load(m_filePath, &loaded));
+
+    EXPECT_EQ(seekFrameIndex.channelCount, loaded.channelCount);
+    EXPECT_EQ(seekFrameIndex.sampleRate, loaded.sampleRate);
+    EXPECT_EQ(seekFrameIndex.bitrate, loaded.bitrate);
+    EXPECT_EQ(seekFrameIndex.frameLength, loaded.frameLength);
+    ASSERT_EQ(seekFrameIndex.seekFrames.size(), loaded.seekFrames.size());
+    for (std::size_t i = 0; i < seekFrameIndex.seekFrames.size(); ++i) {
+        EXPECT_EQ(seekFrameIndex.seekFrames[i].frameIndex, loaded.seekFrames[i].frameIndex);
+        EXPECT_EQ(seekFrameIndex.seekFrames[i].fileOffset, loaded.seekFrames[i].fileOffset);
+    }
+}
+
+TEST_F(Mp3SeekFrameIndexCacheTest, modifiedFile) {
+    const mixxx::Mp3SeekFrameIndexCache cache(cacheDir());
+    ASSERT_TRUE(QDir().mkpath(cacheDir().absolutePath()));
+    ASSERT_TRUE(cache.save(m_filePath, createSeekFrameIndex()));
+
+    writeFile(QByteArray(8192, 'y'));
+
+    mixxx::Mp3SeekFrameIndex loaded;
+    EXPECT_FALSE(cache.load(m_filePath, &loaded));
+}
+
+TEST_F(Mp3SeekFrameIndexCacheTest, corruptEntry) {
+    const mixxx::Mp3SeekFrameIndexCache cache(cacheDir());
+    ASSERT_TRUE(QDir().mkpath(cacheDir().absolutePath()));
+    ASSERT_TRUE(cache.save(m_filePath, createSeekFrameIndex()));
+
+    const auto entries = cacheDir().entryInfoList(QDir::Files);
+    ASSERT_EQ(1, entries.size());
+    QFile entry(entries.first().filePath());
+    ASSERT_TRUE(entry.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(entry.resize(entry.size() - 8));
+    entry.close();
+
+    mixxx::Mp3SeekFrameIndex loaded;
+    EXPECT_FALSE(cache.load(m_filePath, &loaded));
+}
+
+TEST_F(Mp3SeekFrameIndexCacheTest, implausibleSeekFrameCount) {
+    const mixxx::Mp3SeekFrameIndexCache cache(cacheDir());
+    ASSERT_TRUE(QDir().mkpath(cacheDir().absolutePath()));
+    ASSERT_TRUE(cache.save(m_filePath, createSeekFrameIndex()));
+
+    const auto entries = cacheDir().entryInfoList(QDir::Files);
+    ASSERT_EQ(1, entries.size());
+    QFile entry(entries.first().filePath());
+    ASSERT_TRUE(entry.open(QIODevice::ReadWrite | QIODevice::Unbuffered));
+    QDataStream stream(&entry);
+    quint32 magic;
+    quint32 version;
+    QString location;
+    qint64 fileSize;
+    qint64 lastModifiedMillis;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameLength;
+    stream >> magic >> version >> location >> fileSize >> lastModifiedMillis >>
+            channelCount >> sampleRate >> bitrate >> frameLength;
+    ASSERT_EQ(QDataStream::Ok, stream.status());
+    // Overwrite the number of seek frames, but keep the payload
+    stream << std::numeric_limits<quint32>::max();
+    ASSERT_EQ(QDataStream::Ok, stream.status());
+    entry.close();
+
+    mixxx::Mp3SeekFrameIndex loaded;
+    EXPECT_FALSE(cache.load(m_filePath, &loaded));
+}
+
+TEST_F(Mp3SeekFrameIndexCacheTest, invalidIndex) {
+    auto seekFrameIndex = createSeekFrameIndex();
+    std::swap(seekFrameIndex.seekFrames[2], seekFrameIndex.seekFrames[3]);
+    EXPECT_FALSE(seekFrameIndex.isValid());
+
+    seekFrameIndex = createSeekFrameIndex();
+    seekFrameIndex.frameLength = seekFrameIndex.seekFrames.back().frameIndex;
+    EXPECT_FALSE(seekFrameIndex.isValid());
+}
+
+#ifdef __MAD__
+
+constexpr SINT kReadFrameCount = 1024;
+
+QString testFilePath() {
+    return MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-vbr.mp3"));
+}
+
+// Opens the file and decodes the first samples, like a deck does
+// when loading a track
+std::vector<CSAMPLE> openAndReadFirstSamples(
+        mixxx::SoundSourceMp3* pSource) {
+    EXPECT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            pSource->open(mixxx::AudioSource::OpenMode::Strict));
+    mixxx::SampleBuffer buffer(
+            pSource->getSignalInfo().frames2samples(kReadFrameCount));
+    const auto readFrames = pSource->readSampleFrames(mixxx::WritableSampleFrames(
+            mixxx::IndexRange::forward(pSource->frameIndexMin(), kReadFrameCount),
+            mixxx::SampleBuffer::WritableSlice(buffer)));
+    return std::vector<CSAMPLE>(readFrames.readableData(),
+            readFrames.readableData() + readFrames.readableLength());
+}
+
+TEST_F(Mp3SeekFrameIndexCacheTest, openWithSeekFrameIndex) {
+    const QUrl url = QUrl::fromLocalFile(testFilePath());
+
+    mixxx::SoundSourceMp3 scanned(url);
+    const auto scannedSamples = openAndReadFirstSamples(&scanned);
+    ASSERT_FALSE(scannedSamples.empty());
+
+    mixxx::Mp3SeekFrameIndexCache::createInstance(cacheDir());
+    {
+        // Saves the index after scanning
+        mixxx::SoundSourceMp3 source(url);
+        openAndReadFirstSamples(&source);
+    }
+    EXPECT_EQ(1, cacheDir().entryList(QDir::Files).size());
+
+    mixxx::SoundSourceMp3 loaded(url);
+    const auto loadedSamples = openAndReadFirstSamples(&loaded);
+    mixxx::Mp3SeekFrameIndexCache::destroyInstance();
+
+    EXPECT_EQ(scanned.getSignalInfo(), loaded.getSignalInfo());
+    EXPECT_EQ(scanned.getBitrate(), loaded.getBitrate());
+    EXPECT_EQ(scanned.frameIndexRange(), loaded.frameIndexRange());
+    EXPECT_EQ(scannedSamples, loadedSamples);
+
+    // Seeking uses the restored seek frames
+    mixxx::SampleBuffer scannedBuffer(
+            scanned.getSignalInfo().frames2samples(kReadFrameCount));
+    mixxx::SampleBuffer loadedBuffer(
+            loaded.getSignalInfo().frames2samples(kReadFrameCount));
+    const auto range = mixxx::IndexRange::forward(
+            scanned.frameIndexMin() + scanned.frameLength() / 2, kReadFrameCount);
+    const auto scannedFrames = scanned.readSampleFrames(mixxx::WritableSampleFrames(
+            range, mixxx::SampleBuffer::WritableSlice(scannedBuffer)));
+    const auto loadedFrames = loaded.readSampleFrames(mixxx::WritableSampleFrames(
+            range, mixxx::SampleBuffer::WritableSlice(loadedBuffer)));
+    EXPECT_EQ(scannedFrames.frameIndexRange(), loadedFrames.frameIndexRange());
+    EXPECT_EQ(std::vector<CSAMPLE>(scannedFrames.readableData(),
+                      scannedFrames.readableData() + scannedFrames.readableLength()),
+            std::vector<CSAMPLE>(loadedFrames.readableData(),
+                    loadedFrames.readableData() + loadedFrames.readableLength()));
+}
+
+static void BM_OpenMp3ScanningFrameHeaders(benchmark::State& state) {
+    const QUrl url = QUrl::fromLocalFile(testFilePath());
+    for (auto _ : state) {
+        mixxx::SoundSourceMp3 source(url);
+        benchmark::DoNotOptimize(openAndReadFirstSamples(&source));
+    }
+}
+BENCHMARK(BM_OpenMp3ScanningFrameHeaders);
+
+static void BM_OpenMp3WithSeekFrameIndex(benchmark::State& state) {
+    const QUrl url = QUrl::fromLocalFile(testFilePath());
+    QTemporaryDir tempDir;
+    mixxx::Mp3SeekFrameIndexCache::createInstance(QDir(tempDir.path()));
+    {
+        mixxx::SoundSourceMp3 source(url);
+        openAndReadFirstSamples(&source);
+    }
+    for (auto _ : state) {
+        mixxx::SoundSourceMp3 source(url);
+        benchmark::DoNotOptimize(openAndReadFirstSamples(&source));
+    }
+    mixxx::Mp3SeekFrameIndexCache::destroyInstance();
+}
+BENCHMARK(BM_OpenMp3WithSeekFrameIndex);
+
+#endif // __MAD__
+
+} // namespace
@@ -1,7 +1,9 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QtDebug>
 #include <QScopedPointer>
+#include <cmath>
 
 #include "engine/cachingreader/cachingreader.h"
 #include "control/controlobject.h"
@@ -140,3 +142,125 @@ TEST_F(ReadAheadManagerTest, FractionalFrameLoop) {
     // The rounding error must not exceed a half frame (one samples in stereo)
     EXPECT_NEAR(16, m_pReadAheadManager->getPlaypos(), 1);
 }
+
+namespace {
+
+// A 1/32 beat loop at 128 BPM and 44.1 kHz
+constexpr double kTightLoopStartFrame = 10000;
+constexpr double kTightLoopLengthFrames = 60.0 / 128 * 44100 / 32;
+
+constexpr SINT kCallbackFrames = 1024;
+// The scalers request the samples in smaller chunks
+constexpr SINT kChunkFrames = 64;
+
+class FixedLoopControl : public LoopingControl {
+  public:
+    FixedLoopControl(mixxx::audio::FramePos loopStart, mixxx::audio::FramePos loopEnd)
+            : LoopingControl(kGroup, UserSettingsPointer()),
+              m_loopStart(loopStart),
+              m_loopEnd(loopEnd) {
+    }
+
+    mixxx::audio::FramePos nextTrigger(bool reverse,
+            mixxx::audio::FramePos currentPosition,
+            mixxx::audio::FramePos* pTargetPosition) override {
+        Q_UNUSED(currentPosition);
+        *pTargetPosition = reverse ? m_loopEnd : m_loopStart;
+        return reverse ? m_loopStart : m_loopEnd;
+    }
+
+  private:
+    const mixxx::audio::FramePos m_loopStart;
+    const mixxx::audio::FramePos m_loopEnd;
+};
+
+// The controls that are required by LoopingControl
+struct LoopingControlControls {
+    LoopingControlControls()
+            : beatClosestCO(ConfigKey(kGroup, "beat_closest")),
+              beatNextCO(ConfigKey(kGroup, "beat_next")),
+              beatPrevCO(ConfigKey(kGroup, "beat_prev")),
+              playCO(ConfigKey(kGroup, "play")),
+              quantizeCO(ConfigKey(kGroup, "quantize")),
+              repeatCO(ConfigKey(kGroup, "repeat")),
+              slipEnabledCO(ConfigKey(kGroup, "slip_enabled")),
+              trackSamplesCO(ConfigKey(kGroup, "track_samples")) {
+    }
+
+    ControlObject beatClosestCO;
+    ControlObject beatNextCO;
+    ControlObject beatPrevCO;
+    ControlObject playCO;
+    ControlObject quantizeCO;
+    ControlObject repeatCO;
+    ControlObject slipEnabledCO;
+    ControlObject trackSamplesCO;
+};
+
+// Reads the samples of a single callback like EngineBuffer does and
+// consumes the read-ahead log afterwards.
+double processCallback(ReadAheadManager* pReadAheadManager,
+        double rate,
+        CSAMPLE* pBuffer,
+        double playPosition) {
+    const SINT callbackSamples = static_cast<SINT>(
+                                         std::abs(rate) * kCallbackFrames) *
+            mixxx::kEngineChannelCount;
+    SINT remainingSamples = callbackSamples;
+    while (remainingSamples > 0) {
+        const SINT chunkSamples = math_min(
+                remainingSamples, kChunkFrames * mixxx::kEngineChannelCount);
+        remainingSamples -= pReadAheadManager->getNextSamples(
+                rate, pBuffer, chunkSamples);
+    }
+    return pReadAheadManager->getFilePlaypositionFromLog(
+            playPosition, callbackSamples);
+}
+
+} // namespace
+
+static void BM_ReadAheadManagerTightLoop(benchmark::State& state) {
+    LoopingControlControls controls;
+    controls.trackSamplesCO.set(44100 * 60 * mixxx::kEngineChannelCount);
+    StubReader reader;
+    FixedLoopControl loopControl(
+            mixxx::audio::FramePos(kTightLoopStartFrame),
+            mixxx::audio::FramePos(kTightLoopStartFrame + kTightLoopLengthFrames));
+    ReadAheadManager readAheadManager(&reader, &loopControl);
+    CSAMPLE* pBuffer = SampleUtil::alloc(MAX_BUFFER_LEN);
+
+    double playPosition = kTightLoopStartFrame * mixxx::kEngineChannelCount;
+    readAheadManager.notifySeek(playPosition);
+    for (auto _ : state) {
+        playPosition = processCallback(&readAheadManager, 1.0, pBuffer, playPosition);
+    }
+    benchmark::DoNotOptimize(playPosition);
+    SampleUtil::free(pBuffer);
+}
+BENCHMARK(BM_ReadAheadManagerTightLoop);
+
+static void BM_ReadAheadManagerRollingScratch(benchmark::State& state) {
+    LoopingControlControls controls;
+    controls.trackSamplesCO.set(44100 * 60 * mixxx::kEngineChannelCount);
+    StubReader reader;
+    // No loop
+    FixedLoopControl loopControl(
+            mixxx::audio::FramePos(), mixxx::audio::FramePos());
+    ReadAheadManager readAheadManager(&reader, &loopControl);
+    CSAMPLE* pBuffer = SampleUtil::alloc(MAX_BUFFER_LEN);
+
+    // The direction changes every 4 callbacks
+    const int callbacksPerScratch = 8;
+    double playPosition = 44100 * 30 * mixxx::kEngineChannelCount;
+    readAheadManager.notifySeek(playPosition);
+    int callback = 0;
+    for (auto _ : state) {
+        const double rate = 3.0 *
+                std::sin(2 * M_PI * (callback++ % callbacksPerScratch) /
+                        callbacksPerScratch);
+        playPosition = processCallback(&readAheadManager, rate, pBuffer, playPosition);
+    }
+    benchmark::DoNotOptimize(playPosition);
+    SampleUtil::free(pBuffer);
+}
+BENCHMARK(BM_ReadAheadManagerRollingScratch);
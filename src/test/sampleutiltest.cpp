@@ -4,9 +4,11 @@
 #include <QList>
 #include <QPair>
 #include <QtDebug>
+#include <cmath>
 #include <vector>
 
 #include "util/sample.h"
+#include "util/samplekernels.h"
 #include "util/timer.h"
 
 namespace {
@@ -397,6 +399,124 @@ TEST_F(SampleUtilTest, copyReverse) {
     }
 }
 
+// The SIMD kernels that can be executed on this CPU
+std::vector<const mixxx::SampleKernels*> supportedSimdKernels() {
+    std::vector<const mixxx::SampleKernels*> kernels;
+    for (const auto* pKernels : {mixxx::SampleKernels::avx2(),
+                 mixxx::SampleKernels::avx512(),
+                 mixxx::SampleKernels::neon()}) {
+        if (mixxx::SampleKernels::cpuSupports(pKernels)) {
+            kernels.push_back(pKernels);
+        }
+    }
+    return kernels;
+}
+
+void expectBuffersNear(const std::vector<CSAMPLE>& expected,
+        const std::vector<CSAMPLE>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f) << "at index " << i;
+    }
+}
+
+TEST_F(SampleUtilTest, simdKernelsMatchScalarKernels) {
+    const auto& scalar = mixxx::SampleKernels::scalar();
+    // Includes sizes that are not a multiple of any vector size
+    for (SINT size : {0, 2, 6, 30, 1024, 1026}) {
+        const SINT frames = size / 2;
+        std::vector<CSAMPLE> src1(size);
+        std::vector<CSAMPLE> src2(size);
+        std::vector<CSAMPLE> src3(size);
+        std::vector<SAMPLE> s16(size);
+        for (SINT i = 0; i < size; ++i) {
+            // Some samples of src1 exceed the peak to detect clipping
+            src1[i] = static_cast<CSAMPLE>(std::sin(i * 0.1) * 1.2);
+            src2[i] = static_cast<CSAMPLE>(std::cos(i * 0.3) * 0.5);
+            src3[i] = static_cast<CSAMPLE>(i % 7) * 0.1f - 0.3f;
+            s16[i] = static_cast<SAMPLE>((i * 4099) % 65536 - 32768);
+        }
+
+        for (const auto* pKernels : supportedSimdKernels()) {
+            SCOPED_TRACE(testing::Message() << pKernels->name << " size " << size);
+            std::vector<CSAMPLE> expected(src3);
+            std::vector<CSAMPLE> actual(src3);
+
+            scalar.copyWithGain(expected.data(), src1.data(), 0.7f, size);
+            pKernels->copyWithGain(actual.data(), src1.data(), 0.7f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.copy2WithGain(expected.data(), src1.data(), 0.7f, src2.data(), 0.3f, size);
+            pKernels->copy2WithGain(actual.data(), src1.data(), 0.7f, src2.data(), 0.3f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.copy3WithGain(expected.data(),
+                    src1.data(), 0.7f, src2.data(), 0.3f, src3.data(), 1.1f, size);
+            pKernels->copy3WithGain(actual.data(),
+                    src1.data(), 0.7f, src2.data(), 0.3f, src3.data(), 1.1f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.copyWithRampingGain(expected.data(), src1.data(), 0.1f, 0.003f, frames);
+            pKernels->copyWithRampingGain(actual.data(), src1.data(), 0.1f, 0.003f, frames);
+            expectBuffersNear(expected, actual);
+
+            scalar.copy2WithRampingGain(expected.data(),
+                    src1.data(), 0.1f, 0.003f, src2.data(), 0.9f, -0.001f, frames);
+            pKernels->copy2WithRampingGain(actual.data(),
+                    src1.data(), 0.1f, 0.003f, src2.data(), 0.9f, -0.001f, frames);
+            expectBuffersNear(expected, actual);
+
+            scalar.addWithRampingGain(expected.data(), src2.data(), 0.1f, 0.003f, frames);
+            pKernels->addWithRampingGain(actual.data(), src2.data(), 0.1f, 0.003f, frames);
+            expectBuffersNear(expected, actual);
+
+            scalar.addWithGain(expected.data(), src1.data(), 0.7f, size);
+            pKernels->addWithGain(actual.data(), src1.data(), 0.7f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.add2WithGain(expected.data(), src1.data(), 0.7f, src2.data(), 0.2f, size);
+            pKernels->add2WithGain(actual.data(), src1.data(), 0.7f, src2.data(), 0.2f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.add3WithGain(expected.data(),
+                    src1.data(), 0.7f, src2.data(), 0.2f, src3.data(), 0.1f, size);
+            pKernels->add3WithGain(actual.data(),
+                    src1.data(), 0.7f, src2.data(), 0.2f, src3.data(), 0.1f, size);
+            expectBuffersNear(expected, actual);
+
+            scalar.convertS16ToFloat32(expected.data(), s16.data(), size);
+            pKernels->convertS16ToFloat32(actual.data(), s16.data(), size);
+            expectBuffersNear(expected, actual);
+
+            CSAMPLE expectedAbsL, expectedAbsR, actualAbsL, actualAbsR;
+            for (const auto& buffer : {src1, src2}) {
+                EXPECT_EQ(scalar.sumAbsPerChannel(
+                                  &expectedAbsL, &expectedAbsR, buffer.data(), frames),
+                        pKernels->sumAbsPerChannel(
+                                &actualAbsL, &actualAbsR, buffer.data(), frames));
+                // The summation order differs
+                EXPECT_NEAR(expectedAbsL, actualAbsL, 1e-3f);
+                EXPECT_NEAR(expectedAbsR, actualAbsR, 1e-3f);
+            }
+
+            std::vector<CSAMPLE> expectedInterleaved(size * 2);
+            std::vector<CSAMPLE> actualInterleaved(size * 2);
+            scalar.interleaveBuffer(expectedInterleaved.data(), src1.data(), src2.data(), size);
+            pKernels->interleaveBuffer(actualInterleaved.data(), src1.data(), src2.data(), size);
+            expectBuffersNear(expectedInterleaved, actualInterleaved);
+
+            std::vector<CSAMPLE> deinterleaved1(size);
+            std::vector<CSAMPLE> deinterleaved2(size);
+            pKernels->deinterleaveBuffer(deinterleaved1.data(),
+                    deinterleaved2.data(),
+                    expectedInterleaved.data(),
+                    size);
+            expectBuffersNear(src1, deinterleaved1);
+            expectBuffersNear(src2, deinterleaved2);
+        }
+    }
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -583,4 +703,165 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+
+// Benchmarks comparing the scalar kernels with the SIMD kernels. The first
+// argument selects the kernels, the second one is the number of samples.
+const mixxx::SampleKernels* benchmarkKernels(benchmark::State& state) {
+    const mixxx::SampleKernels* pKernels = nullptr;
+    switch (state.range(0)) {
+    case 0:
+        pKernels = &mixxx::SampleKernels::scalar();
+        break;
+    case 1:
+        pKernels = mixxx::SampleKernels::avx2();
+        break;
+    case 2:
+        pKernels = mixxx::SampleKernels::avx512();
+        break;
+    case 3:
+        pKernels = mixxx::SampleKernels::neon();
+        break;
+    }
+    if (!mixxx::SampleKernels::cpuSupports(pKernels)) {
+        state.SkipWithError("Not supported");
+        return nullptr;
+    }
+    state.SetLabel(pKernels->name);
+    return pKernels;
+}
+
+void benchmarkKernelArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (int kernels = 0; kernels < 4; ++kernels) {
+        for (int size : {64, 512, 4096}) {
+            pBenchmark->Args({kernels, size});
+        }
+    }
+}
+
+static void BM_KernelCopyWithRampingGain(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src(size, 0.5f);
+    std::vector<CSAMPLE> dest(size);
+    for (auto _ : state) {
+        pKernels->copyWithRampingGain(dest.data(), src.data(), 0.5f, 0.001f, size / 2);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelCopyWithRampingGain)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelAddWithGain(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src(size, 0.5f);
+    std::vector<CSAMPLE> dest(size);
+    for (auto _ : state) {
+        pKernels->addWithGain(dest.data(), src.data(), 0.5f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelAddWithGain)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelAdd2WithGain(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src1(size, 0.5f);
+    std::vector<CSAMPLE> src2(size, 0.25f);
+    std::vector<CSAMPLE> dest(size);
+    for (auto _ : state) {
+        pKernels->add2WithGain(dest.data(), src1.data(), 0.5f, src2.data(), 0.7f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelAdd2WithGain)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelCopy3WithGain(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src1(size, 0.5f);
+    std::vector<CSAMPLE> src2(size, 0.25f);
+    std::vector<CSAMPLE> src3(size, 0.125f);
+    std::vector<CSAMPLE> dest(size);
+    for (auto _ : state) {
+        pKernels->copy3WithGain(dest.data(),
+                src1.data(), 0.5f, src2.data(), 0.7f, src3.data(), 0.9f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelCopy3WithGain)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelSumAbsPerChannel(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> buffer(size, -0.5f);
+    CSAMPLE absL, absR;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+                pKernels->sumAbsPerChannel(&absL, &absR, buffer.data(), size / 2));
+    }
+}
+BENCHMARK(BM_KernelSumAbsPerChannel)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelConvertS16ToFloat32(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<SAMPLE> src(size, SAMPLE_MAXIMUM / 2);
+    std::vector<CSAMPLE> dest(size);
+    for (auto _ : state) {
+        pKernels->convertS16ToFloat32(dest.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelConvertS16ToFloat32)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelInterleaveBuffer(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src1(size, 0.5f);
+    std::vector<CSAMPLE> src2(size, 0.25f);
+    std::vector<CSAMPLE> dest(size * 2);
+    for (auto _ : state) {
+        pKernels->interleaveBuffer(dest.data(), src1.data(), src2.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelInterleaveBuffer)->Apply(benchmarkKernelArgs);
+
+static void BM_KernelDeinterleaveBuffer(benchmark::State& state) {
+    const auto* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    SINT size = static_cast<SINT>(state.range(1));
+    std::vector<CSAMPLE> src(size * 2, 0.5f);
+    std::vector<CSAMPLE> dest1(size);
+    std::vector<CSAMPLE> dest2(size);
+    for (auto _ : state) {
+        pKernels->deinterleaveBuffer(dest1.data(), dest2.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_KernelDeinterleaveBuffer)->Apply(benchmarkKernelArgs);
+
 }  // namespace
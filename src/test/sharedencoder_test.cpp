@@ -0,0 +1,181 @@
+#include "engine/sidechain/sharedencoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <vector>
+
+#include "engine/sidechain/enginenetworkstream.h"
+#include "recording/defs_recording.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kMaxQueuedBytes = 1024 * 1024;
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+
+class Mp3Settings : public EncoderSettings {
+  public:
+    explicit Mp3Settings(int bitrate)
+            : m_bitrate(bitrate) {
+    }
+
+    int getQuality() const override {
+        return m_bitrate;
+    }
+    ChannelMode getChannelMode() const override {
+        return ChannelMode::STEREO;
+    }
+    QString getFormat() const override {
+        return QStringLiteral(ENCODING_MP3);
+    }
+
+  private:
+    const int m_bitrate;
+};
+
+class EncodedPacketQueueTest : public testing::Test {
+};
+
+TEST_F(EncodedPacketQueueTest, pushAndPop) {
+    QSemaphore packetsAvailable;
+    EncodedPacketQueue queue(QStringLiteral("MP3"), 100, &packetsAvailable);
+
+    EXPECT_TRUE(queue.push(QByteArray(10, 'a')));
+    EXPECT_TRUE(queue.push(QByteArray(20, 'b')));
+    queue.notify();
+    EXPECT_EQ(1, packetsAvailable.available());
+
+    QByteArray packet;
+    ASSERT_TRUE(queue.pop(&packet));
+    EXPECT_EQ(QByteArray(10, 'a'), packet);
+    ASSERT_TRUE(queue.pop(&packet));
+    EXPECT_EQ(QByteArray(20, 'b'), packet);
+    EXPECT_FALSE(queue.pop(&packet));
+    EXPECT_EQ(0, queue.takeDroppedPacketCount());
+}
+
+TEST_F(EncodedPacketQueueTest, dropPacketsOfSlowSubscriber) {
+    EncodedPacketQueue slowQueue(QStringLiteral("MP3"), 100);
+    EncodedPacketQueue fastQueue(QStringLiteral("MP3"), 100);
+    const QByteArray sharedPacket(40, 'x');
+
+    QByteArray packet;
+    for (int i = 0; i < 5; ++i) {
+        slowQueue.push(sharedPacket);
+        EXPECT_TRUE(fastQueue.push(sharedPacket));
+        ASSERT_TRUE(fastQueue.pop(&packet));
+    }
+    EXPECT_EQ(0, fastQueue.takeDroppedPacketCount());
+    // Only 2 packets fit into 100 bytes
+    EXPECT_EQ(3, slowQueue.takeDroppedPacketCount());
+    EXPECT_EQ(0, slowQueue.takeDroppedPacketCount());
+
+    // Popping makes room for new packets again
+    ASSERT_TRUE(slowQueue.pop(&packet));
+    EXPECT_TRUE(slowQueue.push(sharedPacket));
+    slowQueue.clear();
+    EXPECT_FALSE(slowQueue.pop(&packet));
+    EXPECT_TRUE(slowQueue.push(sharedPacket));
+    EXPECT_TRUE(slowQueue.push(sharedPacket));
+}
+
+class SharedEncoderPoolTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pNetworkStream = QSharedPointer<EngineNetworkStream>::create(2, 0);
+        m_pPool = SharedEncoderPoolPointer::create(m_pNetworkStream);
+    }
+
+    void TearDown() override {
+        m_pPool.reset();
+        m_pNetworkStream.reset();
+    }
+
+    EncodedPacketQueuePointer subscribe(int bitrate, QSemaphore* pPacketsAvailable) {
+        QString errorMessage;
+        return m_pPool->subscribe(std::make_shared<Mp3Settings>(bitrate),
+                kSampleRate,
+                kMaxQueuedBytes,
+                pPacketsAvailable,
+                &errorMessage);
+    }
+
+    std::vector<NetworkOutputStreamWorkerPtr> encoderWorkers() const {
+        std::vector<NetworkOutputStreamWorkerPtr> workers;
+        for (const auto& pWorker : m_pNetworkStream->outputWorkers()) {
+            if (pWorker) {
+                workers.push_back(pWorker);
+            }
+        }
+        return workers;
+    }
+
+    QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+    SharedEncoderPoolPointer m_pPool;
+};
+
+TEST_F(SharedEncoderPoolTest, shareEncoderWithSameSettings) {
+    QSemaphore packetsAvailable1;
+    QSemaphore packetsAvailable2;
+    QSemaphore packetsAvailable3;
+    const auto pQueue1 = subscribe(128, &packetsAvailable1);
+    const auto pQueue2 = subscribe(128, &packetsAvailable2);
+    const auto pQueue3 = subscribe(192, &packetsAvailable3);
+    ASSERT_TRUE(pQueue1);
+    ASSERT_TRUE(pQueue2);
+    ASSERT_TRUE(pQueue3);
+    EXPECT_EQ(pQueue1->encoderKey(), pQueue2->encoderKey());
+    EXPECT_NE(pQueue1->encoderKey(), pQueue3->encoderKey());
+    // Subscribed on the thread of the pool, so the encoders are added
+    // immediately
+    EXPECT_EQ(2u, encoderWorkers().size());
+
+    // The last subscriber stops the encoder
+    m_pPool->unsubscribe(pQueue1);
+    EXPECT_EQ(2u, encoderWorkers().size());
+    m_pPool->unsubscribe(pQueue2);
+    EXPECT_EQ(1u, encoderWorkers().size());
+    m_pPool->unsubscribe(pQueue3);
+    EXPECT_TRUE(encoderWorkers().empty());
+
+    // Subscribing again starts a new encoder
+    const auto pQueue4 = subscribe(128, &packetsAvailable1);
+    ASSERT_TRUE(pQueue4);
+    EXPECT_EQ(1u, encoderWorkers().size());
+    m_pPool->unsubscribe(pQueue4);
+}
+
+TEST_F(SharedEncoderPoolTest, fanOutEncodedPackets) {
+    QSemaphore packetsAvailable1;
+    QSemaphore packetsAvailable2;
+    const auto pQueue1 = subscribe(128, &packetsAvailable1);
+    const auto pQueue2 = subscribe(128, &packetsAvailable2);
+    ASSERT_TRUE(pQueue1);
+    ASSERT_TRUE(pQueue2);
+    const auto workers = encoderWorkers();
+    ASSERT_EQ(1u, workers.size());
+
+    // Feed the encoder like SoundDeviceNetwork does
+    const auto pFifo = workers.front()->getOutputFifo();
+    ASSERT_TRUE(pFifo);
+    const std::vector<CSAMPLE> silence(2 * 8192, 0);
+    ASSERT_EQ(static_cast<int>(silence.size()),
+            pFifo->write(silence.data(), static_cast<int>(silence.size())));
+    workers.front()->outputAvailable();
+
+    ASSERT_TRUE(packetsAvailable1.tryAcquire(1, 5000));
+    ASSERT_TRUE(packetsAvailable2.tryAcquire(1, 5000));
+    QByteArray packet1;
+    QByteArray packet2;
+    ASSERT_TRUE(pQueue1->pop(&packet1));
+    ASSERT_TRUE(pQueue2->pop(&packet2));
+    EXPECT_FALSE(packet1.isEmpty());
+    // Encoded once and shared
+    EXPECT_EQ(packet1.constData(), packet2.constData());
+
+    m_pPool->unsubscribe(pQueue1);
+    m_pPool->unsubscribe(pQueue2);
+}
+
+} // namespace
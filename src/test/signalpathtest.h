@@ -24,6 +24,7 @@
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
+#include "util/audiothreadguard.h"
 #include "util/defs.h"
 #include "util/memory.h"
 #include "util/sample.h"
@@ -128,6 +129,21 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         ControlObject::set(ConfigKey(m_sMasterGroup, "enabled"), 1.0);
 
         PlayerInfo::create();
+
+#ifdef __AUDIO_THREAD_GUARD__
+        // Any allocation or lock wait within EngineMaster::process()
+        // fails the test
+        mixxx::AudioThreadGuard::setEnabled(true);
+        m_audioThreadViolationCount = mixxx::AudioThreadGuard::violationCount();
+#endif
+    }
+
+    void TearDown() override {
+#ifdef __AUDIO_THREAD_GUARD__
+        EXPECT_EQ(m_audioThreadViolationCount, mixxx::AudioThreadGuard::violationCount())
+                << "EngineMaster::process() allocated memory or waited for a lock";
+        mixxx::AudioThreadGuard::setEnabled(false);
+#endif
     }
 
     ~BaseSignalPathTest() override {
@@ -266,6 +282,11 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
     static const double kDefaultRateDir;
     static const double kRateRangeDivisor;
     static const int kProcessBufferSize;
+
+#ifdef __AUDIO_THREAD_GUARD__
+  private:
+    quint64 m_audioThreadViolationCount;
+#endif
 };
 
 class SignalPathTest : public BaseSignalPathTest {
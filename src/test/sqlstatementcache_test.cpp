@@ -0,0 +1,99 @@
+#include "util/db/sqlstatementcache.h"
+
+#include <gtest/gtest.h>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+const QString kSelectStatement = QStringLiteral(
+        "SELECT name FROM sqlite_master WHERE type=:type");
+
+class SqlStatementCacheTest : public MixxxDbTest {
+  protected:
+    mixxx::SqlStatementCache* cache() const {
+        return mixxx::SqlStatementCache::forDatabase(dbConnection());
+    }
+};
+
+TEST_F(SqlStatementCacheTest, reuseStatement) {
+    ASSERT_NE(nullptr, cache());
+    const quint64 hitCount = cache()->hitCount();
+    const quint64 missCount = cache()->missCount();
+
+    for (int i = 0; i < 3; ++i) {
+        mixxx::CachedSqlQuery query(dbConnection(), kSelectStatement);
+        ASSERT_TRUE(query.isPrepared());
+        query->bindValue(":type", QStringLiteral("table"));
+        ASSERT_TRUE(query->exec());
+        // Only consume the first row, the statement is
+        // finished when returned to the cache
+        EXPECT_TRUE(query->next());
+    }
+
+    EXPECT_EQ(missCount + 1, cache()->missCount());
+    EXPECT_EQ(hitCount + 2, cache()->hitCount());
+}
+
+TEST_F(SqlStatementCacheTest, resetBoundValues) {
+    {
+        mixxx::CachedSqlQuery query(dbConnection(), kSelectStatement);
+        ASSERT_TRUE(query.isPrepared());
+        query->bindValue(":type", QStringLiteral("table"));
+        ASSERT_TRUE(query->exec());
+    }
+    mixxx::CachedSqlQuery query(dbConnection(), kSelectStatement);
+    ASSERT_TRUE(query.isPrepared());
+    EXPECT_TRUE(query->boundValue(":type").isNull());
+}
+
+TEST_F(SqlStatementCacheTest, nestedBorrowing) {
+    ASSERT_NE(nullptr, cache());
+    const int size = cache()->size();
+    {
+        mixxx::CachedSqlQuery outerQuery(dbConnection(), kSelectStatement);
+        mixxx::CachedSqlQuery innerQuery(dbConnection(), kSelectStatement);
+        ASSERT_TRUE(outerQuery.isPrepared());
+        ASSERT_TRUE(innerQuery.isPrepared());
+        EXPECT_NE(outerQuery.get(), innerQuery.get());
+    }
+    // Only one of both statements is kept
+    EXPECT_EQ(size + 1, cache()->size());
+}
+
+TEST_F(SqlStatementCacheTest, invalidStatement) {
+    ASSERT_NE(nullptr, cache());
+    const int size = cache()->size();
+    {
+        mixxx::CachedSqlQuery query(
+                dbConnection(), QStringLiteral("SELECT * FROM no_such_table"));
+        EXPECT_FALSE(query.isPrepared());
+    }
+    EXPECT_EQ(size, cache()->size());
+}
+
+TEST_F(SqlStatementCacheTest, evictLeastRecentlyUsed) {
+    ASSERT_NE(nullptr, cache());
+    const auto borrowStatement = [this](int index) {
+        mixxx::CachedSqlQuery query(dbConnection(),
+                QStringLiteral("SELECT %1").arg(index));
+        ASSERT_TRUE(query.isPrepared());
+    };
+    for (int i = 0; i <= mixxx::SqlStatementCache::kDefaultCapacity; ++i) {
+        borrowStatement(i);
+        if (i == 1) {
+            // Statement 0 becomes the most recently used statement
+            borrowStatement(0);
+        }
+    }
+    EXPECT_EQ(mixxx::SqlStatementCache::kDefaultCapacity, cache()->size());
+
+    const quint64 missCount = cache()->missCount();
+    borrowStatement(0);
+    EXPECT_EQ(missCount, cache()->missCount());
+    // Statement 1 has been evicted
+    borrowStatement(1);
+    EXPECT_EQ(missCount + 1, cache()->missCount());
+}
+
+} // namespace
@@ -0,0 +1,145 @@
+#include "util/tracering.h"
+
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <thread>
+#include <vector>
+
+#include "util/time.h"
+#include "util/timer.h"
+
+namespace {
+
+constexpr int kNumThreads = 4;
+constexpr int kEventsPerThread = 1000;
+
+class TraceRingTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        mixxx::Time::setTestMode(true);
+        mixxx::Time::setTestElapsedTime(mixxx::Duration::fromNanos(1000));
+        mixxx::Tracing::setEnabled(true);
+        // Discard the events of previous tests
+        drain();
+    }
+
+    void TearDown() override {
+        mixxx::Tracing::setEnabled(false);
+        mixxx::Time::setTestMode(false);
+    }
+
+    QVector<mixxx::TraceRecord> drain() {
+        QVector<mixxx::TraceRecord> records;
+        mixxx::Tracing::drain([&records](const mixxx::TraceRecord& record) {
+            records.append(record);
+        });
+        return records;
+    }
+};
+
+TEST_F(TraceRingTest, internTags) {
+    const auto tag = mixxx::TraceTag::intern(QStringLiteral("TraceRingTest %1").arg(1));
+    EXPECT_STREQ("TraceRingTest 1", tag.name());
+    EXPECT_TRUE(tag == mixxx::TraceTag::intern(QStringLiteral("TraceRingTest 1")));
+    EXPECT_FALSE(tag == mixxx::TraceTag::intern(QStringLiteral("TraceRingTest 2")));
+}
+
+TEST_F(TraceRingTest, disabled) {
+    mixxx::Tracing::setEnabled(false);
+    EXPECT_FALSE(mixxx::Tracing::instant("TraceRingTest::disabled"));
+    {
+        ScopedTimer t("TraceRingTest::disabled");
+    }
+    EXPECT_TRUE(drain().isEmpty());
+}
+
+TEST_F(TraceRingTest, scopedTimer) {
+    {
+        ScopedTimer t("TraceRingTest::scopedTimer");
+        mixxx::Time::setTestElapsedTime(mixxx::Duration::fromNanos(1500));
+    }
+    {
+        ScopedTimer t("TraceRingTest::cancelled");
+        t.cancel();
+    }
+    const auto records = drain();
+    ASSERT_EQ(1, records.size());
+    const auto& event = records[0].event;
+    EXPECT_STREQ("TraceRingTest::scopedTimer", event.name);
+    EXPECT_EQ(mixxx::TraceEvent::Phase::Complete, event.phase);
+    EXPECT_EQ(1000, event.timeNanos);
+    EXPECT_EQ(500, event.durationNanos);
+}
+
+TEST_F(TraceRingTest, drainEventsOfAllThreads) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([] {
+            for (int j = 0; j < kEventsPerThread; ++j) {
+                mixxx::Tracing::complete("TraceRingTest::thread", j, 1, Stat::COUNT);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // The events of each thread are drained in order
+    QMap<int, int> eventCounts;
+    for (const auto& record : drain()) {
+        EXPECT_EQ(eventCounts[record.threadId], record.event.timeNanos);
+        ++eventCounts[record.threadId];
+    }
+    EXPECT_EQ(kNumThreads, eventCounts.size());
+    for (const auto count : qAsConst(eventCounts)) {
+        EXPECT_EQ(kEventsPerThread, count);
+    }
+}
+
+TEST_F(TraceRingTest, writeChromeTrace) {
+    const QVector<mixxx::TraceRecord> records = {
+            {1, {"begin", 1000, 0, Stat::COUNT, mixxx::TraceEvent::Phase::Begin}},
+            {1, {"begin", 3000, 0, Stat::COUNT, mixxx::TraceEvent::Phase::End}},
+            {2, {"instant", 2000, 0, Stat::COUNT, mixxx::TraceEvent::Phase::Instant}},
+            {2, {"complete", 4000, 1500, Stat::COUNT, mixxx::TraceEvent::Phase::Complete}},
+    };
+    const QMap<int, QString> threadNames = {
+            {1, QStringLiteral("Engine")},
+            {2, QStringLiteral("GUI")},
+    };
+
+    QBuffer buffer;
+    ASSERT_TRUE(buffer.open(QIODevice::WriteOnly));
+    ASSERT_TRUE(mixxx::writeChromeTrace(&buffer, records, threadNames));
+
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(buffer.data(), &error);
+    ASSERT_EQ(QJsonParseError::NoError, error.error);
+    const QJsonArray events = document.object().value("traceEvents").toArray();
+    // Metadata of the process and both threads
+    ASSERT_EQ(3 + records.size(), events.size());
+
+    const QJsonObject thread = events[1].toObject();
+    EXPECT_EQ("M", thread.value("ph").toString());
+    EXPECT_EQ(1, thread.value("tid").toInt());
+    EXPECT_EQ("Engine", thread.value("args").toObject().value("name").toString());
+
+    const QJsonObject begin = events[3].toObject();
+    EXPECT_EQ("begin", begin.value("name").toString());
+    EXPECT_EQ("B", begin.value("ph").toString());
+    EXPECT_EQ(1.0, begin.value("ts").toDouble());
+    EXPECT_EQ("E", events[4].toObject().value("ph").toString());
+    EXPECT_EQ("i", events[5].toObject().value("ph").toString());
+
+    const QJsonObject complete = events[6].toObject();
+    EXPECT_EQ("X", complete.value("ph").toString());
+    EXPECT_EQ(2, complete.value("tid").toInt());
+    EXPECT_EQ(4.0, complete.value("ts").toDouble());
+    EXPECT_EQ(1.5, complete.value("dur").toDouble());
+}
+
+} // namespace
@@ -0,0 +1,201 @@
+#include "analyzer/trackanalysisscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QThread>
+#include <algorithm>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+class TestEnvironment : public TrackAnalysisSchedulerEnvironment {
+  public:
+    TrackPointer loadTrackById(TrackId /*trackId*/) const override {
+        return TrackPointer();
+    }
+
+    bool isAnyDeckPlaying() const override {
+        return m_anyDeckPlaying;
+    }
+
+    double engineLoad() const override {
+        return m_engineLoad;
+    }
+
+    std::optional<double> systemLoadAverage() const override {
+        return m_systemLoadAverage;
+    }
+
+    bool m_anyDeckPlaying = false;
+    double m_engineLoad = 0.0;
+    std::optional<double> m_systemLoadAverage;
+};
+
+constexpr int kNumWorkerThreads = 4;
+
+} // namespace
+
+class TrackAnalysisSchedulerTest : public MixxxTest {
+  protected:
+    TrackAnalysisSchedulerTest()
+            : m_pScheduler(TrackAnalysisScheduler::NullPointer()) {
+    }
+
+    void SetUp() override {
+        auto pEnvironment = std::make_unique<TestEnvironment>();
+        m_pEnvironment = pEnvironment.get();
+        // The workers are created in a suspended state and remain
+        // suspended, because resume() is never invoked
+        m_pScheduler = TrackAnalysisScheduler::createInstance(
+                std::move(pEnvironment),
+                kNumWorkerThreads,
+                mixxx::DbConnectionPoolPtr(),
+                config(),
+                AnalyzerModeFlags::LowPriority);
+    }
+
+    void TearDown() override {
+        m_pScheduler.reset();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    std::vector<TrackId> queuedTrackIds(AnalyzerScheduledTrack::Priority priority) const {
+        std::vector<TrackId> trackIds;
+        for (const auto& track :
+                m_pScheduler->m_queuedTracks[static_cast<int>(priority)]) {
+            trackIds.push_back(track.getTrackId());
+        }
+        return trackIds;
+    }
+
+    void updateActiveWorkers() {
+        m_pScheduler->slotUpdateActiveWorkers();
+    }
+
+    int activeWorkerCount() const {
+        return m_pScheduler->m_activeWorkerCount;
+    }
+
+    bool suspendedForEngineLoad() const {
+        return m_pScheduler->m_suspendedForEngineLoad;
+    }
+
+    TestEnvironment* m_pEnvironment;
+    TrackAnalysisScheduler::Pointer m_pScheduler;
+};
+
+TEST_F(TrackAnalysisSchedulerTest, priorityQueues) {
+    const TrackId track1(1);
+    const TrackId track2(2);
+    const TrackId track3(3);
+    const TrackId track4(4);
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track1, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::Low));
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track2, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::Low));
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(track3));
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track4, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::High));
+    EXPECT_EQ(std::vector<TrackId>({track1, track2}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::Low));
+    EXPECT_EQ(std::vector<TrackId>({track3}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::Normal));
+    EXPECT_EQ(std::vector<TrackId>({track4}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::High));
+
+    // Scheduling a queued track again with a higher priority moves it up
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track2, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::High));
+    EXPECT_EQ(std::vector<TrackId>({track1}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::Low));
+    EXPECT_EQ(std::vector<TrackId>({track4, track2}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::High));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, raisePriority) {
+    const TrackId track1(1);
+    const TrackId track2(2);
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track1, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::Low));
+    m_pScheduler->scheduleTrack(AnalyzerScheduledTrack(
+            track2, AnalyzerTrack::Options(), AnalyzerScheduledTrack::Priority::High));
+
+    EXPECT_TRUE(m_pScheduler->raisePriority(track1, AnalyzerScheduledTrack::Priority::Normal));
+    EXPECT_TRUE(queuedTrackIds(AnalyzerScheduledTrack::Priority::Low).empty());
+    EXPECT_EQ(std::vector<TrackId>({track1}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::Normal));
+
+    // Never lowers the priority
+    EXPECT_FALSE(m_pScheduler->raisePriority(track2, AnalyzerScheduledTrack::Priority::Normal));
+    EXPECT_EQ(std::vector<TrackId>({track2}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::High));
+
+    // Never adds tracks
+    EXPECT_FALSE(m_pScheduler->raisePriority(TrackId(3), AnalyzerScheduledTrack::Priority::High));
+    EXPECT_EQ(std::vector<TrackId>({track2}),
+            queuedTrackIds(AnalyzerScheduledTrack::Priority::High));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, suspendForEngineLoadWithHysteresis) {
+    // The default threshold is 50% of the engine load
+    m_pEnvironment->m_engineLoad = 0.9;
+    updateActiveWorkers();
+    EXPECT_FALSE(suspendedForEngineLoad()) << "No deck is playing";
+
+    m_pEnvironment->m_anyDeckPlaying = true;
+    m_pEnvironment->m_engineLoad = 0.5;
+    updateActiveWorkers();
+    EXPECT_FALSE(suspendedForEngineLoad());
+
+    m_pEnvironment->m_engineLoad = 0.6;
+    updateActiveWorkers();
+    EXPECT_TRUE(suspendedForEngineLoad());
+
+    // Below the threshold, but above the hysteresis
+    m_pEnvironment->m_engineLoad = 0.4;
+    updateActiveWorkers();
+    EXPECT_TRUE(suspendedForEngineLoad());
+
+    m_pEnvironment->m_engineLoad = 0.3;
+    updateActiveWorkers();
+    EXPECT_FALSE(suspendedForEngineLoad());
+
+    m_pEnvironment->m_engineLoad = 0.6;
+    updateActiveWorkers();
+    EXPECT_TRUE(suspendedForEngineLoad());
+    m_pEnvironment->m_anyDeckPlaying = false;
+    updateActiveWorkers();
+    EXPECT_FALSE(suspendedForEngineLoad());
+}
+
+TEST_F(TrackAnalysisSchedulerTest, limitActiveWorkersBySystemLoad) {
+    const int idealThreadCount = QThread::idealThreadCount();
+
+    // Without a load average all workers stay active
+    m_pEnvironment->m_systemLoadAverage.reset();
+    updateActiveWorkers();
+    EXPECT_EQ(kNumWorkerThreads, activeWorkerCount());
+
+    m_pEnvironment->m_systemLoadAverage = 0.0;
+    updateActiveWorkers();
+    EXPECT_EQ(std::min(kNumWorkerThreads, idealThreadCount), activeWorkerCount());
+
+    // Other processes occupy all but one core. None of the suspended
+    // workers has reported to be idle, so all of them count as busy and
+    // contribute to the load average.
+    m_pEnvironment->m_systemLoadAverage = idealThreadCount - 1 + kNumWorkerThreads;
+    updateActiveWorkers();
+    EXPECT_EQ(1, activeWorkerCount());
+
+    // At least one worker always stays active
+    m_pEnvironment->m_systemLoadAverage = 2.0 * idealThreadCount + kNumWorkerThreads;
+    updateActiveWorkers();
+    EXPECT_EQ(1, activeWorkerCount());
+
+    m_pEnvironment->m_systemLoadAverage = 0.0;
+    updateActiveWorkers();
+    EXPECT_EQ(std::min(kNumWorkerThreads, idealThreadCount), activeWorkerCount());
+}
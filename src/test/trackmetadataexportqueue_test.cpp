@@ -0,0 +1,139 @@
+#include "library/trackmetadataexportqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "test/mixxxtest.h"
+#include "track/globaltrackcache.h"
+#include "track/track.h"
+
+namespace {
+
+class NoopTrackCacheSaver : public GlobalTrackCacheSaver {
+  public:
+    void saveEvictedTrack(Track* pTrack) noexcept override {
+        Q_UNUSED(pTrack);
+    }
+};
+
+class TrackMetadataExportQueueTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        GlobalTrackCache::createInstance(&m_trackCacheSaver);
+    }
+
+    void TearDown() override {
+        GlobalTrackCache::destroyInstance();
+    }
+
+    // The files do not exist and exporting metadata fails
+    TrackPointer newTrack(const QString& fileName) const {
+        return Track::newTemporary(m_tempDir.filePath(fileName));
+    }
+
+    // Temporary tracks have no valid id and are considered
+    // as in use, i.e. they are never exported in the background
+    static QSet<TrackId> allTracksInUse() {
+        return QSet<TrackId>{TrackId()};
+    }
+
+    static QSet<TrackId> noTracksInUse() {
+        return QSet<TrackId>{};
+    }
+
+    QTemporaryDir m_tempDir;
+    NoopTrackCacheSaver m_trackCacheSaver;
+};
+
+TEST_F(TrackMetadataExportQueueTest, coalescePendingExports) {
+    TrackMetadataExportQueue queue(nullptr, allTracksInUse);
+    const auto pTrack = newTrack(QStringLiteral("a.mp3"));
+    EXPECT_TRUE(queue.enqueue(pTrack->cloneForMetadataExport(), SyncTrackMetadataParams{}));
+    EXPECT_TRUE(queue.enqueue(pTrack->cloneForMetadataExport(), SyncTrackMetadataParams{}));
+    EXPECT_EQ(1, queue.numPendingTracks());
+    EXPECT_TRUE(queue.enqueue(
+            newTrack(QStringLiteral("b.mp3")), SyncTrackMetadataParams{}));
+    EXPECT_EQ(2, queue.numPendingTracks());
+}
+
+TEST_F(TrackMetadataExportQueueTest, rejectWhenFull) {
+    TrackMetadataExportQueue queue(nullptr, allTracksInUse, 1);
+    const auto pTrack = newTrack(QStringLiteral("a.mp3"));
+    EXPECT_TRUE(queue.enqueue(pTrack, SyncTrackMetadataParams{}));
+    // Coalescing is always possible
+    EXPECT_TRUE(queue.enqueue(pTrack, SyncTrackMetadataParams{}));
+    EXPECT_FALSE(queue.enqueue(
+            newTrack(QStringLiteral("b.mp3")), SyncTrackMetadataParams{}));
+    EXPECT_EQ(1, queue.numPendingTracks());
+}
+
+TEST_F(TrackMetadataExportQueueTest, finishPendingExports) {
+    TrackMetadataExportQueue queue(nullptr, allTracksInUse);
+    int exportedCount = 0;
+    int failedCount = 0;
+    int lastFinishedTracks = 0;
+    QObject::connect(&queue,
+            &TrackMetadataExportQueue::trackMetadataExported,
+            [&exportedCount] {
+                ++exportedCount;
+            });
+    QObject::connect(&queue,
+            &TrackMetadataExportQueue::trackMetadataExportFailed,
+            [&failedCount] {
+                ++failedCount;
+            });
+    QObject::connect(&queue,
+            &TrackMetadataExportQueue::progress,
+            [&lastFinishedTracks](int finishedTracks, int totalTracks) {
+                EXPECT_LE(finishedTracks, totalTracks);
+                lastFinishedTracks = finishedTracks;
+            });
+
+    constexpr int kTrackCount = 5;
+    for (int i = 0; i < kTrackCount; ++i) {
+        ASSERT_TRUE(queue.enqueue(
+                newTrack(QStringLiteral("%1.mp3").arg(i)),
+                SyncTrackMetadataParams{}));
+    }
+    EXPECT_EQ(kTrackCount, queue.numPendingTracks());
+
+    // Exports the tracks in use
+    queue.finishPendingExports();
+    EXPECT_EQ(0, queue.numPendingTracks());
+    EXPECT_EQ(0, exportedCount);
+    EXPECT_EQ(kTrackCount, failedCount);
+    EXPECT_EQ(kTrackCount, lastFinishedTracks);
+}
+
+TEST_F(TrackMetadataExportQueueTest, waitWhileFileIsLocked) {
+    TrackMetadataExportQueue queue(nullptr, noTracksInUse);
+    int finishedCount = 0;
+    QObject::connect(&queue,
+            &TrackMetadataExportQueue::progress,
+            [&finishedCount](int finishedTracks, int /*totalTracks*/) {
+                finishedCount = finishedTracks;
+            });
+
+    const auto pTrack = newTrack(QStringLiteral("a.mp3"));
+    {
+        // Importing metadata from the file keeps the same lock
+        GlobalTrackCacheLocker locker(TrackRef::fromFileInfo(pTrack->getFileInfo()));
+        ASSERT_TRUE(queue.enqueue(pTrack, SyncTrackMetadataParams{}));
+        // Start the export on a worker thread
+        QCoreApplication::processEvents();
+        QThread::msleep(100);
+        QCoreApplication::processEvents();
+        EXPECT_EQ(1, queue.numPendingTracks());
+        EXPECT_EQ(0, finishedCount);
+    }
+
+    queue.finishPendingExports();
+    EXPECT_EQ(0, queue.numPendingTracks());
+    EXPECT_EQ(1, finishedCount);
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+#include "waveform/waveform.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr int kAudioSampleRate = 44100;
+constexpr int kVisualSampleRate = 441;
+
+// Fills the waveform with a deterministic pattern
+WaveformPointer createWaveform(SINT frameLength) {
+    auto pWaveform = WaveformPointer(new Waveform(
+            kAudioSampleRate, frameLength, kVisualSampleRate, -1));
+    WaveformData* data = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        data[i].filtered.low = static_cast<unsigned char>((i * 7) % 251);
+        data[i].filtered.mid = static_cast<unsigned char>((i * 13) % 241);
+        data[i].filtered.high = static_cast<unsigned char>((i * 17) % 239);
+        data[i].filtered.all = static_cast<unsigned char>((i * 3) % 255);
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+TEST(WaveformTest, onlyLevel0BeforeBuildingLevels) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60);
+    EXPECT_EQ(1, pWaveform->getLevelCount());
+    EXPECT_EQ(0, pWaveform->getLevelForVisualSamplesPerPixel(1000.0));
+    EXPECT_EQ(pWaveform->getDataSize(), pWaveform->getLevelDataSize(0));
+    EXPECT_EQ(pWaveform->data(), pWaveform->levelData(0));
+}
+
+TEST(WaveformTest, levelsKeepMaximumOfChannel) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60);
+    pWaveform->buildLevels();
+    ASSERT_LT(1, pWaveform->getLevelCount());
+
+    for (int level = 1; level < pWaveform->getLevelCount(); ++level) {
+        const WaveformData* source = pWaveform->levelData(level - 1);
+        const int sourceSize = pWaveform->getLevelDataSize(level - 1);
+        const WaveformData* reduced = pWaveform->levelData(level);
+        const int reducedSize = pWaveform->getLevelDataSize(level);
+        ASSERT_EQ((sourceSize / 2 + 1) / 2 * 2, reducedSize);
+        for (int i = 0; i < reducedSize; ++i) {
+            // Left and right are interleaved
+            const int frame = i / 2;
+            const int channel = i % 2;
+            const int first = 4 * frame + channel;
+            const int second = math_min(first + 2, sourceSize - 2 + channel);
+            EXPECT_EQ(math_max(source[first].filtered.low, source[second].filtered.low),
+                    reduced[i].filtered.low);
+            EXPECT_EQ(math_max(source[first].filtered.mid, source[second].filtered.mid),
+                    reduced[i].filtered.mid);
+            EXPECT_EQ(math_max(source[first].filtered.high, source[second].filtered.high),
+                    reduced[i].filtered.high);
+            EXPECT_EQ(math_max(source[first].filtered.all, source[second].filtered.all),
+                    reduced[i].filtered.all);
+        }
+    }
+}
+
+TEST(WaveformTest, levelForVisualSamplesPerPixel) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60);
+    pWaveform->buildLevels();
+    const int levelCount = pWaveform->getLevelCount();
+    ASSERT_LT(4, levelCount);
+
+    // Zoomed in, less than two visual frames per pixel
+    EXPECT_EQ(0, pWaveform->getLevelForVisualSamplesPerPixel(0.5));
+    EXPECT_EQ(0, pWaveform->getLevelForVisualSamplesPerPixel(3.9));
+    // Each pixel spans at least one visual frame of the level
+    EXPECT_EQ(1, pWaveform->getLevelForVisualSamplesPerPixel(4.0));
+    EXPECT_EQ(1, pWaveform->getLevelForVisualSamplesPerPixel(7.9));
+    EXPECT_EQ(3, pWaveform->getLevelForVisualSamplesPerPixel(16.0));
+    // Zoomed out beyond the coarsest level
+    EXPECT_EQ(levelCount - 1, pWaveform->getLevelForVisualSamplesPerPixel(1e9));
+}
+
+TEST(WaveformTest, visibleLevel) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60);
+    pWaveform->buildLevels();
+    ASSERT_LT(3, pWaveform->getLevelCount());
+
+    // 8 visual samples per pixel select level 2
+    const auto visibleLevel = pWaveform->getVisibleLevel(1000.0, 1800.0, 100.0);
+    EXPECT_EQ(pWaveform->levelData(2), visibleLevel.data);
+    EXPECT_EQ(pWaveform->getLevelDataSize(2), visibleLevel.dataSize);
+    EXPECT_DOUBLE_EQ(250.0, visibleLevel.firstVisualIndex);
+    EXPECT_DOUBLE_EQ(450.0, visibleLevel.lastVisualIndex);
+
+    // Zoomed in
+    const auto visibleLevel0 = pWaveform->getVisibleLevel(1000.0, 1100.0, 100.0);
+    EXPECT_EQ(pWaveform->data(), visibleLevel0.data);
+    EXPECT_EQ(pWaveform->getDataSize(), visibleLevel0.dataSize);
+    EXPECT_DOUBLE_EQ(1000.0, visibleLevel0.firstVisualIndex);
+    EXPECT_DOUBLE_EQ(1100.0, visibleLevel0.lastVisualIndex);
+}
+
+// Reduces the visible samples to one maximum per pixel, like the renderers do
+void reduceToPixels(const Waveform& waveform, int pixels, benchmark::State& state) {
+    const Waveform::VisibleLevel visibleLevel =
+            waveform.getVisibleLevel(0.0, waveform.getDataSize(), pixels);
+    const WaveformData* data = visibleLevel.data;
+    const int dataSize = visibleLevel.dataSize;
+    const double gain = visibleLevel.lastVisualIndex / pixels;
+    for (auto _ : state) {
+        int sum = 0;
+        for (int x = 0; x < pixels; ++x) {
+            const int start = static_cast<int>(gain * x / 2) * 2;
+            const int stop = math_min(static_cast<int>(gain * (x + 1) / 2) * 2, dataSize);
+            unsigned char maxAll = 0;
+            for (int i = start; i < stop; ++i) {
+                maxAll = math_max(maxAll, data[i].filtered.all);
+            }
+            sum += maxAll;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void BM_WaveformReduceFullTrackLevel0(benchmark::State& state) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60 * 8);
+    reduceToPixels(*pWaveform, static_cast<int>(state.range(0)), state);
+}
+BENCHMARK(BM_WaveformReduceFullTrackLevel0)->Arg(500)->Arg(2000);
+
+static void BM_WaveformReduceFullTrackLevels(benchmark::State& state) {
+    const auto pWaveform = createWaveform(kAudioSampleRate * 60 * 8);
+    pWaveform->buildLevels();
+    reduceToPixels(*pWaveform, static_cast<int>(state.range(0)), state);
+}
+BENCHMARK(BM_WaveformReduceFullTrackLevels)->Arg(500)->Arg(2000);
+
+} // namespace
@@ -0,0 +1,61 @@
+#include "widget/woverview.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+class WOverviewTest : public testing::Test {
+  protected:
+    // Verifies that the tiles cover the scaled length without gaps
+    // or overlaps
+    static void expectAdjacentTiles(int sourceWidth, int scaledLength) {
+        const int tileCount = (sourceWidth + kTileColumns - 1) / kTileColumns;
+        int scaledEnd = 0;
+        for (int tile = 0; tile < tileCount; ++tile) {
+            const auto layout = WOverview::waveformTileLayout(
+                    tile, sourceWidth, scaledLength);
+            EXPECT_EQ(scaledEnd, layout.scaledStart)
+                    << "tile " << tile << " of " << sourceWidth << " columns";
+            EXPECT_LT(layout.scaledStart, layout.scaledEnd);
+            scaledEnd = layout.scaledEnd;
+
+            // The padding comes from the neighboring tiles only
+            EXPECT_EQ(tile == 0 ? 0 : tile * kTileColumns - 1,
+                    layout.paddedFirstColumn);
+            EXPECT_EQ(std::min((tile + 1) * kTileColumns + 1, sourceWidth),
+                    layout.paddedEndColumn);
+            EXPECT_LE(layout.paddedScaledStart, layout.scaledStart);
+            EXPECT_GE(layout.paddedScaledEnd, layout.scaledEnd);
+        }
+        EXPECT_EQ(scaledLength, scaledEnd);
+    }
+
+    static constexpr int kTileColumns = WOverview::kWaveformTileColumns;
+};
+
+TEST_F(WOverviewTest, singleTile) {
+    const auto layout = WOverview::waveformTileLayout(0, 100, 250);
+    EXPECT_EQ(0, layout.paddedFirstColumn);
+    EXPECT_EQ(100, layout.paddedEndColumn);
+    EXPECT_EQ(0, layout.scaledStart);
+    EXPECT_EQ(250, layout.scaledEnd);
+    EXPECT_EQ(0, layout.paddedScaledStart);
+    EXPECT_EQ(250, layout.paddedScaledEnd);
+}
+
+TEST_F(WOverviewTest, tilesAreAdjacent) {
+    expectAdjacentTiles(2 * kTileColumns, 2 * kTileColumns);
+    expectAdjacentTiles(1999, 500);
+    expectAdjacentTiles(1000, 3000);
+    expectAdjacentTiles(kTileColumns + 1, 300);
+}
+
+TEST_F(WOverviewTest, tilesAreAdjacentWithFractionalDevicePixelRatio) {
+    for (const double devicePixelRatio : {1.25, 1.5, 1.75}) {
+        for (const int width : {101, 333, 1023}) {
+            expectAdjacentTiles(1000,
+                    static_cast<int>(std::ceil(width * devicePixelRatio)));
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "track/globaltrackcache.h"
 
 #include <QCoreApplication>
+#include <QThread>
+#include <vector>
 
 #include "moc_globaltrackcache.cpp"
 #include "track/track.h"
@@ -28,8 +30,6 @@ inline bool traceLogEnabled() {
     return kLogEnabled || kLogger.traceEnabled();
 }
 
-constexpr bool kLogStats = false;
-
 inline
 TrackRef createTrackRef(const Track& track) {
     return TrackRef::fromFileInfo(track.getFileInfo(), track.getId());
@@ -93,51 +93,58 @@ class EvictAndSaveFunctor {
 } // anonymous namespace
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker()
-        : m_pInstance(nullptr) {
-    lockCache();
+        : m_pInstance(s_pInstance),
+          m_lockedShardIndex(-1) {
+    DEBUG_ASSERT(m_pInstance);
+}
+
+GlobalTrackCacheLocker::GlobalTrackCacheLocker(
+        const TrackRef& trackRef)
+        : GlobalTrackCacheLocker() {
+    lockShard(GlobalTrackCache::shardIndexOf(trackRef));
 }
 
 GlobalTrackCacheLocker::GlobalTrackCacheLocker(
         GlobalTrackCacheLocker&& moveable)
-        : m_pInstance(std::move(moveable.m_pInstance)) {
+        : m_pInstance(std::move(moveable.m_pInstance)),
+          m_lockedShardIndex(moveable.m_lockedShardIndex) {
     moveable.m_pInstance = nullptr;
+    moveable.m_lockedShardIndex = -1;
 }
 
 GlobalTrackCacheLocker::~GlobalTrackCacheLocker() {
     unlockCache();
 }
 
-void GlobalTrackCacheLocker::lockCache() {
-    DEBUG_ASSERT(s_pInstance);
-    DEBUG_ASSERT(!m_pInstance);
+void GlobalTrackCacheLocker::lockShard(int shardIndex) {
+    DEBUG_ASSERT(m_pInstance);
+    DEBUG_ASSERT(m_lockedShardIndex < 0);
     if (traceLogEnabled()) {
-        kLogger.trace() << "Locking cache";
+        kLogger.trace() << "Locking shard" << shardIndex;
     }
-    s_pInstance->m_mutex.lock();
+    m_pInstance->m_shards[shardIndex].mutex.lock();
     if (traceLogEnabled()) {
-        kLogger.trace() << "Cache is locked";
+        kLogger.trace() << "Shard" << shardIndex << "is locked";
     }
-    m_pInstance = s_pInstance;
+    m_lockedShardIndex = shardIndex;
 }
 
-void GlobalTrackCacheLocker::unlockCache() {
-    if (m_pInstance) {
+void GlobalTrackCacheLocker::unlockShard() {
+    if (m_pInstance && m_lockedShardIndex >= 0) {
         if (traceLogEnabled()) {
-            kLogger.trace() << "Unlocking cache";
-        }
-        if (kLogStats && debugLogEnabled()) {
-            kLogger.debug()
-                    << "#tracksById ="
-                    << m_pInstance->m_tracksById.size()
-                    << "/ #tracksByCanonicalLocation ="
-                    << m_pInstance->m_tracksByCanonicalLocation.size();
+            kLogger.trace() << "Unlocking shard" << m_lockedShardIndex;
         }
-        m_pInstance->m_mutex.unlock();
+        m_pInstance->m_shards[m_lockedShardIndex].mutex.unlock();
         if (traceLogEnabled()) {
-            kLogger.trace() << "Cache is unlocked";
+            kLogger.trace() << "Shard" << m_lockedShardIndex << "is unlocked";
         }
-        m_pInstance = nullptr;
     }
+    m_lockedShardIndex = -1;
+}
+
+void GlobalTrackCacheLocker::unlockCache() {
+    unlockShard();
+    m_pInstance = nullptr;
 }
 
 void GlobalTrackCacheLocker::relocateCachedTracks(
@@ -305,16 +312,16 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     }
 }
 
+GlobalTrackCache::Shard::Shard()
+        : mutex(QT_RECURSIVE_MUTEX_INIT),
+          tracksById(kUnorderedCollectionMinCapacity / kShardCount, DbId::hash_fun) {
+}
+
 GlobalTrackCache::GlobalTrackCache(
         GlobalTrackCacheSaver* pSaver,
         deleteTrackFn_t deleteTrackFn)
-        :
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-          m_mutex(QMutex::Recursive),
-#endif
-          m_pSaver(pSaver),
-          m_deleteTrackFn(deleteTrackFn),
-          m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+        : m_pSaver(pSaver),
+          m_deleteTrackFn(deleteTrackFn) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
 }
@@ -323,59 +330,94 @@ GlobalTrackCache::~GlobalTrackCache() {
     deactivate();
 }
 
+//static
+int GlobalTrackCache::shardIndexOf(const TrackRef& trackRef) {
+    if (trackRef.hasCanonicalLocation()) {
+        return shardIndexOf(trackRef.getCanonicalLocation());
+    }
+    if (trackRef.hasId()) {
+        return shardIndexOf(trackRef.getId());
+    }
+    return 0;
+}
+
+//static
+int GlobalTrackCache::shardIndexOf(const QString& canonicalLocation) {
+    return static_cast<int>(qHash(canonicalLocation) % kShardCount);
+}
+
+//static
+int GlobalTrackCache::shardIndexOf(TrackId trackId) {
+    return static_cast<int>(trackId.hash() % kShardCount);
+}
+
+void GlobalTrackCache::lockAllShards() const {
+    // Always in ascending order to prevent deadlocks
+    for (const auto& shard : m_shards) {
+        shard.mutex.lock();
+    }
+}
+
+void GlobalTrackCache::unlockAllShards() const {
+    for (auto i = m_shards.rbegin(); i != m_shards.rend(); ++i) {
+        i->mutex.unlock();
+    }
+}
+
 void GlobalTrackCache::relocateTracks(
         GlobalTrackCacheRelocator* pRelocator) {
     if (debugLogEnabled()) {
         kLogger.debug()
                 << "Relocating tracks";
     }
-    TracksByCanonicalLocation relocatedTracksByCanonicalLocation;
-    for (auto&&
-            i = m_tracksByCanonicalLocation.begin();
-            i != m_tracksByCanonicalLocation.end();
-            ++i) {
-        const QString oldCanonicalLocation = i->first;
-        Track* plainPtr = i->second->getPlainPtr();
-        auto fileAccess = plainPtr->getFileAccess();
-        TrackRef trackRef = TrackRef::fromFileInfo(
-                fileAccess.info(),
-                plainPtr->getId());
-        if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
-            auto relocatedFileAccess = pRelocator->relocateCachedTrack(
-                    trackRef.getId(),
-                    fileAccess);
-            if (fileAccess.info() != relocatedFileAccess.info()) {
-                plainPtr->relocate(relocatedFileAccess);
-                trackRef = TrackRef::fromFileInfo(
-                        relocatedFileAccess.info(),
-                        trackRef.getId());
-                fileAccess = std::move(relocatedFileAccess);
+    lockAllShards();
+    // Relocated tracks might move into a different shard
+    std::array<TracksByCanonicalLocation, kShardCount> relocatedTracksByCanonicalLocation;
+    for (const auto& shard : m_shards) {
+        for (auto i = shard.tracksByCanonicalLocation.constBegin();
+                i != shard.tracksByCanonicalLocation.constEnd();
+                ++i) {
+            const QString oldCanonicalLocation = i.key();
+            Track* plainPtr = i.value()->getPlainPtr();
+            auto fileAccess = plainPtr->getFileAccess();
+            TrackRef trackRef = TrackRef::fromFileInfo(
+                    fileAccess.info(),
+                    plainPtr->getId());
+            if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
+                auto relocatedFileAccess = pRelocator->relocateCachedTrack(
+                        trackRef.getId(),
+                        fileAccess);
+                if (fileAccess.info() != relocatedFileAccess.info()) {
+                    plainPtr->relocate(relocatedFileAccess);
+                    trackRef = TrackRef::fromFileInfo(
+                            relocatedFileAccess.info(),
+                            trackRef.getId());
+                    fileAccess = std::move(relocatedFileAccess);
+                }
             }
+            if (!trackRef.hasCanonicalLocation()) {
+                kLogger.warning()
+                        << "Failed to relocate track"
+                        << oldCanonicalLocation
+                        << trackRef;
+                continue;
+            }
+            const QString& newCanonicalLocation = trackRef.getCanonicalLocation();
+            if (debugLogEnabled() && oldCanonicalLocation != newCanonicalLocation) {
+                kLogger.debug()
+                        << "Relocating track"
+                        << "from" << oldCanonicalLocation
+                        << "to" << newCanonicalLocation;
+            }
+            relocatedTracksByCanonicalLocation[shardIndexOf(newCanonicalLocation)]
+                    .insert(newCanonicalLocation, i.value());
         }
-        if (!trackRef.hasCanonicalLocation()) {
-            kLogger.warning()
-                    << "Failed to relocate track"
-                    << oldCanonicalLocation
-                    << trackRef;
-            continue;
-        }
-        QString newCanonicalLocation = trackRef.getCanonicalLocation();
-        if (oldCanonicalLocation == newCanonicalLocation) {
-            // Copy the entry unmodified into the new map
-            relocatedTracksByCanonicalLocation.insert(*i);
-            continue;
-        }
-        if (debugLogEnabled()) {
-            kLogger.debug()
-                    << "Relocating track"
-                    << "from" << oldCanonicalLocation
-                    << "to" << newCanonicalLocation;
-        }
-        relocatedTracksByCanonicalLocation.insert(std::make_pair(
-                std::move(newCanonicalLocation),
-                i->second));
     }
-    m_tracksByCanonicalLocation = std::move(relocatedTracksByCanonicalLocation);
+    for (int i = 0; i < kShardCount; ++i) {
+        m_shards[i].tracksByCanonicalLocation =
+                std::move(relocatedTracksByCanonicalLocation[i]);
+    }
+    unlockAllShards();
 }
 
 void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
@@ -398,6 +440,34 @@ void GlobalTrackCache::deactivate() {
         return;
     }
 
+    lockAllShards();
+
+    // Tracks are indexed by both id and canonical location
+    std::vector<GlobalTrackCacheEntryPointer> cacheEntries;
+    QSet<Track*> plainPtrs;
+    std::vector<TrackId> savingTrackIds;
+    for (auto& shard : m_shards) {
+        {
+            const auto locked = lockMutex(&shard.idMutex);
+            for (const auto& entry : shard.tracksById) {
+                shard.savingTrackIds.insert(entry.first);
+                savingTrackIds.push_back(entry.first);
+                if (!plainPtrs.contains(entry.second->getPlainPtr())) {
+                    plainPtrs.insert(entry.second->getPlainPtr());
+                    cacheEntries.push_back(entry.second);
+                }
+            }
+            shard.tracksById.clear();
+        }
+        for (const auto& cacheEntryPtr : qAsConst(shard.tracksByCanonicalLocation)) {
+            if (!plainPtrs.contains(cacheEntryPtr->getPlainPtr())) {
+                plainPtrs.insert(cacheEntryPtr->getPlainPtr());
+                cacheEntries.push_back(cacheEntryPtr);
+            }
+        }
+        shard.tracksByCanonicalLocation.clear();
+    }
+
     // Ideally the cache should be empty when destroyed.
     // But since this is difficult to achieve all remaining
     // cached tracks will be evicted no matter if they are still
@@ -406,46 +476,64 @@ void GlobalTrackCache::deactivate() {
     // exiting the application.
     kLogger.warning()
             << "Evicting all remaining"
-            << m_tracksById.size()
-            << '/'
-            << m_tracksByCanonicalLocation.size()
+            << cacheEntries.size()
             << "tracks from cache";
 
-    while (!m_tracksById.empty()) {
-        auto i = m_tracksById.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(plainPtr->getFileInfo().canonicalLocation());
-        m_tracksById.erase(i);
+    for (const auto& cacheEntryPtr : cacheEntries) {
+        saveEvictedTrack(cacheEntryPtr->getPlainPtr());
     }
-
-    while (!m_tracksByCanonicalLocation.empty()) {
-        auto i = m_tracksByCanonicalLocation.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(i);
+    for (const auto& trackId : savingTrackIds) {
+        finishSaving(trackId);
     }
 
     // Verify that all cached tracks have been evicted
-    DEBUG_ASSERT(m_tracksById.empty());
-    DEBUG_ASSERT(m_tracksByCanonicalLocation.empty());
+    DEBUG_ASSERT(isEmpty());
 
     // The singular cache instance is already unavailable and
     // all allocated tracks will simply be deleted when their
     // shared pointer goes out of scope. Unsaved modifications
     // will be lost.
     m_pSaver = nullptr;
+
+    unlockAllShards();
 }
 
 bool GlobalTrackCache::isEmpty() const {
-    return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
+    for (const auto& shard : m_shards) {
+        {
+            const auto locked = lockMutex(&shard.idMutex);
+            if (!shard.tracksById.empty()) {
+                return false;
+            }
+        }
+        const auto locked = lockMutex(&shard.mutex);
+        if (!shard.tracksByCanonicalLocation.isEmpty()) {
+            return false;
+        }
+    }
+    return true;
 }
 
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
     TrackPointer trackPtr;
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    Shard& shard = m_shards[shardIndexOf(trackId)];
+    const auto locked = lockMutex(&shard.idMutex);
+    // An evicted track is still cached until it has been saved, but
+    // not for the thread that is saving it
+    if (QThread::currentThread() != thread()) {
+        while (shard.savingTrackIds.contains(trackId)) {
+            if (traceLogEnabled()) {
+                kLogger.trace()
+                        << "Waiting until the evicted track"
+                        << trackId
+                        << "has been saved";
+            }
+            shard.trackIdSaved.wait(&shard.idMutex);
+        }
+    }
+    const auto trackById(shard.tracksById.find(trackId));
+    if (shard.tracksById.end() != trackById) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
@@ -492,17 +580,26 @@ TrackPointer GlobalTrackCache::lookupByRef(
 TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
         const QString& canonicalLocation) {
     TrackPointer trackPtr;
+    Shard& shard = m_shards[shardIndexOf(canonicalLocation)];
+    const auto locked = lockMutex(&shard.mutex);
     const auto trackByCanonicalLocation(
-            m_tracksByCanonicalLocation.find(canonicalLocation));
-    if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+            shard.tracksByCanonicalLocation.constFind(canonicalLocation));
+    if (shard.tracksByCanonicalLocation.constEnd() != trackByCanonicalLocation) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << canonicalLocation
-                    << trackByCanonicalLocation->second->getPlainPtr();
+                    << trackByCanonicalLocation.value()->getPlainPtr();
+        }
+        // The track might be revived concurrently by its id
+        const TrackId trackId = trackByCanonicalLocation.value()->getPlainPtr()->getId();
+        if (trackId.isValid()) {
+            const auto idLocked = lockMutex(&m_shards[shardIndexOf(trackId)].idMutex);
+            trackPtr = revive(trackByCanonicalLocation.value());
+        } else {
+            trackPtr = revive(trackByCanonicalLocation.value());
         }
-        trackPtr = revive(trackByCanonicalLocation->second);
         DEBUG_ASSERT(trackPtr);
     } else {
         // Cache miss
@@ -517,8 +614,11 @@ TrackPointer GlobalTrackCache::lookupByCanonicalLocation(
 
 QSet<TrackId> GlobalTrackCache::getCachedTrackIds() const {
     QSet<TrackId> trackIds;
-    for (const auto& entry : m_tracksById) {
-        trackIds << entry.first;
+    for (const auto& shard : m_shards) {
+        const auto locked = lockMutex(&shard.idMutex);
+        for (const auto& entry : shard.tracksById) {
+            trackIds << entry.first;
+        }
     }
     return trackIds;
 }
@@ -588,6 +688,12 @@ void GlobalTrackCache::resolve(
     // The TrackRef is constructed now after the lookup by ID failed to
     // avoid calculating the canonical file path if it is not needed.
     TrackRef trackRef = TrackRef::fromFileInfo(fileAccess.info(), trackId);
+    // Keep the shard locked until the resolver is unlocked. This prevents
+    // that the same track is allocated twice and that the track is loaded
+    // from the database while it is still being saved.
+    const int shardIndex = shardIndexOf(trackRef);
+    pCacheResolver->lockShard(shardIndex);
+    Shard& shard = m_shards[shardIndex];
     if (trackRef.hasCanonicalLocation()) {
         if (debugLogEnabled()) {
             kLogger.debug()
@@ -624,8 +730,9 @@ void GlobalTrackCache::resolve(
     }
     if (!m_pSaver) {
         // Do not allocate any new tracks once the cache
-        // has been deactivated
-        DEBUG_ASSERT(isEmpty());
+        // has been deactivated. Only the locked shard is checked
+        // to preserve the lock order.
+        DEBUG_ASSERT(shard.tracksByCanonicalLocation.isEmpty());
         kLogger.warning()
                 << "Cache miss - caching has already been deactivated"
                 << trackRef;
@@ -644,33 +751,68 @@ void GlobalTrackCache::resolve(
 
     auto cacheEntryPtr = std::make_shared<GlobalTrackCacheEntry>(
             std::move(deletingPtr));
-    auto savingPtr = TrackPointer(
-            cacheEntryPtr->getPlainPtr(),
-            EvictAndSaveFunctor(cacheEntryPtr));
-    cacheEntryPtr->init(savingPtr);
+    TrackPointer savingPtr;
 
     if (debugLogEnabled()) {
         kLogger.debug()
                 << "Cache miss - inserting new track into cache"
                 << trackRef
-                << deletingPtr.get();
+                << cacheEntryPtr->getPlainPtr();
     }
 
     if (trackRef.hasId()) {
         // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
-                trackRef.getId(),
-                cacheEntryPtr));
+        Shard& idShard = m_shards[shardIndexOf(trackRef.getId())];
+        TrackPointer strongPtr;
+        {
+            const auto locked = lockMutex(&idShard.idMutex);
+            const auto trackById = idShard.tracksById.find(trackRef.getId());
+            if (trackById != idShard.tracksById.end()) {
+                // The shard of the id is not locked while resolving. The
+                // same id might have been resolved concurrently through
+                // a different location, e.g. after relocating the track.
+                strongPtr = revive(trackById->second);
+            } else {
+                savingPtr = TrackPointer(
+                        cacheEntryPtr->getPlainPtr(),
+                        EvictAndSaveFunctor(cacheEntryPtr));
+                cacheEntryPtr->init(savingPtr);
+                idShard.tracksById.insert(std::make_pair(
+                        trackRef.getId(),
+                        cacheEntryPtr));
+            }
+        }
+        if (strongPtr) {
+            if (debugLogEnabled()) {
+                kLogger.debug()
+                        << "Cache hit - found concurrently allocated track by id"
+                        << trackRef.getId()
+                        << strongPtr.get();
+            }
+            // The new track is discarded when cacheEntryPtr goes out of scope
+            // and must be deleted within the event loop of the main thread
+            cacheEntryPtr->getPlainPtr()->moveToThread(
+                    QCoreApplication::instance()->thread());
+            TrackRef cachedTrackRef = createTrackRef(*strongPtr);
+            pCacheResolver->initLookupResult(
+                    GlobalTrackCacheLookupResult::Hit,
+                    std::move(strongPtr),
+                    std::move(cachedTrackRef));
+            return;
+        }
+    } else {
+        savingPtr = TrackPointer(
+                cacheEntryPtr->getPlainPtr(),
+                EvictAndSaveFunctor(cacheEntryPtr));
+        cacheEntryPtr->init(savingPtr);
     }
     if (trackRef.hasCanonicalLocation()) {
         // Insert item by track location
-        DEBUG_ASSERT(m_tracksByCanonicalLocation.find(
-                trackRef.getCanonicalLocation()) == m_tracksByCanonicalLocation.end());
-        m_tracksByCanonicalLocation.insert(std::make_pair(
+        DEBUG_ASSERT(!shard.tracksByCanonicalLocation.contains(
+                trackRef.getCanonicalLocation()));
+        shard.tracksByCanonicalLocation.insert(
                 trackRef.getCanonicalLocation(),
-                cacheEntryPtr));
+                cacheEntryPtr);
     }
 
     // Track objects live together with the cache on the main thread
@@ -699,15 +841,17 @@ TrackRef GlobalTrackCache::initTrackId(
     EvictAndSaveFunctor* pDel = std::get_deleter<EvictAndSaveFunctor>(strongPtr);
     DEBUG_ASSERT(pDel);
 
-    // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
+    // Insert item by id. The track must not be found by its
+    // id before the id has been initialized.
+    Shard& idShard = m_shards[shardIndexOf(trackId)];
+    const auto locked = lockMutex(&idShard.idMutex);
+    DEBUG_ASSERT(idShard.tracksById.find(trackId) == idShard.tracksById.end());
+    idShard.tracksById.insert(std::make_pair(
             trackId,
             pDel->getCacheEntryPointer()));
 
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
 
     return trackRefWithId;
 }
@@ -715,11 +859,13 @@ TrackRef GlobalTrackCache::initTrackId(
 void GlobalTrackCache::purgeTrackId(TrackId trackId) {
     DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    Shard& shard = m_shards[shardIndexOf(trackId)];
+    const auto locked = lockMutex(&shard.idMutex);
+    const auto trackById(shard.tracksById.find(trackId));
+    if (shard.tracksById.end() != trackById) {
         Track* track = trackById->second->getPlainPtr();
         track->resetId();
-        m_tracksById.erase(trackById);
+        shard.tracksById.erase(trackById);
     }
 }
 
@@ -730,27 +876,29 @@ void GlobalTrackCache::slotEvictAndSave(
 
     // GlobalTrackCacheSaver::saveEvictedTrack() requires that
     // exclusive access is guaranteed for the duration of the
-    // whole invocation!
+    // whole invocation! Only the shard of the track needs to
+    // be locked. The track is owned by cacheEntryPtr and could
+    // safely be accessed before locking.
     GlobalTrackCacheLocker cacheLocker;
-
-    if (!cacheEntryPtr->expired()) {
-        // We have handed out (revived) this track again after our reference count
-        // drops to zero and before acquiring the lock at the beginning of this function
-        if (debugLogEnabled()) {
-            kLogger.debug()
-                    << "Skip to evict and save a revived or reallocated track"
-                    << cacheEntryPtr->getPlainPtr();
+    while (true) {
+        const int shardIndex = shardIndexOf(createTrackRef(*cacheEntryPtr->getPlainPtr()));
+        cacheLocker.lockShard(shardIndex);
+        if (shardIndexOf(createTrackRef(*cacheEntryPtr->getPlainPtr())) == shardIndex) {
+            break;
         }
-        return;
+        // The track has been relocated or purged before locking
+        cacheLocker.unlockShard();
     }
 
-    if (!tryEvict(cacheEntryPtr->getPlainPtr())) {
-        // A second deleter has already evicted the track from cache after our
-        // reference count drops to zero and before acquiring the lock at the
-        // beginning of this function
+    TrackId savingTrackId;
+    if (!tryEvict(cacheEntryPtr, &savingTrackId)) {
+        // We have handed out (revived) this track again or a second deleter
+        // has already evicted the track from cache after our reference count
+        // drops to zero and before acquiring the lock at the beginning of this
+        // function
         if (debugLogEnabled()) {
             kLogger.debug()
-                    << "Skip to save an already evicted track again"
+                    << "Skip to evict and save a revived or already evicted track"
                     << cacheEntryPtr->getPlainPtr();
         }
         return;
@@ -758,17 +906,24 @@ void GlobalTrackCache::slotEvictAndSave(
 
     DEBUG_ASSERT(!isCached(cacheEntryPtr->getPlainPtr()));
     saveEvictedTrack(cacheEntryPtr->getPlainPtr());
+    if (savingTrackId.isValid()) {
+        finishSaving(savingTrackId);
+    }
 
     // Explicitly release the cacheEntryPtr including the owned
-    // track object while the cache is still locked.
+    // track object while the shard is still locked.
     cacheEntryPtr.reset();
 
-    // Finally the exclusive lock on the cache is released implicitly
+    // Finally the exclusive lock on the shard is released implicitly
     // when exiting the scope of this method.
 }
 
-bool GlobalTrackCache::tryEvict(Track* plainPtr) {
+bool GlobalTrackCache::tryEvict(
+        const GlobalTrackCacheEntryPointer& cacheEntryPtr,
+        TrackId* /*out*/ pSavingTrackId) {
+    Track* plainPtr = cacheEntryPtr->getPlainPtr();
     DEBUG_ASSERT(plainPtr);
+    DEBUG_ASSERT(pSavingTrackId);
     // Make the cached track object invisible to avoid reusing
     // it before starting to save it. This is achieved by
     // removing it from both cache indices.
@@ -786,22 +941,37 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
+        Shard& idShard = m_shards[shardIndexOf(trackRef.getId())];
+        const auto locked = lockMutex(&idShard.idMutex);
+        if (!cacheEntryPtr->expired()) {
+            // Revived or reallocated
+            return false;
+        }
+        const auto trackById = idShard.tracksById.find(trackRef.getId());
+        if (trackById != idShard.tracksById.end()) {
             if (trackById->second->getPlainPtr() == plainPtr) {
-                m_tracksById.erase(trackById);
+                idShard.tracksById.erase(trackById);
+                // Concurrent lookups by id wait until the track
+                // has been saved
+                idShard.savingTrackIds.insert(trackRef.getId());
+                *pSavingTrackId = trackRef.getId();
                 evicted = true;
             } else {
                 notEvicted = true;
             }
         }
+    } else if (!cacheEntryPtr->expired()) {
+        // Revived by canonical location
+        return false;
     }
     if (trackRef.hasCanonicalLocation()) {
+        // Locked by the caller
+        Shard& shard = m_shards[shardIndexOf(trackRef.getCanonicalLocation())];
         const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
-            if (trackByCanonicalLocation->second->getPlainPtr() == plainPtr) {
-                m_tracksByCanonicalLocation.erase(
+                shard.tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
+        if (shard.tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+            if (trackByCanonicalLocation.value()->getPlainPtr() == plainPtr) {
+                shard.tracksByCanonicalLocation.erase(
                         trackByCanonicalLocation);
                 evicted = true;
             } else {
@@ -815,15 +985,34 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
     return evicted;
 }
 
+void GlobalTrackCache::finishSaving(TrackId trackId) {
+    DEBUG_ASSERT(trackId.isValid());
+    Shard& shard = m_shards[shardIndexOf(trackId)];
+    const auto locked = lockMutex(&shard.idMutex);
+    DEBUG_ASSERT(shard.savingTrackIds.contains(trackId));
+    shard.savingTrackIds.remove(trackId);
+    shard.trackIdSaved.wakeAll();
+}
+
 bool GlobalTrackCache::isCached(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return true;
+    // Only the indices of the shards that are accessible without
+    // violating the lock hierarchy are checked
+    const auto trackRef = createTrackRef(*plainPtr);
+    if (trackRef.hasId()) {
+        const Shard& idShard = m_shards[shardIndexOf(trackRef.getId())];
+        const auto locked = lockMutex(&idShard.idMutex);
+        for (auto&& entry : idShard.tracksById) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
-    for (auto&& entry: m_tracksByCanonicalLocation) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-              return true;
+    if (trackRef.hasCanonicalLocation()) {
+        const Shard& shard = m_shards[shardIndexOf(trackRef.getCanonicalLocation())];
+        for (const auto& cacheEntryPtr : shard.tracksByCanonicalLocation) {
+            if (cacheEntryPtr->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
     return false;
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <map>
+#include <QHash>
+#include <QSet>
+#include <QWaitCondition>
+#include <array>
 #include <unordered_map>
 
 #include "track/track_decl.h"
@@ -86,9 +89,18 @@ class GlobalTrackCacheEntry final {
 
 typedef std::shared_ptr<GlobalTrackCacheEntry> GlobalTrackCacheEntryPointer;
 
+/// Provides access to the GlobalTrackCache.
+///
+/// The cache is partitioned into shards that are locked independently.
+/// The default constructor does not lock anything upfront. Instead each
+/// operation only locks the shards it needs to access for its duration.
 class GlobalTrackCacheLocker {
 public:
     GlobalTrackCacheLocker();
+    /// Keeps the shard of the given track locked until unlocked
+    /// explicitly or going out of scope. While locked the track can
+    /// neither be resolved nor evicted and saved concurrently.
+    explicit GlobalTrackCacheLocker(const TrackRef& trackRef);
     GlobalTrackCacheLocker(const GlobalTrackCacheLocker&) = delete;
     GlobalTrackCacheLocker(GlobalTrackCacheLocker&&);
     virtual ~GlobalTrackCacheLocker();
@@ -119,7 +131,8 @@ public:
   private:
     friend class GlobalTrackCache;
 
-    void lockCache();
+    void lockShard(int shardIndex);
+    void unlockShard();
 
 protected:
     GlobalTrackCacheLocker(
@@ -129,6 +142,9 @@ protected:
             TrackRef&& trackRef);
 
     GlobalTrackCache* m_pInstance;
+
+    // -1 if no shard is locked
+    int m_lockedShardIndex;
 };
 
 class GlobalTrackCacheResolver final: public GlobalTrackCacheLocker {
@@ -185,7 +201,8 @@ private:
     ///
     /// GlobalTrackCache ensures that the given pointer is valid
     /// and the last and only reference to this Track object.
-    /// While invoked the GlobalTrackCache is locked to ensure
+    /// While invoked the shard of the GlobalTrackCache that contains
+    /// this track is locked to ensure
     /// that this particular track is not accessible while
     /// saving the Track object, e.g. by updating the database
     /// and exporting file tags.
@@ -238,6 +255,59 @@ class GlobalTrackCache : public QObject {
     void relocateTracks(
             GlobalTrackCacheRelocator* /*nullable*/ pRelocator);
 
+    // The cache is partitioned into shards to reduce lock contention
+    // between threads. A track is indexed by its id in the shard of
+    // its id and by its canonical location in the shard of its
+    // canonical location.
+    //
+    // Lock hierarchy:
+    //  1. Shard mutexes, managed by GlobalTrackCacheLocker. Only a
+    //     single shard is locked at a time, except for operations on
+    //     the whole cache that lock all shards in ascending order.
+    //  2. Id mutexes. They are only held for short sections. No other
+    //     lock is acquired and no track reference is released while
+    //     holding an id mutex.
+    //
+    // A cached track with an id is only revived or evicted while
+    // holding the id mutex of the shard of its id. lookupById() waits
+    // while an evicted track with the requested id is saved and must
+    // not be invoked while holding a shard mutex on other threads.
+    static constexpr int kShardCount = 16;
+
+    // This caches the unsaved Tracks by ID
+    typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
+
+    // This caches the unsaved Tracks by location
+    typedef QHash<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
+
+    struct Shard {
+        Shard();
+
+        // Guards the tracks that are indexed by their canonical location
+        // in this shard, and tracks without a canonical location that are
+        // indexed by their id in this shard. Saving an evicted track and
+        // allocating a new track require this lock.
+        mutable QT_RECURSIVE_MUTEX mutex;
+        TracksByCanonicalLocation tracksByCanonicalLocation;
+
+        mutable QMutex idMutex;
+        TracksById tracksById;
+        // The ids of evicted tracks that are still being saved by the
+        // thread of the cache. Otherwise the outdated track could be
+        // loaded from the database while saving.
+        QSet<TrackId> savingTrackIds;
+        QWaitCondition trackIdSaved;
+    };
+
+    /// The shard that is locked while resolving, evicting, and saving
+    /// the referenced track.
+    static int shardIndexOf(const TrackRef& trackRef);
+    static int shardIndexOf(const QString& canonicalLocation);
+    static int shardIndexOf(TrackId trackId);
+
+    void lockAllShards() const;
+    void unlockAllShards() const;
+
     TrackPointer lookupById(
             const TrackId& trackId);
     TrackPointer lookupByCanonicalLocation(
@@ -252,6 +322,7 @@ class GlobalTrackCache : public QObject {
 
     QSet<TrackId> getCachedTrackIds() const;
 
+    /// Requires the id mutex of the track if it has an id
     TrackPointer revive(GlobalTrackCacheEntryPointer entryPtr);
 
     void resolve(
@@ -266,7 +337,12 @@ class GlobalTrackCache : public QObject {
 
     void purgeTrackId(TrackId trackId);
 
-    bool tryEvict(Track* plainPtr);
+    /// Marks the id of the evicted track as saving until
+    /// finishSaving() is invoked
+    bool tryEvict(
+            const GlobalTrackCacheEntryPointer& cacheEntryPtr,
+            TrackId* /*out*/ pSavingTrackId);
+    void finishSaving(TrackId trackId);
     bool isCached(Track* plainPtr) const;
 
     bool isEmpty() const;
@@ -275,18 +351,10 @@ class GlobalTrackCache : public QObject {
 
     void saveEvictedTrack(Track* pEvictedTrack) const;
 
-    // Managed by GlobalTrackCacheLocker
-    mutable QT_RECURSIVE_MUTEX m_mutex;
-
+    // Reset while all shards are locked
     GlobalTrackCacheSaver* m_pSaver;
 
     deleteTrackFn_t m_deleteTrackFn;
 
-    // This caches the unsaved Tracks by ID
-    typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
-    TracksById m_tracksById;
-
-    // This caches the unsaved Tracks by location
-    typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
-    TracksByCanonicalLocation m_tracksByCanonicalLocation;
+    std::array<Shard, kShardCount> m_shards;
 };
@@ -128,6 +128,16 @@ TrackPointer Track::newTemporary(
             std::move(fileAccess));
 }
 
+TrackPointer Track::cloneForMetadataExport() const {
+    const auto locked = lockMutex(&m_qMutex);
+    auto pClone = std::make_shared<Track>(m_fileAccess, m_record.getId());
+    pClone->m_record = m_record;
+    pClone->m_bMarkedForMetadataExport = m_bMarkedForMetadataExport;
+    pClone->m_cuePoints = m_cuePoints;
+    pClone->m_pBeats = m_pBeats;
+    return pClone;
+}
+
 //static
 TrackPointer Track::newDummy(
         const QString& filePath,
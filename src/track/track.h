@@ -404,6 +404,12 @@ class Track : public QObject {
     void markForMetadataExport();
     bool isMarkedForMetadataExport() const;
 
+    // Creates a detached copy of an evicted track for exporting its
+    // metadata on a worker thread. The copy is not managed by the
+    // GlobalTrackCache and shares the cue points and the immutable
+    // beats with this track.
+    TrackPointer cloneForMetadataExport() const;
+
     void setAudioProperties(
             mixxx::audio::ChannelCount channelCount,
             mixxx::audio::SampleRate sampleRate,
@@ -0,0 +1,66 @@
+#include "util/audiothreadguard.h"
+
+#include <QHash>
+#include <QSet>
+#include <cstdlib>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define MIXXX_HAVE_BACKTRACE
+#endif
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AudioThreadGuard");
+
+constexpr int kMaxBacktraceFrames = 32;
+
+} // namespace
+
+// static
+std::atomic<bool> AudioThreadGuard::s_enabled{false};
+// static
+std::atomic<quint64> AudioThreadGuard::s_violationCount{0};
+// static
+thread_local int AudioThreadGuard::s_scopeDepth = 0;
+// static
+thread_local int AudioThreadGuard::s_suspendDepth = 0;
+
+// static
+void AudioThreadGuard::reportViolation(const char* what) {
+    s_violationCount.fetch_add(1, std::memory_order_relaxed);
+    // Reporting allocates and locks
+    const Suspend suspend;
+#ifdef MIXXX_HAVE_BACKTRACE
+    void* frames[kMaxBacktraceFrames];
+    const int frameCount = backtrace(frames, kMaxBacktraceFrames);
+    {
+        static QMutex s_reportedMutex;
+        static QSet<size_t> s_reportedBacktraces;
+        const size_t backtraceHash = qHashBits(frames, frameCount * sizeof(void*));
+        const auto locker = lockMutex(&s_reportedMutex);
+        if (s_reportedBacktraces.contains(backtraceHash)) {
+            return;
+        }
+        s_reportedBacktraces.insert(backtraceHash);
+    }
+    kLogger.warning() << "Audio thread is" << what;
+    char** symbols = backtrace_symbols(frames, frameCount);
+    if (symbols) {
+        // Skip the frames of the guard itself
+        for (int i = 1; i < frameCount; ++i) {
+            kLogger.warning() << "  " << symbols[i];
+        }
+        std::free(symbols);
+    }
+#else
+    kLogger.warning() << "Audio thread is" << what;
+#endif
+}
+
+} // namespace mixxx
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+
+namespace mixxx {
+
+// Detects heap allocations and lock waits on the audio thread that may
+// cause xruns.
+//
+// The code that runs in the audio callback is marked by a Scope. Only
+// if Mixxx is built with AUDIO_THREAD_GUARD the functions malloc(), free()
+// and pthread_mutex_lock() are intercepted and every violation within a
+// Scope is logged together with a backtrace. The same backtrace is only
+// logged once. Otherwise all checks compile to nothing.
+class AudioThreadGuard {
+  public:
+    // Marks the current thread as the audio thread. Scopes may be nested.
+    class Scope {
+      public:
+        Scope() {
+#ifdef __AUDIO_THREAD_GUARD__
+            ++s_scopeDepth;
+#endif
+        }
+        ~Scope() {
+#ifdef __AUDIO_THREAD_GUARD__
+            --s_scopeDepth;
+#endif
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Temporarily tolerates violations within a Scope, e.g. for code
+    // that is known to allocate and is going to be fixed.
+    class Suspend {
+      public:
+        Suspend() {
+#ifdef __AUDIO_THREAD_GUARD__
+            ++s_suspendDepth;
+#endif
+        }
+        ~Suspend() {
+#ifdef __AUDIO_THREAD_GUARD__
+            --s_suspendDepth;
+#endif
+        }
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+    };
+
+    static void setEnabled(bool enabled) {
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    // True while the current thread is within a Scope and violations
+    // are reported
+    static bool isActive() {
+#ifdef __AUDIO_THREAD_GUARD__
+        return s_scopeDepth > 0 && s_suspendDepth == 0 &&
+                s_enabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+
+    // The total number of violations, including those that have not
+    // been logged again because of a duplicate backtrace
+    static quint64 violationCount() {
+        return s_violationCount.load(std::memory_order_relaxed);
+    }
+
+    // Reports a lock wait if the mutex is currently locked by another
+    // thread. The mutex is not locked afterwards.
+    template<typename Mutex>
+    static void checkLock(Mutex* pMutex) {
+        if (!isActive()) {
+            return;
+        }
+        if (pMutex->tryLock()) {
+            pMutex->unlock();
+        } else {
+            reportViolation("waiting for a locked QMutex");
+        }
+    }
+
+    // Called by the intercepted functions of the C library. Must not
+    // allocate any memory unless a violation is reported.
+    static void reportViolation(const char* what);
+
+  private:
+    static std::atomic<bool> s_enabled;
+    static std::atomic<quint64> s_violationCount;
+    static thread_local int s_scopeDepth;
+    static thread_local int s_suspendDepth;
+};
+
+} // namespace mixxx
@@ -0,0 +1,117 @@
+// Replaces functions of the C library for AudioThreadGuard. Only linked
+// into executables if Mixxx is built with AUDIO_THREAD_GUARD.
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstddef>
+
+#include "util/audiothreadguard.h"
+
+#ifndef __GLIBC__
+#error "AUDIO_THREAD_GUARD requires the GNU C library"
+#endif
+
+namespace {
+
+using MutexLockFunction = int (*)(pthread_mutex_t*);
+
+// Resolved once while loading the executable instead of on the first
+// call, because dlsym() may lock a mutex itself
+MutexLockFunction s_realMutexLock = nullptr;
+
+__attribute__((constructor)) void resolveRealMutexLock() {
+    s_realMutexLock = reinterpret_cast<MutexLockFunction>(
+            dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+}
+
+} // anonymous namespace
+
+extern "C" {
+
+// The implementations of glibc that are replaced
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (malloc)");
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (calloc)");
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (realloc)");
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (memalign)");
+    }
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (aligned_alloc)");
+    }
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pPtr, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    if (mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("allocating memory (posix_memalign)");
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *pPtr = ptr;
+    return 0;
+}
+
+void free(void* ptr) {
+    if (ptr && mixxx::AudioThreadGuard::isActive()) {
+        mixxx::AudioThreadGuard::reportViolation("freeing memory (free)");
+    }
+    __libc_free(ptr);
+}
+
+// Only waiting for a mutex that is locked by another thread is reported
+int pthread_mutex_lock(pthread_mutex_t* pMutex) {
+    if (mixxx::AudioThreadGuard::isActive()) {
+        if (pthread_mutex_trylock(pMutex) == 0) {
+            return 0;
+        }
+        mixxx::AudioThreadGuard::reportViolation("waiting for a locked pthread mutex");
+    }
+    if (!s_realMutexLock) {
+        // Only before or while resolving the real function
+        int result;
+        while ((result = pthread_mutex_trylock(pMutex)) == EBUSY) {
+            sched_yield();
+        }
+        return result;
+    }
+    return s_realMutexLock(pMutex);
+}
+
+} // extern "C"
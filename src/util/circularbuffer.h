@@ -3,6 +3,8 @@
 #include <cstdlib>
 #include <vector>
 
+#include "util/assert.h"
+
 // CircularBuffer is a basic implementation of a constant-length circular
 // buffer.
 //
@@ -44,6 +46,39 @@ class CircularBuffer {
         return m_iLength;
     }
 
+    // Returns the number of items in the CircularBuffer
+    inline unsigned int size() const {
+        return (m_iWritePos + m_iLength - m_iReadPos) % m_iLength;
+    }
+
+    // The oldest item. The buffer must not be empty.
+    inline T& front() {
+        DEBUG_ASSERT(!isEmpty());
+        return m_pBuffer[m_iReadPos];
+    }
+
+    // The newest item. The buffer must not be empty.
+    inline T& back() {
+        DEBUG_ASSERT(!isEmpty());
+        return m_pBuffer[(m_iWritePos + m_iLength - 1) % m_iLength];
+    }
+
+    // Appends a single item. Returns false if the buffer is full.
+    bool push(const T& item) {
+        if (m_pBuffer.empty() || isFull()) {
+            return false;
+        }
+        m_pBuffer[m_iWritePos] = item;
+        m_iWritePos = (m_iWritePos + 1) % m_iLength;
+        return true;
+    }
+
+    // Removes the oldest item. The buffer must not be empty.
+    inline void pop() {
+        DEBUG_ASSERT(!isEmpty());
+        m_iReadPos = (m_iReadPos + 1) % m_iLength;
+    }
+
     // Write numItems into the CircularBuffer. Returns the total number of
     // items written, which could be less than numItems if the buffer becomes
     // full.
@@ -27,6 +27,7 @@ CmdlineArgs::CmdlineArgs()
           m_debugAssertBreak(false),
           m_settingsPathSet(false),
           m_scaleFactor(1.0),
+          m_renderDurationSeconds(0),
           m_useColors(false),
           m_parseForUserFeedbackRequired(false),
           m_logLevel(mixxx::kLogLevelDefault),
@@ -172,6 +173,24 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(timelinePath);
     parser.addOption(timelinePathDeprecated);
 
+    const QCommandLineOption renderOffline(QStringLiteral("render-offline"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Render the mix of the specified music files into a "
+                                      "WAV, AIFF or FLAC file without opening an audio device "
+                                      "or a window and quit afterwards.")
+                            : QString(),
+            QStringLiteral("path"));
+    parser.addOption(renderOffline);
+
+    const QCommandLineOption renderDuration(QStringLiteral("render-duration"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "The duration in seconds that is rendered with "
+                                      "--render-offline. Default: until all decks have "
+                                      "stopped playing.")
+                            : QString(),
+            QStringLiteral("seconds"));
+    parser.addOption(renderDuration);
+
     const QCommandLineOption enableVuMeterGL(QStringLiteral("enable-vumetergl"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Use OpenGL vu meter")
@@ -338,6 +357,18 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(renderOffline)) {
+        m_renderOfflinePath = parser.value(renderOffline);
+    }
+    if (parser.isSet(renderDuration)) {
+        bool ok = false;
+        m_renderDurationSeconds = parser.value(renderDuration).toDouble(&ok);
+        if (!ok || m_renderDurationSeconds <= 0) {
+            fputs("\nrender-duration must be a positive number of seconds!\n", stdout);
+            m_renderDurationSeconds = 0;
+        }
+    }
+
     m_useVuMeterGL = parser.isSet(enableVuMeterGL);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
     m_controllerAbortOnWarning = parser.isSet(controllerAbortOnWarning);
@@ -58,6 +58,17 @@ class CmdlineArgs final {
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
 
+    bool getRenderOffline() const {
+        return !m_renderOfflinePath.isEmpty();
+    }
+    const QString& getRenderOfflinePath() const {
+        return m_renderOfflinePath;
+    }
+    /// 0 if not set on the command line
+    double getRenderDurationSeconds() const {
+        return m_renderDurationSeconds;
+    }
+
     void setScaleFactor(double scaleFactor) {
         m_scaleFactor = scaleFactor;
     }
@@ -83,6 +94,7 @@ class CmdlineArgs final {
     bool m_debugAssertBreak;
     bool m_settingsPathSet; // has --settingsPath been set on command line ?
     double m_scaleFactor;
+    double m_renderDurationSeconds;
     bool m_useColors;       // should colors be used
     bool m_parseForUserFeedbackRequired;
     mixxx::LogLevel m_logLevel; // Level of stderr logging message verbosity
@@ -91,4 +103,5 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_renderOfflinePath;
 };
@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -22,6 +23,8 @@ namespace {
 
 const mixxx::Logger kLogger("DbConnection");
 
+const QString kSqliteDriverName = QStringLiteral("QSQLITE");
+
 QSqlDatabase createDatabase(
         const DbConnection::Params& params,
         const QString& connectionName) {
@@ -41,9 +44,90 @@ QSqlDatabase createDatabase(
 
 QSqlDatabase cloneDatabase(
         const QSqlDatabase& database,
-        const QString& connectionName) {
+        const QString& connectionName,
+        DbConnection::AccessMode accessMode) {
     DEBUG_ASSERT(!database.isOpen());
-    return QSqlDatabase::cloneDatabase(database, connectionName);
+    QSqlDatabase clonedDatabase =
+            QSqlDatabase::cloneDatabase(database, connectionName);
+    if (accessMode == DbConnection::AccessMode::ReadOnly &&
+            clonedDatabase.driverName() == kSqliteDriverName) {
+        QString connectOptions = clonedDatabase.connectOptions();
+        if (!connectOptions.isEmpty()) {
+            connectOptions += QChar(';');
+        }
+        connectOptions += QStringLiteral("QSQLITE_OPEN_READONLY");
+        clonedDatabase.setConnectOptions(connectOptions);
+    }
+    return clonedDatabase;
+}
+
+bool execPragma(
+        const QSqlDatabase& database,
+        const QString& statement,
+        QString* pResult = nullptr) {
+    QSqlQuery query(database);
+    if (!query.exec(statement)) {
+        kLogger.warning()
+                << "Failed to execute"
+                << statement
+                << query.lastError();
+        return false;
+    }
+    if (pResult && query.next()) {
+        *pResult = query.value(0).toString();
+    }
+    return true;
+}
+
+void applyTuning(
+        const QSqlDatabase& database,
+        const DbConnection::Tuning& tuning,
+        DbConnection::AccessMode accessMode) {
+    DEBUG_ASSERT(database.isOpen());
+    if (database.driverName() != kSqliteDriverName) {
+        return;
+    }
+    if (tuning.busyTimeoutMillis > 0) {
+        // Must be set first, switching the journal mode requires
+        // an exclusive lock
+        execPragma(database,
+                QStringLiteral("PRAGMA busy_timeout=%1")
+                        .arg(tuning.busyTimeoutMillis));
+    }
+    // The journal mode is stored in the database file and could
+    // only be changed by a writer
+    if (!tuning.journalMode.isEmpty() &&
+            accessMode == DbConnection::AccessMode::ReadWrite) {
+        QString journalMode;
+        if (execPragma(database,
+                    QStringLiteral("PRAGMA journal_mode=%1")
+                            .arg(tuning.journalMode),
+                    &journalMode) &&
+                journalMode.compare(tuning.journalMode, Qt::CaseInsensitive) != 0) {
+            // In-memory databases don't support WAL
+            kLogger.info()
+                    << "Using journal mode"
+                    << journalMode
+                    << "instead of"
+                    << tuning.journalMode;
+        }
+    }
+    if (!tuning.synchronous.isEmpty()) {
+        execPragma(database,
+                QStringLiteral("PRAGMA synchronous=%1")
+                        .arg(tuning.synchronous));
+    }
+    if (tuning.cacheSizeKiB > 0) {
+        // Negative values are interpreted as KiB instead of pages
+        execPragma(database,
+                QStringLiteral("PRAGMA cache_size=-%1")
+                        .arg(tuning.cacheSizeKiB));
+    }
+    if (tuning.mmapSizeBytes > 0) {
+        execPragma(database,
+                QStringLiteral("PRAGMA mmap_size=%1")
+                        .arg(tuning.mmapSizeBytes));
+    }
 }
 
 void removeDatabase(
@@ -317,13 +401,18 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_tuning(params.tuning),
+      m_accessMode(AccessMode::ReadWrite) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
-        const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+        const QString& connectionName,
+        AccessMode accessMode)
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName, accessMode)),
+      m_tuning(prototype.m_tuning),
+      m_accessMode(accessMode) {
 }
 
 DbConnection::~DbConnection() {
@@ -351,11 +440,15 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    applyTuning(m_sqlDatabase, m_tuning, m_accessMode);
+    m_statementCache.attach(m_sqlDatabase.connectionName());
     return true;
 }
 
 void DbConnection::close() {
     if (m_sqlDatabase.isOpen()) {
+        // Cached statements must not outlive the connection
+        m_statementCache.detach();
         // There should never be an outstanding transaction when this code is
         // called. If there is, it means we probably aren't committing a
         // transaction somewhere that should be.
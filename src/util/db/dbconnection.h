@@ -3,6 +3,7 @@
 #include <QSqlDatabase>
 #include <QtDebug>
 
+#include "util/db/sqlstatementcache.h"
 #include "util/string.h"
 
 namespace mixxx {
@@ -22,6 +23,23 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // Settings that are applied to each connection after opening it.
+    // Only supported by SQLite and ignored for other database types.
+    // Empty or zero values keep the defaults of the database.
+    struct Tuning {
+        // Persistent for the database file. WAL allows concurrent
+        // readers while a single writer is active.
+        QString journalMode;
+        QString synchronous;
+        // Size of the page cache per connection
+        int cacheSizeKiB = 0;
+        // Size of the memory-mapped I/O region per connection
+        qint64 mmapSizeBytes = 0;
+        // How long to wait for a lock that is held by another connection
+        // before failing with SQLITE_BUSY
+        int busyTimeoutMillis = 0;
+    };
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +47,15 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        Tuning tuning;
+    };
+
+    enum class AccessMode {
+        ReadWrite,
+        // Rejects all writes except to temporary tables and views.
+        // Readers in WAL mode neither block nor are blocked by the
+        // writers of other connections.
+        ReadOnly,
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -37,7 +64,8 @@ class DbConnection final {
             const QString& connectionName);
     DbConnection(
             const DbConnection& prototype,
-            const QString& connectionName);
+            const QString& connectionName,
+            AccessMode accessMode = AccessMode::ReadWrite);
     ~DbConnection();
 
     QString name() const {
@@ -51,6 +79,10 @@ class DbConnection final {
         return m_sqlDatabase.isOpen();
     }
 
+    AccessMode accessMode() const {
+        return m_accessMode;
+    }
+
     operator QSqlDatabase() const {
         return m_sqlDatabase;
     }
@@ -62,7 +94,10 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    Tuning m_tuning;
+    AccessMode m_accessMode;
     mixxx::StringCollator m_collator;
+    SqlStatementCache m_statementCache;
 };
 
 } // namespace mixxx
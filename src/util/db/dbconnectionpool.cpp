@@ -11,12 +11,15 @@ const Logger kLogger("DbConnectionPool");
 
 } // anonymous namespace
 
-bool DbConnectionPool::createThreadLocalConnection() {
-    VERIFY_OR_DEBUG_ASSERT(!m_threadLocalConnections.hasLocalData()) {
-        DEBUG_ASSERT(m_threadLocalConnections.localData());
+bool DbConnectionPool::createThreadLocalConnection(
+        DbConnection::AccessMode accessMode) {
+    QThreadStorage<DbConnection*>& connections =
+            threadLocalConnections(accessMode);
+    VERIFY_OR_DEBUG_ASSERT(!connections.hasLocalData()) {
+        DEBUG_ASSERT(connections.localData());
         kLogger.critical()
                 << "Thread-local database connection already exists"
-                << *m_threadLocalConnections.localData();
+                << *connections.localData();
         return false; // abort
     }
     const int connectionIndex =
@@ -25,7 +28,8 @@ bool DbConnectionPool::createThreadLocalConnection() {
             QString("%1-%2").arg(
                     m_prototypeConnection.name(),
                     QString::number(connectionIndex));
-    auto pConnection = std::make_unique<DbConnection>(m_prototypeConnection, indexedConnectionName);
+    auto pConnection = std::make_unique<DbConnection>(
+            m_prototypeConnection, indexedConnectionName, accessMode);
     if (!pConnection->open()) {
         kLogger.critical()
                 << "Failed to open thread-local database connection"
@@ -33,23 +37,30 @@ bool DbConnectionPool::createThreadLocalConnection() {
         return false; // abort
     }
 
-    // m_threadLocalConnections takes the ownership of pConnection
-    m_threadLocalConnections.setLocalData(pConnection.release());
+    // connections takes the ownership of pConnection
+    connections.setLocalData(pConnection.release());
 
-    DEBUG_ASSERT(m_threadLocalConnections.hasLocalData());
-    DEBUG_ASSERT(m_threadLocalConnections.localData());
+    DEBUG_ASSERT(connections.hasLocalData());
+    DEBUG_ASSERT(connections.localData());
     kLogger.info()
-            << "Cloned thread-local database connection"
-            << *m_threadLocalConnections.localData();
+            << "Cloned thread-local"
+            << (accessMode == DbConnection::AccessMode::ReadOnly
+                               ? "read-only"
+                               : "read-write")
+            << "database connection"
+            << *connections.localData();
     return true;
 }
 
-void DbConnectionPool::destroyThreadLocalConnection() {
-    VERIFY_OR_DEBUG_ASSERT(m_threadLocalConnections.hasLocalData()) {
+void DbConnectionPool::destroyThreadLocalConnection(
+        DbConnection::AccessMode accessMode) {
+    QThreadStorage<DbConnection*>& connections =
+            threadLocalConnections(accessMode);
+    VERIFY_OR_DEBUG_ASSERT(connections.hasLocalData()) {
         kLogger.critical()
                 << "Thread-local database connection not found";
     }
-    m_threadLocalConnections.setLocalData(nullptr);
+    connections.setLocalData(nullptr);
 }
 
 DbConnectionPool::DbConnectionPool(
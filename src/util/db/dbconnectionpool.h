@@ -34,8 +34,17 @@ class DbConnectionPool final {
     // Prefer to use DbConnectionPooler instead of the
     // following functions. Only if there is no appropriate
     // scoping possible then use these functions directly.
-    bool createThreadLocalConnection();
-    void destroyThreadLocalConnection();
+    //
+    // Each thread owns at most one connection per access mode. The
+    // read-write connection is the only writer of a thread. Threads
+    // that display the contents of the database, i.e. the GUI thread,
+    // additionally query through a read-only connection. In WAL mode
+    // these readers see a consistent snapshot and are not blocked
+    // while other threads are writing.
+    bool createThreadLocalConnection(
+            DbConnection::AccessMode accessMode = DbConnection::AccessMode::ReadWrite);
+    void destroyThreadLocalConnection(
+            DbConnection::AccessMode accessMode = DbConnection::AccessMode::ReadWrite);
 
   private:
     DbConnectionPool(const DbConnectionPool&) = delete;
@@ -50,8 +59,22 @@ class DbConnectionPool final {
     // to be created through DbConnectionPooler the latter case should
     // never happen.
     friend class DbConnectionPooled;
-    const DbConnection* threadLocalConnection() const {
-        return m_threadLocalConnections.localData();
+    const DbConnection* threadLocalConnection(
+            DbConnection::AccessMode accessMode) const {
+        return threadLocalConnections(accessMode).localData();
+    }
+
+    QThreadStorage<DbConnection*>& threadLocalConnections(
+            DbConnection::AccessMode accessMode) {
+        return accessMode == DbConnection::AccessMode::ReadOnly
+                ? m_threadLocalReadOnlyConnections
+                : m_threadLocalConnections;
+    }
+    const QThreadStorage<DbConnection*>& threadLocalConnections(
+            DbConnection::AccessMode accessMode) const {
+        return accessMode == DbConnection::AccessMode::ReadOnly
+                ? m_threadLocalReadOnlyConnections
+                : m_threadLocalConnections;
     }
 
     const DbConnection m_prototypeConnection;
@@ -59,7 +82,7 @@ class DbConnectionPool final {
     QAtomicInt m_connectionCounter;
 
     QThreadStorage<DbConnection*> m_threadLocalConnections;
-
+    QThreadStorage<DbConnection*> m_threadLocalReadOnlyConnections;
 };
 
 } // namespace mixxx
@@ -17,7 +17,7 @@ DbConnectionPooled::operator QSqlDatabase() const {
                 << "No connection pool";
         return QSqlDatabase(); // abort
     }
-    const DbConnection* pDbConnection = m_pDbConnectionPool->threadLocalConnection();
+    const DbConnection* pDbConnection = m_pDbConnectionPool->threadLocalConnection(m_accessMode);
     // The return pointer is at least valid until leaving this
     // function, because only the current thread is able to
     // remove this connection from the pool.
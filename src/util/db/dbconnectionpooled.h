@@ -12,8 +12,10 @@ namespace mixxx {
 class DbConnectionPooled final {
   public:
     explicit DbConnectionPooled(
-            DbConnectionPoolPtr pDbConnectionPool = DbConnectionPoolPtr())
-        : m_pDbConnectionPool(std::move(pDbConnectionPool)) {
+            DbConnectionPoolPtr pDbConnectionPool = DbConnectionPoolPtr(),
+            DbConnection::AccessMode accessMode = DbConnection::AccessMode::ReadWrite)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_accessMode(accessMode) {
     }
 
     // Checks if this instance actually references a connection pool
@@ -35,6 +37,7 @@ class DbConnectionPooled final {
 
   private:
     DbConnectionPoolPtr m_pDbConnectionPool;
+    DbConnection::AccessMode m_accessMode;
 };
 
 } // namespace mixxx
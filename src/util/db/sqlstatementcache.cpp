@@ -0,0 +1,161 @@
+#include "util/db/sqlstatementcache.h"
+
+#include <QHash>
+#include <QSqlError>
+
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SqlStatementCache");
+
+// Connections are thread-local and so are their caches
+thread_local QHash<QString, SqlStatementCache*> s_cachesByConnectionName;
+
+// Summed up for all connections
+Counter s_hitCounter(QStringLiteral("SqlStatementCache: hit"));
+Counter s_missCounter(QStringLiteral("SqlStatementCache: miss"));
+
+} // anonymous namespace
+
+SqlStatementCache::SqlStatementCache(int capacity)
+        : m_capacity(capacity),
+          m_usageCounter(0),
+          m_hitCount(0),
+          m_missCount(0) {
+    DEBUG_ASSERT(m_capacity > 0);
+}
+
+SqlStatementCache::~SqlStatementCache() {
+    DEBUG_ASSERT(m_connectionName.isEmpty());
+    detach();
+}
+
+// static
+SqlStatementCache* SqlStatementCache::forDatabase(const QSqlDatabase& database) {
+    return s_cachesByConnectionName.value(database.connectionName(), nullptr);
+}
+
+void SqlStatementCache::attach(const QString& connectionName) {
+    DEBUG_ASSERT(m_connectionName.isEmpty());
+    DEBUG_ASSERT(!s_cachesByConnectionName.contains(connectionName));
+    m_connectionName = connectionName;
+    s_cachesByConnectionName.insert(m_connectionName, this);
+}
+
+void SqlStatementCache::detach() {
+    if (m_connectionName.isEmpty()) {
+        return;
+    }
+    DEBUG_ASSERT(s_cachesByConnectionName.value(m_connectionName) == this);
+    s_cachesByConnectionName.remove(m_connectionName);
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Discarding"
+                << m_entries.size()
+                << "statement(s) of connection"
+                << m_connectionName
+                << "after"
+                << m_hitCount
+                << "hit(s) and"
+                << m_missCount
+                << "miss(es)";
+    }
+    m_connectionName.clear();
+    m_entries.clear();
+}
+
+std::unique_ptr<QSqlQuery> SqlStatementCache::take(const QString& statement) {
+    const auto it = m_entries.find(statement);
+    if (it == m_entries.end() || !it->second.pQuery) {
+        ++m_missCount;
+        s_missCounter.increment();
+        return nullptr;
+    }
+    ++m_hitCount;
+    s_hitCounter.increment();
+    it->second.lastUsed = ++m_usageCounter;
+    return std::move(it->second.pQuery);
+}
+
+void SqlStatementCache::put(
+        const QString& statement,
+        std::unique_ptr<QSqlQuery> pQuery) {
+    DEBUG_ASSERT(pQuery);
+    // Release the read lock of an active SELECT statement
+    pQuery->finish();
+    // Values of the previous execution must not leak into the next one
+    const int boundValueCount = static_cast<int>(pQuery->boundValues().size());
+    for (int i = 0; i < boundValueCount; ++i) {
+        pQuery->bindValue(i, QVariant());
+    }
+    auto it = m_entries.find(statement);
+    if (it != m_entries.end()) {
+        if (!it->second.pQuery) {
+            it->second.pQuery = std::move(pQuery);
+        }
+        // Otherwise discard the redundant statement
+        return;
+    }
+    if (static_cast<int>(m_entries.size()) >= m_capacity) {
+        // Evict the least recently used statement that is not borrowed
+        auto lruIt = m_entries.end();
+        for (auto entryIt = m_entries.begin(); entryIt != m_entries.end(); ++entryIt) {
+            if (entryIt->second.pQuery &&
+                    (lruIt == m_entries.end() ||
+                            entryIt->second.lastUsed < lruIt->second.lastUsed)) {
+                lruIt = entryIt;
+            }
+        }
+        if (lruIt == m_entries.end()) {
+            return;
+        }
+        m_entries.erase(lruIt);
+    }
+    Entry entry;
+    entry.pQuery = std::move(pQuery);
+    entry.lastUsed = ++m_usageCounter;
+    m_entries.emplace(statement, std::move(entry));
+}
+
+CachedSqlQuery::CachedSqlQuery(
+        const QSqlDatabase& database,
+        const QString& statement)
+        : m_connectionName(database.connectionName()),
+          m_statement(statement),
+          m_prepared(false) {
+    SqlStatementCache* pCache = SqlStatementCache::forDatabase(database);
+    if (pCache) {
+        m_pQuery = pCache->take(m_statement);
+    }
+    if (m_pQuery) {
+        m_prepared = true;
+        return;
+    }
+    m_pQuery = std::make_unique<QSqlQuery>(database);
+    m_prepared = m_pQuery->prepare(m_statement);
+    if (!m_prepared) {
+        kLogger.warning()
+                << "Failed to prepare"
+                << m_statement
+                << m_pQuery->lastError();
+    }
+}
+
+CachedSqlQuery::~CachedSqlQuery() {
+    if (!m_prepared) {
+        return;
+    }
+    // Look up the cache again, the connection might have been closed
+    SqlStatementCache* pCache =
+            s_cachesByConnectionName.value(m_connectionName, nullptr);
+    if (pCache) {
+        pCache->put(m_statement, std::move(m_pQuery));
+    }
+}
+
+} // namespace mixxx
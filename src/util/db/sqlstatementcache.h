@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <map>
+#include <memory>
+
+namespace mixxx {
+
+/// Reuses the prepared statements of a single database connection
+/// instead of parsing the same SQL text again for every execution.
+///
+/// Every open DbConnection owns a cache that is registered for the
+/// thread that opened it. Statements are borrowed through CachedSqlQuery
+/// and returned when the borrowing instance goes out of scope.
+///
+/// Only intended for statements with a constant SQL text that are
+/// executed frequently. The hits and misses of all caches are reported
+/// to the StatsManager. The least recently used statements are discarded
+/// when the capacity is exceeded.
+///
+/// Not thread-safe! Must only be used by the thread that owns the
+/// connection.
+class SqlStatementCache final {
+  public:
+    static constexpr int kDefaultCapacity = 64;
+
+    explicit SqlStatementCache(int capacity = kDefaultCapacity);
+    ~SqlStatementCache();
+
+    /// Returns the cache of a connection that has been opened by the
+    /// current thread or nullptr if none is available.
+    static SqlStatementCache* forDatabase(const QSqlDatabase& database);
+
+    /// Registers the cache for a connection of the current thread.
+    void attach(const QString& connectionName);
+    /// Unregisters the cache and discards all cached statements. Must
+    /// be invoked before closing the connection.
+    void detach();
+
+    int size() const {
+        return static_cast<int>(m_entries.size());
+    }
+
+    quint64 hitCount() const {
+        return m_hitCount;
+    }
+    quint64 missCount() const {
+        return m_missCount;
+    }
+
+  private:
+    friend class CachedSqlQuery;
+
+    // Returns nullptr if the statement is either not cached or
+    // currently borrowed
+    std::unique_ptr<QSqlQuery> take(const QString& statement);
+    void put(const QString& statement, std::unique_ptr<QSqlQuery> pQuery);
+
+    struct Entry {
+        std::unique_ptr<QSqlQuery> pQuery;
+        quint64 lastUsed = 0;
+    };
+
+    const int m_capacity;
+    QString m_connectionName;
+    std::map<QString, Entry> m_entries;
+    quint64 m_usageCounter;
+    quint64 m_hitCount;
+    quint64 m_missCount;
+};
+
+/// A prepared QSqlQuery that is borrowed from the SqlStatementCache of
+/// the database connection.
+///
+/// The statement is finished, its bound values are reset and it is
+/// returned to the cache on destruction. A new statement is prepared if
+/// no cache is available or if the same statement is already borrowed,
+/// e.g. by a recursive invocation.
+class CachedSqlQuery final {
+  public:
+    CachedSqlQuery(
+            const QSqlDatabase& database,
+            const QString& statement);
+    CachedSqlQuery(const CachedSqlQuery&) = delete;
+    CachedSqlQuery(CachedSqlQuery&&) = delete;
+    ~CachedSqlQuery();
+
+    bool isPrepared() const {
+        return m_prepared;
+    }
+
+    QSqlQuery* get() const {
+        return m_pQuery.get();
+    }
+    QSqlQuery* operator->() const {
+        return m_pQuery.get();
+    }
+    QSqlQuery& operator*() const {
+        return *m_pQuery;
+    }
+
+    CachedSqlQuery& operator=(const CachedSqlQuery&) = delete;
+    CachedSqlQuery& operator=(CachedSqlQuery&&) = delete;
+
+  private:
+    const QString m_connectionName;
+    const QString m_statement;
+    std::unique_ptr<QSqlQuery> m_pQuery;
+    bool m_prepared;
+};
+
+} // namespace mixxx
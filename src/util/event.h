@@ -5,6 +5,7 @@
 
 #include "util/stat.h"
 #include "util/duration.h"
+#include "util/tracering.h"
 
 class Event {
   public:
@@ -18,8 +19,23 @@ class Event {
     EventType m_type;
     mixxx::Duration m_time;
 
+    // Events are recorded by mixxx::Tracing. Prefer recording events with
+    // a mixxx::TraceTag directly, because interning the tag requires a
+    // lookup on every call.
     static bool event(const QString& tag, Event::EventType type = Stat::EVENT) {
-        return Stat::track(tag, type, Stat::experimentFlags(Stat::COUNT), 0.0);
+        if (!mixxx::Tracing::isEnabled()) {
+            return false;
+        }
+        const auto traceTag = mixxx::TraceTag::intern(tag);
+        const auto compute = Stat::experimentFlags(Stat::COUNT);
+        switch (type) {
+        case Stat::EVENT_START:
+            return mixxx::Tracing::begin(traceTag, compute);
+        case Stat::EVENT_END:
+            return mixxx::Tracing::end(traceTag, compute);
+        default:
+            return mixxx::Tracing::instant(traceTag, compute);
+        }
     }
 
     static bool start(const QString& tag) {
@@ -0,0 +1,43 @@
+#include "util/physicalmemory.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_MAC)
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+namespace mixxx {
+
+// static
+quint64 PhysicalMemory::totalBytes() {
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) {
+        return 0;
+    }
+    return status.ullTotalPhys;
+#elif defined(Q_OS_MAC)
+    int mib[2] = {CTL_HW, HW_MEMSIZE};
+    uint64_t memSize = 0;
+    size_t length = sizeof(memSize);
+    if (sysctl(mib, 2, &memSize, &length, nullptr, 0) != 0) {
+        return 0;
+    }
+    return memSize;
+#elif defined(Q_OS_UNIX)
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) {
+        return 0;
+    }
+    return static_cast<quint64>(pages) * static_cast<quint64>(pageSize);
+#else
+    return 0;
+#endif
+}
+
+} // namespace mixxx
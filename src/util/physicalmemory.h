@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QtGlobal>
+
+namespace mixxx {
+
+class PhysicalMemory {
+  public:
+    /// Returns the total size of the physical memory in bytes or 0 if
+    /// it could not be determined. Should be used for sizing caches
+    /// once during startup, it is not intended to be polled.
+    static quint64 totalBytes();
+};
+
+} // namespace mixxx
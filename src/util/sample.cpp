@@ -5,6 +5,7 @@
 
 #include "engine/engine.h"
 #include "util/math.h"
+#include "util/samplekernels.h"
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -20,6 +21,10 @@ typedef qint32 int32_t;
 // using scons optimize=native.
 // "SINT i" is the preferred loop index type that should allow vectorization in
 // general. Unfortunately there are exceptions where "int i" is required for some reasons.
+//
+// The loops of the hot functions are dispatched to mixxx::SampleKernels,
+// which provides hand-written AVX2, AVX-512 and NEON versions selected at
+// runtime. Their scalar fallbacks are the former loops from this file.
 
 namespace {
 
@@ -250,10 +255,7 @@ void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc[i] * gain;
-    }
+    mixxx::SampleKernels::active().addWithGain(pDest, pSrc, gain, numSamples);
 }
 
 void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
@@ -266,19 +268,12 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
 
     const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
             / CSAMPLE_GAIN(numSamples / 2);
+    const auto& kernels = mixxx::SampleKernels::active();
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        kernels.addWithRampingGain(pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pDest[i] += pSrc[i] * old_gain;
-        }
+        kernels.addWithGain(pDest, pSrc, old_gain, numSamples);
     }
 }
 
@@ -295,10 +290,8 @@ void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
-    }
+    mixxx::SampleKernels::active().add2WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
 }
 
 // static
@@ -318,10 +311,8 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
-    }
+    mixxx::SampleKernels::active().add3WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);
 }
 
 // static
@@ -337,10 +328,7 @@ void SampleUtil::copyWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = pSrc[i] * gain;
-    }
+    mixxx::SampleKernels::active().copyWithGain(pDest, pSrc, gain, numSamples);
 
     // OR! need to test which fares better
     // copy(pDest, pSrc, iNumSamples);
@@ -364,19 +352,12 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
 
     const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
             / CSAMPLE_GAIN(numSamples / 2);
+    const auto& kernels = mixxx::SampleKernels::active();
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i)
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        kernels.copyWithRampingGain(pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
-        // note: LOOP VECTORIZED.
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = pSrc[i] * old_gain;
-        }
+        kernels.copyWithGain(pDest, pSrc, old_gain, numSamples);
     }
 
     // OR! need to test which fares better
@@ -391,11 +372,7 @@ void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
     // is the highest valid sample. Note that this means that although some
     // sample values convert to -1.0, none will convert to +1.0.
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
-    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
-    }
+    mixxx::SampleKernels::active().convertS16ToFloat32(pDest, pSrc, numSamples);
 }
 
 //static
@@ -416,29 +393,14 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
+    const int clipped = mixxx::SampleKernels::active().sumAbsPerChannel(
+            pfAbsL, pfAbsR, pBuffer, numSamples / 2);
 
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
     SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
-    if (clippedL > 0) {
+    if (clipped & mixxx::SampleKernels::kClippedLeft) {
         clipping |= SampleUtil::CLIPPING_LEFT;
     }
-    if (clippedR > 0) {
+    if (clipped & mixxx::SampleKernels::kClippedRight) {
         clipping |= SampleUtil::CLIPPING_RIGHT;
     }
     return clipping;
@@ -485,11 +447,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    mixxx::SampleKernels::active().interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -497,11 +455,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    mixxx::SampleKernels::active().deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -669,3 +623,59 @@ void SampleUtil::copyReverse(CSAMPLE* M_RESTRICT pDest,
         pDest[j * 2 + 1] = pSrc[endpos];
     }
 }
+
+// static
+void SampleUtil::copyWithGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    mixxx::SampleKernels::active().copyWithGain(pDest, pSrc, gain, numSamples);
+}
+
+// static
+void SampleUtil::copy2WithGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    mixxx::SampleKernels::active().copy2WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, numSamples);
+}
+
+// static
+void SampleUtil::copy3WithGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    mixxx::SampleKernels::active().copy3WithGain(
+            pDest, pSrc1, gain1, pSrc2, gain2, pSrc3, gain3, numSamples);
+}
+
+// static
+void SampleUtil::copyWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    mixxx::SampleKernels::active().copyWithRampingGain(
+            pDest, pSrc, startGain, gainDelta, numFrames);
+}
+
+// static
+void SampleUtil::copy2WithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    mixxx::SampleKernels::active().copy2WithRampingGain(pDest,
+            pSrc1, startGain1, gainDelta1,
+            pSrc2, startGain2, gainDelta2, numFrames);
+}
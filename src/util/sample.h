@@ -313,6 +313,41 @@ class SampleUtil {
     // Include auto-generated methods (e.g. copyXWithGain, copyXWithRampingGain,
     // etc.)
 #include "util/sample_autogen.h"
+
+  private:
+    // Out-of-line entry points into the runtime dispatched
+    // mixxx::SampleKernels that are used by the auto-generated methods.
+    static void copyWithGainKernel(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN gain,
+            SINT numSamples);
+    static void copy2WithGainKernel(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            SINT numSamples);
+    static void copy3WithGainKernel(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            const CSAMPLE* M_RESTRICT pSrc3,
+            CSAMPLE_GAIN gain3,
+            SINT numSamples);
+    static void copyWithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    static void copy2WithRampingGainKernel(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN startGain1,
+            CSAMPLE_GAIN gainDelta1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN startGain2,
+            CSAMPLE_GAIN gainDelta2,
+            SINT numFrames);
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(SampleUtil::CLIP_STATUS);
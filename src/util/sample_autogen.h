@@ -10,10 +10,7 @@ static inline void copy1WithGain(CSAMPLE* M_RESTRICT pDest,
         clear(pDest, iNumSamples);
         return;
     }
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples; ++i) {
-        pDest[i] = pSrc0[i] * gain0;
-    }
+    copyWithGainKernel(pDest, pSrc0, gain0, iNumSamples);
 }
 static inline void copy1WithRampingGain(CSAMPLE* M_RESTRICT pDest,
                                         const CSAMPLE* M_RESTRICT pSrc0, CSAMPLE_GAIN gain0in, CSAMPLE_GAIN gain0out,
@@ -24,12 +21,7 @@ static inline void copy1WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     }
     const CSAMPLE_GAIN gain_delta0 = (gain0out - gain0in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0;
-    }
+    copyWithRampingGainKernel(pDest, pSrc0, start_gain0, gain_delta0, iNumSamples / 2);
 }
 static inline void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
                                  const CSAMPLE* M_RESTRICT pSrc0, CSAMPLE_GAIN gain0,
@@ -43,11 +35,7 @@ static inline void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
         copy1WithGain(pDest, pSrc0, gain0, iNumSamples);
         return;
     }
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples; ++i) {
-        pDest[i] = pSrc0[i] * gain0 +
-                   pSrc1[i] * gain1;
-    }
+    copy2WithGainKernel(pDest, pSrc0, gain0, pSrc1, gain1, iNumSamples);
 }
 static inline void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
                                         const CSAMPLE* M_RESTRICT pSrc0, CSAMPLE_GAIN gain0in, CSAMPLE_GAIN gain0out,
@@ -65,15 +53,7 @@ static inline void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
     const CSAMPLE_GAIN gain_delta1 = (gain1out - gain1in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0 +
-                       pSrc1[i * 2] * gain1;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
-                           pSrc1[i * 2 + 1] * gain1;
-    }
+    copy2WithRampingGainKernel(pDest, pSrc0, start_gain0, gain_delta0, pSrc1, start_gain1, gain_delta1, iNumSamples / 2);
 }
 static inline void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
                                  const CSAMPLE* M_RESTRICT pSrc0, CSAMPLE_GAIN gain0,
@@ -92,12 +72,7 @@ static inline void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
         copy2WithGain(pDest, pSrc0, gain0, pSrc1, gain1, iNumSamples);
         return;
     }
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples; ++i) {
-        pDest[i] = pSrc0[i] * gain0 +
-                   pSrc1[i] * gain1 +
-                   pSrc2[i] * gain2;
-    }
+    copy3WithGainKernel(pDest, pSrc0, gain0, pSrc1, gain1, pSrc2, gain2, iNumSamples);
 }
 static inline void copy3WithRampingGain(CSAMPLE* M_RESTRICT pDest,
                                         const CSAMPLE* M_RESTRICT pSrc0, CSAMPLE_GAIN gain0in, CSAMPLE_GAIN gain0out,
@@ -0,0 +1,328 @@
+#include "util/samplekernels.h"
+
+#include <cmath>
+#include <initializer_list>
+
+#if defined(MIXXX_SAMPLE_KERNELS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The scalar kernels are the original loops of SampleUtil. LOOP VECTORIZED
+// marks the loops that are auto-vectorized, see the notes in sample.cpp.
+
+namespace {
+
+void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc1[i * 2] * gain1 + pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc1[i * 2 + 1] * gain1 + pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+void add2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void add3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+int sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        CSAMPLE absl = std::fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = std::fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    return (clippedL > 0 ? mixxx::SampleKernels::kClippedLeft : 0) |
+            (clippedR > 0 ? mixxx::SampleKernels::kClippedRight : 0);
+}
+
+void convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    // SAMPLE_MIN = -32768 is a valid low sample, whereas SAMPLE_MAX = 32767
+    // is the highest valid sample. Note that this means that although some
+    // sample values convert to -1.0, none will convert to +1.0.
+    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
+    }
+}
+
+void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const mixxx::SampleKernels kScalarKernels = {
+        "Scalar",
+        copyWithGain,
+        copy2WithGain,
+        copy3WithGain,
+        copyWithRampingGain,
+        copy2WithRampingGain,
+        addWithRampingGain,
+        addWithGain,
+        add2WithGain,
+        add3WithGain,
+        sumAbsPerChannel,
+        convertS16ToFloat32,
+        interleaveBuffer,
+        deinterleaveBuffer,
+};
+
+#if defined(MIXXX_SAMPLE_KERNELS_X86)
+#if defined(_MSC_VER)
+// XCR0 bits of the register states the OS saves on context switches
+constexpr unsigned long long kXcr0Ymm = 0x06;    // SSE, AVX
+constexpr unsigned long long kXcr0Zmm = 0xe6;    // SSE, AVX, opmask, ZMM
+constexpr int kCpuid1EcxOsxsave = 1 << 27;
+constexpr int kCpuid1EcxAvx = 1 << 28;
+constexpr int kCpuid7EbxAvx2 = 1 << 5;
+constexpr int kCpuid7EbxAvx512f = 1 << 16;
+
+bool cpuSupportsOsXsaveState(unsigned long long xcr0Mask) {
+    int info[4];
+    __cpuid(info, 1);
+    if ((info[2] & kCpuid1EcxOsxsave) == 0 || (info[2] & kCpuid1EcxAvx) == 0) {
+        return false;
+    }
+    return (_xgetbv(0) & xcr0Mask) == xcr0Mask;
+}
+
+int cpuid7Ebx() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return 0;
+    }
+    __cpuidex(info, 7, 0);
+    return info[1];
+}
+
+bool cpuSupportsAvx2() {
+    return cpuSupportsOsXsaveState(kXcr0Ymm) && (cpuid7Ebx() & kCpuid7EbxAvx2) != 0;
+}
+
+bool cpuSupportsAvx512() {
+    return cpuSupportsOsXsaveState(kXcr0Zmm) && (cpuid7Ebx() & kCpuid7EbxAvx512f) != 0;
+}
+#else
+// The GCC and Clang builtins also check that the OS saves the
+// YMM/ZMM registers on context switches.
+bool cpuSupportsAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+bool cpuSupportsAvx512() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+}
+#endif
+#endif // MIXXX_SAMPLE_KERNELS_X86
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+const SampleKernels& SampleKernels::scalar() {
+    return kScalarKernels;
+}
+
+#if !defined(MIXXX_SAMPLE_KERNELS_X86)
+// static
+const SampleKernels* SampleKernels::avx2() {
+    return nullptr;
+}
+
+// static
+const SampleKernels* SampleKernels::avx512() {
+    return nullptr;
+}
+#endif
+
+#if !defined(__ARM_NEON) && !defined(__ARM_NEON__)
+// static
+const SampleKernels* SampleKernels::neon() {
+    return nullptr;
+}
+#endif
+
+// static
+bool SampleKernels::cpuSupports(const SampleKernels* pKernels) {
+    if (!pKernels) {
+        return false;
+    }
+#if defined(MIXXX_SAMPLE_KERNELS_X86)
+    if (pKernels == avx512()) {
+        return cpuSupportsAvx512();
+    }
+    if (pKernels == avx2()) {
+        return cpuSupportsAvx2();
+    }
+#endif
+    return true;
+}
+
+// static
+const SampleKernels& SampleKernels::selectKernels() {
+    for (const SampleKernels* pKernels : {avx512(), avx2(), neon()}) {
+        if (cpuSupports(pKernels)) {
+            return *pKernels;
+        }
+    }
+    return scalar();
+}
+
+// static
+bool SampleKernels::selectActive() {
+    s_pActive = &selectKernels();
+    return true;
+}
+
+// Constant initialized, i.e. valid even if SampleUtil is used during the
+// static initialization of another translation unit
+// static
+const SampleKernels* SampleKernels::s_pActive = &kScalarKernels;
+
+// The dispatch is resolved once and not checked on every call
+// static
+const bool SampleKernels::s_activeSelected = selectActive();
+
+} // namespace mixxx
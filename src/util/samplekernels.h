@@ -0,0 +1,135 @@
+#pragma once
+
+#include "util/platform.h"
+#include "util/types.h"
+
+namespace mixxx {
+
+/// SampleKernels is a table of the innermost loops of the hot SampleUtil
+/// functions, i.e. the ones that run for every channel in every engine
+/// callback.
+///
+/// The portable scalar() kernels rely on the compiler auto-vectorizing for
+/// the baseline instruction set of the build, which is only SSE2 for the
+/// x86-64 distribution packages. The instruction set specific kernels are
+/// written with intrinsics and are compiled into the same binary. active()
+/// returns the widest one the CPU supports.
+///
+/// All kernels only contain the loops. Special cases, e.g. a gain of zero or
+/// one, are handled by the SampleUtil functions calling them.
+struct SampleKernels {
+    /// The bits returned by sumAbsPerChannel(). They have the same values as
+    /// SampleUtil::CLIPPING_LEFT and SampleUtil::CLIPPING_RIGHT.
+    static constexpr int kClippedLeft = 1;
+    static constexpr int kClippedRight = 2;
+
+    const char* name;
+
+    void (*copyWithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN gain,
+            SINT numSamples);
+    void (*copy2WithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            SINT numSamples);
+    void (*copy3WithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            const CSAMPLE* M_RESTRICT pSrc3,
+            CSAMPLE_GAIN gain3,
+            SINT numSamples);
+
+    // The ramping kernels operate on stereo frames. Both samples of
+    // frame i are multiplied by startGain + gainDelta * i.
+    void (*copyWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*copy2WithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN startGain1,
+            CSAMPLE_GAIN gainDelta1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN startGain2,
+            CSAMPLE_GAIN gainDelta2,
+            SINT numFrames);
+    void (*addWithRampingGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+
+    void (*addWithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc,
+            CSAMPLE_GAIN gain,
+            SINT numSamples);
+    void (*add2WithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            SINT numSamples);
+    void (*add3WithGain)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            CSAMPLE_GAIN gain1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            CSAMPLE_GAIN gain2,
+            const CSAMPLE* M_RESTRICT pSrc3,
+            CSAMPLE_GAIN gain3,
+            SINT numSamples);
+
+    /// Returns a combination of kClippedLeft and kClippedRight.
+    int (*sumAbsPerChannel)(CSAMPLE* pfAbsL,
+            CSAMPLE* pfAbsR,
+            const CSAMPLE* pBuffer,
+            SINT numFrames);
+
+    void (*convertS16ToFloat32)(CSAMPLE* M_RESTRICT pDest,
+            const SAMPLE* M_RESTRICT pSrc,
+            SINT numSamples);
+
+    void (*interleaveBuffer)(CSAMPLE* M_RESTRICT pDest,
+            const CSAMPLE* M_RESTRICT pSrc1,
+            const CSAMPLE* M_RESTRICT pSrc2,
+            SINT numFrames);
+    void (*deinterleaveBuffer)(CSAMPLE* M_RESTRICT pDest1,
+            CSAMPLE* M_RESTRICT pDest2,
+            const CSAMPLE* M_RESTRICT pSrc,
+            SINT numFrames);
+
+    /// The portable kernels, always available.
+    static const SampleKernels& scalar();
+
+    /// The instruction set specific kernels. They return nullptr if the
+    /// kernels are not compiled in for the target architecture. The x86
+    /// kernels must only be called if cpuSupports() confirms the CPU
+    /// features, NEON is part of every ARM target we build NEON kernels for.
+    static const SampleKernels* avx2();
+    static const SampleKernels* avx512();
+    static const SampleKernels* neon();
+
+    /// Returns true if the kernels can be executed on this CPU.
+    static bool cpuSupports(const SampleKernels* pKernels);
+
+    /// The fastest kernels supported by this CPU. They are selected once
+    /// during static initialization. Until then the scalar kernels are
+    /// returned.
+    static const SampleKernels& active() {
+        return *s_pActive;
+    }
+
+  private:
+    static const SampleKernels& selectKernels();
+    static bool selectActive();
+
+    static const SampleKernels* s_pActive;
+    static const bool s_activeSelected;
+};
+
+} // namespace mixxx
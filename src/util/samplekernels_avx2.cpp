@@ -0,0 +1,346 @@
+#include "util/samplekernels.h"
+
+#include <immintrin.h>
+
+// This file is compiled with AVX2 code generation enabled, see
+// CMakeLists.txt. Its kernels must only be called after checking the CPU
+// features with SampleKernels::cpuSupports().
+//
+// Don't call any inline functions from other headers here! The linker may
+// pick the AVX2 instance of such a function for the whole binary, which
+// crashes on older CPUs.
+
+namespace {
+
+// The number of samples in a 256 bit register
+constexpr SINT kLanes = 8;
+// The number of stereo frames in a 256 bit register
+constexpr SINT kFrameLanes = kLanes / 2;
+
+// The frame index offsets of the samples in a register of stereo samples
+inline __m256 frameOffsets() {
+    return _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+}
+
+// The per sample gains of the frames [i, i + kFrameLanes), computed
+// exactly like in the scalar kernels.
+inline __m256 rampingGains(__m256 startGain, __m256 gainDelta, __m256 offsets, SINT i) {
+    const __m256 frames = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), offsets);
+    return _mm256_add_ps(startGain, _mm256_mul_ps(gainDelta, frames));
+}
+
+inline CSAMPLE absSample(CSAMPLE sample) {
+    return sample < CSAMPLE_ZERO ? -sample : sample;
+}
+
+void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    const __m256 vGain = _mm256_set1_ps(gain);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        _mm256_storeu_ps(pDest + i, _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), vGain));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    const __m256 vGain1 = _mm256_set1_ps(gain1);
+    const __m256 vGain2 = _mm256_set1_ps(gain2);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i), vGain1);
+        const __m256 v2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i), vGain2);
+        _mm256_storeu_ps(pDest + i, _mm256_add_ps(v1, v2));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    const __m256 vGain1 = _mm256_set1_ps(gain1);
+    const __m256 vGain2 = _mm256_set1_ps(gain2);
+    const __m256 vGain3 = _mm256_set1_ps(gain3);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i), vGain1);
+        const __m256 v2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i), vGain2);
+        const __m256 v3 = _mm256_mul_ps(_mm256_loadu_ps(pSrc3 + i), vGain3);
+        _mm256_storeu_ps(pDest + i, _mm256_add_ps(_mm256_add_ps(v1, v2), v3));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m256 vStartGain = _mm256_set1_ps(startGain);
+    const __m256 vGainDelta = _mm256_set1_ps(gainDelta);
+    const __m256 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m256 vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_mul_ps(_mm256_loadu_ps(pSrc + i * 2), vGain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const __m256 vStartGain1 = _mm256_set1_ps(startGain1);
+    const __m256 vGainDelta1 = _mm256_set1_ps(gainDelta1);
+    const __m256 vStartGain2 = _mm256_set1_ps(startGain2);
+    const __m256 vGainDelta2 = _mm256_set1_ps(gainDelta2);
+    const __m256 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m256 vGain1 = rampingGains(vStartGain1, vGainDelta1, vOffsets, i);
+        const __m256 vGain2 = rampingGains(vStartGain2, vGainDelta2, vOffsets, i);
+        const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i * 2), vGain1);
+        const __m256 v2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i * 2), vGain2);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_add_ps(v1, v2));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc1[i * 2] * gain1 + pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc1[i * 2 + 1] * gain1 + pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m256 vStartGain = _mm256_set1_ps(startGain);
+    const __m256 vGainDelta = _mm256_set1_ps(gainDelta);
+    const __m256 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m256 vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(pSrc + i * 2), vGain);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_add_ps(_mm256_loadu_ps(pDest + i * 2), v));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    const __m256 vGain = _mm256_set1_ps(gain);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(pSrc + i), vGain);
+        _mm256_storeu_ps(pDest + i, _mm256_add_ps(_mm256_loadu_ps(pDest + i), v));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+void add2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    const __m256 vGain1 = _mm256_set1_ps(gain1);
+    const __m256 vGain2 = _mm256_set1_ps(gain2);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i), vGain1);
+        const __m256 v2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i), vGain2);
+        _mm256_storeu_ps(pDest + i,
+                _mm256_add_ps(_mm256_loadu_ps(pDest + i), _mm256_add_ps(v1, v2)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void add3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    const __m256 vGain1 = _mm256_set1_ps(gain1);
+    const __m256 vGain2 = _mm256_set1_ps(gain2);
+    const __m256 vGain3 = _mm256_set1_ps(gain3);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256 v1 = _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i), vGain1);
+        const __m256 v2 = _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i), vGain2);
+        const __m256 v3 = _mm256_mul_ps(_mm256_loadu_ps(pSrc3 + i), vGain3);
+        _mm256_storeu_ps(pDest + i,
+                _mm256_add_ps(_mm256_loadu_ps(pDest + i),
+                        _mm256_add_ps(_mm256_add_ps(v1, v2), v3)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+int sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const __m256 vAbsMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vPeak = _mm256_set1_ps(CSAMPLE_PEAK);
+    __m256 vSum = _mm256_setzero_ps();
+    __m256 vClipped = _mm256_setzero_ps();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m256 vAbs = _mm256_and_ps(_mm256_loadu_ps(pBuffer + i * 2), vAbsMask);
+        vSum = _mm256_add_ps(vSum, vAbs);
+        vClipped = _mm256_or_ps(vClipped, _mm256_cmp_ps(vAbs, vPeak, _CMP_GT_OQ));
+    }
+    alignas(32) CSAMPLE sums[kLanes];
+    _mm256_store_ps(sums, vSum);
+    CSAMPLE fAbsL = sums[0] + sums[2] + sums[4] + sums[6];
+    CSAMPLE fAbsR = sums[1] + sums[3] + sums[5] + sums[7];
+    // The even lanes are the left, the odd lanes the right channel
+    const int clippedLanes = _mm256_movemask_ps(vClipped);
+    bool clippedL = (clippedLanes & 0x55) != 0;
+    bool clippedR = (clippedLanes & 0xaa) != 0;
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absL = absSample(pBuffer[i * 2]);
+        const CSAMPLE absR = absSample(pBuffer[i * 2 + 1]);
+        fAbsL += absL;
+        fAbsR += absR;
+        clippedL |= absL > CSAMPLE_PEAK;
+        clippedR |= absR > CSAMPLE_PEAK;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    return (clippedL ? mixxx::SampleKernels::kClippedLeft : 0) |
+            (clippedR ? mixxx::SampleKernels::kClippedRight : 0);
+}
+
+void convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    // Dividing by -SAMPLE_MINIMUM = 2^15 is exactly the same as
+    // multiplying with its reciprocal.
+    const CSAMPLE kConversionFactor = CSAMPLE_ONE / (SAMPLE_MINIMUM * -1.0f);
+    const __m256 vConversionFactor = _mm256_set1_ps(kConversionFactor);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m128i vS16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        const __m256 v = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(vS16));
+        _mm256_storeu_ps(pDest + i, _mm256_mul_ps(v, vConversionFactor));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) * kConversionFactor;
+    }
+}
+
+void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        const __m256 v1 = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 v2 = _mm256_loadu_ps(pSrc2 + i);
+        // unpack works within the 128 bit lanes:
+        // lo = 1[0] 2[0] 1[1] 2[1] | 1[4] 2[4] 1[5] 2[5]
+        // hi = 1[2] 2[2] 1[3] 2[3] | 1[6] 2[6] 1[7] 2[7]
+        const __m256 lo = _mm256_unpacklo_ps(v1, v2);
+        const __m256 hi = _mm256_unpackhi_ps(v1, v2);
+        _mm256_storeu_ps(pDest + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(pDest + 2 * i + kLanes, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        const __m256 v0 = _mm256_loadu_ps(pSrc + 2 * i);
+        const __m256 v1 = _mm256_loadu_ps(pSrc + 2 * i + kLanes);
+        // t0 = frames 0, 1 | 4, 5
+        // t1 = frames 2, 3 | 6, 7
+        const __m256 t0 = _mm256_permute2f128_ps(v0, v1, 0x20);
+        const __m256 t1 = _mm256_permute2f128_ps(v0, v1, 0x31);
+        _mm256_storeu_ps(pDest1 + i, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(pDest2 + i, _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const mixxx::SampleKernels kAvx2Kernels = {
+        "AVX2",
+        copyWithGain,
+        copy2WithGain,
+        copy3WithGain,
+        copyWithRampingGain,
+        copy2WithRampingGain,
+        addWithRampingGain,
+        addWithGain,
+        add2WithGain,
+        add3WithGain,
+        sumAbsPerChannel,
+        convertS16ToFloat32,
+        interleaveBuffer,
+        deinterleaveBuffer,
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+const SampleKernels* SampleKernels::avx2() {
+    return &kAvx2Kernels;
+}
+
+} // namespace mixxx
@@ -0,0 +1,349 @@
+#include "util/samplekernels.h"
+
+#include <immintrin.h>
+
+// This file is compiled with AVX-512 code generation enabled, see
+// CMakeLists.txt. Its kernels must only be called after checking the CPU
+// features with SampleKernels::cpuSupports().
+//
+// Don't call any inline functions from other headers here! The linker may
+// pick the AVX-512 instance of such a function for the whole binary, which
+// crashes on older CPUs.
+
+namespace {
+
+// The number of samples in a 512 bit register
+constexpr SINT kLanes = 16;
+// The number of stereo frames in a 512 bit register
+constexpr SINT kFrameLanes = kLanes / 2;
+
+// The frame index offsets of the samples in a register of stereo samples
+inline __m512 frameOffsets() {
+    return _mm512_setr_ps(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+}
+
+// The per sample gains of the frames [i, i + kFrameLanes), computed
+// exactly like in the scalar kernels.
+inline __m512 rampingGains(__m512 startGain, __m512 gainDelta, __m512 offsets, SINT i) {
+    const __m512 frames = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(i)), offsets);
+    return _mm512_add_ps(startGain, _mm512_mul_ps(gainDelta, frames));
+}
+
+inline CSAMPLE absSample(CSAMPLE sample) {
+    return sample < CSAMPLE_ZERO ? -sample : sample;
+}
+
+void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    const __m512 vGain = _mm512_set1_ps(gain);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        _mm512_storeu_ps(pDest + i, _mm512_mul_ps(_mm512_loadu_ps(pSrc + i), vGain));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    const __m512 vGain1 = _mm512_set1_ps(gain1);
+    const __m512 vGain2 = _mm512_set1_ps(gain2);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m512 v1 = _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i), vGain1);
+        const __m512 v2 = _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i), vGain2);
+        _mm512_storeu_ps(pDest + i, _mm512_add_ps(v1, v2));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    const __m512 vGain1 = _mm512_set1_ps(gain1);
+    const __m512 vGain2 = _mm512_set1_ps(gain2);
+    const __m512 vGain3 = _mm512_set1_ps(gain3);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m512 v1 = _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i), vGain1);
+        const __m512 v2 = _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i), vGain2);
+        const __m512 v3 = _mm512_mul_ps(_mm512_loadu_ps(pSrc3 + i), vGain3);
+        _mm512_storeu_ps(pDest + i, _mm512_add_ps(_mm512_add_ps(v1, v2), v3));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m512 vStartGain = _mm512_set1_ps(startGain);
+    const __m512 vGainDelta = _mm512_set1_ps(gainDelta);
+    const __m512 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m512 vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        _mm512_storeu_ps(pDest + i * 2,
+                _mm512_mul_ps(_mm512_loadu_ps(pSrc + i * 2), vGain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const __m512 vStartGain1 = _mm512_set1_ps(startGain1);
+    const __m512 vGainDelta1 = _mm512_set1_ps(gainDelta1);
+    const __m512 vStartGain2 = _mm512_set1_ps(startGain2);
+    const __m512 vGainDelta2 = _mm512_set1_ps(gainDelta2);
+    const __m512 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m512 vGain1 = rampingGains(vStartGain1, vGainDelta1, vOffsets, i);
+        const __m512 vGain2 = rampingGains(vStartGain2, vGainDelta2, vOffsets, i);
+        const __m512 v1 = _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i * 2), vGain1);
+        const __m512 v2 = _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i * 2), vGain2);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_add_ps(v1, v2));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc1[i * 2] * gain1 + pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc1[i * 2 + 1] * gain1 + pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m512 vStartGain = _mm512_set1_ps(startGain);
+    const __m512 vGainDelta = _mm512_set1_ps(gainDelta);
+    const __m512 vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m512 vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        const __m512 v = _mm512_mul_ps(_mm512_loadu_ps(pSrc + i * 2), vGain);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_add_ps(_mm512_loadu_ps(pDest + i * 2), v));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    const __m512 vGain = _mm512_set1_ps(gain);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m512 v = _mm512_mul_ps(_mm512_loadu_ps(pSrc + i), vGain);
+        _mm512_storeu_ps(pDest + i, _mm512_add_ps(_mm512_loadu_ps(pDest + i), v));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+void add2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    const __m512 vGain1 = _mm512_set1_ps(gain1);
+    const __m512 vGain2 = _mm512_set1_ps(gain2);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m512 v1 = _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i), vGain1);
+        const __m512 v2 = _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i), vGain2);
+        _mm512_storeu_ps(pDest + i,
+                _mm512_add_ps(_mm512_loadu_ps(pDest + i), _mm512_add_ps(v1, v2)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void add3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    const __m512 vGain1 = _mm512_set1_ps(gain1);
+    const __m512 vGain2 = _mm512_set1_ps(gain2);
+    const __m512 vGain3 = _mm512_set1_ps(gain3);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m512 v1 = _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i), vGain1);
+        const __m512 v2 = _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i), vGain2);
+        const __m512 v3 = _mm512_mul_ps(_mm512_loadu_ps(pSrc3 + i), vGain3);
+        _mm512_storeu_ps(pDest + i,
+                _mm512_add_ps(_mm512_loadu_ps(pDest + i),
+                        _mm512_add_ps(_mm512_add_ps(v1, v2), v3)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+int sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const __m512 vPeak = _mm512_set1_ps(CSAMPLE_PEAK);
+    __m512 vSum = _mm512_setzero_ps();
+    __mmask16 clippedLanes = 0;
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const __m512 vAbs = _mm512_abs_ps(_mm512_loadu_ps(pBuffer + i * 2));
+        vSum = _mm512_add_ps(vSum, vAbs);
+        clippedLanes |= _mm512_cmp_ps_mask(vAbs, vPeak, _CMP_GT_OQ);
+    }
+    alignas(64) CSAMPLE sums[kLanes];
+    _mm512_store_ps(sums, vSum);
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    for (SINT lane = 0; lane < kLanes; lane += 2) {
+        fAbsL += sums[lane];
+        fAbsR += sums[lane + 1];
+    }
+    // The even lanes are the left, the odd lanes the right channel
+    bool clippedL = (clippedLanes & 0x5555) != 0;
+    bool clippedR = (clippedLanes & 0xaaaa) != 0;
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absL = absSample(pBuffer[i * 2]);
+        const CSAMPLE absR = absSample(pBuffer[i * 2 + 1]);
+        fAbsL += absL;
+        fAbsR += absR;
+        clippedL |= absL > CSAMPLE_PEAK;
+        clippedR |= absR > CSAMPLE_PEAK;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    return (clippedL ? mixxx::SampleKernels::kClippedLeft : 0) |
+            (clippedR ? mixxx::SampleKernels::kClippedRight : 0);
+}
+
+void convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    // Dividing by -SAMPLE_MINIMUM = 2^15 is exactly the same as
+    // multiplying with its reciprocal.
+    const CSAMPLE kConversionFactor = CSAMPLE_ONE / (SAMPLE_MINIMUM * -1.0f);
+    const __m512 vConversionFactor = _mm512_set1_ps(kConversionFactor);
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const __m256i vS16 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+        const __m512 v = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(vS16));
+        _mm512_storeu_ps(pDest + i, _mm512_mul_ps(v, vConversionFactor));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) * kConversionFactor;
+    }
+}
+
+void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // Indices into the concatenation of both sources, 16 and above
+    // select from the second one.
+    const __m512i vLoIndices = _mm512_setr_epi32(
+            0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i vHiIndices = _mm512_setr_epi32(
+            8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        const __m512 v1 = _mm512_loadu_ps(pSrc1 + i);
+        const __m512 v2 = _mm512_loadu_ps(pSrc2 + i);
+        _mm512_storeu_ps(pDest + 2 * i, _mm512_permutex2var_ps(v1, vLoIndices, v2));
+        _mm512_storeu_ps(pDest + 2 * i + kLanes, _mm512_permutex2var_ps(v1, vHiIndices, v2));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    const __m512i vEvenIndices = _mm512_setr_epi32(
+            0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i vOddIndices = _mm512_setr_epi32(
+            1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        const __m512 v0 = _mm512_loadu_ps(pSrc + 2 * i);
+        const __m512 v1 = _mm512_loadu_ps(pSrc + 2 * i + kLanes);
+        _mm512_storeu_ps(pDest1 + i, _mm512_permutex2var_ps(v0, vEvenIndices, v1));
+        _mm512_storeu_ps(pDest2 + i, _mm512_permutex2var_ps(v0, vOddIndices, v1));
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const mixxx::SampleKernels kAvx512Kernels = {
+        "AVX-512",
+        copyWithGain,
+        copy2WithGain,
+        copy3WithGain,
+        copyWithRampingGain,
+        copy2WithRampingGain,
+        addWithRampingGain,
+        addWithGain,
+        add2WithGain,
+        add3WithGain,
+        sumAbsPerChannel,
+        convertS16ToFloat32,
+        interleaveBuffer,
+        deinterleaveBuffer,
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+const SampleKernels* SampleKernels::avx512() {
+    return &kAvx512Kernels;
+}
+
+} // namespace mixxx
@@ -0,0 +1,322 @@
+#include "util/samplekernels.h"
+
+// NEON is mandatory on AArch64 and enabled with -mfpu=neon for our 32 bit
+// ARM builds, so unlike the x86 kernels these need no runtime check.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace {
+
+// The number of samples in a 128 bit register
+constexpr SINT kLanes = 4;
+// The number of stereo frames in a 128 bit register
+constexpr SINT kFrameLanes = kLanes / 2;
+
+// The frame index offsets of the samples in a register of stereo samples
+inline float32x4_t frameOffsets() {
+    alignas(16) static const float kOffsets[kLanes] = {0, 0, 1, 1};
+    return vld1q_f32(kOffsets);
+}
+
+// The per sample gains of the frames [i, i + kFrameLanes), computed
+// exactly like in the scalar kernels.
+inline float32x4_t rampingGains(
+        float32x4_t startGain, float32x4_t gainDelta, float32x4_t offsets, SINT i) {
+    const float32x4_t frames = vaddq_f32(vdupq_n_f32(static_cast<float>(i)), offsets);
+    return vaddq_f32(startGain, vmulq_f32(gainDelta, frames));
+}
+
+inline CSAMPLE absSample(CSAMPLE sample) {
+    return sample < CSAMPLE_ZERO ? -sample : sample;
+}
+
+void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        vst1q_f32(pDest + i, vmulq_n_f32(vld1q_f32(pSrc + i), gain));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+void copy2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const float32x4_t v1 = vmulq_n_f32(vld1q_f32(pSrc1 + i), gain1);
+        const float32x4_t v2 = vmulq_n_f32(vld1q_f32(pSrc2 + i), gain2);
+        vst1q_f32(pDest + i, vaddq_f32(v1, v2));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void copy3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const float32x4_t v1 = vmulq_n_f32(vld1q_f32(pSrc1 + i), gain1);
+        const float32x4_t v2 = vmulq_n_f32(vld1q_f32(pSrc2 + i), gain2);
+        const float32x4_t v3 = vmulq_n_f32(vld1q_f32(pSrc3 + i), gain3);
+        vst1q_f32(pDest + i, vaddq_f32(vaddq_f32(v1, v2), v3));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const float32x4_t vStartGain = vdupq_n_f32(startGain);
+    const float32x4_t vGainDelta = vdupq_n_f32(gainDelta);
+    const float32x4_t vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const float32x4_t vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        vst1q_f32(pDest + i * 2, vmulq_f32(vld1q_f32(pSrc + i * 2), vGain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const float32x4_t vStartGain1 = vdupq_n_f32(startGain1);
+    const float32x4_t vGainDelta1 = vdupq_n_f32(gainDelta1);
+    const float32x4_t vStartGain2 = vdupq_n_f32(startGain2);
+    const float32x4_t vGainDelta2 = vdupq_n_f32(gainDelta2);
+    const float32x4_t vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const float32x4_t vGain1 = rampingGains(vStartGain1, vGainDelta1, vOffsets, i);
+        const float32x4_t vGain2 = rampingGains(vStartGain2, vGainDelta2, vOffsets, i);
+        const float32x4_t v1 = vmulq_f32(vld1q_f32(pSrc1 + i * 2), vGain1);
+        const float32x4_t v2 = vmulq_f32(vld1q_f32(pSrc2 + i * 2), vGain2);
+        vst1q_f32(pDest + i * 2, vaddq_f32(v1, v2));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc1[i * 2] * gain1 + pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc1[i * 2 + 1] * gain1 + pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const float32x4_t vStartGain = vdupq_n_f32(startGain);
+    const float32x4_t vGainDelta = vdupq_n_f32(gainDelta);
+    const float32x4_t vOffsets = frameOffsets();
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const float32x4_t vGain = rampingGains(vStartGain, vGainDelta, vOffsets, i);
+        const float32x4_t v = vmulq_f32(vld1q_f32(pSrc + i * 2), vGain);
+        vst1q_f32(pDest + i * 2, vaddq_f32(vld1q_f32(pDest + i * 2), v));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const float32x4_t v = vmulq_n_f32(vld1q_f32(pSrc + i), gain);
+        vst1q_f32(pDest + i, vaddq_f32(vld1q_f32(pDest + i), v));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+void add2WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const float32x4_t v1 = vmulq_n_f32(vld1q_f32(pSrc1 + i), gain1);
+        const float32x4_t v2 = vmulq_n_f32(vld1q_f32(pSrc2 + i), gain2);
+        vst1q_f32(pDest + i, vaddq_f32(vld1q_f32(pDest + i), vaddq_f32(v1, v2)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2;
+    }
+}
+
+void add3WithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN gain1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN gain2,
+        const CSAMPLE* M_RESTRICT pSrc3,
+        CSAMPLE_GAIN gain3,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + kLanes <= numSamples; i += kLanes) {
+        const float32x4_t v1 = vmulq_n_f32(vld1q_f32(pSrc1 + i), gain1);
+        const float32x4_t v2 = vmulq_n_f32(vld1q_f32(pSrc2 + i), gain2);
+        const float32x4_t v3 = vmulq_n_f32(vld1q_f32(pSrc3 + i), gain3);
+        vst1q_f32(pDest + i,
+                vaddq_f32(vld1q_f32(pDest + i), vaddq_f32(vaddq_f32(v1, v2), v3)));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] += pSrc1[i] * gain1 + pSrc2[i] * gain2 + pSrc3[i] * gain3;
+    }
+}
+
+int sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        const CSAMPLE* pBuffer,
+        SINT numFrames) {
+    const float32x4_t vPeak = vdupq_n_f32(CSAMPLE_PEAK);
+    float32x4_t vSum = vdupq_n_f32(CSAMPLE_ZERO);
+    uint32x4_t vClipped = vdupq_n_u32(0);
+    SINT i = 0;
+    for (; i + kFrameLanes <= numFrames; i += kFrameLanes) {
+        const float32x4_t vAbs = vabsq_f32(vld1q_f32(pBuffer + i * 2));
+        vSum = vaddq_f32(vSum, vAbs);
+        vClipped = vorrq_u32(vClipped, vcgtq_f32(vAbs, vPeak));
+    }
+    alignas(16) CSAMPLE sums[kLanes];
+    vst1q_f32(sums, vSum);
+    alignas(16) uint32_t clipped[kLanes];
+    vst1q_u32(clipped, vClipped);
+    // The even lanes are the left, the odd lanes the right channel
+    CSAMPLE fAbsL = sums[0] + sums[2];
+    CSAMPLE fAbsR = sums[1] + sums[3];
+    bool clippedL = (clipped[0] | clipped[2]) != 0;
+    bool clippedR = (clipped[1] | clipped[3]) != 0;
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absL = absSample(pBuffer[i * 2]);
+        const CSAMPLE absR = absSample(pBuffer[i * 2 + 1]);
+        fAbsL += absL;
+        fAbsR += absR;
+        clippedL |= absL > CSAMPLE_PEAK;
+        clippedR |= absR > CSAMPLE_PEAK;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    return (clippedL ? mixxx::SampleKernels::kClippedLeft : 0) |
+            (clippedR ? mixxx::SampleKernels::kClippedRight : 0);
+}
+
+void convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    // Dividing by -SAMPLE_MINIMUM = 2^15 is exactly the same as
+    // multiplying with its reciprocal.
+    const CSAMPLE kConversionFactor = CSAMPLE_ONE / (SAMPLE_MINIMUM * -1.0f);
+    SINT i = 0;
+    for (; i + 2 * kLanes <= numSamples; i += 2 * kLanes) {
+        const int16x8_t vS16 = vld1q_s16(pSrc + i);
+        const float32x4_t vLo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(vS16)));
+        const float32x4_t vHi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(vS16)));
+        vst1q_f32(pDest + i, vmulq_n_f32(vLo, kConversionFactor));
+        vst1q_f32(pDest + i + kLanes, vmulq_n_f32(vHi, kConversionFactor));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) * kConversionFactor;
+    }
+}
+
+void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(pSrc1 + i);
+        v.val[1] = vld1q_f32(pSrc2 + i);
+        vst2q_f32(pDest + 2 * i, v);
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + kLanes <= numFrames; i += kLanes) {
+        const float32x4x2_t v = vld2q_f32(pSrc + 2 * i);
+        vst1q_f32(pDest1 + i, v.val[0]);
+        vst1q_f32(pDest2 + i, v.val[1]);
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const mixxx::SampleKernels kNeonKernels = {
+        "NEON",
+        copyWithGain,
+        copy2WithGain,
+        copy3WithGain,
+        copyWithRampingGain,
+        copy2WithRampingGain,
+        addWithRampingGain,
+        addWithGain,
+        add2WithGain,
+        add3WithGain,
+        sumAbsPerChannel,
+        convertS16ToFloat32,
+        interleaveBuffer,
+        deinterleaveBuffer,
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+// static
+const SampleKernels* SampleKernels::neon() {
+    return &kNeonKernels;
+}
+
+} // namespace mixxx
+
+#endif // __ARM_NEON
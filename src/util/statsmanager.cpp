@@ -13,6 +13,10 @@
 constexpr int kStatsPipeSize = 1 << 10;
 constexpr int kProcessLength = kStatsPipeSize * 4 / 5;
 
+// Trace events can't wake up the StatsManager thread without blocking,
+// so the per-thread rings are drained periodically.
+constexpr unsigned long kTraceDrainIntervalMillis = 100;
+
 // static
 bool StatsManager::s_bStatsManagerEnabled = false;
 
@@ -32,6 +36,7 @@ StatsManager::StatsManager()
         : QThread(),
           m_quit(0) {
     s_bStatsManagerEnabled = true;
+    mixxx::Tracing::setEnabled(true);
     setObjectName("StatsManager");
     moveToThread(this);
     start(QThread::LowPriority);
@@ -39,9 +44,14 @@ StatsManager::StatsManager()
 
 StatsManager::~StatsManager() {
     s_bStatsManagerEnabled = false;
+    mixxx::Tracing::setEnabled(false);
     m_quit = 1;
     m_statsPipeCondition.wakeAll();
     wait();
+    { // Collect the events that have been recorded after the thread finished
+        const auto locker = lockMutex(&m_statsPipeLock);
+        processTraceEvents();
+    }
     qDebug() << "StatsManager shutdown report:";
     qDebug() << "=====================================";
     qDebug() << "ALL STATS";
@@ -72,6 +82,12 @@ StatsManager::~StatsManager() {
     }
     qDebug() << "=====================================";
 
+    const quint64 droppedTraceEvents = mixxx::Tracing::droppedEventCount();
+    if (droppedTraceEvents > 0) {
+        qWarning() << "StatsManager dropped" << droppedTraceEvents
+                   << "trace events. Your measurements may be affected.";
+    }
+
     if (CmdlineArgs::Instance().getTimelineEnabled()) {
         writeTimeline(CmdlineArgs::Instance().getTimelinePath());
     }
@@ -111,21 +127,57 @@ void StatsManager::writeTimeline(const QString& filename) {
         return;
     }
 
-    if (m_events.isEmpty()) {
+    if (m_traceRecords.isEmpty()) {
         qDebug() << "No events recorded.";
         return;
     }
 
+    // Timelines with the extension .json can be loaded into Perfetto
+    // or chrome://tracing
+    if (filename.endsWith(QStringLiteral(".json"), Qt::CaseInsensitive)) {
+        if (!mixxx::writeChromeTrace(
+                    &timeline, m_traceRecords, mixxx::Tracing::threadNames())) {
+            qWarning() << "Failed to write timeline" << timeline.fileName();
+        }
+        timeline.close();
+        return;
+    }
+
+    QList<Event> events;
+    for (const auto& record : qAsConst(m_traceRecords)) {
+        Event event;
+        event.m_tag = m_traceTags.value(record.event.name);
+        event.m_time = mixxx::Duration::fromNanos(record.event.timeNanos);
+        switch (record.event.phase) {
+        case mixxx::TraceEvent::Phase::Begin:
+            event.m_type = Stat::EVENT_START;
+            break;
+        case mixxx::TraceEvent::Phase::End:
+            event.m_type = Stat::EVENT_END;
+            break;
+        case mixxx::TraceEvent::Phase::Instant:
+            event.m_type = Stat::EVENT;
+            break;
+        case mixxx::TraceEvent::Phase::Complete:
+            event.m_type = Stat::EVENT_START;
+            events.append(event);
+            event.m_type = Stat::EVENT_END;
+            event.m_time += mixxx::Duration::fromNanos(record.event.durationNanos);
+            break;
+        }
+        events.append(event);
+    }
+
     // Sort by time.
-    std::sort(m_events.begin(), m_events.end(), OrderByTime());
+    std::sort(events.begin(), events.end(), OrderByTime());
 
-    mixxx::Duration last_time = m_events[0].m_time;
+    mixxx::Duration last_time = events[0].m_time;
 
     QMap<QString, qint64> startTimes;
     QMap<QString, qint64> endTimes;
 
     QTextStream out(&timeline);
-    foreach (const Event& event, m_events) {
+    for (const Event& event : qAsConst(events)) {
         qint64 last_start = startTimes.value(event.m_tag, -1);
         qint64 last_end = endTimes.value(event.m_tag, -1);
 
@@ -201,39 +253,67 @@ void StatsManager::processIncomingStatReports() {
     StatReport report;
     foreach (StatsPipe* pStatsPipe, m_statsPipes) {
         while (pStatsPipe->dequeue(&report)) {
-            QString tag = report.tag;
-            Stat& info = m_stats[tag];
-            info.m_tag = tag;
-            info.m_type = report.type;
-            info.m_compute = report.compute;
-            info.processReport(report);
-            emit statUpdated(info);
-
-            if (report.compute & Stat::STATS_EXPERIMENT) {
-                Stat& experiment = m_experimentStats[tag];
-                experiment.m_tag = tag;
-                experiment.m_type = report.type;
-                experiment.m_compute = report.compute;
-                experiment.processReport(report);
-            } else if (report.compute & Stat::STATS_BASE) {
-                Stat& base = m_baseStats[tag];
-                base.m_tag = tag;
-                base.m_type = report.type;
-                base.m_compute = report.compute;
-                base.processReport(report);
-            }
+            processReport(report);
+        }
+    }
+}
 
-            if (CmdlineArgs::Instance().getTimelineEnabled() &&
-                    (report.type == Stat::EVENT ||
-                     report.type == Stat::EVENT_START ||
-                     report.type == Stat::EVENT_END)) {
-                Event event;
-                event.m_tag = tag;
-                event.m_type = report.type;
-                event.m_time = mixxx::Duration::fromNanos(report.time);
-                m_events.append(event);
-            }
+void StatsManager::processTraceEvents() {
+    const bool timelineEnabled = CmdlineArgs::Instance().getTimelineEnabled();
+    mixxx::Tracing::drain([this, timelineEnabled](const mixxx::TraceRecord& record) {
+        const mixxx::TraceEvent& event = record.event;
+        auto tag = m_traceTags.constFind(event.name);
+        if (tag == m_traceTags.constEnd()) {
+            tag = m_traceTags.insert(event.name, QString::fromUtf8(event.name));
+        }
+        StatReport report;
+        report.tag = tag.value();
+        report.time = event.timeNanos;
+        report.compute = event.compute;
+        report.value = 0.0;
+        switch (event.phase) {
+        case mixxx::TraceEvent::Phase::Begin:
+            report.type = Stat::EVENT_START;
+            break;
+        case mixxx::TraceEvent::Phase::End:
+            report.type = Stat::EVENT_END;
+            break;
+        case mixxx::TraceEvent::Phase::Instant:
+            report.type = Stat::EVENT;
+            break;
+        case mixxx::TraceEvent::Phase::Complete:
+            report.type = Stat::DURATION_NANOSEC;
+            report.value = static_cast<double>(event.durationNanos);
+            break;
         }
+        processReport(report);
+        if (timelineEnabled) {
+            m_traceRecords.append(record);
+        }
+    });
+}
+
+void StatsManager::processReport(const StatReport& report) {
+    const QString& tag = report.tag;
+    Stat& info = m_stats[tag];
+    info.m_tag = tag;
+    info.m_type = report.type;
+    info.m_compute = report.compute;
+    info.processReport(report);
+    emit statUpdated(info);
+
+    if (report.compute & Stat::STATS_EXPERIMENT) {
+        Stat& experiment = m_experimentStats[tag];
+        experiment.m_tag = tag;
+        experiment.m_type = report.type;
+        experiment.m_compute = report.compute;
+        experiment.processReport(report);
+    } else if (report.compute & Stat::STATS_BASE) {
+        Stat& base = m_baseStats[tag];
+        base.m_tag = tag;
+        base.m_type = report.type;
+        base.m_compute = report.compute;
+        base.processReport(report);
     }
 }
 
@@ -241,10 +321,11 @@ void StatsManager::run() {
     qDebug() << "StatsManager thread starting up.";
     while (true) {
         m_statsPipeLock.lock();
-        m_statsPipeCondition.wait(&m_statsPipeLock);
+        m_statsPipeCondition.wait(&m_statsPipeLock, kTraceDrainIntervalMillis);
         // We want to process reports even when we are about to quit since we
         // want to print the most accurate stat report on shutdown.
         processIncomingStatReports();
+        processTraceEvents();
         m_statsPipeLock.unlock();
 
         if (m_emitAllStats.loadAcquire() == 1) {
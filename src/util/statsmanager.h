@@ -10,12 +10,15 @@
 #include <QWaitCondition>
 #include <QThreadStorage>
 #include <QList>
+#include <QHash>
+#include <QVector>
 
 #include "rigtorp/SPSCQueue.h"
 
 #include "util/singleton.h"
 #include "util/stat.h"
 #include "util/event.h"
+#include "util/tracering.h"
 
 class StatsManager;
 
@@ -75,6 +78,8 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
 
   private:
     void processIncomingStatReports();
+    void processTraceEvents();
+    void processReport(const StatReport& report);
     StatsPipe* getStatsPipeForThread();
     void onStatsPipeDestroyed(StatsPipe* pPipe);
     void writeTimeline(const QString& filename);
@@ -84,7 +89,10 @@ class StatsManager : public QThread, public Singleton<StatsManager> {
     QMap<QString, Stat> m_stats;
     QMap<QString, Stat> m_baseStats;
     QMap<QString, Stat> m_experimentStats;
-    QList<Event> m_events;
+    // Only recorded if the timeline is enabled
+    QVector<mixxx::TraceRecord> m_traceRecords;
+    // Converted names of trace tags
+    QHash<const char*, QString> m_traceTags;
 
     QWaitCondition m_statsPipeCondition;
     QMutex m_statsPipeLock;
@@ -8,6 +8,7 @@
 #include "util/parented_ptr.h"
 #include "util/performancetimer.h"
 #include "util/stat.h"
+#include "util/tracering.h"
 
 const Stat::ComputeFlags kDefaultComputeFlags = Stat::COUNT | Stat::SUM | Stat::AVERAGE |
         Stat::MAX | Stat::MIN | Stat::SAMPLE_VARIANCE;
@@ -50,63 +51,70 @@ class SuspendableTimer : public Timer {
     mixxx::Duration m_leapTime;
 };
 
+// Records the time spent in a scope as a trace event that also appears in
+// the statistics of the StatsManager. Timers with a constant tag don't
+// allocate any memory and are cheap enough for the audio callback.
 class ScopedTimer {
   public:
-    ScopedTimer(const char* key, int i,
-                Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
-              m_cancel(false) {
-        if (CmdlineArgs::Instance().getDeveloper()) {
-            initialize(QString(key), QString::number(i), compute);
+    explicit ScopedTimer(mixxx::TraceTag tag,
+            Stat::ComputeFlags compute = kDefaultComputeFlags)
+            : m_tag(tag),
+              m_compute(compute),
+              m_startNanos(kNotStarted) {
+        if (mixxx::Tracing::isEnabled()) {
+            m_startNanos = mixxx::Tracing::now();
         }
     }
 
-    ScopedTimer(const char* key, const char *arg = NULL,
+    // Timers with tags that are composed at runtime are only available
+    // in developer mode, because interning the tag allocates memory.
+    ScopedTimer(const char* key, int i,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
-              m_cancel(false) {
+            : m_tag(""),
+              m_compute(compute),
+              m_startNanos(kNotStarted) {
         if (CmdlineArgs::Instance().getDeveloper()) {
-            initialize(QString(key), arg ? QString(arg) : QString(), compute);
+            initialize(QString(key).arg(i));
         }
     }
 
     ScopedTimer(const char* key, const QString& arg,
                 Stat::ComputeFlags compute = kDefaultComputeFlags)
-            : m_pTimer(NULL),
-              m_cancel(false) {
+            : m_tag(""),
+              m_compute(compute),
+              m_startNanos(kNotStarted) {
         if (CmdlineArgs::Instance().getDeveloper()) {
-            initialize(QString(key), arg, compute);
-        }
-    }
-
-    virtual ~ScopedTimer() {
-        if (m_pTimer) {
-            if (!m_cancel) {
-                m_pTimer->elapsed(true);
-            }
-            m_pTimer->~Timer();
+            initialize(arg.isEmpty() ? QString(key) : QString(key).arg(arg));
         }
     }
 
-    inline void initialize(const QString& key, const QString& arg,
-                Stat::ComputeFlags compute = kDefaultComputeFlags) {
-        QString strKey;
-        if (arg.isEmpty()) {
-            strKey = key;
-        } else {
-            strKey = key.arg(arg);
+    ~ScopedTimer() {
+        if (m_startNanos != kNotStarted) {
+            const qint64 endNanos = mixxx::Tracing::now();
+            mixxx::Tracing::complete(m_tag,
+                    m_startNanos,
+                    endNanos - m_startNanos,
+                    Stat::experimentFlags(m_compute));
         }
-        m_pTimer = new(m_timerMem) Timer(strKey, compute);
-        m_pTimer->start();
     }
 
     void cancel() {
-        m_cancel = true;
+        m_startNanos = kNotStarted;
     }
+
   private:
-    Timer* m_pTimer;
-    char m_timerMem[sizeof(Timer)];
-    bool m_cancel;
+    static constexpr qint64 kNotStarted = -1;
+
+    void initialize(const QString& key) {
+        if (mixxx::Tracing::isEnabled()) {
+            m_tag = mixxx::TraceTag::intern(key);
+            m_startNanos = mixxx::Tracing::now();
+        }
+    }
+
+    mixxx::TraceTag m_tag;
+    const Stat::ComputeFlags m_compute;
+    qint64 m_startNanos;
 };
 
 // A timer that provides a similar API to QTimer but uses render events from the
@@ -0,0 +1,247 @@
+#include "util/tracering.h"
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "rigtorp/SPSCQueue.h"
+#include "util/audiothreadguard.h"
+#include "util/compatibility/qmutex.h"
+#include "util/time.h"
+
+namespace mixxx {
+
+namespace {
+
+// Sufficient for recording a few hundred events per audio callback
+// between two runs of the StatsManager thread.
+constexpr std::size_t kTraceRingCapacity = 1 << 14;
+
+class TraceRing {
+  public:
+    explicit TraceRing(int threadId)
+            : m_threadId(threadId),
+              m_queue(kTraceRingCapacity) {
+    }
+
+    bool push(const TraceEvent& event) {
+        return m_queue.try_push(event);
+    }
+
+    int drain(const std::function<void(const TraceRecord&)>& consumer) {
+        int count = 0;
+        while (const TraceEvent* pEvent = m_queue.front()) {
+            consumer(TraceRecord{m_threadId, *pEvent});
+            m_queue.pop();
+            ++count;
+        }
+        return count;
+    }
+
+  private:
+    const int m_threadId;
+    rigtorp::SPSCQueue<TraceEvent> m_queue;
+};
+
+struct TraceRegistry {
+    QMutex mutex;
+    // Rings of threads that have exited are removed after they have
+    // been drained
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    QMap<int, QString> threadNames;
+    int nextThreadId = 1;
+    QHash<QString, const char*> internedNames;
+    std::atomic<quint64> droppedEventCount{0};
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry s_registry;
+    return s_registry;
+}
+
+thread_local std::shared_ptr<TraceRing> t_pRing;
+
+// Avoids locking the registry for names that have already been
+// interned on the current thread
+thread_local QHash<QString, const char*> t_internedNames;
+
+TraceRing* currentRing() {
+    if (!t_pRing) {
+        // Only allocates once per thread
+        const AudioThreadGuard::Suspend audioThreadGuardSuspend;
+        TraceRegistry& reg = registry();
+        const auto locker = lockMutex(&reg.mutex);
+        const int threadId = reg.nextThreadId++;
+        QString threadName = QThread::currentThread()->objectName();
+        if (threadName.isEmpty()) {
+            threadName = QStringLiteral("Thread %1").arg(threadId);
+        }
+        reg.threadNames.insert(threadId, threadName);
+        t_pRing = std::make_shared<TraceRing>(threadId);
+        reg.rings.push_back(t_pRing);
+    }
+    return t_pRing.get();
+}
+
+const char* chromePhase(TraceEvent::Phase phase) {
+    switch (phase) {
+    case TraceEvent::Phase::Begin:
+        return "B";
+    case TraceEvent::Phase::End:
+        return "E";
+    case TraceEvent::Phase::Instant:
+        return "i";
+    case TraceEvent::Phase::Complete:
+        return "X";
+    }
+    return "i";
+}
+
+double nanosToMicros(qint64 nanos) {
+    return static_cast<double>(nanos) / 1000.0;
+}
+
+} // namespace
+
+// static
+std::atomic<bool> Tracing::s_enabled{false};
+
+// static
+TraceTag TraceTag::intern(const QString& name) {
+    const char* pName = t_internedNames.value(name);
+    if (!pName) {
+        TraceRegistry& reg = registry();
+        const auto locker = lockMutex(&reg.mutex);
+        pName = reg.internedNames.value(name);
+        if (!pName) {
+            pName = qstrdup(name.toUtf8().constData());
+            reg.internedNames.insert(name, pName);
+        }
+        t_internedNames.insert(name, pName);
+    }
+    return TraceTag(pName, true);
+}
+
+// static
+void Tracing::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// static
+qint64 Tracing::now() {
+    return Time::elapsed().toIntegerNanos();
+}
+
+// static
+bool Tracing::record(TraceTag tag,
+        TraceEvent::Phase phase,
+        qint64 timeNanos,
+        qint64 durationNanos,
+        Stat::ComputeFlags compute) {
+    const TraceEvent event{tag.name(), timeNanos, durationNanos, compute, phase};
+    if (currentRing()->push(event)) {
+        return true;
+    }
+    registry().droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// static
+int Tracing::drain(const std::function<void(const TraceRecord&)>& consumer) {
+    TraceRegistry& reg = registry();
+    const auto locker = lockMutex(&reg.mutex);
+    int count = 0;
+    auto it = reg.rings.begin();
+    while (it != reg.rings.end()) {
+        count += (*it)->drain(consumer);
+        // The registry holds the last reference after the thread has exited
+        if (it->use_count() == 1) {
+            it = reg.rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return count;
+}
+
+// static
+quint64 Tracing::droppedEventCount() {
+    return registry().droppedEventCount.load(std::memory_order_relaxed);
+}
+
+// static
+QMap<int, QString> Tracing::threadNames() {
+    TraceRegistry& reg = registry();
+    const auto locker = lockMutex(&reg.mutex);
+    return reg.threadNames;
+}
+
+bool writeChromeTrace(
+        QIODevice* pDevice,
+        const QVector<TraceRecord>& records,
+        const QMap<int, QString>& threadNames) {
+    const qint64 pid = QCoreApplication::applicationPid();
+    bool success = pDevice->write("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n") >= 0;
+    bool firstEvent = true;
+    const auto writeEvent = [&](const QJsonObject& event) {
+        if (!firstEvent) {
+            success &= pDevice->write(",\n") >= 0;
+        }
+        firstEvent = false;
+        success &= pDevice->write(
+                           QJsonDocument(event).toJson(QJsonDocument::Compact)) >= 0;
+    };
+
+    writeEvent(QJsonObject{
+            {QStringLiteral("name"), QStringLiteral("process_name")},
+            {QStringLiteral("ph"), QStringLiteral("M")},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("args"),
+                    QJsonObject{{QStringLiteral("name"),
+                            QCoreApplication::applicationName()}}},
+    });
+    for (auto it = threadNames.constBegin(); it != threadNames.constEnd(); ++it) {
+        writeEvent(QJsonObject{
+                {QStringLiteral("name"), QStringLiteral("thread_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), pid},
+                {QStringLiteral("tid"), it.key()},
+                {QStringLiteral("args"),
+                        QJsonObject{{QStringLiteral("name"), it.value()}}},
+        });
+    }
+
+    // Many events share the same name
+    QHash<const char*, QString> names;
+    for (const auto& record : records) {
+        const TraceEvent& event = record.event;
+        auto name = names.constFind(event.name);
+        if (name == names.constEnd()) {
+            name = names.insert(event.name, QString::fromUtf8(event.name));
+        }
+        QJsonObject json{
+                {QStringLiteral("name"), name.value()},
+                {QStringLiteral("ph"), QLatin1String(chromePhase(event.phase))},
+                {QStringLiteral("ts"), nanosToMicros(event.timeNanos)},
+                {QStringLiteral("pid"), pid},
+                {QStringLiteral("tid"), record.threadId},
+        };
+        if (event.phase == TraceEvent::Phase::Complete) {
+            json.insert(QStringLiteral("dur"), nanosToMicros(event.durationNanos));
+        } else if (event.phase == TraceEvent::Phase::Instant) {
+            // Instant events are scoped to their thread
+            json.insert(QStringLiteral("s"), QStringLiteral("t"));
+        }
+        writeEvent(json);
+    }
+
+    success &= pDevice->write("\n]}\n") >= 0;
+    return success;
+}
+
+} // namespace mixxx
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <QIODevice>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+#include "util/stat.h"
+
+namespace mixxx {
+
+// The name of a trace event that can be recorded without any allocation.
+//
+// Tags are created at compile time from string literals. Names that are
+// composed at runtime, e.g. with the name of a device or deck, need to be
+// interned once, preferably when constructing the object that records
+// the events. The address of the name is used as the id of a tag.
+class TraceTag {
+  public:
+    template<std::size_t N>
+    consteval TraceTag(const char (&name)[N])
+            : m_name(name) {
+    }
+
+    // Returns the same tag for all equal names. Interned names are never
+    // released. Only the first call for a name on each thread acquires a
+    // lock and allocates memory.
+    static TraceTag intern(const QString& name);
+
+    const char* name() const {
+        return m_name;
+    }
+
+    friend bool operator==(TraceTag lhs, TraceTag rhs) {
+        return lhs.m_name == rhs.m_name;
+    }
+
+  private:
+    explicit constexpr TraceTag(const char* name, bool /*interned*/)
+            : m_name(name) {
+    }
+
+    const char* m_name;
+};
+
+struct TraceEvent {
+    // The phases correspond to those of the Chrome trace event format
+    enum class Phase : quint8 {
+        Begin,
+        End,
+        Instant,
+        // A duration that is recorded as a single event when it ends
+        Complete,
+    };
+
+    const char* name;
+    // Nanoseconds since Mixxx started, see mixxx::Time::elapsed()
+    qint64 timeNanos;
+    // Only for Complete events
+    qint64 durationNanos;
+    // Flags of the statistic that is derived from the event
+    Stat::ComputeFlags compute;
+    Phase phase;
+};
+
+// A recorded event together with the id of the thread that recorded it
+struct TraceRecord {
+    int threadId;
+    TraceEvent event;
+};
+
+// Records trace events into a fixed-size ring buffer per thread.
+//
+// Recording an event never blocks and doesn't allocate memory, with the
+// exception of creating the ring buffer for a thread on its first event.
+// Events are dropped if the ring buffer of a thread is full. A single
+// consumer, the StatsManager thread, periodically drains all ring buffers.
+class Tracing {
+  public:
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled);
+
+    // Nanoseconds since Mixxx started
+    static qint64 now();
+
+    static bool begin(TraceTag tag, Stat::ComputeFlags compute = Stat::COUNT) {
+        return isEnabled() && record(tag, TraceEvent::Phase::Begin, now(), 0, compute);
+    }
+    static bool end(TraceTag tag, Stat::ComputeFlags compute = Stat::COUNT) {
+        return isEnabled() && record(tag, TraceEvent::Phase::End, now(), 0, compute);
+    }
+    static bool instant(TraceTag tag, Stat::ComputeFlags compute = Stat::COUNT) {
+        return isEnabled() && record(tag, TraceEvent::Phase::Instant, now(), 0, compute);
+    }
+    static bool complete(TraceTag tag,
+            qint64 startNanos,
+            qint64 durationNanos,
+            Stat::ComputeFlags compute) {
+        return isEnabled() &&
+                record(tag,
+                        TraceEvent::Phase::Complete,
+                        startNanos,
+                        durationNanos,
+                        compute);
+    }
+
+    // Passes all pending events of all threads to the consumer and returns
+    // the number of events. Must not be called concurrently.
+    static int drain(const std::function<void(const TraceRecord&)>& consumer);
+
+    // The number of events that have been dropped because a ring buffer
+    // was full
+    static quint64 droppedEventCount();
+
+    // The names of all threads that have ever recorded an event
+    static QMap<int, QString> threadNames();
+
+  private:
+    static bool record(TraceTag tag,
+            TraceEvent::Phase phase,
+            qint64 timeNanos,
+            qint64 durationNanos,
+            Stat::ComputeFlags compute);
+
+    static std::atomic<bool> s_enabled;
+};
+
+// Writes the records in the Chrome trace event JSON format that can be
+// loaded into Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+bool writeChromeTrace(
+        QIODevice* pDevice,
+        const QVector<TraceRecord>& records,
+        const QMap<int, QString>& threadNames);
+
+} // namespace mixxx
@@ -22,6 +22,7 @@
 #include <vorbis/codec.h>
 
 #include "util/gitinfostore.h"
+#include "util/samplekernels.h"
 #include "version.h"
 
 namespace {
@@ -214,4 +215,6 @@ void VersionStore::logBuildDetails() {
              << QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     qDebug() << "QCoreApplication::applicationDirPath()"
              << QCoreApplication::applicationDirPath();
+    // This also selects the kernels before the engine thread needs them
+    qDebug() << "Sample processing kernels:" << mixxx::SampleKernels::active().name;
 }
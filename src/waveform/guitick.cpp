@@ -3,15 +3,31 @@
 #include "waveform/guitick.h"
 #include "control/controlobject.h"
 
-GuiTick::GuiTick() {
+GuiTick::GuiTick()
+        : m_deferredPublishingEnabled(false) {
     m_pCOGuiTickTime = std::make_unique<ControlObject>(ConfigKey("[Master]", "guiTickTime"));
     m_pCOGuiTick50ms = std::make_unique<ControlObject>(ConfigKey("[Master]", "guiTick50ms"));
     m_cpuTimer.start();
 }
 
+GuiTick::~GuiTick() {
+    if (m_deferredPublishingEnabled) {
+        ControlDoublePrivate::setDeferredPublishingEnabled(false);
+        ControlDoublePrivate::publishDeferredValueChanges();
+    }
+}
+
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
+    if (!m_deferredPublishingEnabled) {
+        // Not before the first tick, otherwise deferred changes would
+        // pile up until the VsyncThread has been started
+        ControlDoublePrivate::setDeferredPublishingEnabled(true);
+        m_deferredPublishingEnabled = true;
+    }
+    ControlDoublePrivate::publishDeferredValueChanges();
+
     m_cpuTimeLastTick += m_cpuTimer.restart();
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
@@ -9,9 +9,12 @@
 
 // A helper class that manages the "guiTickTime" COs, that drive updates of the
 // GUI from the VsyncThread at the user's configured FPS (possibly downsampled).
+// Each tick also publishes the deferred changes of controls that are written
+// by the engine, see ControlPublishMode.
 class GuiTick {
   public:
     GuiTick();
+    ~GuiTick();
     void process();
 
   private:
@@ -20,4 +23,5 @@ class GuiTick {
     PerformanceTimer m_cpuTimer;
     mixxx::Duration m_lastUpdateTime;
     mixxx::Duration m_cpuTimeLastTick;
+    bool m_deferredPublishingEnabled;
 };
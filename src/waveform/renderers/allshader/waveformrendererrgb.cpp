@@ -45,7 +45,7 @@ void WaveformRendererRGB::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = waveform->getDataSize();
     if (dataSize <= 1) {
         return;
     }
@@ -63,8 +63,16 @@ void WaveformRendererRGB::paintGL() {
     // also what is used for the beat grid and the markers), or in other words
     // each block of samples is represented by devicePixelRatio pixels (width).
 
-    const double firstVisualIndex = m_waveformRenderer->getFirstDisplayedPosition() * dataSize;
-    const double lastVisualIndex = m_waveformRenderer->getLastDisplayedPosition() * dataSize;
+    // Read the reduced level that matches the zoom, so that the cost of
+    // drawing doesn't depend on the number of visible samples
+    const Waveform::VisibleLevel visibleLevel = waveform->getVisibleLevel(
+            m_waveformRenderer->getFirstDisplayedPosition() * dataSize,
+            m_waveformRenderer->getLastDisplayedPosition() * dataSize,
+            length);
+    dataSize = visibleLevel.dataSize;
+    data = visibleLevel.data;
+    const double firstVisualIndex = visibleLevel.firstVisualIndex;
+    const double lastVisualIndex = visibleLevel.lastVisualIndex;
 
     // Represents the # of waveform data points per horizontal pixel.
     const double visualIncrementPerPixel =
@@ -107,7 +107,7 @@ int QtWaveformRendererFilteredSignal::buildPolygon() {
         return 0;
     }
 
-    const int dataSize = pWaveform->getDataSize();
+    int dataSize = pWaveform->getDataSize();
     if (dataSize <= 1) {
         return 0;
     }
@@ -122,12 +122,18 @@ int QtWaveformRendererFilteredSignal::buildPolygon() {
         return 0;
     }
 
-    const double firstVisualIndex =
+    // Read the reduced level that matches the zoom, so that the cost of
+    // drawing doesn't depend on the number of visible samples
+    const Waveform::VisibleLevel visibleLevel = pWaveform->getVisibleLevel(
             m_waveformRenderer->getFirstDisplayedPosition() * trackSamples /
-            audioVisualRatio;
-    const double lastVisualIndex =
+                    audioVisualRatio,
             m_waveformRenderer->getLastDisplayedPosition() * trackSamples /
-            audioVisualRatio;
+                    audioVisualRatio,
+            m_waveformRenderer->getLength());
+    dataSize = visibleLevel.dataSize;
+    data = visibleLevel.data;
+    const double firstVisualIndex = visibleLevel.firstVisualIndex;
+    const double lastVisualIndex = visibleLevel.lastVisualIndex;
 
     m_polygon[0].clear();
     m_polygon[1].clear();
@@ -48,7 +48,7 @@ void QtWaveformRendererSimpleSignal::draw(QPainter* painter, QPaintEvent* /*even
         return;
     }
 
-    const int dataSize = pWaveform->getDataSize();
+    int dataSize = pWaveform->getDataSize();
     if (dataSize <= 1) {
         return;
     }
@@ -94,12 +94,19 @@ void QtWaveformRendererSimpleSignal::draw(QPainter* painter, QPaintEvent* /*even
         painter->drawLine(0,0,m_waveformRenderer->getLength(),0);
     }
 
-    const double firstVisualIndex =
+    // Read the reduced level that matches the zoom, so that the cost of
+    // drawing doesn't depend on the number of visible samples
+    const Waveform::VisibleLevel visibleLevel = pWaveform->getVisibleLevel(
             m_waveformRenderer->getFirstDisplayedPosition() * trackSamples /
-            audioVisualRatio;
-    const double lastVisualIndex =
+                    audioVisualRatio,
             m_waveformRenderer->getLastDisplayedPosition() * trackSamples /
-            audioVisualRatio;
+                    audioVisualRatio,
+            m_waveformRenderer->getLength());
+    dataSize = visibleLevel.dataSize;
+    data = visibleLevel.data;
+    const double firstVisualIndex = visibleLevel.firstVisualIndex;
+    const double lastVisualIndex = visibleLevel.lastVisualIndex;
+
     m_polygon.clear();
     m_polygon.reserve(2 * m_waveformRenderer->getLength() + 2);
     m_polygon.append(QPointF(0.0, 0.0));
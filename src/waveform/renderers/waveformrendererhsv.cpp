@@ -35,7 +35,7 @@ void WaveformRendererHSV::draw(
         return;
     }
 
-    const int dataSize = pWaveform->getDataSize();
+    int dataSize = pWaveform->getDataSize();
     if (dataSize <= 1) {
         return;
     }
@@ -62,12 +62,18 @@ void WaveformRendererHSV::draw(
         painter->setTransform(QTransform(0, 1, 1, 0, 0, 0));
     }
 
-    const double firstVisualIndex =
+    // Read the reduced level that matches the zoom, so that the cost of
+    // drawing doesn't depend on the number of visible samples
+    const Waveform::VisibleLevel visibleLevel = pWaveform->getVisibleLevel(
             m_waveformRenderer->getFirstDisplayedPosition() * trackSamples /
-            audioVisualRatio;
-    const double lastVisualIndex =
+                    audioVisualRatio,
             m_waveformRenderer->getLastDisplayedPosition() * trackSamples /
-            audioVisualRatio;
+                    audioVisualRatio,
+            m_waveformRenderer->getLength());
+    dataSize = visibleLevel.dataSize;
+    data = visibleLevel.data;
+    const double firstVisualIndex = visibleLevel.firstVisualIndex;
+    const double lastVisualIndex = visibleLevel.lastVisualIndex;
 
     const double offset = firstVisualIndex;
 
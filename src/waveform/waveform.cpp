@@ -4,11 +4,15 @@
 
 #include "analyzer/constants.h"
 #include "proto/waveform.pb.h"
+#include "util/math.h"
 
 using namespace mixxx::track;
 
 constexpr int kNumChannels = 2;
 
+// Reducing further than this doesn't pay off for any zoom factor
+constexpr int kMinLevelVisualFrames = 64;
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -26,7 +30,8 @@ Waveform::Waveform(const QByteArray& data)
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_levelCount(1) {
     readByteArray(data);
 }
 
@@ -41,7 +46,8 @@ Waveform::Waveform(
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
-          m_completion(-1) {
+          m_completion(-1),
+          m_levelCount(1) {
     int numberOfVisualSamples = 0;
     if (audioSampleRate > 0) {
         if (maxVisualSamples == -1) {
@@ -218,6 +224,63 @@ void Waveform::assign(int size, int value) {
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::buildLevels() {
+    VERIFY_OR_DEBUG_ASSERT(getLevelCount() == 1) {
+        return;
+    }
+    std::vector<std::vector<WaveformData>> levels;
+    const WaveformData* pSource = data();
+    int sourceFrames = m_dataSize / kNumChannels;
+    while (sourceFrames > kMinLevelVisualFrames) {
+        const int frames = (sourceFrames + 1) / 2;
+        std::vector<WaveformData> level(frames * kNumChannels);
+        for (int frame = 0; frame < frames; ++frame) {
+            const int first = 2 * frame;
+            // The last frame of an odd number of frames has no successor
+            const int second = math_min(first + 1, sourceFrames - 1);
+            for (int channel = 0; channel < kNumChannels; ++channel) {
+                const WaveformData& a = pSource[first * kNumChannels + channel];
+                const WaveformData& b = pSource[second * kNumChannels + channel];
+                WaveformData& reduced = level[frame * kNumChannels + channel];
+                reduced.filtered.low = math_max(a.filtered.low, b.filtered.low);
+                reduced.filtered.mid = math_max(a.filtered.mid, b.filtered.mid);
+                reduced.filtered.high = math_max(a.filtered.high, b.filtered.high);
+                reduced.filtered.all = math_max(a.filtered.all, b.filtered.all);
+            }
+        }
+        levels.push_back(std::move(level));
+        pSource = levels.back().data();
+        sourceFrames = frames;
+    }
+    m_levels = std::move(levels);
+    // Publish the levels to the renderers
+    m_levelCount.storeRelease(static_cast<int>(m_levels.size()) + 1);
+}
+
+int Waveform::getLevelForVisualSamplesPerPixel(double visualSamplesPerPixel) const {
+    const int levelCount = getLevelCount();
+    // Each pixel still spans at least one visual frame of the selected level
+    int level = 0;
+    double levelFramesPerPixel = visualSamplesPerPixel / kNumChannels;
+    while (level + 1 < levelCount && levelFramesPerPixel >= 2.0) {
+        levelFramesPerPixel /= 2;
+        ++level;
+    }
+    return level;
+}
+
+Waveform::VisibleLevel Waveform::getVisibleLevel(double firstVisualIndex,
+        double lastVisualIndex,
+        double pixelCount) const {
+    const int level = getLevelForVisualSamplesPerPixel(
+            (lastVisualIndex - firstVisualIndex) / pixelCount);
+    const double levelScale = std::ldexp(1.0, -level);
+    return VisibleLevel{levelData(level),
+            getLevelDataSize(level),
+            firstVisualIndex * levelScale,
+            lastVisualIndex * levelScale};
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
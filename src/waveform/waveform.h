@@ -128,6 +128,47 @@ class Waveform {
     // constructor runs.
     const WaveformData* data() const { return &m_data[0];}
 
+    // Builds the reduced levels from the completed waveform data. Must be
+    // called at most once after all data has been written.
+    void buildLevels();
+
+    // The waveform data is reduced by successive 2x decimations of the
+    // visual frames, keeping the maximum of each band and channel. Level 0
+    // is the waveform data itself. Renderers read the level that matches
+    // the current zoom so the cost of a frame is proportional to the number
+    // of pixels and not to the number of visible samples. Until the levels
+    // are built only level 0 is available.
+    int getLevelCount() const {
+        return m_levelCount.loadAcquire();
+    }
+
+    // Returns the coarsest level in which a single visual frame does not
+    // span more than the given number of visual samples of level 0.
+    int getLevelForVisualSamplesPerPixel(double visualSamplesPerPixel) const;
+
+    // The data of level n is indexed by visual sample index / 2^n.
+    int getLevelDataSize(int level) const {
+        return level == 0 ? m_dataSize : static_cast<int>(m_levels[level - 1].size());
+    }
+    const WaveformData* levelData(int level) const {
+        return level == 0 ? data() : m_levels[level - 1].data();
+    }
+
+    // The data of a level and the visible range of visual sample indices
+    // within that level.
+    struct VisibleLevel {
+        const WaveformData* data;
+        int dataSize;
+        double firstVisualIndex;
+        double lastVisualIndex;
+    };
+
+    // Selects the level for drawing the visual samples of level 0 from
+    // firstVisualIndex to lastVisualIndex onto the given number of pixels.
+    VisibleLevel getVisibleLevel(double firstVisualIndex,
+            double lastVisualIndex,
+            double pixelCount) const;
+
     void dump() const;
 
   private:
@@ -173,6 +214,11 @@ class Waveform {
     // the mutex. The completion of the waveform calculation.
     QAtomicInt m_completion;
 
+    // The reduced levels 1..n. Not allowed to change after m_levelCount has
+    // been published.
+    std::vector<std::vector<WaveformData>> m_levels;
+    QAtomicInt m_levelCount;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
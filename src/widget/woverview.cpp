@@ -301,6 +301,7 @@ void WOverview::slotWaveformSummaryUpdated() {
     } else {
         // Null waveform pointer means waveform was cleared.
         m_waveformSourceImage = QImage();
+        invalidateScaledWaveform();
         m_analyzerProgress = kAnalyzerProgressUnknown;
         m_actualCompletion = 0;
         m_waveformPeak = -1.0;
@@ -349,6 +350,7 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     }
 
     m_waveformSourceImage = QImage();
+    invalidateScaledWaveform();
     m_analyzerProgress = kAnalyzerProgressUnknown;
     m_actualCompletion = 0;
     m_waveformPeak = -1.0;
@@ -703,24 +705,107 @@ void WOverview::drawWaveformPixmap(QPainter* pPainter) {
             diffGain = 255.0f - (255.0f / visualGain);
         }
 
-        if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
-            QRect sourceRect(0,
-                    static_cast<int>(diffGain),
-                    m_waveformSourceImage.width(),
-                    m_waveformSourceImage.height() -
-                            2 * static_cast<int>(diffGain));
-            QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
-            if (m_orientation == Qt::Vertical) {
-                // Rotate pixmap
-                croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
-            }
-            m_waveformImageScaled = croppedImage.scaled(size() * m_devicePixelRatio,
-                    Qt::IgnoreAspectRatio,
-                    Qt::SmoothTransformation);
+        if (m_diffGain != diffGain) {
+            invalidateScaledWaveform();
             m_diffGain = diffGain;
         }
 
-        pPainter->drawImage(rect(), m_waveformImageScaled);
+        const int tileCount = (m_waveformSourceImage.width() + kWaveformTileColumns - 1) /
+                kWaveformTileColumns;
+        if (static_cast<int>(m_waveformTilesScaled.size()) != tileCount) {
+            m_waveformTilesScaled.assign(tileCount, QImage());
+            m_waveformTilePositions.assign(tileCount, 0);
+        }
+
+        // Draw in device pixels, so that the tiles remain adjacent with a
+        // fractional device pixel ratio
+        pPainter->scale(1 / m_devicePixelRatio, 1 / m_devicePixelRatio);
+
+        // In the steady state this is only a blit of each tile
+        for (int tile = 0; tile < tileCount; ++tile) {
+            QImage& scaledTile = m_waveformTilesScaled[tile];
+            if (scaledTile.isNull()) {
+                scaledTile = scaleWaveformTile(tile, &m_waveformTilePositions[tile]);
+                if (scaledTile.isNull()) {
+                    continue;
+                }
+            }
+            if (m_orientation == Qt::Horizontal) {
+                pPainter->drawImage(QPoint(m_waveformTilePositions[tile], 0), scaledTile);
+            } else {
+                pPainter->drawImage(QPoint(0, m_waveformTilePositions[tile]), scaledTile);
+            }
+        }
+    }
+}
+
+// static
+WOverview::WaveformTileLayout WOverview::waveformTileLayout(
+        int tile, int sourceWidth, int scaledLength) {
+    const auto scaledColumn = [sourceWidth, scaledLength](int column) {
+        return static_cast<int>(std::round(
+                static_cast<double>(column) * scaledLength / sourceWidth));
+    };
+    const int firstColumn = tile * kWaveformTileColumns;
+    const int endColumn = math_min(firstColumn + kWaveformTileColumns, sourceWidth);
+    WaveformTileLayout layout;
+    layout.paddedFirstColumn = math_max(firstColumn - 1, 0);
+    layout.paddedEndColumn = math_min(endColumn + 1, sourceWidth);
+    layout.paddedScaledStart = scaledColumn(layout.paddedFirstColumn);
+    layout.paddedScaledEnd = scaledColumn(layout.paddedEndColumn);
+    layout.scaledStart = scaledColumn(firstColumn);
+    layout.scaledEnd = scaledColumn(endColumn);
+    return layout;
+}
+
+QImage WOverview::scaleWaveformTile(int tile, int* pScaledStart) const {
+    const int scaledLength = static_cast<int>(std::ceil(
+            (m_orientation == Qt::Horizontal ? width() : height()) * m_devicePixelRatio));
+    const int scaledBreadth = static_cast<int>(std::ceil(
+            (m_orientation == Qt::Horizontal ? height() : width()) * m_devicePixelRatio));
+    const WaveformTileLayout layout = waveformTileLayout(
+            tile, m_waveformSourceImage.width(), scaledLength);
+    if (layout.scaledEnd <= layout.scaledStart || scaledBreadth <= 0) {
+        return QImage();
+    }
+    *pScaledStart = layout.scaledStart;
+
+    QRect sourceRect(layout.paddedFirstColumn,
+            static_cast<int>(m_diffGain),
+            layout.paddedEndColumn - layout.paddedFirstColumn,
+            m_waveformSourceImage.height() -
+                    2 * static_cast<int>(m_diffGain));
+    QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
+    QSize scaledSize(layout.paddedScaledEnd - layout.paddedScaledStart, scaledBreadth);
+    QRect tileRect(layout.scaledStart - layout.paddedScaledStart,
+            0,
+            layout.scaledEnd - layout.scaledStart,
+            scaledBreadth);
+    if (m_orientation == Qt::Vertical) {
+        // Rotate pixmap
+        croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+        scaledSize.transpose();
+        tileRect = QRect(tileRect.y(), tileRect.x(), tileRect.height(), tileRect.width());
+    }
+    // The padding is covered by the neighboring tiles
+    return croppedImage
+            .scaled(scaledSize,
+                    Qt::IgnoreAspectRatio,
+                    Qt::SmoothTransformation)
+            .copy(tileRect);
+}
+
+void WOverview::invalidateScaledWaveform(int firstColumn, int endColumn) {
+    if (m_waveformTilesScaled.empty() || endColumn <= firstColumn) {
+        return;
+    }
+    // The neighboring tiles are padded with the outermost columns
+    firstColumn = math_max(firstColumn - 1, 0);
+    endColumn = math_min(endColumn + 1, m_waveformSourceImage.width());
+    const int lastTile = math_min((endColumn - 1) / kWaveformTileColumns,
+            static_cast<int>(m_waveformTilesScaled.size()) - 1);
+    for (int tile = firstColumn / kWaveformTileColumns; tile <= lastTile; ++tile) {
+        m_waveformTilesScaled[tile] = QImage();
     }
 }
 
@@ -730,14 +815,14 @@ void WOverview::drawPlayedOverlay(QPainter* pPainter) {
         if (m_orientation == Qt::Vertical) {
             pPainter->fillRect(0,
                     0,
-                    m_waveformImageScaled.width(),
+                    width(),
                     m_iPlayPos,
                     m_playedOverlayColor);
         } else {
             pPainter->fillRect(0,
                     0,
                     m_iPlayPos,
-                    m_waveformImageScaled.height(),
+                    height(),
                     m_playedOverlayColor);
         }
     }
@@ -1314,8 +1399,7 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_devicePixelRatio = devicePixelRatioF();
 
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
+    invalidateScaledWaveform();
     Init();
 }
 
@@ -16,6 +16,7 @@
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPixmap>
+#include <vector>
 
 #include "analyzer/analyzerprogress.h"
 #include "skin/legacy/skincontext.h"
@@ -37,6 +38,10 @@ class PainterScope;
 class WOverview : public WWidget, public TrackDropTarget {
     Q_OBJECT
   public:
+    // The number of columns of the source image per scaled tile. The source
+    // image of a waveform summary has less than 2000 columns.
+    static constexpr int kWaveformTileColumns = 128;
+
     void setup(const QDomNode& node, const SkinContext& context);
     virtual void initWithTrack(TrackPointer pTrack);
 
@@ -89,8 +94,15 @@ class WOverview : public WWidget, public TrackDropTarget {
         }
     }
 
+    // Invalidates the scaled tiles that contain or are padded with the
+    // given columns of m_waveformSourceImage, i.e. visual frames of the
+    // waveform summary
+    void invalidateScaledWaveform(int firstColumn, int endColumn);
+    void invalidateScaledWaveform() {
+        m_waveformTilesScaled.clear();
+    }
+
     QImage m_waveformSourceImage;
-    QImage m_waveformImageScaled;
 
     WaveformSignalColors m_signalColors;
 
@@ -103,6 +115,38 @@ class WOverview : public WWidget, public TrackDropTarget {
     float m_diffGain;
     qreal m_devicePixelRatio;
 
+  private:
+    friend class WOverviewTest;
+
+    // The columns of m_waveformSourceImage and the device pixels along the
+    // length of the widget that make up a scaled tile. Adjacent tiles share
+    // their boundaries, because both are rounded from the same column.
+    struct WaveformTileLayout {
+        // Includes a column of each neighboring tile, so that the smooth
+        // scaling is continuous across the boundaries of the tiles
+        int paddedFirstColumn;
+        int paddedEndColumn;
+        int paddedScaledStart;
+        int paddedScaledEnd;
+        // The part of the scaled padded tile that is drawn
+        int scaledStart;
+        int scaledEnd;
+    };
+    static WaveformTileLayout waveformTileLayout(
+            int tile, int sourceWidth, int scaledLength);
+
+    // Renders the scaled tile from m_waveformSourceImage and returns its
+    // position in device pixels along the length of the widget
+    QImage scaleWaveformTile(int tile, int* pScaledStart) const;
+
+    // The scaled waveform is split into tiles with a fixed number of
+    // columns of m_waveformSourceImage. A null tile needs to be scaled
+    // again, all other tiles are only blitted on paint.
+    std::vector<QImage> m_waveformTilesScaled;
+    // The position of each tile in device pixels along the length of the
+    // widget
+    std::vector<int> m_waveformTilePositions;
+
   private slots:
     void onEndOfTrackChange(double v);
 
@@ -123,9 +123,9 @@ bool WOverviewLMH::drawNextPixmapPart() {
                 static_cast<float>(pWaveform->getAll(currentCompletion + 1)));
     }
 
+    // Only the newly drawn part needs to be scaled again
+    invalidateScaledWaveform(m_actualCompletion / 2, nextCompletion / 2);
     m_actualCompletion = nextCompletion;
-    m_waveformImageScaled = QImage();
-    m_diffGain = 0;
 
     // Test if the complete waveform is done
     if (m_actualCompletion >= dataSize - 2) {
@@ -22,6 +22,22 @@ def copy_with_ramping_gain_method_name(i):
     return RAMPING_GAIN_METHOD_PATTERN % {"i": i}
 
 
+# The loops that are implemented by mixxx::SampleKernels with runtime
+# dispatched SIMD instructions, see src/util/samplekernels.h. They are
+# called through out-of-line SampleUtil wrappers named <kernel>Kernel, so
+# that sample.h does not depend on samplekernels.h.
+COPY_WITH_GAIN_KERNELS = {
+    1: "copyWithGain",
+    2: "copy2WithGain",
+    3: "copy3WithGain",
+}
+COPY_WITH_RAMPING_GAIN_KERNELS = {
+    1: "copyWithRampingGain",
+    2: "copy2WithRampingGain",
+}
+SAMPLE_KERNEL_SUFFIX = "Kernel"
+
+
 def method_call(method_name, args):
     return "%(method_name)s(%(args)s)" % {
         "method_name": method_name,
@@ -44,19 +60,16 @@ def hanging_indent(base, groups, hanging_suffix, terminator, depth=0):
 
 
 def write_sample_autogen(output, num_channels):
-    output.append("#ifndef MIXXX_UTIL_SAMPLEAUTOGEN_H")
-    output.append("#define MIXXX_UTIL_SAMPLEAUTOGEN_H")
+    output.append("#pragma once")
     output.append("////////////////////////////////////////////////////////")
     output.append("// THIS FILE IS AUTO-GENERATED. DO NOT EDIT DIRECTLY! //")
-    output.append("// SEE scripts/generate_sample_functions.py           //")
+    output.append("// SEE tools/generate_sample_functions.py             //")
     output.append("////////////////////////////////////////////////////////")
 
     for i in range(1, num_channels + 1):
         copy_with_gain(output, 0, i)
         copy_with_ramping_gain(output, 0, i)
 
-    output.append("#endif /* MIXXX_UTIL_SAMPLEAUTOGEN_H */")
-
 
 def copy_with_gain(output, base_indent_depth, num_channels):
     def write(data, depth=0):
@@ -105,6 +118,20 @@ def copy_with_gain(output, base_indent_depth, num_channels):
         write("return;", depth=2)
         write("}", depth=1)
 
+    if num_channels in COPY_WITH_GAIN_KERNELS:
+        args = (
+            ["pDest"]
+            + ["pSrc%(i)d, gain%(i)d" % {"i": i} for i in range(num_channels)]
+            + ["iNumSamples"]
+        )
+        write(
+            "%s;"
+            % method_call(COPY_WITH_GAIN_KERNELS[num_channels] + SAMPLE_KERNEL_SUFFIX, args),
+            depth=1,
+        )
+        write("}")
+        return
+
     write("// note: LOOP VECTORIZED.", depth=1)
     write("for (int i = 0; i < iNumSamples; ++i) {", depth=1)
     terms = [
@@ -192,6 +219,23 @@ def copy_with_ramping_gain(output, base_indent_depth, num_channels):
             depth=1,
         )
 
+    if num_channels in COPY_WITH_RAMPING_GAIN_KERNELS:
+        args = (
+            ["pDest"]
+            + [
+                "pSrc%(i)d, start_gain%(i)d, gain_delta%(i)d" % {"i": i}
+                for i in range(num_channels)
+            ]
+            + ["iNumSamples / 2"]
+        )
+        write(
+            "%s;"
+            % method_call(COPY_WITH_RAMPING_GAIN_KERNELS[num_channels] + SAMPLE_KERNEL_SUFFIX, args),
+            depth=1,
+        )
+        write("}")
+        return
+
     write("// note: LOOP VECTORIZED.", depth=1)
     write("for (int i = 0; i < iNumSamples / 2; ++i) {", depth=1)
 